@@ -0,0 +1,157 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+// Measures the throughput of cdc_concurrent_map and of cdc_hash_table guarded
+// by one mutex for a growing number of threads. 90% of operations are lookups,
+// 10% are insertions or assignments.
+#define _POSIX_C_SOURCE 200112L
+#include <cdcontainers/concurrent-map.h>
+#include <cdcontainers/hash-table.h>
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define KEYS (1 << 20)
+#define OPS_PER_THREAD (1 << 21)
+#define MAX_THREADS 16
+
+struct locked_table {
+  pthread_mutex_t lock;
+  struct cdc_hash_table *table;
+};
+
+struct worker_arg {
+  struct cdc_concurrent_map *map;
+  struct locked_table *locked;
+  size_t seed;
+};
+
+static int eq(const void *l, const void *r) { return l == r; }
+
+static size_t hash(const void *val) { return (size_t)val; }
+
+static size_t next_random(size_t *state)
+{
+  *state = *state * 6364136223846793005u + 1442695040888963407u;
+  return *state >> 16;
+}
+
+static double now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void *map_worker(void *ptr)
+{
+  struct worker_arg *arg = (struct worker_arg *)ptr;
+  void *value = NULL;
+  for (size_t i = 0; i < OPS_PER_THREAD; ++i) {
+    size_t r = next_random(&arg->seed);
+    void *key = (void *)(r % KEYS + 1);
+    if (r % 10 == 0) {
+      cdc_concurrent_map_insert_or_assign(arg->map, key, key, NULL);
+    } else {
+      cdc_concurrent_map_get(arg->map, key, &value);
+    }
+  }
+
+  return NULL;
+}
+
+static void *locked_worker(void *ptr)
+{
+  struct worker_arg *arg = (struct worker_arg *)ptr;
+  void *value = NULL;
+  for (size_t i = 0; i < OPS_PER_THREAD; ++i) {
+    size_t r = next_random(&arg->seed);
+    void *key = (void *)(r % KEYS + 1);
+    pthread_mutex_lock(&arg->locked->lock);
+    if (r % 10 == 0) {
+      cdc_hash_table_insert_or_assign(arg->locked->table, key, key, NULL, NULL);
+    } else {
+      cdc_hash_table_get(arg->locked->table, key, &value);
+    }
+
+    pthread_mutex_unlock(&arg->locked->lock);
+  }
+
+  return NULL;
+}
+
+static double run(void *(*fn)(void *), struct cdc_concurrent_map *map,
+                  struct locked_table *locked, int nthreads)
+{
+  pthread_t threads[MAX_THREADS];
+  struct worker_arg args[MAX_THREADS];
+  double start = now();
+  for (int i = 0; i < nthreads; ++i) {
+    args[i].map = map;
+    args[i].locked = locked;
+    args[i].seed = (size_t)i + 1;
+    pthread_create(&threads[i], NULL, fn, &args[i]);
+  }
+
+  for (int i = 0; i < nthreads; ++i) {
+    pthread_join(threads[i], NULL);
+  }
+
+  double elapsed = now() - start;
+  return (double)nthreads * OPS_PER_THREAD / elapsed / 1e6;
+}
+
+int main()
+{
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  struct cdc_concurrent_map *map = NULL;
+  struct locked_table locked;
+  if (cdc_concurrent_map_ctor1(&map, &info, MAX_THREADS) != CDC_STATUS_OK) {
+    return EXIT_FAILURE;
+  }
+
+  if (cdc_hash_table_ctor(&locked.table, &info) != CDC_STATUS_OK) {
+    cdc_concurrent_map_dtor(map);
+    return EXIT_FAILURE;
+  }
+
+  pthread_mutex_init(&locked.lock, NULL);
+  for (size_t i = 1; i <= KEYS; ++i) {
+    cdc_concurrent_map_insert(map, (void *)i, (void *)i, NULL);
+    cdc_hash_table_insert(locked.table, (void *)i, (void *)i, NULL, NULL);
+  }
+
+  printf("threads  mutex + cdc_hash_table  cdc_concurrent_map (Mops/s)\n");
+  for (int nthreads = 1; nthreads <= MAX_THREADS; nthreads *= 2) {
+    double locked_ops = run(locked_worker, NULL, &locked, nthreads);
+    double map_ops = run(map_worker, map, NULL, nthreads);
+    printf("%7d  %22.2f  %18.2f\n", nthreads, locked_ops, map_ops);
+  }
+
+  pthread_mutex_destroy(&locked.lock);
+  cdc_hash_table_dtor(locked.table);
+  cdc_concurrent_map_dtor(map);
+  return EXIT_SUCCESS;
+}
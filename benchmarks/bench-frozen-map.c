@@ -0,0 +1,102 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+// Compares lookups in cdc_frozen_map with lookups in cdc_hash_table that the
+// frozen map is built from.
+#include <cdcontainers/frozen-map.h>
+#include <cdcontainers/global.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define COUNT (1 << 22)
+#define LOOKUPS (1 << 22)
+
+static int eq(const void *l, const void *r) { return l == r; }
+
+static int lt(const void *l, const void *r) { return l < r; }
+
+static size_t hash(const void *val) { return (size_t)val; }
+
+static double seconds(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static size_t next_random(size_t *state)
+{
+  *state = *state * 6364136223846793005u + 1442695040888963407u;
+  return *state >> 16;
+}
+
+int main()
+{
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.eq = eq;
+  info.hash = hash;
+  struct cdc_map *map = NULL;
+  struct cdc_frozen_map *frozen = NULL;
+  void **keys = (void **)malloc(LOOKUPS * sizeof(void *));
+  if (!keys || cdc_map_ctor(cdc_map_htable, &map, &info) != CDC_STATUS_OK) {
+    free(keys);
+    return EXIT_FAILURE;
+  }
+
+  for (size_t i = 1; i <= COUNT; ++i) {
+    cdc_map_insert(map, (void *)i, (void *)i, NULL, NULL);
+  }
+
+  clock_t start = clock();
+  if (cdc_frozen_map_ctor(&frozen, &info, map) != CDC_STATUS_OK) {
+    cdc_map_dtor(map);
+    free(keys);
+    return EXIT_FAILURE;
+  }
+
+  printf("cdc_frozen_map_ctor, %d keys: %.3f s\n", COUNT, seconds(start));
+  size_t state = 1;
+  for (size_t i = 0; i < LOOKUPS; ++i) {
+    keys[i] = (void *)(next_random(&state) % (2 * COUNT) + 1);
+  }
+
+  size_t found = 0;
+  void *value = NULL;
+  start = clock();
+  for (size_t i = 0; i < LOOKUPS; ++i) {
+    found += cdc_map_get(map, keys[i], &value) == CDC_STATUS_OK;
+  }
+
+  printf("%d x cdc_hash_table get: %.3f s (found %zu)\n", LOOKUPS,
+         seconds(start), found);
+  found = 0;
+  start = clock();
+  for (size_t i = 0; i < LOOKUPS; ++i) {
+    found += cdc_frozen_map_get(frozen, keys[i], &value) == CDC_STATUS_OK;
+  }
+
+  printf("%d x cdc_frozen_map_get: %.3f s (found %zu)\n", LOOKUPS,
+         seconds(start), found);
+  cdc_frozen_map_dtor(frozen);
+  cdc_map_dtor(map);
+  free(keys);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+// Compares cdc_hash_table_get_many with separate calls of cdc_hash_table_get
+// on a table that does not fit in the cache.
+#include <cdcontainers/hash-table.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define COUNT (1 << 22)
+#define LOOKUPS (1 << 22)
+
+static int eq(const void *l, const void *r) { return l == r; }
+
+static size_t hash(const void *val) { return (size_t)val; }
+
+static double seconds(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static size_t next_random(size_t *state)
+{
+  *state = *state * 6364136223846793005u + 1442695040888963407u;
+  return *state >> 16;
+}
+
+int main()
+{
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  struct cdc_hash_table *t = NULL;
+  void **keys = (void **)malloc(LOOKUPS * sizeof(void *));
+  void **values = (void **)malloc(LOOKUPS * sizeof(void *));
+  if (!keys || !values || cdc_hash_table_ctor(&t, &info) != CDC_STATUS_OK) {
+    free(keys);
+    free(values);
+    return EXIT_FAILURE;
+  }
+
+  for (size_t i = 1; i <= COUNT; ++i) {
+    cdc_hash_table_insert(t, (void *)i, (void *)i, NULL, NULL);
+  }
+
+  size_t state = 1;
+  for (size_t i = 0; i < LOOKUPS; ++i) {
+    keys[i] = (void *)(next_random(&state) % COUNT + 1);
+  }
+
+  size_t found = 0;
+  clock_t start = clock();
+  for (size_t i = 0; i < LOOKUPS; ++i) {
+    found += cdc_hash_table_get(t, keys[i], &values[i]) == CDC_STATUS_OK;
+  }
+
+  printf("%d x cdc_hash_table_get: %.3f s (found %zu)\n", LOOKUPS,
+         seconds(start), found);
+  const size_t batches[] = {32, 64, 128, 256};
+  for (size_t b = 0; b < sizeof(batches) / sizeof(batches[0]); ++b) {
+    found = 0;
+    start = clock();
+    for (size_t i = 0; i < LOOKUPS; i += batches[b]) {
+      found += cdc_hash_table_get_many(t, keys + i, batches[b], values + i,
+                                       NULL);
+    }
+
+    printf("cdc_hash_table_get_many, batch %3zu: %.3f s (found %zu)\n",
+           batches[b], seconds(start), found);
+  }
+
+  cdc_hash_table_dtor(t);
+  free(keys);
+  free(values);
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,108 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+// Compares cdc_hash_set with cdc_hash_table used as a set with NULL values.
+#include <cdcontainers/hash-set.h>
+#include <cdcontainers/hash-table.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define COUNT (1 << 20)
+
+static int eq(const void *l, const void *r) { return l == r; }
+
+static size_t hash(const void *val) { return (size_t)val; }
+
+static double seconds(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static void bench_table(struct cdc_data_info *info)
+{
+  struct cdc_hash_table *t = NULL;
+  if (cdc_hash_table_ctor(&t, info) != CDC_STATUS_OK) {
+    return;
+  }
+
+  clock_t start = clock();
+  for (size_t i = 1; i <= COUNT; ++i) {
+    cdc_hash_table_insert(t, (void *)i, NULL, NULL, NULL);
+  }
+
+  printf("cdc_hash_table insert:   %.3f s\n", seconds(start));
+  size_t found = 0;
+  start = clock();
+  for (size_t i = 1; i <= 2 * COUNT; ++i) {
+    found += cdc_hash_table_count(t, (void *)i);
+  }
+
+  printf("cdc_hash_table count:    %.3f s (found %zu)\n", seconds(start),
+         found);
+  start = clock();
+  for (size_t i = 1; i <= COUNT; ++i) {
+    cdc_hash_table_erase(t, (void *)i);
+  }
+
+  printf("cdc_hash_table erase:    %.3f s\n", seconds(start));
+  cdc_hash_table_dtor(t);
+}
+
+static void bench_set(struct cdc_data_info *info)
+{
+  struct cdc_hash_set *s = NULL;
+  if (cdc_hash_set_ctor(&s, info) != CDC_STATUS_OK) {
+    return;
+  }
+
+  clock_t start = clock();
+  for (size_t i = 1; i <= COUNT; ++i) {
+    cdc_hash_set_insert(s, (void *)i, NULL, NULL);
+  }
+
+  printf("cdc_hash_set insert:     %.3f s\n", seconds(start));
+  size_t found = 0;
+  start = clock();
+  for (size_t i = 1; i <= 2 * COUNT; ++i) {
+    found += cdc_hash_set_contains(s, (void *)i);
+  }
+
+  printf("cdc_hash_set contains:   %.3f s (found %zu)\n", seconds(start),
+         found);
+  start = clock();
+  for (size_t i = 1; i <= COUNT; ++i) {
+    cdc_hash_set_erase(s, (void *)i);
+  }
+
+  printf("cdc_hash_set erase:      %.3f s\n", seconds(start));
+  cdc_hash_set_dtor(s);
+}
+
+int main()
+{
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  bench_table(&info);
+  bench_set(&info);
+  return EXIT_SUCCESS;
+}
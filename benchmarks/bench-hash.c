@@ -0,0 +1,220 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+// Compares the old and the new hash functions: distribution of keys over
+// buckets and throughput, and the ways to load a hash table.
+#define _POSIX_C_SOURCE 200112L
+#include <cdcontainers/hash-table.h>
+#include <cdcontainers/hash.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BUCKETS (1 << 16)
+#define KEYS (BUCKETS / 2)
+
+static double seconds(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static double now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static void print_distribution(const char *name, size_t (*hash)(size_t),
+                               size_t stride)
+{
+  static size_t counts[BUCKETS];
+  memset(counts, 0, sizeof(counts));
+  size_t max_chain = 0;
+  for (size_t i = 0; i < KEYS; ++i) {
+    size_t bucket = hash(i * stride) & (BUCKETS - 1);
+    if (++counts[bucket] > max_chain) {
+      max_chain = counts[bucket];
+    }
+  }
+
+  size_t used = 0;
+  for (size_t i = 0; i < BUCKETS; ++i) {
+    used += counts[i] != 0;
+  }
+
+  printf("  %-16s stride %4zu: used buckets %6zu, max chain %6zu\n", name,
+         stride, used, max_chain);
+}
+
+static size_t old_int_hash(size_t val) { return cdc_hash_ulong(val); }
+
+static size_t new_int_hash(size_t val) { return cdc_hash_u64(val); }
+
+static void bench_distribution()
+{
+  printf("Distribution of %d keys over %d buckets:\n", KEYS, BUCKETS);
+  const size_t strides[] = {1, 8, 64, 4096};
+  for (size_t i = 0; i < sizeof(strides) / sizeof(strides[0]); ++i) {
+    print_distribution("cdc_hash_ulong", old_int_hash, strides[i]);
+    print_distribution("cdc_hash_u64", new_int_hash, strides[i]);
+  }
+}
+
+static void bench_throughput()
+{
+  const size_t total = (size_t)1 << 28;
+  const size_t lengths[] = {8, 16, 32, 64, 256, 4096};
+  char *buffer = (char *)malloc(4096);
+  if (!buffer) {
+    return;
+  }
+
+  for (size_t i = 0; i < 4096; ++i) {
+    buffer[i] = (char)rand();
+  }
+
+  printf("Throughput:\n");
+  for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); ++i) {
+    size_t length = lengths[i];
+    size_t n = total / length;
+    volatile size_t sink = 0;
+    clock_t start = clock();
+    for (size_t j = 0; j < n; ++j) {
+      buffer[0] = (char)j;
+      sink += cdc_hash_binary(buffer, length);
+    }
+
+    double old_time = seconds(start);
+    start = clock();
+    for (size_t j = 0; j < n; ++j) {
+      buffer[0] = (char)j;
+      sink += cdc_hash_bytes(buffer, length, 0);
+    }
+
+    double new_time = seconds(start);
+    printf("  %4zu bytes: cdc_hash_binary %8.1f MB/s, cdc_hash_bytes %8.1f "
+           "MB/s\n",
+           length, (double)total / old_time / 1e6,
+           (double)total / new_time / 1e6);
+  }
+
+  free(buffer);
+}
+
+static int eq(const void *l, const void *r) { return l == r; }
+
+static size_t hash(const void *val) { return (size_t)val; }
+
+static void bench_hash_table()
+{
+  const size_t count = 1000000;
+  const size_t stride = 64;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  struct cdc_hash_table *t = NULL;
+  if (cdc_hash_table_ctor(&t, &info) != CDC_STATUS_OK) {
+    return;
+  }
+
+  clock_t start = clock();
+  for (size_t i = 1; i <= count; ++i) {
+    cdc_hash_table_insert(t, (void *)(i * stride), NULL, NULL, NULL);
+  }
+
+  double insert_time = seconds(start);
+  size_t found = 0;
+  start = clock();
+  for (size_t i = 1; i <= count; ++i) {
+    found += cdc_hash_table_count(t, (void *)(i * stride));
+  }
+
+  double find_time = seconds(start);
+  printf("cdc_hash_table with %zu aligned pointer keys: insert %.3f s, "
+         "find %.3f s (found %zu)\n",
+         count, insert_time, find_time, found);
+  cdc_hash_table_dtor(t);
+}
+
+static void bench_bulk_load()
+{
+  const size_t count = 4000000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  void **keys = (void **)malloc(count * sizeof(void *));
+  if (!keys) {
+    return;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    keys[i] = (void *)((i + 1) * 64);
+  }
+
+  struct cdc_hash_table *t = NULL;
+  double start = now();
+  if (cdc_hash_table_ctor(&t, &info) != CDC_STATUS_OK) {
+    free(keys);
+    return;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    cdc_hash_table_insert(t, keys[i], keys[i], NULL, NULL);
+  }
+
+  double insert_time = now() - start;
+  cdc_hash_table_dtor(t);
+  start = now();
+  if (cdc_hash_table_ctor_from(&t, &info, keys, keys, count) !=
+      CDC_STATUS_OK) {
+    free(keys);
+    return;
+  }
+
+  double bulk_time = now() - start;
+  cdc_hash_table_dtor(t);
+  start = now();
+  if (cdc_hash_table_ctor(&t, &info) != CDC_STATUS_OK) {
+    free(keys);
+    return;
+  }
+
+  cdc_hash_table_set_bulk_threads(t, 4);
+  cdc_hash_table_insert_range(t, keys, keys, count);
+  double threads_time = now() - start;
+  cdc_hash_table_dtor(t);
+  printf("cdc_hash_table load of %zu keys: insert %.3f s, ctor_from %.3f s, "
+         "insert_range with 4 threads %.3f s\n",
+         count, insert_time, bulk_time, threads_time);
+  free(keys);
+}
+
+int main()
+{
+  bench_distribution();
+  bench_throughput();
+  bench_hash_table();
+  bench_bulk_load();
+  return EXIT_SUCCESS;
+}
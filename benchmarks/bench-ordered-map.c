@@ -0,0 +1,128 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+// Compares random inserts, random lookups, ordered scans and range queries of
+// the ordered cdc_map backends.
+#include <cdcontainers/adapters/map.h>
+#include <cdcontainers/global.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define COUNT (1 << 21)
+#define LOOKUPS (1 << 21)
+#define RANGES (1 << 18)
+// The keys are 48-bit random numbers, so a range holds about 64 keys.
+#define RANGE_WIDTH (((size_t)1 << 48) / COUNT * 64)
+
+static int lt(const void *l, const void *r) { return l < r; }
+
+static double seconds(clock_t start)
+{
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+static size_t next_random(size_t *state)
+{
+  *state = *state * 6364136223846793005u + 1442695040888963407u;
+  return *state >> 16;
+}
+
+static bool sum_value(void *key, void *value, void *ctx)
+{
+  CDC_UNUSED(key);
+
+  *(size_t *)ctx += (size_t)value;
+  return true;
+}
+
+static int bench(const char *name, const struct cdc_map_table *table,
+                 void **keys)
+{
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  struct cdc_map *map = NULL;
+  struct cdc_map_iter it = CDC_INIT_STRUCT;
+  if (cdc_map_ctor(table, &map, &info) != CDC_STATUS_OK) {
+    return EXIT_FAILURE;
+  }
+
+  if (cdc_map_iter_ctor(map, &it) != CDC_STATUS_OK) {
+    cdc_map_dtor(map);
+    return EXIT_FAILURE;
+  }
+
+  clock_t start = clock();
+  for (size_t i = 0; i < COUNT; ++i) {
+    cdc_map_insert(map, keys[i], keys[i], NULL, NULL);
+  }
+
+  double insert_time = seconds(start);
+  size_t found = 0;
+  void *value = NULL;
+  start = clock();
+  for (size_t i = 0; i < LOOKUPS; ++i) {
+    found += cdc_map_get(map, keys[LOOKUPS - 1 - i], &value) == CDC_STATUS_OK;
+  }
+
+  double get_time = seconds(start);
+  size_t sum = 0;
+  start = clock();
+  for (cdc_map_begin(map, &it); cdc_map_iter_has_next(&it);
+       cdc_map_iter_next(&it)) {
+    sum += (size_t)cdc_map_iter_value(&it);
+  }
+
+  double scan_time = seconds(start);
+  start = clock();
+  for (size_t i = 0; i < RANGES; ++i) {
+    void *hi = (void *)((size_t)keys[i] + RANGE_WIDTH);
+    cdc_map_range(map, keys[i], hi, sum_value, &sum);
+  }
+
+  printf("%-6s insert: %.3f s, get: %.3f s (found %zu), scan: %.3f s, "
+         "range: %.3f s (%zx)\n",
+         name, insert_time, get_time, found, scan_time, seconds(start), sum);
+  cdc_map_iter_dtor(&it);
+  cdc_map_dtor(map);
+  return EXIT_SUCCESS;
+}
+
+int main()
+{
+  void **keys = (void **)malloc(COUNT * sizeof(void *));
+  if (!keys) {
+    return EXIT_FAILURE;
+  }
+
+  size_t state = 1;
+  for (size_t i = 0; i < COUNT; ++i) {
+    keys[i] = (void *)(next_random(&state) + 1);
+  }
+
+  printf("%d random keys, %d lookups, %d ranges\n", COUNT, LOOKUPS, RANGES);
+  int ret = bench("avl", cdc_map_avl, keys) ||
+            bench("splay", cdc_map_splay, keys) ||
+            bench("treap", cdc_map_treap, keys) ||
+            bench("bplus", cdc_map_bplus, keys);
+  free(keys);
+  return ret;
+}
@@ -0,0 +1,108 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+// Compares the union and the intersection of two treaps done by
+// cdc_treap_union/cdc_treap_intersection with the same operations done by
+// iteration and insertion.
+#include <cdcontainers/treap.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define COUNT (1 << 20)
+
+static int lt(const void *l, const void *r) { return l < r; }
+
+static double seconds(struct timespec *start)
+{
+  struct timespec now;
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (double)(now.tv_sec - start->tv_sec) +
+         (double)(now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+// Makes a treap with the keys i * step + 1 for i in [0, COUNT).
+static struct cdc_treap *make_treap(size_t step)
+{
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  struct cdc_treap *t = NULL;
+  if (cdc_treap_ctor(&t, &info) != CDC_STATUS_OK) {
+    exit(EXIT_FAILURE);
+  }
+
+  for (size_t i = 0; i < COUNT; ++i) {
+    void *key = (void *)(i * step + 1);
+    if (cdc_treap_insert(t, key, key, NULL) != CDC_STATUS_OK) {
+      exit(EXIT_FAILURE);
+    }
+  }
+
+  return t;
+}
+
+static void bench_insert_union()
+{
+  struct cdc_treap *a = make_treap(2);
+  struct cdc_treap *b = make_treap(3);
+  struct cdc_treap_iter it = CDC_INIT_STRUCT;
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (cdc_treap_begin(b, &it); cdc_treap_iter_has_next(&it);
+       cdc_treap_iter_next(&it)) {
+    cdc_treap_insert(a, cdc_treap_iter_key(&it), cdc_treap_iter_value(&it),
+                     NULL);
+  }
+
+  printf("insert union:       %.3f s (%zu)\n", seconds(&start),
+         cdc_treap_size(a));
+  cdc_treap_dtor(a);
+  cdc_treap_dtor(b);
+}
+
+static void bench_set_operation(const char *name, size_t threads,
+                                void (*op)(struct cdc_treap *,
+                                           struct cdc_treap *))
+{
+  struct cdc_treap *a = make_treap(2);
+  struct cdc_treap *b = make_treap(3);
+  cdc_treap_set_threads(a, threads);
+  struct timespec start;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  op(a, b);
+  printf("%-12s %zu thr: %.3f s (%zu)\n", name, threads, seconds(&start),
+         cdc_treap_size(a));
+  cdc_treap_dtor(a);
+  cdc_treap_dtor(b);
+}
+
+int main()
+{
+  printf("%d keys in each treap\n", COUNT);
+  bench_insert_union();
+  size_t threads[] = {1, 4};
+  for (size_t i = 0; i < CDC_ARRAY_SIZE(threads); ++i) {
+    bench_set_operation("union", threads[i], cdc_treap_union);
+    bench_set_operation("intersection", threads[i], cdc_treap_intersection);
+  }
+
+  return EXIT_SUCCESS;
+}
@@ -71,7 +71,8 @@ struct cdc_map_iter {
 /**
  * @brief Constructs an empty map.
  * @param[in] table - table of a map implementation. It can be cdc_map_avl,
- * cdc_map_splay, cdc_map_map, cdc_map_htable.
+ * cdc_map_splay, cdc_map_treap, cdc_map_bplus, cdc_map_htable,
+ * cdc_map_rhtable, cdc_map_swtable, cdc_map_cmtable.
  * @param[out] m - cdc_map
  * @param[in] info - cdc_data_info
  * @return CDC_STATUS_OK in a successful case or other value indicating
@@ -94,7 +95,8 @@ enum cdc_stat cdc_map_ctor(const struct cdc_map_table *table,
  * pointers on cdc_pair's(first - key, and the second - value).  The last item
  * must be CDC_END.
  * @param[in] table - table of a map implementation. It can be cdc_map_avl,
- * cdc_map_splay, cdc_map_map, cdc_map_htable.
+ * cdc_map_splay, cdc_map_treap, cdc_map_bplus, cdc_map_htable,
+ * cdc_map_rhtable, cdc_map_swtable, cdc_map_cmtable.
  * @param[out] m - cdc_map
  * @param[in] info - cdc_data_info
  * @return CDC_STATUS_OK in a successful case or other value indicating
@@ -119,7 +121,8 @@ enum cdc_stat cdc_map_ctorl(const struct cdc_map_table *table,
  * @brief Constructs a map, initialized by args. The last item must be
  * CDC_END.
  * @param[in] table - table of a map implementation. It can be cdc_map_avl,
- * cdc_map_splay, cdc_map_map, cdc_map_htable.
+ * cdc_map_splay, cdc_map_treap, cdc_map_bplus, cdc_map_htable,
+ * cdc_map_rhtable, cdc_map_swtable, cdc_map_cmtable.
  * @param[out] m - cdc_map
  * @param[in] info - cdc_data_info
  * @return CDC_STATUS_OK in a successful case or other value indicating
@@ -186,6 +189,62 @@ static inline void cdc_map_find(struct cdc_map *m, void *key,
 
   m->table->find(m->container, key, it->iter);
 }
+
+/**
+ * @brief Finds the first element with key not less than key. Only the tree
+ * tables (cdc_map_avl, cdc_map_splay, cdc_map_treap, cdc_map_bplus) support
+ * this function.
+ * @param[in] m - cdc_map
+ * @param[in] key - key value to compare the elements to
+ * @param[out] it - pointer will be recorded iterator to the first element with
+ * key not less than key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+static inline void cdc_map_lower_bound(struct cdc_map *m, void *key,
+                                       struct cdc_map_iter *it)
+{
+  assert(m != NULL);
+
+  m->table->lower_bound(m->container, key, it->iter);
+}
+
+/**
+ * @brief Finds the first element with key greater than key. Only the tree
+ * tables support this function.
+ * @param[in] m - cdc_map
+ * @param[in] key - key value to compare the elements to
+ * @param[out] it - pointer will be recorded iterator to the first element with
+ * key greater than key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+static inline void cdc_map_upper_bound(struct cdc_map *m, void *key,
+                                       struct cdc_map_iter *it)
+{
+  assert(m != NULL);
+
+  m->table->upper_bound(m->container, key, it->iter);
+}
+
+/**
+ * @brief Calls cb for the elements with keys in [lo, hi) in ascending key
+ * order. The iteration stops when cb returns false. The cost is O(log n + k),
+ * where k is the number of visited elements. Only the tree tables support
+ * this function.
+ * @param[in] m - cdc_map
+ * @param[in] lo - lower bound of the keys, inclusive
+ * @param[in] hi - upper bound of the keys, exclusive
+ * @param[in] cb - function that is called with the key, the value and ctx
+ * @param[in] ctx - user data passed to cb
+ */
+static inline void cdc_map_range(struct cdc_map *m, void *lo, void *hi,
+                                 bool (*cb)(void *key, void *value, void *ctx),
+                                 void *ctx)
+{
+  assert(m != NULL);
+  assert(cb != NULL);
+
+  m->table->range(m->container, lo, hi, cb, ctx);
+}
 /** @} */
 
 // Capacity
@@ -516,6 +575,9 @@ typedef struct cdc_map_iter map_iter_t;
 #define map_get(...) cdc_map_get(__VA_ARGS__)
 #define map_count(...) cdc_map_count(__VA_ARGS__)
 #define map_find(...) cdc_map_find(__VA_ARGS__)
+#define map_lower_bound(...) cdc_map_lower_bound(__VA_ARGS__)
+#define map_upper_bound(...) cdc_map_upper_bound(__VA_ARGS__)
+#define map_range(...) cdc_map_range(__VA_ARGS__)
 
 // Capacity
 #define map_size(...) cdc_map_size(__VA_ARGS__)
@@ -27,6 +27,7 @@
 #define CDCONTAINERS_INCLUDE_CDCONTAINERS_avl_tree_H
 
 #include <cdcontainers/common.h>
+#include <cdcontainers/node-pool.h>
 #include <cdcontainers/status.h>
 
 #include <assert.h>
@@ -39,7 +40,8 @@
  * @{
  */
 /**
- * @brief The cdc_avl_tree_node is service struct.
+ * @brief The cdc_avl_tree_node is service struct. The size is the number of
+ * nodes in the subtree of the node.
  * @warning To avoid problems, do not change the structure fields in the code.
  * Use only special functions to access and change structure fields.
  */
@@ -49,6 +51,7 @@ struct cdc_avl_tree_node {
   struct cdc_avl_tree_node *right;
   void *key;
   void *value;
+  size_t size;
   unsigned char height;
 };
 
@@ -61,6 +64,7 @@ struct cdc_avl_tree {
   struct cdc_avl_tree_node *root;
   size_t size;
   struct cdc_data_info *dinfo;
+  struct cdc_node_pool pool;
 };
 
 /**
@@ -91,6 +95,9 @@ struct cdc_pair_avl_tree_iter_bool {
  */
 /**
  * @brief Constructs an empty avl tree.
+ *
+ * If info->pool_chunk is not 0, the nodes of the tree are allocated from a
+ * node pool and are released by chunks on clear and destruction.
  * @param[out] t - cdc_avl_tree
  * @param[in] info - cdc_data_info
  * @return CDC_STATUS_OK in a successful case or other value indicating
@@ -175,6 +182,61 @@ size_t cdc_avl_tree_count(struct cdc_avl_tree *t, void *key);
  */
 void cdc_avl_tree_find(struct cdc_avl_tree *t, void *key,
                        struct cdc_avl_tree_iter *it);
+
+/**
+ * @brief Finds the first element with key not less than key in O(log n).
+ * @param[in] t - cdc_avl_tree
+ * @param[in] key - key value to compare the elements to
+ * @param[out] it - pointer will be recorded iterator to the first element with
+ * key not less than key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_avl_tree_lower_bound(struct cdc_avl_tree *t, void *key,
+                              struct cdc_avl_tree_iter *it);
+
+/**
+ * @brief Finds the first element with key greater than key in O(log n).
+ * @param[in] t - cdc_avl_tree
+ * @param[in] key - key value to compare the elements to
+ * @param[out] it - pointer will be recorded iterator to the first element with
+ * key greater than key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_avl_tree_upper_bound(struct cdc_avl_tree *t, void *key,
+                              struct cdc_avl_tree_iter *it);
+
+/**
+ * @brief Returns a range containing all elements with key equivalent to key.
+ * Since this container does not allow duplicates, the range contains at most
+ * one element.
+ * @param[in] t - cdc_avl_tree
+ * @param[in] key - key value to compare the elements to
+ * @param[out] ret - pair of iterators: the first is the lower bound of key and
+ * the second is the upper bound of key. If there is no such element, both
+ * iterators point to the first element with key greater than key.
+ */
+void cdc_avl_tree_equal_range(struct cdc_avl_tree *t, void *key,
+                              struct cdc_pair_avl_tree_iter *ret);
+
+/**
+ * @brief Returns the number of elements with keys less than key in O(log n).
+ * If the key exists, it is the position of the element in the sorted order.
+ * @param[in] t - cdc_avl_tree
+ * @param[in] key - key value
+ * @return the number of elements with keys less than key.
+ */
+size_t cdc_avl_tree_rank(struct cdc_avl_tree *t, void *key);
+
+/**
+ * @brief Finds the element at the position index in the sorted order in
+ * O(log n).
+ * @param[in] t - cdc_avl_tree
+ * @param[in] index - position of the element, starting from 0
+ * @param[out] it - pointer will be recorded iterator to the element. If index
+ * is not less than the size of the tree, past-the-end iterator is returned.
+ */
+void cdc_avl_tree_select(struct cdc_avl_tree *t, size_t index,
+                         struct cdc_avl_tree_iter *it);
 /** @} */
 
 // Capacity
@@ -441,6 +503,11 @@ typedef struct cdc_pair_avl_tree_iter_bool pair_avl_tree_iter_bool_t;
 #define avl_tree_get(...) cdc_avl_tree_get(__VA_ARGS__)
 #define avl_tree_count(...) cdc_avl_tree_count(__VA_ARGS__)
 #define avl_tree_find(...) cdc_avl_tree_find(__VA_ARGS__)
+#define avl_tree_lower_bound(...) cdc_avl_tree_lower_bound(__VA_ARGS__)
+#define avl_tree_upper_bound(...) cdc_avl_tree_upper_bound(__VA_ARGS__)
+#define avl_tree_equal_range(...) cdc_avl_tree_equal_range(__VA_ARGS__)
+#define avl_tree_rank(...) cdc_avl_tree_rank(__VA_ARGS__)
+#define avl_tree_select(...) cdc_avl_tree_select(__VA_ARGS__)
 
 // Capacity
 #define avl_tree_size(...) cdc_avl_tree_size(__VA_ARGS__)
@@ -0,0 +1,587 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+/**
+ * @file
+ * @author Maksim Andrianov <maksimandrianov1@yandex.ru>
+ * @brief The cdc_bplus_tree is a struct and functions that provide a B+ tree.
+ */
+#ifndef CDCONTAINERS_INCLUDE_CDCONTAINERS_BPLUS_TREE_H
+#define CDCONTAINERS_INCLUDE_CDCONTAINERS_BPLUS_TREE_H
+
+#include <cdcontainers/common.h>
+#include <cdcontainers/node-pool.h>
+#include <cdcontainers/status.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdbool.h>
+
+/**
+ * @defgroup cdc_bplus_tree
+ * @brief The cdc_bplus_tree is a struct and functions that provide a B+ tree.
+ *
+ * Keys are kept in wide nodes with up to CDC_BPLUS_TREE_ORDER keys, so a
+ * lookup touches a few nodes instead of one node per level of a binary tree.
+ * All key-value pairs live in the leaves, which are linked into a list, so an
+ * ordered scan walks arrays of keys and values. Any insertion or removal
+ * invalidates all iterators.
+ * @{
+ */
+/**
+ * @brief The maximum number of keys in a node. The keys of a node take four
+ * cache lines on 64-bit platforms.
+ */
+#define CDC_BPLUS_TREE_ORDER 32
+
+/**
+ * @brief The cdc_bplus_tree_node is service struct. It is the common head of
+ * leaves and inner nodes.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_bplus_tree_node {
+  unsigned size;
+  bool is_leaf;
+  void *keys[CDC_BPLUS_TREE_ORDER];
+};
+
+/**
+ * @brief The cdc_bplus_tree_leaf is service struct.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_bplus_tree_leaf {
+  struct cdc_bplus_tree_node base;
+  struct cdc_bplus_tree_leaf *prev;
+  struct cdc_bplus_tree_leaf *next;
+  void *values[CDC_BPLUS_TREE_ORDER];
+};
+
+/**
+ * @brief The cdc_bplus_tree_inner is service struct. The key i is the
+ * smallest key of the subtree children[i + 1].
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_bplus_tree_inner {
+  struct cdc_bplus_tree_node base;
+  struct cdc_bplus_tree_node *children[CDC_BPLUS_TREE_ORDER + 1];
+};
+
+/**
+ * @brief The cdc_bplus_tree is service struct.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_bplus_tree {
+  struct cdc_bplus_tree_node *root;
+  struct cdc_bplus_tree_leaf *head;
+  struct cdc_bplus_tree_leaf *tail;
+  size_t size;
+  size_t height;
+  struct cdc_data_info *dinfo;
+  struct cdc_node_pool leaf_pool;
+  struct cdc_node_pool inner_pool;
+};
+
+/**
+ * @brief The cdc_bplus_tree_iter is service struct. The past-the-end iterator
+ * has leaf equal to NULL.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_bplus_tree_iter {
+  struct cdc_bplus_tree *container;
+  struct cdc_bplus_tree_leaf *leaf;
+  size_t pos;
+};
+
+struct cdc_pair_bplus_tree_iter {
+  struct cdc_bplus_tree_iter first;
+  struct cdc_bplus_tree_iter second;
+};
+
+struct cdc_pair_bplus_tree_iter_bool {
+  struct cdc_bplus_tree_iter first;
+  bool second;
+};
+
+// Base
+/**
+ * @defgroup cdc_bplus_tree_base Base
+ * @{
+ */
+/**
+ * @brief Constructs an empty B+ tree.
+ *
+ * If info->pool_chunk is not 0, the nodes of the tree are allocated from node
+ * pools and are released by chunks on clear and destruction.
+ * @param[out] t - cdc_bplus_tree
+ * @param[in] info - cdc_data_info
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_bplus_tree_ctor(struct cdc_bplus_tree **t,
+                                  struct cdc_data_info *info);
+
+/**
+ * @brief Constructs a B+ tree, initialized by an variable number of
+ * pointers on cdc_pair's(first - key, and the second - value).  The last item
+ * must be CDC_END.
+ * @param[out] t - cdc_bplus_tree
+ * @param[in] info - cdc_data_info
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ *
+ * Example:
+ * @code{.c}
+ * struct cdc_bplus_tree *tree = NULL;
+ * cdc_pair value1 = {CDC_FROM_INT(1), CDC_FROM_INT(2)};
+ * cdc_pair value2 = {CDC_FROM_INT(3), CDC_FROM_INT(4)};
+ * ...
+ * if (cdc_bplus_tree_ctorl(&tree, info, &value1, &value2, CDC_END) != CDC_STATUS_OK) {
+ *   // handle error
+ * }
+ * @endcode
+ */
+enum cdc_stat cdc_bplus_tree_ctorl(struct cdc_bplus_tree **t,
+                                   struct cdc_data_info *info, ...);
+
+/**
+ * @brief Constructs a B+ tree, initialized by args. The last item must be
+ * CDC_END.
+ * @param[out] t - cdc_bplus_tree
+ * @param[in] info - cdc_data_info
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_bplus_tree_ctorv(struct cdc_bplus_tree **t,
+                                   struct cdc_data_info *info, va_list args);
+
+/**
+ * @brief Destroys the B+ tree.
+ * @param[in] t - cdc_bplus_tree
+ */
+void cdc_bplus_tree_dtor(struct cdc_bplus_tree *t);
+/** @} */
+
+// Lookup
+/**
+ * @defgroup cdc_bplus_tree_lookup Lookup
+ * @{
+ */
+/**
+ * @brief Returns a value that is mapped to a key. If the key does
+ * not exist, then NULL will return.
+ * @param[in] t - cdc_bplus_tree
+ * @param[in] key - key of the element to find
+ * @param[out] value - pinter to the value that is mapped to a key.
+ * @return CDC_STATUS_OK if the key is found, CDC_STATUS_NOT_FOUND otherwise.
+ */
+enum cdc_stat cdc_bplus_tree_get(struct cdc_bplus_tree *t, void *key,
+                                 void **value);
+
+/**
+ * @brief Returns the number of elements with key that compares equal to the
+ * specified argument key, which is either 1 or 0 since this container does not
+ * allow duplicates.
+ * @param[in] t - cdc_bplus_tree
+ * @param[in] key - key value of the elements to count
+ * @return number of elements with key key, that is either 1 or 0.
+ */
+size_t cdc_bplus_tree_count(struct cdc_bplus_tree *t, void *key);
+
+/**
+ * @brief Finds an element with key equivalent to key.
+ * @param[in] t - cdc_bplus_tree
+ * @param[in] key - key value of the element to search for
+ * @param[out] it - pointer will be recorded iterator to an element with key
+ * equivalent to key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_bplus_tree_find(struct cdc_bplus_tree *t, void *key,
+                         struct cdc_bplus_tree_iter *it);
+
+/**
+ * @brief Finds the first element with key not less than key in O(log n).
+ * @param[in] t - cdc_bplus_tree
+ * @param[in] key - key value to compare the elements to
+ * @param[out] it - pointer will be recorded iterator to the first element with
+ * key not less than key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_bplus_tree_lower_bound(struct cdc_bplus_tree *t, void *key,
+                                struct cdc_bplus_tree_iter *it);
+
+/**
+ * @brief Finds the first element with key greater than key in O(log n).
+ * @param[in] t - cdc_bplus_tree
+ * @param[in] key - key value to compare the elements to
+ * @param[out] it - pointer will be recorded iterator to the first element with
+ * key greater than key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_bplus_tree_upper_bound(struct cdc_bplus_tree *t, void *key,
+                                struct cdc_bplus_tree_iter *it);
+
+/**
+ * @brief Returns a range containing all elements with key equivalent to key.
+ * Since this container does not allow duplicates, the range contains at most
+ * one element.
+ * @param[in] t - cdc_bplus_tree
+ * @param[in] key - key value to compare the elements to
+ * @param[out] ret - pair of iterators: the first is the lower bound of key and
+ * the second is the upper bound of key. If there is no such element, both
+ * iterators point to the first element with key greater than key.
+ */
+void cdc_bplus_tree_equal_range(struct cdc_bplus_tree *t, void *key,
+                                struct cdc_pair_bplus_tree_iter *ret);
+/** @} */
+
+// Capacity
+/**
+ * @defgroup cdc_bplus_tree_capacity Capacity
+ * @{
+ */
+/**
+ * @brief Returns the number of items in the bplus_tree.
+ * @param[in] t - cdc_bplus_tree
+ * @return the number of items in the bplus_tree.
+ */
+static inline size_t cdc_bplus_tree_size(struct cdc_bplus_tree *t)
+{
+  assert(t != NULL);
+
+  return t->size;
+}
+
+/**
+ * @brief Checks if the B+ tree has no elements.
+ * @param[in] t - cdc_bplus_tree
+ * @return true if the B+ tree is empty, false otherwise.
+ */
+static inline bool cdc_bplus_tree_empty(struct cdc_bplus_tree *t)
+{
+  assert(t != NULL);
+
+  return t->size == 0;
+}
+/** @} */
+
+// Modifiers
+/**
+ * @defgroup cdc_bplus_tree_modifiers Modifiers
+ * @{
+ */
+/**
+ * @brief Removes all the elements from the bplus_tree.
+ * @param[in] t - cdc_bplus_tree
+ */
+void cdc_bplus_tree_clear(struct cdc_bplus_tree *t);
+
+/**
+ * @brief Inserts an element into the container, if the container doesn't already
+ * contain an element with an equivalent key.
+ * @param[in] t - cdc_bplus_tree
+ * @param[in] key - key of the element
+ * @param[in] value - value of the element
+ * @param[out] ret - pair consisting of an iterator to the inserted element (or to
+ * the element that prevented the insertion) and a bool denoting whether the
+ * insertion took place. The pointer can be equal to NULL.
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_bplus_tree_insert(struct cdc_bplus_tree *t, void *key,
+                                    void *value,
+                                    struct cdc_pair_bplus_tree_iter_bool *ret);
+
+/**
+ * @brief Inserts an element into the container, if the container doesn't already
+ * contain an element with an equivalent key.
+ * @param[in] t - cdc_bplus_tree
+ * @param[in] key - key of the element
+ * @param[in] value - value of the element
+ * @param[out] it - iterator to the inserted element (or to the element that
+ * prevented the insertion). The pointer can be equal to NULL.
+ * @param[out] inserted - bool denoting whether the insertion
+ * took place. The pointer can be equal to NULL.
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_bplus_tree_insert1(struct cdc_bplus_tree *t, void *key,
+                                     void *value,
+                                     struct cdc_bplus_tree_iter *it,
+                                     bool *inserted);
+
+/**
+ * @brief Inserts an element or assigns to the current element if the key
+ * already exists.
+ * @param[in] t - cdc_bplus_tree
+ * @param[in] key - key of the element
+ * @param[in] value - value of the element
+ * @param[out] ret - pair. The bool component is true if the insertion took place and
+ * false if the assignment took place. The iterator component is pointing at the
+ * element that was inserted or updated.
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_bplus_tree_insert_or_assign(
+    struct cdc_bplus_tree *t, void *key, void *value,
+    struct cdc_pair_bplus_tree_iter_bool *ret);
+
+/**
+ * @brief Inserts an element or assigns to the current element if the key
+ * already exists.
+ * @param[in] t - cdc_bplus_tree
+ * @param[in] key - key of the element
+ * @param[in] value - value of the element
+ * @param[out] it - iterator is pointing at the element that was inserted or updated.
+ * The pointer can be equal to NULL
+ * @param[out] inserted - bool is true if the insertion took place and false if the
+ * assignment took place. The pointer can be equal to NULL
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_bplus_tree_insert_or_assign1(struct cdc_bplus_tree *t,
+                                               void *key, void *value,
+                                               struct cdc_bplus_tree_iter *it,
+                                               bool *inserted);
+
+/**
+ * @brief Removes the element (if one exists) with the key equivalent to key.
+ * @param[in] t - cdc_bplus_tree
+ * @param[in] key - key value of the elements to remove
+ * @return number of elements removed.
+ */
+size_t cdc_bplus_tree_erase(struct cdc_bplus_tree *t, void *key);
+
+/**
+ * @brief Swaps bplus_trees a and b. This operation is very fast and never fails.
+ * @param[in, out] a - cdc_bplus_tree
+ * @param[in, out] b - cdc_bplus_tree
+ */
+void cdc_bplus_tree_swap(struct cdc_bplus_tree *a, struct cdc_bplus_tree *b);
+/** @} */
+
+// Iterators
+/**
+ * @defgroup cdc_bplus_tree_iterators Iterators
+ * @{
+ */
+/**
+ * @brief Initializes the iterator to the beginning.
+ * @param[in] t - cdc_bplus_tree
+ * @param[out] it - cdc_bplus_tree_iter
+ */
+void cdc_bplus_tree_begin(struct cdc_bplus_tree *t,
+                          struct cdc_bplus_tree_iter *it);
+
+/**
+ * @brief Initializes the iterator to the end.
+ * @param[in] t - cdc_bplus_tree
+ * @param[out] it - cdc_bplus_tree_iter
+ */
+void cdc_bplus_tree_end(struct cdc_bplus_tree *t,
+                        struct cdc_bplus_tree_iter *it);
+/** @} */
+
+// Iterators
+/**
+ * @defgroup cdc_bplus_tree_iter
+ * @brief The cdc_bplus_tree_iter is a struct and functions that provide a B+ tree iterator.
+ * @{
+ */
+/**
+ * @brief Advances the iterator to the next element in the B+ tree.
+ * @param[in] it - iterator
+ */
+static inline void cdc_bplus_tree_iter_next(struct cdc_bplus_tree_iter *it)
+{
+  assert(it != NULL);
+
+  if (++it->pos == it->leaf->base.size) {
+    it->leaf = it->leaf->next;
+    it->pos = 0;
+  }
+}
+
+/**
+ * @brief Advances the iterator to the previous element in the B+ tree.
+ * @param[in] it - iterator
+ */
+static inline void cdc_bplus_tree_iter_prev(struct cdc_bplus_tree_iter *it)
+{
+  assert(it != NULL);
+
+  if (!it->leaf) {
+    it->leaf = it->container->tail;
+    it->pos = it->leaf->base.size - 1;
+  } else if (it->pos == 0) {
+    it->leaf = it->leaf->prev;
+    it->pos = it->leaf->base.size - 1;
+  } else {
+    --it->pos;
+  }
+}
+
+/**
+ * @brief Returns true if there is at least one element ahead of the iterator, i.e.
+ * the iterator is not at the back of the container; otherwise returns false.
+ * @param[in] it - iterator
+ * @return true if there is at least one element ahead of the iterator, i.e.
+ * the iterator is not at the back of the container; otherwise returns false.
+ */
+static inline bool cdc_bplus_tree_iter_has_next(struct cdc_bplus_tree_iter *it)
+{
+  assert(it != NULL);
+
+  return it->leaf != NULL;
+}
+
+/**
+ * @brief Returns true if there is at least one element behind the iterator, i.e.
+ * the iterator is not at the front of the container; otherwise returns false.
+ * @param[in] it - iterator
+ * @return true if there is at least one element behind the iterator, i.e.
+ * the iterator is not at the front of the container; otherwise returns false.
+ */
+static inline bool cdc_bplus_tree_iter_has_prev(struct cdc_bplus_tree_iter *it)
+{
+  assert(it != NULL);
+
+  if (!it->leaf) {
+    return it->container->size != 0;
+  }
+
+  return it->pos != 0 || it->leaf->prev != NULL;
+}
+
+/**
+ * @brief Returns an item's key.
+ * @param[in] it - iterator
+ * @return the item's key.
+ */
+static inline void *cdc_bplus_tree_iter_key(struct cdc_bplus_tree_iter *it)
+{
+  assert(it != NULL);
+
+  return it->leaf->base.keys[it->pos];
+}
+
+/**
+ * @brief Returns an item's value.
+ * @param[in] it - iterator
+ * @return the item's value.
+ */
+static inline void *cdc_bplus_tree_iter_value(struct cdc_bplus_tree_iter *it)
+{
+  assert(it != NULL);
+
+  return it->leaf->values[it->pos];
+}
+
+/**
+ * @brief Returns a pair, where first - key, second - value.
+ * @param[in] it - iterator
+ * @return pair, where first - key, second - value.
+ */
+static inline struct cdc_pair cdc_bplus_tree_iter_key_value(
+    struct cdc_bplus_tree_iter *it)
+{
+  assert(it != NULL);
+
+  struct cdc_pair pair = {it->leaf->base.keys[it->pos],
+                          it->leaf->values[it->pos]};
+  return pair;
+}
+
+/**
+ * @brief Returns true if the iterator |it1| equal to the iterator |it2|,
+ * otherwise returns false.
+ * @param[in] it1 - iterator
+ * @param[in] it2 - iterator
+ * @return true if the iterator |it1| equal to the iterator |it2|,
+ * otherwise returns false.
+ */
+static inline bool cdc_bplus_tree_iter_is_eq(struct cdc_bplus_tree_iter *it1,
+                                             struct cdc_bplus_tree_iter *it2)
+{
+  assert(it1 != NULL);
+  assert(it2 != NULL);
+
+  return it1->container == it2->container && it1->leaf == it2->leaf &&
+         it1->pos == it2->pos;
+}
+/** @} */
+
+// Short names
+#ifdef CDC_USE_SHORT_NAMES
+typedef struct cdc_bplus_tree bplus_tree_t;
+typedef struct cdc_bplus_tree_iter bplus_tree_iter_t;
+typedef struct cdc_pair_bplus_tree_iter pair_bplus_tree_iter_t;
+typedef struct cdc_pair_bplus_tree_iter_bool pair_bplus_tree_iter_bool_t;
+
+// Base
+#define bplus_tree_ctor(...) cdc_bplus_tree_ctor(__VA_ARGS__)
+#define bplus_tree_ctorv(...) cdc_bplus_tree_ctorv(__VA_ARGS__)
+#define bplus_tree_ctorl(...) cdc_bplus_tree_ctorl(__VA_ARGS__)
+#define bplus_tree_dtor(...) cdc_bplus_tree_dtor(__VA_ARGS__)
+
+// Lookup
+#define bplus_tree_get(...) cdc_bplus_tree_get(__VA_ARGS__)
+#define bplus_tree_count(...) cdc_bplus_tree_count(__VA_ARGS__)
+#define bplus_tree_find(...) cdc_bplus_tree_find(__VA_ARGS__)
+#define bplus_tree_lower_bound(...) cdc_bplus_tree_lower_bound(__VA_ARGS__)
+#define bplus_tree_upper_bound(...) cdc_bplus_tree_upper_bound(__VA_ARGS__)
+#define bplus_tree_equal_range(...) cdc_bplus_tree_equal_range(__VA_ARGS__)
+
+// Capacity
+#define bplus_tree_size(...) cdc_bplus_tree_size(__VA_ARGS__)
+#define bplus_tree_empty(...) cdc_bplus_tree_empty(__VA_ARGS__)
+
+// Modifiers
+#define bplus_tree_clear(...) cdc_bplus_tree_clear(__VA_ARGS__)
+#define bplus_tree_insert(...) cdc_bplus_tree_insert(__VA_ARGS__)
+#define bplus_tree_insert1(...) cdc_bplus_tree_insert1(__VA_ARGS__)
+#define bplus_tree_insert_or_assign(...) \
+  cdc_bplus_tree_insert_or_assign(__VA_ARGS__)
+#define bplus_tree_insert_or_assign1(...) \
+  cdc_bplus_tree_insert_or_assign1(__VA_ARGS__)
+#define bplus_tree_erase(...) cdc_bplus_tree_erase(__VA_ARGS__)
+#define bplus_tree_swap(...) cdc_bplus_tree_swap(__VA_ARGS__)
+
+// Iterators
+#define bplus_tree_begin(...) cdc_bplus_tree_begin(__VA_ARGS__)
+#define bplus_tree_end(...) cdc_bplus_tree_end(__VA_ARGS__)
+
+// Iterators
+#define bplus_tree_iter_next(...) cdc_bplus_tree_iter_next(__VA_ARGS__)
+#define bplus_tree_iter_prev(...) cdc_bplus_tree_iter_prev(__VA_ARGS__)
+#define bplus_tree_iter_has_next(...) cdc_bplus_tree_iter_has_next(__VA_ARGS__)
+#define bplus_tree_iter_has_prev(...) cdc_bplus_tree_iter_has_prev(__VA_ARGS__)
+#define bplus_tree_iter_key(...) cdc_bplus_tree_iter_key(__VA_ARGS__)
+#define bplus_tree_iter_value(...) cdc_bplus_tree_iter_value(__VA_ARGS__)
+#define bplus_tree_iter_key_value(...) \
+  cdc_bplus_tree_iter_key_value(__VA_ARGS__)
+#define bplus_tree_iter_is_eq(...) cdc_bplus_tree_iter_is_eq(__VA_ARGS__)
+#endif
+/** @} */
+#endif  // CDCONTAINERS_INCLUDE_CDCONTAINERS_BPLUS_TREE_H
@@ -32,9 +32,24 @@
  *   - cdc_pairing_heap - pairing heap. See pairing-heap.h.
  *   - cdc_hash_table - hash table with collisions resolved by chaining. See
  * hash-table.h.
+ *   - cdc_rh_table - hash table with open addressing and Robin Hood hashing.
+ * See rh-table.h.
+ *   - cdc_swiss_table - hash table with open addressing and SIMD group
+ * probing. See swiss-table.h.
+ *   - cdc_compact_table - chained hash table with entries in one array and
+ * 32-bit indices. See compact-table.h.
+ *   - cdc_concurrent_map - hash map for several threads with per-segment
+ * locks. See concurrent-map.h.
+ *   - cdc_hash_set - hash set with open addressing and set operations. See
+ * hash-set.h.
+ *   - cdc_frozen_map - immutable map with a minimal perfect hash function.
+ * See frozen-map.h.
+ *   - cdc_hash_snapshot - read-only hash table mapped from a file written
+ * from a cdc_hash_table. See hash-snapshot.h.
  *   - cdc_avl_tree - avl tree. See avl-tree.h.
  *   - cdc_splay_tree - splay tree. See splay-tree.h.
  *   - cdc_treap - сartesian tree. See treap.h.
+ *   - cdc_bplus_tree - B+ tree with linked leaves. See bplus-tree.h.
  *
  * and following adapters:
  *   - cdc_deque (Can work with: cdc_array, cdc_list, cdc_circular_array). See
@@ -45,8 +60,9 @@
  * queue.h.
  *   - cdc_priority_queue (Can work with: cdc_heap, cdc_binomial_heap,
  * cdc_pairing_heap). See priority-queue.h.
- *   - cdc_map (Can work with: cdc_avl_tree, cdc_splay_tree, cdc_treap). See
- * map.h.
+ *   - cdc_map (Can work with: cdc_avl_tree, cdc_splay_tree, cdc_treap,
+ * cdc_bplus_tree, cdc_hash_table, cdc_rh_table, cdc_swiss_table,
+ * cdc_compact_table). See map.h.
  *
  *  Example usage array:
  *  @include array.c
@@ -64,17 +80,25 @@
 #include <cdcontainers/array.h>
 #include <cdcontainers/avl-tree.h>
 #include <cdcontainers/binomial-heap.h>
+#include <cdcontainers/bplus-tree.h>
 #include <cdcontainers/casts.h>
 #include <cdcontainers/circular-array.h>
 #include <cdcontainers/common.h>
+#include <cdcontainers/compact-table.h>
+#include <cdcontainers/concurrent-map.h>
+#include <cdcontainers/frozen-map.h>
 #include <cdcontainers/global.h>
+#include <cdcontainers/hash-set.h>
+#include <cdcontainers/hash-snapshot.h>
 #include <cdcontainers/hash-table.h>
 #include <cdcontainers/hash.h>
 #include <cdcontainers/heap.h>
 #include <cdcontainers/list.h>
 #include <cdcontainers/pairing-heap.h>
+#include <cdcontainers/rh-table.h>
 #include <cdcontainers/splay-tree.h>
 #include <cdcontainers/status.h>
+#include <cdcontainers/swiss-table.h>
 #include <cdcontainers/treap.h>
 
 #endif  // CDCONTAINERS_INCLUDE_CDCONTAINERS_CDC_H
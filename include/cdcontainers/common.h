@@ -52,16 +52,60 @@
 #define CDC_STATIC_ASSERT(COND, MSG) \
   typedef char cdc_static_assertion_##MSG[(COND) ? 1 : -1]
 
+#if defined(__GNUC__) || defined(__clang__)
+#define CDC_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define CDC_PREFETCH(addr) ((void)(addr))
+#endif
+
 typedef void (*cdc_free_fn_t)(void *);
 typedef int (*cdc_unary_pred_fn_t)(const void *);
 typedef int (*cdc_binary_pred_fn_t)(const void *, const void *);
+typedef int (*cdc_cmp3_fn_t)(const void *, const void *);
 typedef void (*cdc_copy_fn_t)(void *, const void *);
+typedef void *(*cdc_alloc_fn_t)(size_t size, void *ctx);
+typedef void *(*cdc_realloc_fn_t)(void *ptr, size_t size, void *ctx);
+typedef void (*cdc_dealloc_fn_t)(void *ptr, void *ctx);
 
 struct cdc_pair {
   void *first;
   void *second;
 };
 
+/**
+ * @brief The cdc_allocator struct describes a memory allocator.
+ *
+ * All callbacks receive ctx as the last argument. If allocate is NULL, the
+ * standard malloc, realloc and free are used. The allocator is used for the
+ * container storage (nodes, buffers, buckets), containers that exchange nodes
+ * (splice, merge) must use the same allocator.
+ */
+struct cdc_allocator {
+  /**
+   * @brief allocate - callback that allocates size bytes.
+   *
+   * Must return NULL if the memory cannot be allocated.
+   */
+  cdc_alloc_fn_t allocate;
+  /**
+   * @brief reallocate - callback that resizes a block allocated by allocate.
+   *
+   * It can be NULL, in this case a new block is allocated and the data is
+   * copied.
+   */
+  cdc_realloc_fn_t reallocate;
+  /**
+   * @brief deallocate - callback that frees a block allocated by allocate.
+   *
+   * Must be set if allocate is set.
+   */
+  cdc_dealloc_fn_t deallocate;
+  /**
+   * @brief ctx - opaque pointer that is passed to all callbacks.
+   */
+  void *ctx;
+};
+
 /**
  * @brief The cdc_data_info struct used to initialize contaners.
  *
@@ -93,6 +137,31 @@ struct cdc_data_info {
   cdc_hash_fn_t hash;
   cdc_copy_fn_t cp;
   size_t size;
+  /**
+   * @brief allocator - memory allocator for container items.
+   *
+   * It is used for nodes, buckets and buffers of the container. Containers
+   * that exchange nodes (splice, merge) must use the same allocator.
+   */
+  struct cdc_allocator allocator;
+  /**
+   * @brief pool_chunk - number of nodes in one chunk of the node pool.
+   *
+   * If this value is not 0, node-based containers that support it carve their
+   * nodes from chunks of pool_chunk nodes and release the chunks at once on
+   * clear and destruction. If 0, nodes are allocated one by one.
+   */
+  size_t pool_chunk;
+  /**
+   * @brief cmp3 - three-way comparison callback.
+   *
+   * Returns a negative value, zero or a positive value if the first argument
+   * is less than, equal to or greater than the second, like strcmp. If it is
+   * not NULL, ordered containers use it instead of cmp and can be created
+   * without cmp. A lookup in a tree then calls it once per level instead of
+   * two or three calls of cmp.
+   */
+  cdc_cmp3_fn_t cmp3;
   /**
    * @brief __cnt
    *
@@ -125,6 +194,7 @@ enum cdc_iterator_type {
 #ifdef CDC_USE_SHORT_NAMES
 typedef struct cdc_pair pair_t;
 typedef struct cdc_data_info data_info_t;
+typedef struct cdc_allocator allocator_t;
 #endif
 
 #endif  // CDCONTAINERS_INCLUDE_CDCONTAINERS_COMMON_H
@@ -0,0 +1,238 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+/**
+ * @file
+ * @author Maksim Andrianov <maksimandrianov1@yandex.ru>
+ * @brief The cdc_concurrent_map is a struct and functions that provide a hash
+ * map that can be used from several threads at once.
+ */
+#ifndef CDCONTAINERS_INCLUDE_CDCONTAINERS_CONCURRENT_MAP_H
+#define CDCONTAINERS_INCLUDE_CDCONTAINERS_CONCURRENT_MAP_H
+
+#include <cdcontainers/common.h>
+#include <cdcontainers/hash-table.h>
+#include <cdcontainers/status.h>
+
+#include <assert.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * @defgroup cdc_concurrent_map
+ * @brief The cdc_concurrent_map is a struct and functions that provide a hash
+ * map that can be used from several threads at once.
+ *
+ * Keys are spread over segments by the high bits of their hash. Each segment
+ * is a cdc_hash_table guarded by its own read-write lock, so readers never
+ * block each other and writers block only the operations on the same segment.
+ * The key hash is computed once, outside of the lock. There are no iterators,
+ * because they cannot stay valid while other threads modify the map.
+ *
+ * A value returned by cdc_concurrent_map_get is not protected after the call.
+ * If dfree is set, another thread can free it by erasing the key.
+ * @{
+ */
+/**
+ * @brief The cdc_concurrent_map_segment is service struct.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_concurrent_map_segment {
+  pthread_rwlock_t lock;
+  struct cdc_hash_table *table;
+};
+
+/**
+ * @brief The cdc_concurrent_map is service struct.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_concurrent_map {
+  struct cdc_concurrent_map_segment *segments;
+  size_t segment_count;
+  unsigned segment_shift;
+  struct cdc_data_info *dinfo;
+};
+
+// Base
+/**
+ * @defgroup cdc_concurrent_map_base Base
+ * @{
+ */
+/**
+ * @brief Constructs an empty concurrent map with 64 segments.
+ * @param[out] m - cdc_concurrent_map
+ * @param[in] info - cdc_data_info
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_concurrent_map_ctor(struct cdc_concurrent_map **m,
+                                      struct cdc_data_info *info);
+
+/**
+ * @brief Constructs an empty concurrent map.
+ * @param[out] m - cdc_concurrent_map
+ * @param[in] info - cdc_data_info
+ * @param[in] concurrency - expected number of threads that modify the map at
+ * once. The number of segments is a power of two not less than 4 *
+ * concurrency.
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_concurrent_map_ctor1(struct cdc_concurrent_map **m,
+                                       struct cdc_data_info *info,
+                                       size_t concurrency);
+
+/**
+ * @brief Destroys the concurrent map. No other thread may use the map.
+ * @param[in] m - cdc_concurrent_map
+ */
+void cdc_concurrent_map_dtor(struct cdc_concurrent_map *m);
+/** @} */
+
+// Lookup
+/**
+ * @defgroup cdc_concurrent_map_lookup Lookup
+ * @{
+ */
+/**
+ * @brief Returns a value that is mapped to a key.
+ * @param[in] m - cdc_concurrent_map
+ * @param[in] key - key of the element to find
+ * @param[out] value - pinter to the value that is mapped to a key.
+ * @return CDC_STATUS_OK if the key is found, CDC_STATUS_NOT_FOUND otherwise.
+ */
+enum cdc_stat cdc_concurrent_map_get(struct cdc_concurrent_map *m, void *key,
+                                     void **value);
+
+/**
+ * @brief Returns the number of elements with key that compares equal to the
+ * specified argument key, which is either 1 or 0.
+ * @param[in] m - cdc_concurrent_map
+ * @param[in] key - key value of the elements to count
+ * @return number of elements with key key, that is either 1 or 0.
+ */
+size_t cdc_concurrent_map_count(struct cdc_concurrent_map *m, void *key);
+/** @} */
+
+// Capacity
+/**
+ * @defgroup cdc_concurrent_map_capacity Capacity
+ * @{
+ */
+/**
+ * @brief Returns the number of items in the map. If other threads modify the
+ * map, the result is approximate.
+ * @param[in] m - cdc_concurrent_map
+ * @return the number of items in the map.
+ */
+size_t cdc_concurrent_map_size(struct cdc_concurrent_map *m);
+
+/**
+ * @brief Checks if the map has no elements.
+ * @param[in] m - cdc_concurrent_map
+ * @return true if the map is empty, false otherwise.
+ */
+static inline bool cdc_concurrent_map_empty(struct cdc_concurrent_map *m)
+{
+  assert(m != NULL);
+
+  return cdc_concurrent_map_size(m) == 0;
+}
+/** @} */
+
+// Modifiers
+/**
+ * @defgroup cdc_concurrent_map_modifiers Modifiers
+ * @{
+ */
+/**
+ * @brief Removes all the elements from the map. Segments are cleared one by
+ * one, so concurrent insertions into already cleared segments are kept.
+ * @param[in] m - cdc_concurrent_map
+ */
+void cdc_concurrent_map_clear(struct cdc_concurrent_map *m);
+
+/**
+ * @brief Inserts an element into the container, if the container doesn't
+ * already contain an element with an equivalent key.
+ * @param[in] m - cdc_concurrent_map
+ * @param[in] key - key of the element
+ * @param[in] value - value of the element
+ * @param[out] inserted - true if the insertion took place. The pointer can be
+ * equal to NULL.
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_concurrent_map_insert(struct cdc_concurrent_map *m,
+                                        void *key, void *value, bool *inserted);
+
+/**
+ * @brief Inserts an element or assigns to the current element if the key
+ * already exists.
+ * @param[in] m - cdc_concurrent_map
+ * @param[in] key - key of the element
+ * @param[in] value - value of the element
+ * @param[out] inserted - true if the insertion took place and false if the
+ * assignment took place. The pointer can be equal to NULL.
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_concurrent_map_insert_or_assign(struct cdc_concurrent_map *m,
+                                                  void *key, void *value,
+                                                  bool *inserted);
+
+/**
+ * @brief Removes the element (if one exists) with the key equivalent to key.
+ * @param[in] m - cdc_concurrent_map
+ * @param[in] key - key value of the elements to remove
+ * @return number of elements removed.
+ */
+size_t cdc_concurrent_map_erase(struct cdc_concurrent_map *m, void *key);
+/** @} */
+
+// Short names
+#ifdef CDC_USE_SHORT_NAMES
+typedef struct cdc_concurrent_map concurrent_map_t;
+
+// Base
+#define concurrent_map_ctor(...) cdc_concurrent_map_ctor(__VA_ARGS__)
+#define concurrent_map_ctor1(...) cdc_concurrent_map_ctor1(__VA_ARGS__)
+#define concurrent_map_dtor(...) cdc_concurrent_map_dtor(__VA_ARGS__)
+
+// Lookup
+#define concurrent_map_get(...) cdc_concurrent_map_get(__VA_ARGS__)
+#define concurrent_map_count(...) cdc_concurrent_map_count(__VA_ARGS__)
+
+// Capacity
+#define concurrent_map_size(...) cdc_concurrent_map_size(__VA_ARGS__)
+#define concurrent_map_empty(...) cdc_concurrent_map_empty(__VA_ARGS__)
+
+// Modifiers
+#define concurrent_map_clear(...) cdc_concurrent_map_clear(__VA_ARGS__)
+#define concurrent_map_insert(...) cdc_concurrent_map_insert(__VA_ARGS__)
+#define concurrent_map_insert_or_assign(...) \
+  cdc_concurrent_map_insert_or_assign(__VA_ARGS__)
+#define concurrent_map_erase(...) cdc_concurrent_map_erase(__VA_ARGS__)
+#endif
+/** @} */
+#endif  // CDCONTAINERS_INCLUDE_CDCONTAINERS_CONCURRENT_MAP_H
@@ -22,16 +22,121 @@
 #define CDCONTAINERS_SRC_DATA_INFO_H
 
 #include <cdcontainers/common.h>
+#include <cdcontainers/node-pool.h>
+
+#include <stdlib.h>
+#include <string.h>
 
 struct cdc_data_info *cdc_di_shared_ctorc(struct cdc_data_info *other);
 void cdc_di_shared_dtor(struct cdc_data_info *info);
 
 #define CDC_HAS_DFREE(dinfo) (dinfo && dinfo->dfree)
 #define CDC_HAS_CMP(dinfo) (dinfo && dinfo->cmp)
+#define CDC_HAS_CMP3(dinfo) (dinfo && dinfo->cmp3)
+// The items can be ordered with cmp or cmp3.
+#define CDC_HAS_ORDER(dinfo) (CDC_HAS_CMP(dinfo) || CDC_HAS_CMP3(dinfo))
 #define CDC_HAS_EQ(dinfo) (dinfo && dinfo->eq)
 #define CDC_HAS_HASH(dinfo) (dinfo && dinfo->hash)
 #define CDC_HAS_CP(dinfo) (dinfo && dinfo->cp)
 #define CDC_HAS_SIZE(dinfo) (dinfo && dinfo->size)
+#define CDC_HAS_ALLOCATOR(dinfo) (dinfo && dinfo->allocator.allocate)
+
+static inline void *cdc_di_alloc(struct cdc_data_info *dinfo, size_t size)
+{
+  if (CDC_HAS_ALLOCATOR(dinfo)) {
+    return dinfo->allocator.allocate(size, dinfo->allocator.ctx);
+  }
+
+  return malloc(size);
+}
+
+static inline void *cdc_di_calloc(struct cdc_data_info *dinfo, size_t size)
+{
+  if (!CDC_HAS_ALLOCATOR(dinfo)) {
+    return calloc(size, 1);
+  }
+
+  void *ptr = dinfo->allocator.allocate(size, dinfo->allocator.ctx);
+  if (ptr) {
+    memset(ptr, 0, size);
+  }
+
+  return ptr;
+}
+
+static inline void cdc_di_free(struct cdc_data_info *dinfo, void *ptr)
+{
+  if (CDC_HAS_ALLOCATOR(dinfo)) {
+    if (ptr) {
+      dinfo->allocator.deallocate(ptr, dinfo->allocator.ctx);
+    }
+  } else {
+    free(ptr);
+  }
+}
+
+static inline void *cdc_di_realloc(struct cdc_data_info *dinfo, void *ptr,
+                                   size_t old_size, size_t size)
+{
+  if (!CDC_HAS_ALLOCATOR(dinfo)) {
+    return realloc(ptr, size);
+  }
+
+  if (dinfo->allocator.reallocate) {
+    return dinfo->allocator.reallocate(ptr, size, dinfo->allocator.ctx);
+  }
+
+  void *tmp = dinfo->allocator.allocate(size, dinfo->allocator.ctx);
+  if (tmp && ptr) {
+    memcpy(tmp, ptr, CDC_MIN(old_size, size));
+    dinfo->allocator.deallocate(ptr, dinfo->allocator.ctx);
+  }
+
+  return tmp;
+}
+
+static inline void *cdc_di_node_alloc(struct cdc_data_info *dinfo,
+                                      struct cdc_node_pool *pool, size_t size)
+{
+  if (cdc_node_pool_enabled(pool)) {
+    return cdc_node_pool_alloc(pool, dinfo);
+  }
+
+  return cdc_di_alloc(dinfo, size);
+}
+
+static inline void cdc_di_node_free(struct cdc_data_info *dinfo,
+                                    struct cdc_node_pool *pool, void *node)
+{
+  if (cdc_node_pool_enabled(pool)) {
+    cdc_node_pool_free(pool, node);
+  } else {
+    cdc_di_free(dinfo, node);
+  }
+}
+
+// Returns true if l is less than r. cmp3 is preferred if it is set.
+static inline int cdc_di_less(struct cdc_data_info *dinfo, const void *l,
+                              const void *r)
+{
+  return dinfo->cmp3 ? dinfo->cmp3(l, r) < 0 : dinfo->cmp(l, r);
+}
+
+// Returns a negative value, zero or a positive value if l is less than, equal
+// to or greater than r. Without cmp3 it takes one or two calls of cmp.
+static inline int cdc_di_cmp3(struct cdc_data_info *dinfo, const void *l,
+                              const void *r)
+{
+  if (dinfo->cmp3) {
+    return dinfo->cmp3(l, r);
+  }
+
+  if (dinfo->cmp(l, r)) {
+    return -1;
+  }
+
+  return dinfo->cmp(r, l) ? 1 : 0;
+}
 
 static inline int cdc_eq(int (*pred)(const void *, const void *), const void *l,
                          const void *r)
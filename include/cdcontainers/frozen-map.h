@@ -0,0 +1,388 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+/**
+ * @file
+ * @author Maksim Andrianov <maksimandrianov1@yandex.ru>
+ * @brief The cdc_frozen_map is a struct and functions that provide an
+ * immutable map with a minimal perfect hash function.
+ */
+#ifndef CDCONTAINERS_INCLUDE_CDCONTAINERS_FROZEN_MAP_H
+#define CDCONTAINERS_INCLUDE_CDCONTAINERS_FROZEN_MAP_H
+
+#include <cdcontainers/adapters/map.h>
+#include <cdcontainers/common.h>
+#include <cdcontainers/hash.h>
+#include <cdcontainers/status.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/**
+ * @defgroup cdc_frozen_map
+ * @brief The cdc_frozen_map is a struct and functions that provide an
+ * immutable map with a minimal perfect hash function.
+ *
+ * The map is built once from a cdc_map or from a list of pairs and can not be
+ * changed afterwards. The construction uses hash and displace: keys are split
+ * into small buckets, and for every bucket a pilot is searched that sends all
+ * its keys to free slots. Buckets of one key take the remaining free slots
+ * directly, so there are exactly as many slots as distinct hashes. A lookup
+ * reads the pilot of the bucket and then the slot; there are no chains and no
+ * probing.
+ *
+ * Keys whose hashes are equal can not be separated by a hash function. Such
+ * keys, except the first one, are kept sorted by hash after the slots and are
+ * searched only when the slot holds an equal hash but another key.
+ *
+ * The keys and the values are not copied. The function dfree of
+ * cdc_data_info is called for the pairs in cdc_frozen_map_dtor.
+ * @{
+ */
+/**
+ * @brief The cdc_frozen_map_entry struct
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_frozen_map_entry {
+  size_t hash;
+  void *key;
+  void *value;
+};
+
+/**
+ * @brief The cdc_frozen_map is service struct.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_frozen_map {
+  struct cdc_frozen_map_entry *entries;
+  size_t size;
+  size_t slot_count;
+  uint32_t *pilots;
+  size_t pilot_count;
+  uint64_t seed;
+  struct cdc_data_info *dinfo;
+};
+
+/**
+ * @brief The cdc_frozen_map_iter is service struct.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_frozen_map_iter {
+  struct cdc_frozen_map *container;
+  struct cdc_frozen_map_entry *current;
+};
+// Base
+/**
+ * @defgroup cdc_frozen_map_base Base
+ * @{
+ */
+/**
+ * @brief Constructs a frozen map with all the pairs of the map.
+ * @param[out] m - cdc_frozen_map
+ * @param[in] info - cdc_data_info. It must have the functions hash and eq.
+ * @param[in] map - cdc_map, it can use any implementation
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_frozen_map_ctor(struct cdc_frozen_map **m,
+                                  struct cdc_data_info *info,
+                                  struct cdc_map *map);
+
+/**
+ * @brief Constructs a frozen map, initialized by an variable number of
+ * pointers on cdc_pair's(first - key, and the second - value). The last item
+ * must be CDC_END. If a key repeats, the first pair is kept.
+ * @param[out] m - cdc_frozen_map
+ * @param[in] info - cdc_data_info. It must have the functions hash and eq.
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_frozen_map_ctorl(struct cdc_frozen_map **m,
+                                   struct cdc_data_info *info, ...);
+
+/**
+ * @brief Constructs a frozen map, initialized by args. The last item must be
+ * CDC_END.
+ * @param[out] m - cdc_frozen_map
+ * @param[in] info - cdc_data_info. It must have the functions hash and eq.
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_frozen_map_ctorv(struct cdc_frozen_map **m,
+                                   struct cdc_data_info *info, va_list args);
+
+/**
+ * @brief Destroys the frozen map.
+ * @param[in] m - cdc_frozen_map
+ */
+void cdc_frozen_map_dtor(struct cdc_frozen_map *m);
+/** @} */
+
+// Lookup
+/**
+ * @defgroup cdc_frozen_map_lookup Lookup
+ * @{
+ */
+/**
+ * @brief Returns a value that is mapped to a key. If the key does
+ * not exist, then NULL will return.
+ * @param[in] m - cdc_frozen_map
+ * @param[in] key - key of the element to find
+ * @param[out] value - pinter to the value that is mapped to a key.
+ * @return CDC_STATUS_OK if the key is found, CDC_STATUS_NOT_FOUND otherwise.
+ */
+enum cdc_stat cdc_frozen_map_get(struct cdc_frozen_map *m, void *key,
+                                 void **value);
+
+/**
+ * @brief Returns the number of elements with key that compares equal to the
+ * specified argument key, which is either 1 or 0 since this container does not
+ * allow duplicates.
+ * @param[in] m - cdc_frozen_map
+ * @param[in] key - key value of the elements to count
+ * @return number of elements with key key, that is either 1 or 0.
+ */
+size_t cdc_frozen_map_count(struct cdc_frozen_map *m, void *key);
+
+/**
+ * @brief Finds an element with key equivalent to key.
+ * @param[in] m - cdc_frozen_map
+ * @param[in] key - key value of the element to search for
+ * @param[out] it - pointer will be recorded iterator to an element with key
+ * equivalent to key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_frozen_map_find(struct cdc_frozen_map *m, void *key,
+                         struct cdc_frozen_map_iter *it);
+/** @} */
+
+// Capacity
+/**
+ * @defgroup cdc_frozen_map_capacity Capacity
+ * @{
+ */
+/**
+ * @brief Returns the number of items in the frozen map.
+ * @param[in] m - cdc_frozen_map
+ * @return the number of items in the frozen map.
+ */
+static inline size_t cdc_frozen_map_size(struct cdc_frozen_map *m)
+{
+  assert(m != NULL);
+
+  return m->size;
+}
+
+/**
+ * @brief Checks if the frozen map has no elements.
+ * @param[in] m - cdc_frozen_map
+ * @return true if the frozen map is empty, false otherwise.
+ */
+static inline bool cdc_frozen_map_empty(struct cdc_frozen_map *m)
+{
+  assert(m != NULL);
+
+  return m->size == 0;
+}
+/** @} */
+
+// Modifiers
+/**
+ * @defgroup cdc_frozen_map_modifiers Modifiers
+ * @{
+ */
+/**
+ * @brief Swaps frozen maps a and b. This operation is very fast and never
+ * fails.
+ * @param[in, out] a - cdc_frozen_map
+ * @param[in, out] b - cdc_frozen_map
+ */
+void cdc_frozen_map_swap(struct cdc_frozen_map *a, struct cdc_frozen_map *b);
+/** @} */
+
+// Iterators
+/**
+ * @defgroup cdc_frozen_map_iterators Iterators
+ * @{
+ */
+/**
+ * @brief Initializes the iterator to the beginning.
+ * @param m[in] - cdc_frozen_map
+ * @param it[out] - cdc_frozen_map_iter
+ */
+static inline void cdc_frozen_map_begin(struct cdc_frozen_map *m,
+                                        struct cdc_frozen_map_iter *it)
+{
+  assert(m != NULL);
+  assert(it != NULL);
+
+  it->container = m;
+  it->current = m->entries;
+}
+
+/**
+ * @brief Initializes the iterator to the end.
+ * @param[in] m - cdc_frozen_map
+ * @param[out] it - cdc_frozen_map_iter
+ */
+static inline void cdc_frozen_map_end(struct cdc_frozen_map *m,
+                                      struct cdc_frozen_map_iter *it)
+{
+  assert(m != NULL);
+  assert(it != NULL);
+
+  it->container = m;
+  it->current = m->entries + m->size;
+}
+/** @} */
+
+// Iterators
+/**
+ * @defgroup cdc_frozen_map_iter
+ * @brief The cdc_frozen_map_iter is a struct and functions that provide a
+ * frozen map iterator.
+ * @{
+ */
+/**
+ * @brief Advances the iterator to the next element in the frozen map.
+ * @param[in] it - iterator
+ */
+static inline void cdc_frozen_map_iter_next(struct cdc_frozen_map_iter *it)
+{
+  assert(it != NULL);
+
+  ++it->current;
+}
+
+/**
+ * @brief Returns true if there is at least one element ahead of the iterator,
+ * i.e. the iterator is not at the back of the container; otherwise returns
+ * false.
+ * @param[in] it - iterator
+ * @return true if there is at least one element ahead of the iterator, i.e.
+ * the iterator is not at the back of the container; otherwise returns false.
+ */
+static inline bool cdc_frozen_map_iter_has_next(struct cdc_frozen_map_iter *it)
+{
+  assert(it != NULL);
+
+  return it->current != it->container->entries + it->container->size;
+}
+
+/**
+ * @brief Returns an item's key.
+ * @param[in] it - iterator
+ * @return the item's key.
+ */
+static inline void *cdc_frozen_map_iter_key(struct cdc_frozen_map_iter *it)
+{
+  assert(it != NULL);
+
+  return it->current->key;
+}
+
+/**
+ * @brief Returns an item's value.
+ * @param[in] it - iterator
+ * @return the item's value.
+ */
+static inline void *cdc_frozen_map_iter_value(struct cdc_frozen_map_iter *it)
+{
+  assert(it != NULL);
+
+  return it->current->value;
+}
+
+/**
+ * @brief Returns a pair, where first - key, second - value.
+ * @param[in] it - iterator
+ * @return pair, where first - key, second - value.
+ */
+static inline struct cdc_pair cdc_frozen_map_iter_key_value(
+    struct cdc_frozen_map_iter *it)
+{
+  assert(it != NULL);
+
+  struct cdc_pair pair = {it->current->key, it->current->value};
+  return pair;
+}
+
+/**
+ * @brief Returns false if the iterator |it1| equal to the iterator |it2|,
+ * otherwise returns false.
+ * @param[in] it1 - iterator
+ * @param[in] it2 - iterator
+ * @return false if the iterator |it1| equal to the iterator |it2|,
+ * otherwise returns false.
+ */
+static inline bool cdc_frozen_map_iter_is_eq(struct cdc_frozen_map_iter *it1,
+                                             struct cdc_frozen_map_iter *it2)
+{
+  assert(it1 != NULL);
+  assert(it2 != NULL);
+
+  return it1->container == it2->container && it1->current == it2->current;
+}
+/** @} */
+
+// Short names
+#ifdef CDC_USE_SHORT_NAMES
+typedef struct cdc_frozen_map frozen_map_t;
+typedef struct cdc_frozen_map_iter frozen_map_iter_t;
+
+// Base
+#define frozen_map_ctor(...) cdc_frozen_map_ctor(__VA_ARGS__)
+#define frozen_map_ctorl(...) cdc_frozen_map_ctorl(__VA_ARGS__)
+#define frozen_map_ctorv(...) cdc_frozen_map_ctorv(__VA_ARGS__)
+#define frozen_map_dtor(...) cdc_frozen_map_dtor(__VA_ARGS__)
+
+// Lookup
+#define frozen_map_get(...) cdc_frozen_map_get(__VA_ARGS__)
+#define frozen_map_count(...) cdc_frozen_map_count(__VA_ARGS__)
+#define frozen_map_find(...) cdc_frozen_map_find(__VA_ARGS__)
+
+// Capacity
+#define frozen_map_size(...) cdc_frozen_map_size(__VA_ARGS__)
+#define frozen_map_empty(...) cdc_frozen_map_empty(__VA_ARGS__)
+
+// Modifiers
+#define frozen_map_swap(...) cdc_frozen_map_swap(__VA_ARGS__)
+
+// Iterators
+#define frozen_map_begin(...) cdc_frozen_map_begin(__VA_ARGS__)
+#define frozen_map_end(...) cdc_frozen_map_end(__VA_ARGS__)
+
+// Iterators
+#define frozen_map_iter_next(...) cdc_frozen_map_iter_next(__VA_ARGS__)
+#define frozen_map_iter_has_next(...) cdc_frozen_map_iter_has_next(__VA_ARGS__)
+#define frozen_map_iter_key(...) cdc_frozen_map_iter_key(__VA_ARGS__)
+#define frozen_map_iter_value(...) cdc_frozen_map_iter_value(__VA_ARGS__)
+#define frozen_map_iter_key_value(...) \
+  cdc_frozen_map_iter_key_value(__VA_ARGS__)
+#define frozen_map_iter_is_eq(...) cdc_frozen_map_iter_is_eq(__VA_ARGS__)
+#endif
+/** @} */
+#endif  // CDCONTAINERS_INCLUDE_CDCONTAINERS_FROZEN_MAP_H
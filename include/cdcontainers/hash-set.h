@@ -0,0 +1,562 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+/**
+ * @file
+ * @author Maksim Andrianov <maksimandrianov1@yandex.ru>
+ * @brief The cdc_hash_set is a struct and functions that provide a hash set.
+ */
+#ifndef CDCONTAINERS_INCLUDE_CDCONTAINERS_HASH_SET_H
+#define CDCONTAINERS_INCLUDE_CDCONTAINERS_HASH_SET_H
+
+#include <cdcontainers/common.h>
+#include <cdcontainers/hash.h>
+#include <cdcontainers/status.h>
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+/**
+ * @defgroup cdc_hash_set
+ * @brief The cdc_hash_set is a struct and functions that provide a hash set.
+ *
+ * The set stores only keys. Keys and their hashes are kept in one flat array
+ * with open addressing and Robin Hood hashing, so there is no allocation per
+ * key and no value slot. The function dfree of cdc_data_info is called with
+ * the key itself, not with a cdc_pair. Insertion and erasure invalidate
+ * iterators.
+ * @{
+ */
+/**
+ * @brief The cdc_hash_set_entry struct
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_hash_set_entry {
+  size_t hash;
+  void *key;
+};
+
+/**
+ * @brief The cdc_hash_set is service struct.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_hash_set {
+  struct cdc_hash_set_entry *entries;
+  size_t capacity;
+  float load_factor;
+  size_t size;
+  struct cdc_data_info *dinfo;
+};
+
+/**
+ * @brief The cdc_hash_set_iter is service struct.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_hash_set_iter {
+  struct cdc_hash_set *container;
+  struct cdc_hash_set_entry *current;
+};
+// Base
+/**
+ * @defgroup cdc_hash_set_base Base
+ * @{
+ */
+/**
+ * @brief Constructs an empty hash set.
+ * @param[out] s - cdc_hash_set
+ * @param[in] info - cdc_data_info
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_set_ctor(struct cdc_hash_set **s,
+                                struct cdc_data_info *info);
+
+/**
+ * @brief Constructs a hash set, initialized by an variable number of keys.
+ * The last item must be CDC_END.
+ * @param[out] s - cdc_hash_set
+ * @param[in] info - cdc_data_info
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ *
+ * Example:
+ * @code{.c}
+ * struct cdc_hash_set *set = NULL;
+ * if (cdc_hash_set_ctorl(&set, info, CDC_FROM_INT(1),
+ *                        CDC_FROM_INT(2), CDC_END) != CDC_STATUS_OK) {
+ *   // handle error
+ * }
+ * @endcode
+ */
+enum cdc_stat cdc_hash_set_ctorl(struct cdc_hash_set **s,
+                                 struct cdc_data_info *info, ...);
+
+/**
+ * @brief Constructs a hash set, initialized by args. The last item must be
+ * CDC_END.
+ * @param[out] s - cdc_hash_set
+ * @param[in] info - cdc_data_info
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_set_ctorv(struct cdc_hash_set **s,
+                                 struct cdc_data_info *info, va_list args);
+
+/**
+ * @brief Constructs an empty hash set.
+ * @param[out] s - cdc_hash_set
+ * @param[in] info - cdc_data_info
+ * @param[in] load_factor - maximum load factor, it must be less than 1
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_set_ctor1(struct cdc_hash_set **s,
+                                 struct cdc_data_info *info, float load_factor);
+
+/**
+ * @brief Constructs a hash set, initialized by an variable number of keys.
+ * The last item must be CDC_END.
+ * @param[out] s - cdc_hash_set
+ * @param[in] info - cdc_data_info
+ * @param[in] load_factor - maximum load factor, it must be less than 1
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_set_ctorl1(struct cdc_hash_set **s,
+                                  struct cdc_data_info *info, float load_factor,
+                                  ...);
+
+/**
+ * @brief Constructs a hash set, initialized by args. The last item must be
+ * CDC_END.
+ * @param[out] s - cdc_hash_set
+ * @param[in] info - cdc_data_info
+ * @param[in] load_factor - maximum load factor, it must be less than 1
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_set_ctorv1(struct cdc_hash_set **s,
+                                  struct cdc_data_info *info, float load_factor,
+                                  va_list args);
+
+/**
+ * @brief Destroys the hash set.
+ * @param[in] s - cdc_hash_set
+ */
+void cdc_hash_set_dtor(struct cdc_hash_set *s);
+/** @} */
+
+// Lookup
+/**
+ * @defgroup cdc_hash_set_lookup Lookup
+ * @{
+ */
+/**
+ * @brief Checks if the set contains the key.
+ * @param[in] s - cdc_hash_set
+ * @param[in] key - key to search for
+ * @return true if the set contains the key, false otherwise.
+ */
+bool cdc_hash_set_contains(struct cdc_hash_set *s, void *key);
+
+/**
+ * @brief Returns the number of elements with key that compares equal to the
+ * specified argument key, which is either 1 or 0 since this container does not
+ * allow duplicates.
+ * @param[in] s - cdc_hash_set
+ * @param[in] key - key value of the elements to count
+ * @return number of elements with key key, that is either 1 or 0.
+ */
+static inline size_t cdc_hash_set_count(struct cdc_hash_set *s, void *key)
+{
+  assert(s != NULL);
+
+  return (size_t)cdc_hash_set_contains(s, key);
+}
+
+/**
+ * @brief Finds an element with key equivalent to key.
+ * @param[in] s - cdc_hash_set
+ * @param[in] key - key value of the element to search for
+ * @param[out] it - pointer will be recorded iterator to an element with key
+ * equivalent to key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_hash_set_find(struct cdc_hash_set *s, void *key,
+                       struct cdc_hash_set_iter *it);
+/** @} */
+
+// Capacity
+/**
+ * @defgroup cdc_hash_set_capacity Capacity
+ * @{
+ */
+/**
+ * @brief Returns the number of items in the hash set.
+ * @param[in] s - cdc_hash_set
+ * @return the number of items in the hash set.
+ */
+static inline size_t cdc_hash_set_size(struct cdc_hash_set *s)
+{
+  assert(s != NULL);
+
+  return s->size;
+}
+
+/**
+ * @brief Checks if the hash set has no elements.
+ * @param[in] s - cdc_hash_set
+ * @return true if the hash set is empty, false otherwise.
+ */
+static inline bool cdc_hash_set_empty(struct cdc_hash_set *s)
+{
+  assert(s != NULL);
+
+  return s->size == 0;
+}
+/** @} */
+
+// Modifiers
+/**
+ * @defgroup cdc_hash_set_modifiers Modifiers
+ * @{
+ */
+/**
+ * @brief Removes all the elements from the hash set.
+ * @param[in] s - cdc_hash_set
+ */
+void cdc_hash_set_clear(struct cdc_hash_set *s);
+
+/**
+ * @brief Inserts a key into the set, if the set doesn't already contain an
+ * equivalent key.
+ * @param[in] s - cdc_hash_set
+ * @param[in] key - key of the element
+ * @param[out] it - iterator to the inserted element (or to the element that
+ * prevented the insertion). The pointer can be equal to NULL.
+ * @param[out] inserted - true if the insertion took place. The pointer can be
+ * equal to NULL.
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_set_insert(struct cdc_hash_set *s, void *key,
+                                  struct cdc_hash_set_iter *it, bool *inserted);
+
+/**
+ * @brief Removes the element (if one exists) with the key equivalent to key.
+ * @param[in] s - cdc_hash_set
+ * @param[in] key - key value of the elements to remove
+ * @return number of elements removed.
+ */
+size_t cdc_hash_set_erase(struct cdc_hash_set *s, void *key);
+
+/**
+ * @brief Swaps hash sets a and b. This operation is very fast and never fails.
+ * @param[in, out] a - cdc_hash_set
+ * @param[in, out] b - cdc_hash_set
+ */
+void cdc_hash_set_swap(struct cdc_hash_set *a, struct cdc_hash_set *b);
+/** @} */
+
+// Set operations
+/**
+ * @defgroup cdc_hash_set_operations Set operations
+ * @{
+ */
+/**
+ * @brief Inserts into the set s all keys of the set other that s does not
+ * contain. The keys are not copied, so if s frees its keys, the keys must not
+ * be freed by other.
+ * @param[in, out] s - cdc_hash_set
+ * @param[in] other - cdc_hash_set
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error. In the case of an error, s contains a part of the keys of other.
+ */
+enum cdc_stat cdc_hash_set_union(struct cdc_hash_set *s,
+                                 struct cdc_hash_set *other);
+
+/**
+ * @brief Removes from the set s all keys that the set other does not contain.
+ * @param[in, out] s - cdc_hash_set
+ * @param[in] other - cdc_hash_set
+ */
+void cdc_hash_set_intersection(struct cdc_hash_set *s,
+                               struct cdc_hash_set *other);
+
+/**
+ * @brief Removes from the set s all keys that the set other contains. The
+ * smaller of the two sets is iterated.
+ * @param[in, out] s - cdc_hash_set
+ * @param[in] other - cdc_hash_set
+ */
+void cdc_hash_set_difference(struct cdc_hash_set *s,
+                             struct cdc_hash_set *other);
+/** @} */
+
+// Iterators
+/**
+ * @defgroup cdc_hash_set_iterators Iterators
+ * @{
+ */
+/**
+ * @brief Initializes the iterator to the beginning.
+ * @param s[in] - cdc_hash_set
+ * @param it[out] - cdc_hash_set_iter
+ */
+static inline void cdc_hash_set_begin(struct cdc_hash_set *s,
+                                      struct cdc_hash_set_iter *it)
+{
+  assert(s != NULL);
+  assert(it != NULL);
+
+  it->container = s;
+  it->current = s->entries;
+  while (it->current != s->entries + s->capacity && it->current->hash == 0) {
+    ++it->current;
+  }
+}
+
+/**
+ * @brief Initializes the iterator to the end.
+ * @param[in] s - cdc_hash_set
+ * @param[out] it - cdc_hash_set_iter
+ */
+static inline void cdc_hash_set_end(struct cdc_hash_set *s,
+                                    struct cdc_hash_set_iter *it)
+{
+  assert(s != NULL);
+  assert(it != NULL);
+
+  it->container = s;
+  it->current = s->entries + s->capacity;
+}
+/** @} */
+
+// Hash policy
+/**
+ * @defgroup cdc_hash_set_hash_policy Hash policy
+ * @{
+ */
+/**
+ * @brief Returns the ratio of the number of elements to the number of slots.
+ * @param[in] s - cdc_hash_set
+ * @return the ratio of the number of elements to the number of slots.
+ */
+static inline float cdc_hash_set_load_factor(struct cdc_hash_set *s)
+{
+  assert(s != NULL);
+
+  return (float)s->size / (float)s->capacity;
+}
+
+/**
+ * @brief Returns current maximum load factor.
+ * @param[in] s - cdc_hash_set
+ * @return current maximum load factor.
+ */
+static inline float cdc_hash_set_max_load_factor(struct cdc_hash_set *s)
+{
+  assert(s != NULL);
+
+  return s->load_factor;
+}
+
+/**
+ * @brief Sets the maximum load factor. It must be less than 1.
+ * @param[in] s - cdc_hash_set
+ * @param[in] load_factor - new maximum load factor
+ */
+static inline void cdc_hash_set_set_max_load_factor(struct cdc_hash_set *s,
+                                                    float load_factor)
+{
+  assert(s != NULL);
+  assert(load_factor > 0 && load_factor < 1);
+
+  s->load_factor = load_factor;
+}
+
+/**
+ * @brief Reserves at least the specified number of slots. This regenerates
+ * the hash set.
+ * @param[in] s - cdc_hash_set
+ * @param[in] count - new number of slots
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_set_rehash(struct cdc_hash_set *s, size_t count);
+
+/**
+ * @brief Reserves space for at least the specified number of elements. This
+ * regenerates the hash set.
+ * @param[in] s - cdc_hash_set
+ * @param[in] count - new capacity of the container
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_set_reserve(struct cdc_hash_set *s, size_t count);
+/** @} */
+
+// Bucket interface
+/**
+ * @defgroup cdc_hash_set_bucket_interface Bucket interface
+ * @{
+ */
+/**
+ * @brief Returns the number of slots.
+ * @param[in] s - cdc_hash_set
+ * @return returns the number of slots.
+ */
+static inline size_t cdc_hash_set_bucket_count(struct cdc_hash_set *s)
+{
+  assert(s != NULL);
+
+  return s->capacity;
+}
+/** @} */
+
+// Iterators
+/**
+ * @defgroup cdc_hash_set_iter
+ * @brief The cdc_hash_set_iter is a struct and functions that provide a hash
+ * set iterator.
+ * @{
+ */
+/**
+ * @brief Advances the iterator to the next element in the hash set.
+ * @param[in] it - iterator
+ */
+static inline void cdc_hash_set_iter_next(struct cdc_hash_set_iter *it)
+{
+  assert(it != NULL);
+
+  struct cdc_hash_set_entry *end =
+      it->container->entries + it->container->capacity;
+  do {
+    ++it->current;
+  } while (it->current != end && it->current->hash == 0);
+}
+
+/**
+ * @brief Returns true if there is at least one element ahead of the iterator,
+ * i.e. the iterator is not at the back of the container; otherwise returns
+ * false.
+ * @param[in] it - iterator
+ * @return true if there is at least one element ahead of the iterator, i.e.
+ * the iterator is not at the back of the container; otherwise returns false.
+ */
+static inline bool cdc_hash_set_iter_has_next(struct cdc_hash_set_iter *it)
+{
+  assert(it != NULL);
+
+  return it->current != it->container->entries + it->container->capacity;
+}
+
+/**
+ * @brief Returns an item's key.
+ * @param[in] it - iterator
+ * @return the item's key.
+ */
+static inline void *cdc_hash_set_iter_key(struct cdc_hash_set_iter *it)
+{
+  assert(it != NULL);
+
+  return it->current->key;
+}
+
+/**
+ * @brief Returns false if the iterator |it1| equal to the iterator |it2|,
+ * otherwise returns false.
+ * @param[in] it1 - iterator
+ * @param[in] it2 - iterator
+ * @return false if the iterator |it1| equal to the iterator |it2|,
+ * otherwise returns false.
+ */
+static inline bool cdc_hash_set_iter_is_eq(struct cdc_hash_set_iter *it1,
+                                           struct cdc_hash_set_iter *it2)
+{
+  assert(it1 != NULL);
+  assert(it2 != NULL);
+
+  return it1->container == it2->container && it1->current == it2->current;
+}
+/** @} */
+
+// Short names
+#ifdef CDC_USE_SHORT_NAMES
+typedef struct cdc_hash_set hash_set_t;
+typedef struct cdc_hash_set_iter hash_set_iter_t;
+
+// Base
+#define hash_set_ctor(...) cdc_hash_set_ctor(__VA_ARGS__)
+#define hash_set_ctorl(...) cdc_hash_set_ctorl(__VA_ARGS__)
+#define hash_set_ctorv(...) cdc_hash_set_ctorv(__VA_ARGS__)
+#define hash_set_ctor1(...) cdc_hash_set_ctor1(__VA_ARGS__)
+#define hash_set_ctorl1(...) cdc_hash_set_ctorl1(__VA_ARGS__)
+#define hash_set_ctorv1(...) cdc_hash_set_ctorv1(__VA_ARGS__)
+#define hash_set_dtor(...) cdc_hash_set_dtor(__VA_ARGS__)
+
+// Lookup
+#define hash_set_contains(...) cdc_hash_set_contains(__VA_ARGS__)
+#define hash_set_count(...) cdc_hash_set_count(__VA_ARGS__)
+#define hash_set_find(...) cdc_hash_set_find(__VA_ARGS__)
+
+// Capacity
+#define hash_set_size(...) cdc_hash_set_size(__VA_ARGS__)
+#define hash_set_empty(...) cdc_hash_set_empty(__VA_ARGS__)
+
+// Modifiers
+#define hash_set_clear(...) cdc_hash_set_clear(__VA_ARGS__)
+#define hash_set_insert(...) cdc_hash_set_insert(__VA_ARGS__)
+#define hash_set_erase(...) cdc_hash_set_erase(__VA_ARGS__)
+#define hash_set_swap(...) cdc_hash_set_swap(__VA_ARGS__)
+
+// Set operations
+#define hash_set_union(...) cdc_hash_set_union(__VA_ARGS__)
+#define hash_set_intersection(...) cdc_hash_set_intersection(__VA_ARGS__)
+#define hash_set_difference(...) cdc_hash_set_difference(__VA_ARGS__)
+
+// Iterators
+#define hash_set_begin(...) cdc_hash_set_begin(__VA_ARGS__)
+#define hash_set_end(...) cdc_hash_set_end(__VA_ARGS__)
+
+// Hash policy
+#define hash_set_load_factor(...) cdc_hash_set_load_factor(__VA_ARGS__)
+#define hash_set_max_load_factor(...) cdc_hash_set_max_load_factor(__VA_ARGS__)
+#define hash_set_set_max_load_factor(...) \
+  cdc_hash_set_set_max_load_factor(__VA_ARGS__)
+#define hash_set_rehash(...) cdc_hash_set_rehash(__VA_ARGS__)
+#define hash_set_reserve(...) cdc_hash_set_reserve(__VA_ARGS__)
+
+// Bucket interface
+#define hash_set_bucket_count(...) cdc_hash_set_bucket_count(__VA_ARGS__)
+
+// Iterators
+#define hash_set_iter_next(...) cdc_hash_set_iter_next(__VA_ARGS__)
+#define hash_set_iter_has_next(...) cdc_hash_set_iter_has_next(__VA_ARGS__)
+#define hash_set_iter_key(...) cdc_hash_set_iter_key(__VA_ARGS__)
+#define hash_set_iter_is_eq(...) cdc_hash_set_iter_is_eq(__VA_ARGS__)
+#endif
+/** @} */
+#endif  // CDCONTAINERS_INCLUDE_CDCONTAINERS_HASH_SET_H
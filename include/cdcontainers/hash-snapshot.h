@@ -0,0 +1,380 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+/**
+ * @file
+ * @author Maksim Andrianov <maksimandrianov1@yandex.ru>
+ * @brief The cdc_hash_snapshot is a struct and functions that provide a
+ * read-only hash table stored in a file and used without deserialization.
+ */
+#ifndef CDCONTAINERS_INCLUDE_CDCONTAINERS_HASH_SNAPSHOT_H
+#define CDCONTAINERS_INCLUDE_CDCONTAINERS_HASH_SNAPSHOT_H
+
+#include <cdcontainers/hash-table.h>
+#include <cdcontainers/status.h>
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @defgroup cdc_hash_snapshot
+ * @brief The cdc_hash_snapshot is a struct and functions that provide a
+ * read-only hash table stored in a file and used without deserialization.
+ *
+ * cdc_hash_snapshot_write saves the pairs of a cdc_hash_table to a file. The
+ * file uses offsets instead of pointers: a header, an array of bucket bounds,
+ * an array of entries {hash, offset} sorted by bucket, and a blob with the
+ * bytes of the keys and the values. cdc_hash_snapshot_ctor maps the file
+ * read-only (or reads it where mmap is not available) and the lookups work
+ * directly on the mapping, so opening a snapshot of any size takes constant
+ * time and the pages are loaded by the first accesses.
+ *
+ * The keys and the values are converted to bytes by cdc_hash_snapshot_codec.
+ * The items of a fixed size are stored as is, the items of a variable size are
+ * prefixed with their length. In the snapshot the keys are looked up by their
+ * bytes and the hash function is cdc_hash_bytes, so the hash and eq functions
+ * of the table are not needed to read it.
+ *
+ * A snapshot can be read only on a machine with the same byte order and size
+ * of size_t as the machine that wrote it. The loader checks the header, but
+ * it trusts the rest of the file.
+ * @{
+ */
+/**
+ * @brief The cdc_hash_snapshot_codec struct converts keys and values to bytes.
+ *
+ * If key_size is not zero, all the keys have this size and key_size_of is not
+ * called. Otherwise key_size_of returns the size of the key, it must not be
+ * greater than UINT32_MAX. key_write writes the bytes of the key to the buffer
+ * of this size. The fields for the values have the same meaning.
+ */
+struct cdc_hash_snapshot_codec {
+  size_t key_size;
+  size_t (*key_size_of)(void *key);
+  void (*key_write)(void *key, void *buf);
+  size_t value_size;
+  size_t (*value_size_of)(void *value);
+  void (*value_write)(void *value, void *buf);
+};
+
+/**
+ * @brief The cdc_hash_snapshot_entry is a part of the file format.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_hash_snapshot_entry {
+  uint64_t hash;
+  uint64_t offset;
+};
+
+/**
+ * @brief The cdc_hash_snapshot is service struct.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_hash_snapshot {
+  const unsigned char *data;
+  size_t length;
+  const uint64_t *buckets;
+  const struct cdc_hash_snapshot_entry *entries;
+  const unsigned char *blob;
+  size_t size;
+  size_t bucket_mask;
+  size_t key_size;
+  size_t value_size;
+  uint64_t seed;
+  bool mapped;
+};
+
+/**
+ * @brief The cdc_hash_snapshot_iter is service struct.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_hash_snapshot_iter {
+  struct cdc_hash_snapshot *container;
+  size_t current;
+};
+
+// Writer
+/**
+ * @defgroup cdc_hash_snapshot_writer Writer
+ * @{
+ */
+/**
+ * @brief Writes all the pairs of the hash table to the file. If the file
+ * exists, it is overwritten. To replace a snapshot that may be in use, write
+ * it to another file and rename the file.
+ * @param[in] t - cdc_hash_table
+ * @param[in] codec - cdc_hash_snapshot_codec
+ * @param[in] path - path of the file
+ * @return CDC_STATUS_OK in a successful case, CDC_STATUS_IO_ERROR if the file
+ * can not be written, CDC_STATUS_OVERFLOW if an item is too long or other
+ * value indicating an error.
+ */
+enum cdc_stat cdc_hash_snapshot_write(struct cdc_hash_table *t,
+                                      struct cdc_hash_snapshot_codec *codec,
+                                      const char *path);
+/** @} */
+
+// Base
+/**
+ * @defgroup cdc_hash_snapshot_base Base
+ * @{
+ */
+/**
+ * @brief Opens a snapshot written by cdc_hash_snapshot_write.
+ * @param[out] s - cdc_hash_snapshot
+ * @param[in] path - path of the file
+ * @return CDC_STATUS_OK in a successful case, CDC_STATUS_IO_ERROR if the file
+ * can not be read, CDC_STATUS_BAD_FORMAT if the file is not a snapshot or it
+ * was written on an incompatible machine, or other value indicating an error.
+ */
+enum cdc_stat cdc_hash_snapshot_ctor(struct cdc_hash_snapshot **s,
+                                     const char *path);
+
+/**
+ * @brief Closes the snapshot. The pointers to its keys and values become
+ * invalid.
+ * @param[in] s - cdc_hash_snapshot
+ */
+void cdc_hash_snapshot_dtor(struct cdc_hash_snapshot *s);
+/** @} */
+
+// Lookup
+/**
+ * @defgroup cdc_hash_snapshot_lookup Lookup
+ * @{
+ */
+/**
+ * @brief Returns the value that is mapped to the key. If no such element
+ * exists, the function returns CDC_STATUS_NOT_FOUND.
+ * @param[in] s - cdc_hash_snapshot
+ * @param[in] key - bytes of the key, as written by the codec
+ * @param[in] key_size - size of the key
+ * @param[out] value - pointer to the bytes of the value in the snapshot
+ * @param[out] value_size - size of the value. It may be NULL.
+ * @return CDC_STATUS_OK in a successful case or CDC_STATUS_NOT_FOUND.
+ */
+enum cdc_stat cdc_hash_snapshot_get(struct cdc_hash_snapshot *s,
+                                    const void *key, size_t key_size,
+                                    const void **value, size_t *value_size);
+
+/**
+ * @brief Returns the number of elements with key that compares equal to the
+ * specified argument key, which is either 1 or 0 since this container does
+ * not allow duplicates.
+ * @param[in] s - cdc_hash_snapshot
+ * @param[in] key - bytes of the key
+ * @param[in] key_size - size of the key
+ * @return number of elements with key.
+ */
+size_t cdc_hash_snapshot_count(struct cdc_hash_snapshot *s, const void *key,
+                               size_t key_size);
+
+/**
+ * @brief Finds an element with key equivalent to key.
+ * @param[in] s - cdc_hash_snapshot
+ * @param[in] key - bytes of the key
+ * @param[in] key_size - size of the key
+ * @param[out] it - pointer will be recorded iterator to an element with key
+ * equivalent to key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_hash_snapshot_find(struct cdc_hash_snapshot *s, const void *key,
+                            size_t key_size,
+                            struct cdc_hash_snapshot_iter *it);
+/** @} */
+
+// Capacity
+/**
+ * @defgroup cdc_hash_snapshot_capacity Capacity
+ * @{
+ */
+/**
+ * @brief Returns the number of items in the snapshot.
+ * @param[in] s - cdc_hash_snapshot
+ * @return the number of items in the snapshot.
+ */
+static inline size_t cdc_hash_snapshot_size(struct cdc_hash_snapshot *s)
+{
+  assert(s != NULL);
+
+  return s->size;
+}
+
+/**
+ * @brief Checks if the snapshot has no elements.
+ * @param[in] s - cdc_hash_snapshot
+ * @return true if the snapshot is empty, otherwise false.
+ */
+static inline bool cdc_hash_snapshot_empty(struct cdc_hash_snapshot *s)
+{
+  assert(s != NULL);
+
+  return s->size == 0;
+}
+/** @} */
+
+// Iterators
+/**
+ * @defgroup cdc_hash_snapshot_iterators Iterators
+ * @{
+ */
+/**
+ * @brief Initializes the iterator to the beginning.
+ * @param[in] s - cdc_hash_snapshot
+ * @param[out] it - cdc_hash_snapshot_iter
+ */
+static inline void cdc_hash_snapshot_begin(struct cdc_hash_snapshot *s,
+                                           struct cdc_hash_snapshot_iter *it)
+{
+  assert(s != NULL);
+  assert(it != NULL);
+
+  it->container = s;
+  it->current = 0;
+}
+
+/**
+ * @brief Initializes the iterator to the end.
+ * @param[in] s - cdc_hash_snapshot
+ * @param[out] it - cdc_hash_snapshot_iter
+ */
+static inline void cdc_hash_snapshot_end(struct cdc_hash_snapshot *s,
+                                         struct cdc_hash_snapshot_iter *it)
+{
+  assert(s != NULL);
+  assert(it != NULL);
+
+  it->container = s;
+  it->current = s->size;
+}
+/** @} */
+
+// Iterators
+/**
+ * @defgroup cdc_hash_snapshot_iter
+ * @brief The cdc_hash_snapshot_iter is a struct and functions that provide a
+ * hash snapshot iterator.
+ * @{
+ */
+/**
+ * @brief Advances the iterator to the next element in the snapshot.
+ * @param[in] it - iterator
+ */
+static inline void cdc_hash_snapshot_iter_next(
+    struct cdc_hash_snapshot_iter *it)
+{
+  assert(it != NULL);
+
+  ++it->current;
+}
+
+/**
+ * @brief Returns true if there is at least one element ahead of the iterator,
+ * i.e. the iterator is not at the back of the container; otherwise returns
+ * false.
+ * @param[in] it - iterator
+ * @return true if there is at least one element ahead of the iterator, i.e.
+ * the iterator is not at the back of the container; otherwise returns false.
+ */
+static inline bool cdc_hash_snapshot_iter_has_next(
+    struct cdc_hash_snapshot_iter *it)
+{
+  assert(it != NULL);
+
+  return it->current < it->container->size;
+}
+
+/**
+ * @brief Returns the bytes of the key of the item pointed by the iterator.
+ * @param[in] it - iterator
+ * @param[out] size - size of the key. It may be NULL.
+ * @return pointer to the bytes of the key in the snapshot.
+ */
+const void *cdc_hash_snapshot_iter_key(struct cdc_hash_snapshot_iter *it,
+                                       size_t *size);
+
+/**
+ * @brief Returns the bytes of the value of the item pointed by the iterator.
+ * @param[in] it - iterator
+ * @param[out] size - size of the value. It may be NULL.
+ * @return pointer to the bytes of the value in the snapshot.
+ */
+const void *cdc_hash_snapshot_iter_value(struct cdc_hash_snapshot_iter *it,
+                                         size_t *size);
+
+/**
+ * @brief Returns false if the iterator |it1| equal to the iterator |it2|,
+ * otherwise returns false.
+ * @param[in] it1 - iterator
+ * @param[in] it2 - iterator
+ * @return false if the iterator |it1| equal to the iterator |it2|,
+ * otherwise returns false.
+ */
+static inline bool cdc_hash_snapshot_iter_is_eq(
+    struct cdc_hash_snapshot_iter *it1, struct cdc_hash_snapshot_iter *it2)
+{
+  assert(it1 != NULL);
+  assert(it2 != NULL);
+
+  return it1->container == it2->container && it1->current == it2->current;
+}
+/** @} */
+
+// Short names
+#ifdef CDC_USE_SHORT_NAMES
+typedef struct cdc_hash_snapshot hash_snapshot_t;
+typedef struct cdc_hash_snapshot_iter hash_snapshot_iter_t;
+typedef struct cdc_hash_snapshot_codec hash_snapshot_codec_t;
+
+// Writer
+#define hash_snapshot_write(...) cdc_hash_snapshot_write(__VA_ARGS__)
+
+// Base
+#define hash_snapshot_ctor(...) cdc_hash_snapshot_ctor(__VA_ARGS__)
+#define hash_snapshot_dtor(...) cdc_hash_snapshot_dtor(__VA_ARGS__)
+
+// Lookup
+#define hash_snapshot_get(...) cdc_hash_snapshot_get(__VA_ARGS__)
+#define hash_snapshot_count(...) cdc_hash_snapshot_count(__VA_ARGS__)
+#define hash_snapshot_find(...) cdc_hash_snapshot_find(__VA_ARGS__)
+
+// Capacity
+#define hash_snapshot_size(...) cdc_hash_snapshot_size(__VA_ARGS__)
+#define hash_snapshot_empty(...) cdc_hash_snapshot_empty(__VA_ARGS__)
+
+// Iterators
+#define hash_snapshot_begin(...) cdc_hash_snapshot_begin(__VA_ARGS__)
+#define hash_snapshot_end(...) cdc_hash_snapshot_end(__VA_ARGS__)
+
+// Iterators
+#define hash_snapshot_iter_next(...) cdc_hash_snapshot_iter_next(__VA_ARGS__)
+#define hash_snapshot_iter_has_next(...) \
+  cdc_hash_snapshot_iter_has_next(__VA_ARGS__)
+#define hash_snapshot_iter_key(...) cdc_hash_snapshot_iter_key(__VA_ARGS__)
+#define hash_snapshot_iter_value(...) cdc_hash_snapshot_iter_value(__VA_ARGS__)
+#define hash_snapshot_iter_is_eq(...) cdc_hash_snapshot_iter_is_eq(__VA_ARGS__)
+#endif
+/** @} */
+#endif  // CDCONTAINERS_INCLUDE_CDCONTAINERS_HASH_SNAPSHOT_H
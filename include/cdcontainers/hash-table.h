@@ -28,6 +28,7 @@
 
 #include <cdcontainers/common.h>
 #include <cdcontainers/hash.h>
+#include <cdcontainers/node-pool.h>
 #include <cdcontainers/status.h>
 
 #include <assert.h>
@@ -52,6 +53,19 @@ struct cdc_hash_table_entry {
   size_t hash;
 };
 
+/**
+ * @brief The cdc_hash_table_counters struct holds the counters of a hash
+ * table. They are updated only if the library is built with
+ * CDC_HASH_TABLE_STATS, otherwise they stay zero. Lookups update them
+ * atomically, so several threads can look up in a table at the same time.
+ */
+struct cdc_hash_table_counters {
+  size_t rehashes;
+  double rehash_time;
+  size_t lookups;
+  size_t probes;
+};
+
 /**
  * @brief The cdc_hash_table is service struct.
  * @warning To avoid problems, do not change the structure fields in the code.
@@ -64,6 +78,14 @@ struct cdc_hash_table {
   float load_factor;
   size_t size;
   struct cdc_data_info *dinfo;
+  struct cdc_hash_table_entry *old_tail;
+  struct cdc_hash_table_entry **old_buckets;
+  size_t old_bcount;
+  size_t rehash_step;
+  size_t seed;
+  struct cdc_hash_table_counters counters;
+  struct cdc_node_pool pool;
+  size_t bulk_threads;
 };
 
 /**
@@ -75,6 +97,39 @@ struct cdc_hash_table_iter {
   struct cdc_hash_table *container;
   struct cdc_hash_table_entry *current;
 };
+
+#define CDC_HASH_TABLE_STATS_CHAINS 8
+
+/**
+ * @brief The cdc_hash_table_stats struct describes the state of a hash table.
+ * Counters of operations are zero if the library is built without
+ * CDC_HASH_TABLE_STATS.
+ */
+struct cdc_hash_table_stats {
+  /** @brief Number of elements. */
+  size_t size;
+  /** @brief Number of buckets, including the old array of a rehash. */
+  size_t bucket_count;
+  /** @brief Number of non-empty buckets. */
+  size_t used_buckets;
+  /** @brief Length of the longest chain. */
+  size_t max_chain;
+  /**
+   * @brief chains[i] is the number of buckets with i elements. The last item
+   * counts all longer chains.
+   */
+  size_t chains[CDC_HASH_TABLE_STATS_CHAINS];
+  /** @brief Number of rehashes. */
+  size_t rehashes;
+  /** @brief Processor time spent in rehashes, in seconds. */
+  double rehash_time;
+  /** @brief Number of lookups, including insertions and erasures. */
+  size_t lookups;
+  /** @brief Number of keys compared by all lookups. */
+  size_t probes;
+  /** @brief probes / lookups. */
+  double avg_probe_length;
+};
 // Base
 /**
  * @defgroup cdc_hash_table_base Base
@@ -82,6 +137,9 @@ struct cdc_hash_table_iter {
  */
 /**
  * @brief Constructs an empty hash table.
+ *
+ * If info->pool_chunk is not 0, the entries of the table are allocated from a
+ * node pool and are released by chunks on clear and destruction.
  * @param[out] t - cdc_hash_table
  * @param[in] info - cdc_data_info
  * @return CDC_STATUS_OK in a successful case or other value indicating
@@ -90,6 +148,22 @@ struct cdc_hash_table_iter {
 enum cdc_stat cdc_hash_table_ctor(struct cdc_hash_table **t,
                                   struct cdc_data_info *info);
 
+/**
+ * @brief Constructs a hash table from the arrays of keys and values. It is
+ * the same as cdc_hash_table_ctor followed by cdc_hash_table_insert_range, so
+ * the entries are allocated in one block.
+ * @param[out] t - cdc_hash_table
+ * @param[in] info - cdc_data_info
+ * @param[in] keys - array of n keys
+ * @param[in] values - array of n values
+ * @param[in] n - number of pairs
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_table_ctor_from(struct cdc_hash_table **t,
+                                       struct cdc_data_info *info,
+                                       void **keys, void **values, size_t n);
+
 /**
  * @brief Constructs a hash table, initialized by an variable number of
  * pointers on cdc_pair's(first - key, and the second - value).  The last item
@@ -186,6 +260,35 @@ void cdc_hash_table_dtor(struct cdc_hash_table *t);
 enum cdc_stat cdc_hash_table_get(struct cdc_hash_table *t, void *key,
                                  void **value);
 
+/**
+ * @brief Same as cdc_hash_table_get, but takes the hash of the key computed by
+ * the caller.
+ * @param[in] t - cdc_hash_table
+ * @param[in] key - key of the element to find
+ * @param[in] hash - hash of the key. It must be equal to the value that the
+ * hash function of the table returns for the key.
+ * @param[out] value - pinter to the value that is mapped to a key.
+ * @return CDC_STATUS_OK if the key is found, CDC_STATUS_NOT_FOUND otherwise.
+ */
+enum cdc_stat cdc_hash_table_get_hashed(struct cdc_hash_table *t, void *key,
+                                        size_t hash, void **value);
+
+/**
+ * @brief Looks up n keys at once. Loads of buckets and entries of different
+ * keys are issued together, so their cache misses overlap. It is faster than n
+ * calls of cdc_hash_table_get for large tables.
+ * @param[in] t - cdc_hash_table
+ * @param[in] keys - array of n keys
+ * @param[in] n - number of keys
+ * @param[out] values - array of n values. The value of a key that is not found
+ * is set to NULL.
+ * @param[out] found - array of n flags, found[i] is true if keys[i] is found.
+ * The pointer can be equal to NULL.
+ * @return number of found keys.
+ */
+size_t cdc_hash_table_get_many(struct cdc_hash_table *t, void **keys,
+                               size_t n, void **values, bool *found);
+
 /**
  * @brief Returns the number of elements with key that compares equal to the
  * specified argument key, which is either 1 or 0 since this container does not
@@ -206,6 +309,20 @@ size_t cdc_hash_table_count(struct cdc_hash_table *t, void *key);
  */
 void cdc_hash_table_find(struct cdc_hash_table *t, void *key,
                          struct cdc_hash_table_iter *it);
+
+/**
+ * @brief Same as cdc_hash_table_find, but takes the hash of the key computed
+ * by the caller.
+ * @param[in] t - cdc_hash_table
+ * @param[in] key - key value of the element to search for
+ * @param[in] hash - hash of the key. It must be equal to the value that the
+ * hash function of the table returns for the key.
+ * @param[out] it - pointer will be recorded iterator to an element with key
+ * equivalent to key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_hash_table_find_hashed(struct cdc_hash_table *t, void *key,
+                                size_t hash, struct cdc_hash_table_iter *it);
 /** @} */
 
 // Capacity
@@ -265,6 +382,26 @@ enum cdc_stat cdc_hash_table_insert(struct cdc_hash_table *t, void *key,
                                     void *value, struct cdc_hash_table_iter *it,
                                     bool *inserted);
 
+/**
+ * @brief Same as cdc_hash_table_insert, but takes the hash of the key computed
+ * by the caller.
+ * @param[in] t - cdc_hash_table
+ * @param[in] key - key of the element
+ * @param[in] hash - hash of the key. It must be equal to the value that the
+ * hash function of the table returns for the key.
+ * @param[in] value - value of the element
+ * @param[out] it - iterator to the inserted element or to the element that
+ * prevented the insertion. The pointer can be equal to NULL.
+ * @param[out] inserted - true if the insertion took place. The pointer can be
+ * equal to NULL.
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_table_insert_hashed(struct cdc_hash_table *t, void *key,
+                                           size_t hash, void *value,
+                                           struct cdc_hash_table_iter *it,
+                                           bool *inserted);
+
 /**
  * @brief Inserts an element or assigns to the current element if the key
  * already exists.
@@ -282,6 +419,46 @@ enum cdc_stat cdc_hash_table_insert_or_assign(struct cdc_hash_table *t,
                                               struct cdc_hash_table_iter *it,
                                               bool *inserted);
 
+/**
+ * @brief Same as cdc_hash_table_insert_or_assign, but takes the hash of the
+ * key computed by the caller.
+ * @param[in] t - cdc_hash_table
+ * @param[in] key - key of the element
+ * @param[in] hash - hash of the key. It must be equal to the value that the
+ * hash function of the table returns for the key.
+ * @param[in] value - value of the element
+ * @param[out] it - iterator to the inserted or updated element. The pointer
+ * can be equal to NULL.
+ * @param[out] inserted - true if the insertion took place and false if the
+ * assignment took place. The pointer can be equal to NULL.
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_table_insert_or_assign_hashed(
+    struct cdc_hash_table *t, void *key, size_t hash, void *value,
+    struct cdc_hash_table_iter *it, bool *inserted);
+
+/**
+ * @brief Inserts n pairs at once. If a key is already in the container or it
+ * repeats in the array, the pair is not inserted, like in
+ * cdc_hash_table_insert.
+ *
+ * The bucket array is sized once for all the pairs and the keys are hashed in
+ * a separate loop before they are linked into the table. If the table is
+ * empty or uses a node pool, all the entries are allocated in one block and
+ * the table keeps using the node pool afterwards; in this case the pairs are
+ * inserted all or none. Otherwise they are inserted one by one.
+ * @param[in] t - cdc_hash_table
+ * @param[in] keys - array of n keys
+ * @param[in] values - array of n values
+ * @param[in] n - number of pairs
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_table_insert_range(struct cdc_hash_table *t,
+                                          void **keys, void **values,
+                                          size_t n);
+
 /**
  * @brief Removes the element (if one exists) with the key equivalent to key.
  * @param[in] t - cdc_hash_table
@@ -290,6 +467,43 @@ enum cdc_stat cdc_hash_table_insert_or_assign(struct cdc_hash_table *t,
  */
 size_t cdc_hash_table_erase(struct cdc_hash_table *t, void *key);
 
+/**
+ * @brief Same as cdc_hash_table_erase, but takes the hash of the key computed
+ * by the caller.
+ * @param[in] t - cdc_hash_table
+ * @param[in] key - key value of the elements to remove
+ * @param[in] hash - hash of the key. It must be equal to the value that the
+ * hash function of the table returns for the key.
+ * @return number of elements removed.
+ */
+size_t cdc_hash_table_erase_hashed(struct cdc_hash_table *t, void *key,
+                                   size_t hash);
+
+/**
+ * @brief Visits a part of the table, starting from the cursor, and returns
+ * the cursor of the next part. A scan starts with the cursor 0 and ends when
+ * 0 is returned again. Between the calls the table can be changed in any
+ * way, including rehashes. Every element that is in the table for the whole
+ * scan is visited at least once; an element can be visited more than once if
+ * the table grows during the scan.
+ *
+ * The cursor enumerates buckets with reversed bits, so a cursor of a smaller
+ * bucket array covers all the buckets of a bigger one that its entries are
+ * moved to, and vice versa.
+ * @param[in] t - cdc_hash_table
+ * @param[in] cursor - cursor returned by the previous call or 0
+ * @param[in] cb - function called for every visited pair with the ctx. If it
+ * returns true, the pair is erased. It must not change the table in another
+ * way.
+ * @param[in] ctx - argument for cb
+ * @param[in] budget - the call stops after it visits at least budget
+ * elements or budget * 10 empty buckets. At least one bucket is visited.
+ * @return cursor for the next call or 0 if the scan is finished.
+ */
+size_t cdc_hash_table_scan(struct cdc_hash_table *t, size_t cursor,
+                           bool (*cb)(void *key, void *value, void *ctx),
+                           void *ctx, size_t budget);
+
 /**
  * @brief Swaps hash_tables a and b. This operation is very fast and never fails.
  * @param[in, out] a - cdc_hash_table
@@ -316,6 +530,9 @@ static inline void cdc_hash_table_begin(struct cdc_hash_table *t,
 
   it->container = t;
   it->current = t->buckets[0]->next;
+  if (!it->current && t->old_buckets) {
+    it->current = t->old_buckets[0]->next;
+  }
 }
 
 /**
@@ -376,9 +593,67 @@ static inline void cdc_hash_table_set_max_load_factor(struct cdc_hash_table *t,
   t->load_factor = load_factor;
 }
 
+/**
+ * @brief Sets the number of entries moved from the old bucket array to the new
+ * one by each insertion while the table is growing. If the step is 0 (the
+ * default), the table moves all entries at once when it grows. Otherwise the
+ * old and the new bucket arrays live together until all entries are moved,
+ * and lookups search both of them.
+ * @param[in] t - cdc_hash_table
+ * @param[in] step - number of entries moved per insertion
+ */
+static inline void cdc_hash_table_set_rehash_step(struct cdc_hash_table *t,
+                                                  size_t step)
+{
+  assert(t != NULL);
+
+  t->rehash_step = step;
+}
+
+/**
+ * @brief Sets the number of threads that hash the keys in
+ * cdc_hash_table_insert_range. The work is split only for large arrays and
+ * only if the entries are allocated in one block. The hash function of the
+ * table must be safe to call from several threads. The default is 1.
+ * @param[in] t - cdc_hash_table
+ * @param[in] count - number of threads
+ */
+static inline void cdc_hash_table_set_bulk_threads(struct cdc_hash_table *t,
+                                                   size_t count)
+{
+  assert(t != NULL);
+
+  t->bulk_threads = count;
+}
+
+/**
+ * @brief Returns true if entries are being moved to a new bucket array,
+ * otherwise returns false.
+ * @param[in] t - cdc_hash_table
+ * @return true if entries are being moved to a new bucket array, otherwise
+ * returns false.
+ */
+static inline bool cdc_hash_table_is_rehashing(struct cdc_hash_table *t)
+{
+  assert(t != NULL);
+
+  return t->old_buckets != NULL;
+}
+
+/**
+ * @brief Sets the seed that is mixed into the hashes of keys. A random seed,
+ * e.g. cdc_hash_random_seed(), makes bucket collisions unpredictable. This
+ * regenerates the hash table. The default seed is 0.
+ * @param[in] t - cdc_hash_table
+ * @param[in] seed - new seed
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_hash_table_set_seed(struct cdc_hash_table *t, size_t seed);
+
 /**
  * @brief Reserves at least the specified number of buckets. This regenerates
- * the hash table.
+ * the hash table. An incremental rehash in progress is finished first.
  * @param[in] t - cdc_hash_table
  * @param[in] count - new number of buckets
  * @return CDC_STATUS_OK in a successful case or other value indicating
@@ -415,6 +690,26 @@ static inline size_t cdc_hash_table_bucket_count(struct cdc_hash_table *t)
 }
 /** @} */
 
+// Statistics
+/**
+ * @defgroup cdc_hash_table_statistics Statistics
+ * @{
+ */
+/**
+ * @brief Fills stats. It walks all elements, so it takes linear time.
+ * @param[in] t - cdc_hash_table
+ * @param[out] stats - cdc_hash_table_stats
+ */
+void cdc_hash_table_stats(struct cdc_hash_table *t,
+                          struct cdc_hash_table_stats *stats);
+
+/**
+ * @brief Resets the counters of rehashes and lookups.
+ * @param[in] t - cdc_hash_table
+ */
+void cdc_hash_table_reset_stats(struct cdc_hash_table *t);
+/** @} */
+
 // Iterators
 /**
  * @defgroup cdc_hash_table_iter
@@ -429,7 +724,14 @@ static inline void cdc_hash_table_iter_next(struct cdc_hash_table_iter *it)
 {
   assert(it != NULL);
 
-  it->current = it->current->next;
+  struct cdc_hash_table *t = it->container;
+  struct cdc_hash_table_entry *next = it->current->next;
+  // The entries of the old bucket array follow the entries of the new one.
+  if (!next && t->old_buckets && it->current == t->tail) {
+    next = t->old_buckets[0]->next;
+  }
+
+  it->current = next;
 }
 
 /**
@@ -506,6 +808,7 @@ static inline bool cdc_hash_table_iter_is_eq(struct cdc_hash_table_iter *it1,
 #ifdef CDC_USE_SHORT_NAMES
 typedef struct cdc_hash_table hash_table_t;
 typedef struct cdc_hash_table_iter hash_table_iter_t;
+typedef struct cdc_hash_table_stats hash_table_stats_t;
 typedef struct cdc_pair_hash_table_iter pair_hash_table_iter_t;
 typedef struct cdc_pair_hash_table_iter_bool pair_hash_table_iter_bool_t;
 
@@ -516,12 +819,16 @@ typedef struct cdc_pair_hash_table_iter_bool pair_hash_table_iter_bool_t;
 #define hash_table_ctor1(...) cdc_hash_table_ctor1(__VA_ARGS__)
 #define hash_table_ctorl1(...) cdc_hash_table_ctorl1(__VA_ARGS__)
 #define hash_table_ctorv1(...) cdc_hash_table_ctorv1(__VA_ARGS__)
+#define hash_table_ctor_from(...) cdc_hash_table_ctor_from(__VA_ARGS__)
 #define hash_table_dtor(...) cdc_hash_table_dtor(__VA_ARGS__)
 
 // Lookup
 #define hash_table_get(...) cdc_hash_table_get(__VA_ARGS__)
 #define hash_table_count(...) cdc_hash_table_count(__VA_ARGS__)
 #define hash_table_find(...) cdc_hash_table_find(__VA_ARGS__)
+#define hash_table_get_hashed(...) cdc_hash_table_get_hashed(__VA_ARGS__)
+#define hash_table_get_many(...) cdc_hash_table_get_many(__VA_ARGS__)
+#define hash_table_find_hashed(...) cdc_hash_table_find_hashed(__VA_ARGS__)
 
 // Capacity
 #define hash_table_size(...) cdc_hash_table_size(__VA_ARGS__)
@@ -533,6 +840,12 @@ typedef struct cdc_pair_hash_table_iter_bool pair_hash_table_iter_bool_t;
 #define hash_table_insert_or_assign(...) \
   cdc_hash_table_insert_or_assign(__VA_ARGS__)
 #define hash_table_erase(...) cdc_hash_table_erase(__VA_ARGS__)
+#define hash_table_insert_range(...) cdc_hash_table_insert_range(__VA_ARGS__)
+#define hash_table_scan(...) cdc_hash_table_scan(__VA_ARGS__)
+#define hash_table_insert_hashed(...) cdc_hash_table_insert_hashed(__VA_ARGS__)
+#define hash_table_insert_or_assign_hashed(...) \
+  cdc_hash_table_insert_or_assign_hashed(__VA_ARGS__)
+#define hash_table_erase_hashed(...) cdc_hash_table_erase_hashed(__VA_ARGS__)
 #define hash_table_swap(...) cdc_hash_table_swap(__VA_ARGS__)
 
 // Iterators
@@ -545,12 +858,22 @@ typedef struct cdc_pair_hash_table_iter_bool pair_hash_table_iter_bool_t;
   cdc_hash_table_max_load_factor(__VA_ARGS__)
 #define hash_table_set_max_load_factor(...) \
   cdc_hash_table_set_max_load_factor(__VA_ARGS__)
+#define hash_table_set_rehash_step(...) \
+  cdc_hash_table_set_rehash_step(__VA_ARGS__)
+#define hash_table_set_bulk_threads(...) \
+  cdc_hash_table_set_bulk_threads(__VA_ARGS__)
+#define hash_table_is_rehashing(...) cdc_hash_table_is_rehashing(__VA_ARGS__)
+#define hash_table_set_seed(...) cdc_hash_table_set_seed(__VA_ARGS__)
 #define hash_table_rehash(...) cdc_hash_table_rehash(__VA_ARGS__)
 #define hash_table_reserve(...) cdc_hash_table_reserve(__VA_ARGS__)
 
 // Bucket interface
 #define hash_table_bucket_count(...) cdc_hash_table_bucket_count(__VA_ARGS__)
 
+// Statistics
+#define hash_table_stats(...) cdc_hash_table_stats(__VA_ARGS__)
+#define hash_table_reset_stats(...) cdc_hash_table_reset_stats(__VA_ARGS__)
+
 // Iterators
 #define hash_table_iter_next(...) cdc_hash_table_iter_next(__VA_ARGS__)
 #define hash_table_iter_has_next(...) cdc_hash_table_iter_has_next(__VA_ARGS__)
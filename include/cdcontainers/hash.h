@@ -25,6 +25,8 @@
  * The ideas of algorithms were borrowed from the boost library.
  * http://www.boost.org/doc/libs/1_64_0/boost/functional/hash/hash.hpp
  * http://www.boost.org/doc/libs/1_64_0/boost/functional/hash/detail/hash_float.hpp
+ * The integer finalizer is the one of splitmix64, the byte hash follows
+ * wyhash (https://github.com/wangyi-fudan/wyhash).
  */
 #ifndef CDCONTAINERS_INCLUDE_CDCONTAINERS_HASH_H
 #define CDCONTAINERS_INCLUDE_CDCONTAINERS_HASH_H
@@ -33,6 +35,7 @@
 #include <float.h>
 #include <limits.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <string.h>
 
 typedef size_t (*cdc_hash_fn_t)(void const *);
@@ -81,6 +84,10 @@ static inline size_t cdc_hash_float_combine(size_t seed, size_t value)
   return seed;
 }
 
+/**
+ * @brief Hashes a memory block. It combines the memory block by machine words,
+ * so the result is poorly mixed. Prefer cdc_hash_bytes for new code.
+ */
 static inline size_t cdc_hash_binary(char *ptr, size_t length)
 {
   size_t seed = 0;
@@ -160,4 +167,50 @@ MAKE_POINTER_DATA_HASH(float, float, CDC_TO_FLOAT)
 MAKE_POINTER_DATA_HASH(double, double, CDC_TO_DOUBLE)
 #endif
 
+/**
+ * @brief Mixes all bits of a 64-bit integer, so that every input bit affects
+ * every output bit. Use it to finalize weak hashes, e.g. ones of sequential or
+ * aligned integers, before the low bits are taken as a bucket index.
+ * @param[in] val - value
+ * @return hash value.
+ */
+static inline size_t cdc_hash_u64(uint64_t val)
+{
+  val ^= val >> 30;
+  val *= UINT64_C(0xbf58476d1ce4e5b9);
+  val ^= val >> 27;
+  val *= UINT64_C(0x94d049bb133111eb);
+  val ^= val >> 31;
+  return (size_t)val;
+}
+
+/**
+ * @brief Hashes a memory block with a seed. The function processes 48 bytes
+ * per step and is well mixed. Results depend on the byte order of the machine.
+ * @param[in] data - memory block
+ * @param[in] length - length of the memory block in bytes
+ * @param[in] seed - seed. Different seeds give independent hash functions.
+ * @return hash value.
+ */
+size_t cdc_hash_bytes(const void *data, size_t length, uint64_t seed);
+
+/**
+ * @brief Hashes a null-terminated string.
+ * @param[in] str - string
+ * @return hash value.
+ */
+static inline size_t cdc_hash_str(const char *str)
+{
+  return cdc_hash_bytes(str, strlen(str), 0);
+}
+
+/**
+ * @brief Returns a seed built from the time, the clock and addresses of the
+ * process. It makes hash values unpredictable for an attacker who does not
+ * have access to the process, but it is not cryptographically secure. It is
+ * thread-safe.
+ * @return seed.
+ */
+uint64_t cdc_hash_random_seed(void);
+
 #endif  // CDCONTAINERS_INCLUDE_CDCONTAINERS_HASH_H
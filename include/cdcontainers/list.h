@@ -28,6 +28,7 @@
 #define CDCONTAINERS_INCLUDE_CDCONTAINERS_LIST_H
 
 #include <cdcontainers/common.h>
+#include <cdcontainers/node-pool.h>
 #include <cdcontainers/status.h>
 
 #include <assert.h>
@@ -62,6 +63,7 @@ struct cdc_list {
   struct cdc_list_node *tail;
   size_t size;
   struct cdc_data_info *dinfo;
+  struct cdc_node_pool pool;
 };
 
 /**
@@ -106,6 +108,9 @@ struct cdc_list_riter {
  */
 /**
  * @brief Constructs an empty list.
+ *
+ * If info->pool_chunk is not 0, the nodes of the list are allocated from a
+ * node pool and cdc_list_clear and cdc_list_dtor release the memory by chunks.
  * @param[out] l - cdc_list
  * @param[in] info - cdc_data_info
  * @return CDC_STATUS_OK in a successful case or other value indicating
@@ -332,6 +337,9 @@ void cdc_list_swap(struct cdc_list *a, struct cdc_list *b);
 /**
  * @brief Transfers elements from one container, iterators (first, last] to
  * another container at position before iterator position.
+ *
+ * Elements can't be transferred between different lists if one of them uses
+ * a node pool. Such a call terminates the program.
  * @param[in] position - iterator before which the content will be inserted
  * @param[in] first, last - range of elements to transfer from other
  */
@@ -349,7 +357,9 @@ void cdc_list_ssplice(struct cdc_list_iter *position,
 
 /**
  * @brief Transfers all elements from container other to another container at
- * position before iterator position.
+ * position before iterator position. If both lists use a node pool, the
+ * memory of other is moved too. Either both lists or none of them must use a
+ * node pool, otherwise the call terminates the program.
  * @param[in] position - iterator before which the content will be inserted
  * @param[im] other - cdc_list
  */
@@ -357,14 +367,20 @@ void cdc_list_lsplice(struct cdc_list_iter *position, struct cdc_list *other);
 
 /**
  * @brief Merges two sorted lists into one. The lists should be sorted into
- * ascending order.
+ * ascending order. If both lists use a node pool, the memory of other is
+ * moved too. Either both lists or none of them must use a node pool,
+ * otherwise the call terminates the program. The order is given by cmp3 of
+ * the data info if it is set, by cmp otherwise.
  * @param[in] l - cdc_list
  * @param[in] other - another cdc_list to merge
  */
 void cdc_list_merge(struct cdc_list *l, struct cdc_list *other);
 
 /**
- * @brief Merges two sorted lists into one. The lists should be sorted.
+ * @brief Merges two sorted lists into one. The lists should be sorted. If both
+ * lists use a node pool, the memory of other is moved too. Either both lists
+ * or none of them must use a node pool, otherwise the call terminates the
+ * program.
  * @param[in] l - cdc_list
  * @param[in] other - another cdc_list to merge
  * @param[in] compare - comparison function
@@ -403,7 +419,8 @@ void cdc_list_unique(struct cdc_list *l);
 void cdc_list_punique(struct cdc_list *l, cdc_binary_pred_fn_t pred);
 
 /**
- * @brief Sorts elements in ascending order.
+ * @brief Sorts elements in ascending order. The order is given by cmp3 of the
+ * data info if it is set, by cmp otherwise.
  * @param[in] l - cdc_list
  */
 void cdc_list_sort(struct cdc_list *l);
@@ -0,0 +1,145 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+/**
+ * @file
+ * @brief The cdc_node_pool is a struct and functions that provide a pool of
+ * fixed-size container nodes.
+ *
+ * Nodes are carved from big chunks and recycled through a free list. All
+ * chunks are released at once, without visiting the nodes.
+ */
+#ifndef CDCONTAINERS_INCLUDE_CDCONTAINERS_NODE_POOL_H
+#define CDCONTAINERS_INCLUDE_CDCONTAINERS_NODE_POOL_H
+
+#include <cdcontainers/common.h>
+#include <cdcontainers/status.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief The cdc_node_pool is service struct.
+ * @warning To avoid problems, do not change the structure fields in the code.
+ * Use only special functions to access and change structure fields.
+ */
+struct cdc_node_pool {
+  void *chunks;
+  void *free_nodes;
+  char *next;
+  char *end;
+  size_t node_size;
+  size_t chunk_size;
+};
+
+/**
+ * @brief Initializes a pool of nodes of node_size bytes. If chunk_size is 0,
+ * the pool is disabled.
+ * @param p - cdc_node_pool
+ * @param node_size - size of one node
+ * @param chunk_size - number of nodes in one chunk
+ */
+void cdc_node_pool_init(struct cdc_node_pool *p, size_t node_size,
+                        size_t chunk_size);
+
+/**
+ * @brief Allocates a new chunk of nodes.
+ * @param p - cdc_node_pool
+ * @param dinfo - cdc_data_info with the allocator of the chunks
+ * @return CDC_STATUS_OK in a successful case or other value indicating
+ * an error.
+ */
+enum cdc_stat cdc_node_pool_grow(struct cdc_node_pool *p,
+                                 struct cdc_data_info *dinfo);
+
+/**
+ * @brief Allocates count consecutive nodes. They are taken from the current
+ * chunk if it has enough room, otherwise from a new chunk of exactly count
+ * nodes. The nodes can be returned to the pool one by one.
+ * @param p - cdc_node_pool
+ * @param dinfo - cdc_data_info with the allocator of the chunks
+ * @param count - number of nodes
+ * @return pointer to the first node or NULL if there is not enough memory.
+ */
+void *cdc_node_pool_alloc_block(struct cdc_node_pool *p,
+                                struct cdc_data_info *dinfo, size_t count);
+
+/**
+ * @brief Frees all chunks of the pool. All nodes become invalid.
+ * @param p - cdc_node_pool
+ * @param dinfo - cdc_data_info with the allocator of the chunks
+ */
+void cdc_node_pool_release(struct cdc_node_pool *p,
+                           struct cdc_data_info *dinfo);
+
+/**
+ * @brief Moves all chunks of the pool src to the pool dst. The nodes of src
+ * become owned by dst, and its free nodes are added to the free nodes of dst.
+ * The pools must have the same node size and allocator.
+ * @param dst - cdc_node_pool
+ * @param src - cdc_node_pool
+ */
+void cdc_node_pool_merge(struct cdc_node_pool *dst, struct cdc_node_pool *src);
+
+/**
+ * @brief Returns true if the pool is enabled.
+ * @param p - cdc_node_pool
+ */
+static inline bool cdc_node_pool_enabled(struct cdc_node_pool *p)
+{
+  return p->chunk_size != 0;
+}
+
+/**
+ * @brief Allocates a node from the pool.
+ * @param p - cdc_node_pool
+ * @param dinfo - cdc_data_info with the allocator of the chunks
+ * @return pointer to the node or NULL if the memory cannot be allocated.
+ */
+static inline void *cdc_node_pool_alloc(struct cdc_node_pool *p,
+                                        struct cdc_data_info *dinfo)
+{
+  void *node = p->free_nodes;
+  if (node) {
+    p->free_nodes = *(void **)node;
+    return node;
+  }
+
+  if (p->next == p->end && cdc_node_pool_grow(p, dinfo) != CDC_STATUS_OK) {
+    return NULL;
+  }
+
+  node = p->next;
+  p->next += p->node_size;
+  return node;
+}
+
+/**
+ * @brief Returns the node to the pool.
+ * @param p - cdc_node_pool
+ * @param node - node allocated by cdc_node_pool_alloc
+ */
+static inline void cdc_node_pool_free(struct cdc_node_pool *p, void *node)
+{
+  *(void **)node = p->free_nodes;
+  p->free_nodes = node;
+}
+
+#endif  // CDCONTAINERS_INCLUDE_CDCONTAINERS_NODE_POOL_H
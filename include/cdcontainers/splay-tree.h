@@ -27,6 +27,7 @@
 #define CDCONTAINERS_INCLUDE_CDCONTAINERS_SPLAY_TREE_H
 
 #include <cdcontainers/common.h>
+#include <cdcontainers/node-pool.h>
 #include <cdcontainers/status.h>
 
 #include <assert.h>
@@ -60,6 +61,9 @@ struct cdc_splay_tree {
   struct cdc_splay_tree_node *root;
   size_t size;
   struct cdc_data_info *dinfo;
+  struct cdc_node_pool pool;
+  size_t splay_period;
+  size_t lookups;
 };
 
 /**
@@ -73,6 +77,11 @@ struct cdc_splay_tree_iter {
   struct cdc_splay_tree_node *current;
 };
 
+struct cdc_pair_splay_tree_iter {
+  struct cdc_splay_tree_iter first;
+  struct cdc_splay_tree_iter second;
+};
+
 struct cdc_pair_splay_tree_iter_bool {
   struct cdc_splay_tree_iter first;
   bool second;
@@ -85,6 +94,9 @@ struct cdc_pair_splay_tree_iter_bool {
  */
 /**
  * @brief Constructs an empty splay tree.
+ *
+ * If info->pool_chunk is not 0, the nodes of the tree are allocated from a
+ * node pool and are released by chunks on clear and destruction.
  * @param[out] t - cdc_splay_tree
  * @param[in] info - cdc_data_info
  * @return CDC_STATUS_OK in a successful case or other value indicating
@@ -141,7 +153,8 @@ void cdc_splay_tree_dtor(struct cdc_splay_tree *t);
  */
 /**
  * @brief Returns a value that is mapped to a key. If the key does
- * not exist, then NULL will return.
+ * not exist, then NULL will return. The found element is splayed to the root
+ * according to the splay period.
  * @param[in] t - cdc_splay_tree
  * @param[in] key - key of the element to find
  * @param[out] value - pinter to the value that is mapped to a key.
@@ -153,7 +166,8 @@ enum cdc_stat cdc_splay_tree_get(struct cdc_splay_tree *t, void *key,
 /**
  * @brief Returns the number of elements with key that compares equal to the
  * specified argument key, which is either 1 or 0 since this container does not
- * allow duplicates.
+ * allow duplicates. The found element is splayed to the root according to the
+ * splay period.
  * @param[in] t - cdc_splay_tree
  * @param[in] key - key value of the elements to count
  * @return number of elements with key key, that is either 1 or 0.
@@ -161,7 +175,8 @@ enum cdc_stat cdc_splay_tree_get(struct cdc_splay_tree *t, void *key,
 size_t cdc_splay_tree_count(struct cdc_splay_tree *t, void *key);
 
 /**
- * @brief Finds an element with key equivalent to key.
+ * @brief Finds an element with key equivalent to key. The found element is
+ * splayed to the root according to the splay period.
  * @param[in] t - cdc_splay_tree
  * @param[in] key - key value of the element to search for
  * @param[out] it - pointer will be recorded iterator to an element with key
@@ -170,6 +185,87 @@ size_t cdc_splay_tree_count(struct cdc_splay_tree *t, void *key);
  */
 void cdc_splay_tree_find(struct cdc_splay_tree *t, void *key,
                          struct cdc_splay_tree_iter *it);
+
+/**
+ * @brief Returns a value that is mapped to a key without changing the tree.
+ * Several threads can call it at the same time if no thread changes the tree.
+ * @param[in] t - cdc_splay_tree
+ * @param[in] key - key of the element to find
+ * @param[out] value - pointer to the value that is mapped to a key.
+ * @return CDC_STATUS_OK if the key is found, CDC_STATUS_NOT_FOUND otherwise.
+ */
+enum cdc_stat cdc_splay_tree_peek(struct cdc_splay_tree *t, void *key,
+                                  void **value);
+
+/**
+ * @brief Finds an element with key equivalent to key without changing the
+ * tree. Several threads can call it at the same time if no thread changes the
+ * tree.
+ * @param[in] t - cdc_splay_tree
+ * @param[in] key - key value of the element to search for
+ * @param[out] it - pointer will be recorded iterator to an element with key
+ * equivalent to key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_splay_tree_peek_find(struct cdc_splay_tree *t, void *key,
+                              struct cdc_splay_tree_iter *it);
+
+/**
+ * @brief Sets how often the lookups (get, count, find and the bounds) splay
+ * the found element to the root: every period-th lookup does it. The inserts
+ * and the erases always splay. With period 0 the lookups never change the
+ * tree, so the threads can share it for reading under a reader lock. The
+ * default period is 1, i.e. every lookup splays.
+ * @param[in] t - cdc_splay_tree
+ * @param[in] period - number of lookups per splay or 0
+ */
+static inline void cdc_splay_tree_set_splay_period(struct cdc_splay_tree *t,
+                                                   size_t period)
+{
+  assert(t != NULL);
+
+  t->splay_period = period;
+  t->lookups = 0;
+}
+
+/**
+ * @brief Finds the first element with key not less than key. The complexity
+ * is amortized O(log n). The found element is splayed to the root according
+ * to the splay period.
+ * @param[in] t - cdc_splay_tree
+ * @param[in] key - key value to compare the elements to
+ * @param[out] it - pointer will be recorded iterator to the first element with
+ * key not less than key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_splay_tree_lower_bound(struct cdc_splay_tree *t, void *key,
+                                struct cdc_splay_tree_iter *it);
+
+/**
+ * @brief Finds the first element with key greater than key. The complexity
+ * is amortized O(log n). The found element is splayed to the root according
+ * to the splay period.
+ * @param[in] t - cdc_splay_tree
+ * @param[in] key - key value to compare the elements to
+ * @param[out] it - pointer will be recorded iterator to the first element with
+ * key greater than key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_splay_tree_upper_bound(struct cdc_splay_tree *t, void *key,
+                                struct cdc_splay_tree_iter *it);
+
+/**
+ * @brief Returns a range containing all elements with key equivalent to key.
+ * Since this container does not allow duplicates, the range contains at most
+ * one element.
+ * @param[in] t - cdc_splay_tree
+ * @param[in] key - key value to compare the elements to
+ * @param[out] ret - pair of iterators: the first is the lower bound of key and
+ * the second is the upper bound of key. If there is no such element, both
+ * iterators point to the first element with key greater than key.
+ */
+void cdc_splay_tree_equal_range(struct cdc_splay_tree *t, void *key,
+                                struct cdc_pair_splay_tree_iter *ret);
 /** @} */
 
 // Capacity
@@ -439,6 +535,13 @@ typedef struct cdc_pair_splay_tree_iter_bool pair_splay_tree_iter_bool_t;
 #define splay_tree_get(...) cdc_splay_tree_get(__VA_ARGS__)
 #define splay_tree_count(...) cdc_splay_tree_count(__VA_ARGS__)
 #define splay_tree_find(...) cdc_splay_tree_find(__VA_ARGS__)
+#define splay_tree_peek(...) cdc_splay_tree_peek(__VA_ARGS__)
+#define splay_tree_peek_find(...) cdc_splay_tree_peek_find(__VA_ARGS__)
+#define splay_tree_set_splay_period(...) \
+  cdc_splay_tree_set_splay_period(__VA_ARGS__)
+#define splay_tree_lower_bound(...) cdc_splay_tree_lower_bound(__VA_ARGS__)
+#define splay_tree_upper_bound(...) cdc_splay_tree_upper_bound(__VA_ARGS__)
+#define splay_tree_equal_range(...) cdc_splay_tree_equal_range(__VA_ARGS__)
 
 // Capacity
 #define splay_tree_size(...) cdc_splay_tree_size(__VA_ARGS__)
@@ -64,6 +64,10 @@ struct cdc_map_table {
   enum cdc_stat (*get)(void *cntr, void *key, void **value);
   size_t (*count)(void *cntr, void *key);
   void (*find)(void *cntr, void *key, void *it);
+  void (*lower_bound)(void *cntr, void *key, void *it);
+  void (*upper_bound)(void *cntr, void *key, void *it);
+  void (*range)(void *cntr, void *lo, void *hi,
+                bool (*cb)(void *key, void *value, void *ctx), void *ctx);
   size_t (*size)(void *cntr);
   bool (*empty)(void *cntr);
   void (*clear)(void *cntr);
@@ -81,6 +85,10 @@ struct cdc_map_table {
 extern const struct cdc_map_table *cdc_map_avl;
 extern const struct cdc_map_table *cdc_map_splay;
 extern const struct cdc_map_table *cdc_map_treap;
+extern const struct cdc_map_table *cdc_map_bplus;
 extern const struct cdc_map_table *cdc_map_htable;
+extern const struct cdc_map_table *cdc_map_rhtable;
+extern const struct cdc_map_table *cdc_map_swtable;
+extern const struct cdc_map_table *cdc_map_cmtable;
 
 #endif  // CDCONTAINERS_INCLUDE_CDCONTAINERS_INTERFACES_IMAP_H
@@ -27,11 +27,13 @@
 #define CDCONTAINERS_INCLUDE_CDCONTAINERS_TREAP_H
 
 #include <cdcontainers/common.h>
+#include <cdcontainers/node-pool.h>
 #include <cdcontainers/status.h>
 
 #include <assert.h>
 #include <stdarg.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 /**
  * @defgroup cdc_treap
@@ -42,7 +44,17 @@
 typedef int (*cdc_priority_fn_t)(void *);
 
 /**
- * @brief The cdc_treap_node is service struct.
+ * @brief The source of the node priorities of a treap without a priority
+ * function.
+ */
+enum cdc_treap_priority {
+  CDC_TREAP_PRIORITY_RANDOM,  ///< random numbers of the treap's own generator
+  CDC_TREAP_PRIORITY_HASH,    ///< hashes of the keys and the seed
+};
+
+/**
+ * @brief The cdc_treap_node is service struct. The size is the number of
+ * nodes in the subtree of the node.
  * @warning To avoid problems, do not change the structure fields in the code.
  * Use only special functions to access and change structure fields.
  */
@@ -52,6 +64,7 @@ struct cdc_treap_node {
   struct cdc_treap_node *right;
   void *key;
   void *value;
+  size_t size;
   int priority;
 };
 
@@ -65,6 +78,11 @@ struct cdc_treap {
   size_t size;
   cdc_priority_fn_t prior;
   struct cdc_data_info *dinfo;
+  struct cdc_node_pool pool;
+  size_t threads;
+  uint64_t seed;
+  uint64_t rng;
+  enum cdc_treap_priority prior_mode;
 };
 
 /**
@@ -78,6 +96,11 @@ struct cdc_treap_iter {
   struct cdc_treap_node *current;
 };
 
+struct cdc_pair_treap_iter {
+  struct cdc_treap_iter first;
+  struct cdc_treap_iter second;
+};
+
 struct cdc_pair_treap_iter_bool {
   struct cdc_treap_iter first;
   bool second;
@@ -90,6 +113,9 @@ struct cdc_pair_treap_iter_bool {
  */
 /**
  * @brief Constructs an empty treap.
+ *
+ * If info->pool_chunk is not 0, the nodes of the tree are allocated from a
+ * node pool and are released by chunks on clear and destruction.
  * @param[out] t - cdc_treap
  * @param[in] info - cdc_data_info
  * @return CDC_STATUS_OK in a successful case or other value indicating
@@ -133,9 +159,13 @@ enum cdc_stat cdc_treap_ctorv(struct cdc_treap **t, struct cdc_data_info *info,
 
 /**
  * @brief Constructs an empty treap.
+ *
+ * If info->pool_chunk is not 0, the nodes of the tree are allocated from a
+ * node pool and are released by chunks on clear and destruction.
  * @param[out] t - cdc_treap
  * @param[in] info - cdc_data_info
- * @param[in] prior - function that generates a priority
+ * @param[in] prior - function that generates a priority from a value. If it
+ * is NULL, the priorities are given by cdc_treap_set_priority.
  * @return CDC_STATUS_OK in a successful case or other value indicating
  * an error.
  */
@@ -208,6 +238,64 @@ size_t cdc_treap_count(struct cdc_treap *t, void *key);
  * returned.
  */
 void cdc_treap_find(struct cdc_treap *t, void *key, struct cdc_treap_iter *it);
+
+/**
+ * @brief Finds the first element with key not less than key. The complexity
+ * is expected O(log n).
+ * @param[in] t - cdc_treap
+ * @param[in] key - key value to compare the elements to
+ * @param[out] it - pointer will be recorded iterator to the first element with
+ * key not less than key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_treap_lower_bound(struct cdc_treap *t, void *key,
+                           struct cdc_treap_iter *it);
+
+/**
+ * @brief Finds the first element with key greater than key. The complexity
+ * is expected O(log n).
+ * @param[in] t - cdc_treap
+ * @param[in] key - key value to compare the elements to
+ * @param[out] it - pointer will be recorded iterator to the first element with
+ * key greater than key. If no such element is found, past-the-end iterator is
+ * returned.
+ */
+void cdc_treap_upper_bound(struct cdc_treap *t, void *key,
+                           struct cdc_treap_iter *it);
+
+/**
+ * @brief Returns a range containing all elements with key equivalent to key.
+ * Since this container does not allow duplicates, the range contains at most
+ * one element.
+ * @param[in] t - cdc_treap
+ * @param[in] key - key value to compare the elements to
+ * @param[out] ret - pair of iterators: the first is the lower bound of key and
+ * the second is the upper bound of key. If there is no such element, both
+ * iterators point to the first element with key greater than key.
+ */
+void cdc_treap_equal_range(struct cdc_treap *t, void *key,
+                           struct cdc_pair_treap_iter *ret);
+
+/**
+ * @brief Returns the number of elements with keys less than key in expected
+ * O(log n). If the key exists, it is the position of the element in the sorted
+ * order.
+ * @param[in] t - cdc_treap
+ * @param[in] key - key value
+ * @return the number of elements with keys less than key.
+ */
+size_t cdc_treap_rank(struct cdc_treap *t, void *key);
+
+/**
+ * @brief Finds the element at the position index in the sorted order in
+ * expected O(log n).
+ * @param[in] t - cdc_treap
+ * @param[in] index - position of the element, starting from 0
+ * @param[out] it - pointer will be recorded iterator to the element. If index
+ * is not less than the size of the treap, past-the-end iterator is returned.
+ */
+void cdc_treap_select(struct cdc_treap *t, size_t index,
+                      struct cdc_treap_iter *it);
 /** @} */
 
 // Capacity
@@ -330,6 +418,120 @@ size_t cdc_treap_erase(struct cdc_treap *t, void *key);
  * @param[in, out] b - cdc_treap
  */
 void cdc_treap_swap(struct cdc_treap *a, struct cdc_treap *b);
+
+/**
+ * @brief Splits the treap t by key in expected O(log n). The elements with
+ * keys less than key are moved to a new treap left, the other elements are
+ * moved to a new treap right. The new treaps have the data info and the
+ * priority function of t, and t becomes empty. No element is copied.
+ *
+ * A treap that uses a node pool cannot be split, because its nodes cannot be
+ * shared between two pools.
+ * @param[in, out] t - cdc_treap
+ * @param[in] key - key value that separates the elements
+ * @param[out] left - cdc_treap with the elements less than key
+ * @param[out] right - cdc_treap with the elements not less than key
+ * @return CDC_STATUS_OK in a successful case, CDC_STATUS_NOT_SUPPORTED if t
+ * uses a node pool or other value indicating an error. In case of an error t
+ * is not changed.
+ */
+enum cdc_stat cdc_treap_split(struct cdc_treap *t, void *key,
+                              struct cdc_treap **left,
+                              struct cdc_treap **right);
+
+/**
+ * @brief Moves all elements of b to a in expected O(log n). The key ranges of
+ * the treaps must not overlap: either all keys of a are less than all keys of
+ * b or the other way round, otherwise the call terminates the program. The
+ * treaps must have the same order, and b becomes empty. If both treaps use a
+ * node pool, the memory of b is moved too. Either both treaps or none of them
+ * must use a node pool, otherwise the call terminates the program.
+ * @param[in, out] a - cdc_treap
+ * @param[in, out] b - cdc_treap
+ */
+void cdc_treap_join(struct cdc_treap *a, struct cdc_treap *b);
+
+/**
+ * @brief Moves to a the elements of b with keys that a does not contain. For
+ * equal keys the element of a is kept and the element of b is freed. The
+ * expected complexity is O(m log(n / m + 1)), where m is the size of the
+ * smaller treap and n is the size of the bigger one. The treaps must have the
+ * same order, and b becomes empty. If both treaps use a node pool, the memory
+ * of b is moved too. Either both treaps or none of them must use a node pool,
+ * otherwise the call terminates the program.
+ * @param[in, out] a - cdc_treap
+ * @param[in, out] b - cdc_treap
+ */
+void cdc_treap_union(struct cdc_treap *a, struct cdc_treap *b);
+
+/**
+ * @brief Leaves in a only the elements with keys that b contains. The other
+ * elements of a and all elements of b are freed. The complexity and the
+ * requirements are the same as for cdc_treap_union.
+ * @param[in, out] a - cdc_treap
+ * @param[in, out] b - cdc_treap
+ */
+void cdc_treap_intersection(struct cdc_treap *a, struct cdc_treap *b);
+
+/**
+ * @brief Removes from a the elements with keys that b contains. The removed
+ * elements of a and all elements of b are freed. The complexity and the
+ * requirements are the same as for cdc_treap_union.
+ * @param[in, out] a - cdc_treap
+ * @param[in, out] b - cdc_treap
+ */
+void cdc_treap_difference(struct cdc_treap *a, struct cdc_treap *b);
+
+/**
+ * @brief Sets the number of threads that cdc_treap_union,
+ * cdc_treap_intersection and cdc_treap_difference use when a is the treap t.
+ * The work is split only for large treaps. The comparison function must be
+ * safe to call from several threads. The default is 1.
+ * @param[in] t - cdc_treap
+ * @param[in] count - number of threads
+ */
+static inline void cdc_treap_set_threads(struct cdc_treap *t, size_t count)
+{
+  assert(t != NULL);
+
+  t->threads = count;
+}
+
+/**
+ * @brief Sets the source of the priorities of the new nodes of a treap without
+ * a priority function. By default each treap has its own random number
+ * generator, so the threads that insert into different treaps do not share a
+ * state. With CDC_TREAP_PRIORITY_HASH the priority is the hash of the key
+ * mixed with the seed: the shape of the tree depends only on its keys and the
+ * seed, not on the order of insertions. This mode needs info->hash. Set the
+ * mode before inserting elements.
+ * @param[in] t - cdc_treap
+ * @param[in] mode - source of the priorities
+ */
+static inline void cdc_treap_set_priority(struct cdc_treap *t,
+                                          enum cdc_treap_priority mode)
+{
+  assert(t != NULL);
+  assert(mode != CDC_TREAP_PRIORITY_HASH || t->dinfo->hash);
+
+  t->prior_mode = mode;
+}
+
+/**
+ * @brief Sets the seed of the priorities of a treap without a priority
+ * function. The random generator restarts from the seed, so the same
+ * insertions into treaps with the same seed give the same trees. The default
+ * seed is different for each treap.
+ * @param[in] t - cdc_treap
+ * @param[in] seed - seed
+ */
+static inline void cdc_treap_set_seed(struct cdc_treap *t, uint64_t seed)
+{
+  assert(t != NULL);
+
+  t->seed = seed;
+  t->rng = seed;
+}
 /** @} */
 
 // Iterators
@@ -475,6 +677,11 @@ typedef struct cdc_pair_treap_iter_bool pair_treap_iter_bool_t;
 #define treap_get(...) cdc_treap_get(__VA_ARGS__)
 #define treap_count(...) cdc_treap_count(__VA_ARGS__)
 #define treap_find(...) cdc_treap_find(__VA_ARGS__)
+#define treap_lower_bound(...) cdc_treap_lower_bound(__VA_ARGS__)
+#define treap_upper_bound(...) cdc_treap_upper_bound(__VA_ARGS__)
+#define treap_equal_range(...) cdc_treap_equal_range(__VA_ARGS__)
+#define treap_rank(...) cdc_treap_rank(__VA_ARGS__)
+#define treap_select(...) cdc_treap_select(__VA_ARGS__)
 
 // Capacity
 #define treap_size(...) cdc_treap_size(__VA_ARGS__)
@@ -488,6 +695,14 @@ typedef struct cdc_pair_treap_iter_bool pair_treap_iter_bool_t;
 #define treap_insert_or_assign1(...) cdc_treap_insert_or_assign1(__VA_ARGS__)
 #define treap_erase(...) cdc_treap_erase(__VA_ARGS__)
 #define treap_swap(...) cdc_treap_swap(__VA_ARGS__)
+#define treap_split(...) cdc_treap_split(__VA_ARGS__)
+#define treap_join(...) cdc_treap_join(__VA_ARGS__)
+#define treap_union(...) cdc_treap_union(__VA_ARGS__)
+#define treap_intersection(...) cdc_treap_intersection(__VA_ARGS__)
+#define treap_difference(...) cdc_treap_difference(__VA_ARGS__)
+#define treap_set_threads(...) cdc_treap_set_threads(__VA_ARGS__)
+#define treap_set_priority(...) cdc_treap_set_priority(__VA_ARGS__)
+#define treap_set_seed(...) cdc_treap_set_seed(__VA_ARGS__)
 
 // Iterators
 #define treap_begin(...) cdc_treap_begin(__VA_ARGS__)
@@ -25,17 +25,17 @@
 
 #include <stddef.h>
 
-#define CDC_MAKE_FIND_NODE_FN(T)                                           \
-  static T cdc_find_tree_node(T node, void *key, cdc_binary_pred_fn_t cmp) \
-  {                                                                        \
-    while (node != NULL && cdc_not_eq(cmp, node->key, key)) {              \
-      if (cmp(key, node->key)) {                                           \
-        node = node->left;                                                 \
-      } else {                                                             \
-        node = node->right;                                                \
-      }                                                                    \
-    }                                                                      \
-    return node;                                                           \
+#define CDC_MAKE_FIND_NODE_FN(T)                                              \
+  static T cdc_find_tree_node(T node, void *key, struct cdc_data_info *dinfo) \
+  {                                                                           \
+    while (node != NULL) {                                                    \
+      int cmp = cdc_di_cmp3(dinfo, key, node->key);                           \
+      if (cmp == 0) {                                                         \
+        break;                                                                \
+      }                                                                       \
+      node = cmp < 0 ? node->left : node->right;                              \
+    }                                                                         \
+    return node;                                                              \
   }
 
 #define CDC_MAKE_MIN_NODE_FN(T)      \
@@ -101,4 +101,73 @@
     return CDC_MAX(lh, rh) + 1;               \
   }
 
+// Returns the first node whose key is not less than key, or NULL.
+#define CDC_MAKE_LOWER_BOUND_FN(T)                                 \
+  static T cdc_tree_lower_bound(T node, void *key,                 \
+                                struct cdc_data_info *dinfo)       \
+  {                                                                \
+    T res = NULL;                                                  \
+    while (node != NULL) {                                         \
+      if (cdc_di_less(dinfo, node->key, key)) {                    \
+        node = node->right;                                        \
+      } else {                                                     \
+        res = node;                                                \
+        node = node->left;                                         \
+      }                                                            \
+    }                                                              \
+    return res;                                                    \
+  }
+
+// Returns the first node whose key is greater than key, or NULL.
+#define CDC_MAKE_UPPER_BOUND_FN(T)                                 \
+  static T cdc_tree_upper_bound(T node, void *key,                 \
+                                struct cdc_data_info *dinfo)       \
+  {                                                                \
+    T res = NULL;                                                  \
+    while (node != NULL) {                                         \
+      if (cdc_di_less(dinfo, key, node->key)) {                    \
+        res = node;                                                \
+        node = node->left;                                         \
+      } else {                                                     \
+        node = node->right;                                        \
+      }                                                            \
+    }                                                              \
+    return res;                                                    \
+  }
+
+// The rank and select functions need nodes with the subtree size in size.
+#define CDC_MAKE_RANK_FN(T)                                \
+  static size_t cdc_tree_rank(T node, void *key,           \
+                              struct cdc_data_info *dinfo) \
+  {                                                        \
+    size_t rank = 0;                                       \
+    while (node != NULL) {                                 \
+      if (cdc_di_less(dinfo, node->key, key)) {            \
+        rank += (node->left ? node->left->size : 0) + 1;   \
+        node = node->right;                                \
+      } else {                                             \
+        node = node->left;                                 \
+      }                                                    \
+    }                                                      \
+    return rank;                                           \
+  }
+
+#define CDC_MAKE_SELECT_FN(T)                          \
+  static T cdc_tree_select(T node, size_t index)       \
+  {                                                    \
+    while (node != NULL) {                             \
+      size_t left = node->left ? node->left->size : 0; \
+      if (index == left) {                             \
+        break;                                         \
+      }                                                \
+      if (index < left) {                              \
+        node = node->left;                             \
+      } else {                                         \
+        index -= left + 1;                             \
+        node = node->right;                            \
+      }                                                \
+    }                                                  \
+    return node;                                       \
+  }
+
 #endif  // CDCONTAINERS_SRC_TREE_H
@@ -27,7 +27,7 @@ enum cdc_stat cdc_map_ctor(const struct cdc_map_table *table,
 {
   assert(table != NULL);
   assert(m != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   struct cdc_map *tmp = (struct cdc_map *)malloc(sizeof(struct cdc_map));
   if (!tmp) {
@@ -50,7 +50,7 @@ enum cdc_stat cdc_map_ctorl(const struct cdc_map_table *table,
 {
   assert(table != NULL);
   assert(m != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   va_list args;
   va_start(args, info);
@@ -65,7 +65,7 @@ enum cdc_stat cdc_map_ctorv(const struct cdc_map_table *table,
 {
   assert(table != NULL);
   assert(m != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   struct cdc_map *tmp = (struct cdc_map *)malloc(sizeof(struct cdc_map));
   if (!tmp) {
@@ -28,7 +28,7 @@ enum cdc_stat cdc_priority_queue_ctor(
 {
   assert(table != NULL);
   assert(q != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   struct cdc_priority_queue *tmp =
       (struct cdc_priority_queue *)malloc(sizeof(struct cdc_priority_queue));
@@ -53,7 +53,7 @@ enum cdc_stat cdc_priority_queue_ctorl(
 {
   assert(table != NULL);
   assert(q != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   va_list args;
   va_start(args, info);
@@ -68,7 +68,7 @@ enum cdc_stat cdc_priority_queue_ctorv(
 {
   assert(table != NULL);
   assert(q != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   struct cdc_priority_queue *tmp =
       (struct cdc_priority_queue *)malloc(sizeof(struct cdc_priority_queue));
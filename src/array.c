@@ -43,13 +43,13 @@ static enum cdc_stat reallocate(struct cdc_array *v, size_t capacity)
     return CDC_STATUS_OK;
   }
 
-  void **tmp = (void **)malloc(capacity * sizeof(void *));
+  void **tmp = (void **)cdc_di_realloc(v->dinfo, v->buffer,
+                                       v->capacity * sizeof(void *),
+                                       capacity * sizeof(void *));
   if (!tmp) {
     return CDC_STATUS_BAD_ALLOC;
   }
 
-  memcpy(tmp, v->buffer, v->size * sizeof(void *));
-  free(v->buffer);
   v->capacity = capacity;
   v->buffer = tmp;
   return CDC_STATUS_OK;
@@ -72,7 +72,7 @@ static void free_data(struct cdc_array *v)
 static void free_buffer(struct cdc_array *v)
 {
   free_data(v);
-  free(v->buffer);
+  cdc_di_free(v->dinfo, v->buffer);
   v->buffer = NULL;
 }
 
@@ -32,11 +32,17 @@ CDC_MAKE_MIN_NODE_FN(struct cdc_avl_tree_node *)
 CDC_MAKE_MAX_NODE_FN(struct cdc_avl_tree_node *)
 CDC_MAKE_SUCCESSOR_FN(struct cdc_avl_tree_node *)
 CDC_MAKE_PREDECESSOR_FN(struct cdc_avl_tree_node *)
+CDC_MAKE_LOWER_BOUND_FN(struct cdc_avl_tree_node *)
+CDC_MAKE_UPPER_BOUND_FN(struct cdc_avl_tree_node *)
+CDC_MAKE_RANK_FN(struct cdc_avl_tree_node *)
+CDC_MAKE_SELECT_FN(struct cdc_avl_tree_node *)
 
-static struct cdc_avl_tree_node *make_new_node(void *key, void *val)
+static struct cdc_avl_tree_node *make_new_node(struct cdc_avl_tree *t,
+                                               void *key, void *val)
 {
   struct cdc_avl_tree_node *node =
-      (struct cdc_avl_tree_node *)malloc(sizeof(struct cdc_avl_tree_node));
+      (struct cdc_avl_tree_node *)cdc_di_node_alloc(
+          t->dinfo, &t->pool, sizeof(struct cdc_avl_tree_node));
   if (!node) {
     return NULL;
   }
@@ -44,6 +50,7 @@ static struct cdc_avl_tree_node *make_new_node(void *key, void *val)
   node->key = key;
   node->value = val;
   node->height = 1;
+  node->size = 1;
   node->parent = NULL;
   node->left = NULL;
   node->right = NULL;
@@ -59,7 +66,7 @@ static void free_node(struct cdc_avl_tree *t, struct cdc_avl_tree_node *node)
     t->dinfo->dfree(&pair);
   }
 
-  free(node);
+  cdc_di_node_free(t->dinfo, &t->pool, node);
 }
 
 static void free_avl_tree(struct cdc_avl_tree *t,
@@ -76,21 +83,37 @@ static void free_avl_tree(struct cdc_avl_tree *t,
   free_node(t, root);
 }
 
+static void free_nodes(struct cdc_avl_tree *t)
+{
+  if (!cdc_node_pool_enabled(&t->pool) || CDC_HAS_DFREE(t->dinfo)) {
+    free_avl_tree(t, t->root);
+  }
+
+  cdc_node_pool_release(&t->pool, t->dinfo);
+}
+
 static unsigned char height(struct cdc_avl_tree_node *node)
 {
   return node ? node->height : 0;
 }
 
+static size_t subtree_size(struct cdc_avl_tree_node *node)
+{
+  return node ? node->size : 0;
+}
+
 static int height_diff(struct cdc_avl_tree_node *node)
 {
   return height(node->right) - height(node->left);
 }
 
+// Updates the height and the subtree size of the node from its children.
 static void update_height(struct cdc_avl_tree_node *node)
 {
   unsigned char lhs = height(node->left);
   unsigned char rhs = height(node->right);
   node->height = CDC_MAX(lhs, rhs) + 1;
+  node->size = subtree_size(node->left) + subtree_size(node->right) + 1;
 }
 
 static void update_link(struct cdc_avl_tree_node *parent,
@@ -193,7 +216,7 @@ static struct cdc_avl_tree_node *insert_unique(
     struct cdc_avl_tree_node *nearest)
 {
   if (t->root != NULL) {
-    if (t->dinfo->cmp(node->key, nearest->key)) {
+    if (cdc_di_less(t->dinfo, node->key, nearest->key)) {
       nearest->left = node;
     } else {
       nearest->right = node;
@@ -211,21 +234,14 @@ static struct cdc_avl_tree_node *insert_unique(
 
 static struct cdc_avl_tree_node *find_hint(struct cdc_avl_tree_node *node,
                                            void *key,
-                                           cdc_binary_pred_fn_t compar)
+                                           struct cdc_data_info *dinfo)
 {
   while (node) {
-    if (compar(key, node->key)) {
-      if (node->left) {
-        node = node->left;
-      } else {
-        break;
-      }
-    } else if (compar(node->key, key)) {
-      if (node->right) {
-        node = node->right;
-      } else {
-        break;
-      }
+    int cmp = cdc_di_cmp3(dinfo, key, node->key);
+    if (cmp < 0 && node->left) {
+      node = node->left;
+    } else if (cmp > 0 && node->right) {
+      node = node->right;
     } else {
       break;
     }
@@ -275,12 +291,13 @@ static struct cdc_avl_tree_node *erase_node(struct cdc_avl_tree *t,
     CDC_SWAP(void *, node->key, mnode->key);
     parent = mnode->parent;
     if (parent == node) {
-      parent->right = NULL;
-    } else if (parent) {
+      parent->right = mnode->right;
+    } else {
       parent->left = mnode->right;
-      if (mnode->right) {
-        mnode->right->parent = parent;
-      }
+    }
+
+    if (mnode->right) {
+      mnode->right->parent = parent;
     }
 
     node = mnode;
@@ -308,7 +325,7 @@ enum cdc_stat cdc_avl_tree_ctor(struct cdc_avl_tree **t,
                                 struct cdc_data_info *info)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   struct cdc_avl_tree *tmp =
       (struct cdc_avl_tree *)calloc(sizeof(struct cdc_avl_tree), 1);
@@ -321,6 +338,11 @@ enum cdc_stat cdc_avl_tree_ctor(struct cdc_avl_tree **t,
     return CDC_STATUS_BAD_ALLOC;
   }
 
+  if (info->pool_chunk) {
+    cdc_node_pool_init(&tmp->pool, sizeof(struct cdc_avl_tree_node),
+                       info->pool_chunk);
+  }
+
   *t = tmp;
   return CDC_STATUS_OK;
 }
@@ -329,7 +351,7 @@ enum cdc_stat cdc_avl_tree_ctorl(struct cdc_avl_tree **t,
                                  struct cdc_data_info *info, ...)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   va_list args;
   va_start(args, info);
@@ -342,7 +364,7 @@ enum cdc_stat cdc_avl_tree_ctorv(struct cdc_avl_tree **t,
                                  struct cdc_data_info *info, va_list args)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   enum cdc_stat stat = cdc_avl_tree_ctor(t, info);
   if (stat != CDC_STATUS_OK) {
@@ -356,7 +378,7 @@ void cdc_avl_tree_dtor(struct cdc_avl_tree *t)
 {
   assert(t != NULL);
 
-  free_avl_tree(t, t->root);
+  free_nodes(t);
   cdc_di_shared_dtor(t->dinfo);
   free(t);
 }
@@ -365,8 +387,7 @@ enum cdc_stat cdc_avl_tree_get(struct cdc_avl_tree *t, void *key, void **value)
 {
   assert(t != NULL);
 
-  struct cdc_avl_tree_node *node =
-      cdc_find_tree_node(t->root, key, t->dinfo->cmp);
+  struct cdc_avl_tree_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
   if (node) {
     *value = node->value;
     return CDC_STATUS_OK;
@@ -379,17 +400,12 @@ size_t cdc_avl_tree_count(struct cdc_avl_tree *t, void *key)
 {
   assert(t != NULL);
 
-  return (size_t)(cdc_find_tree_node(t->root, key, t->dinfo->cmp) != NULL);
+  return (size_t)(cdc_find_tree_node(t->root, key, t->dinfo) != NULL);
 }
 
-void cdc_avl_tree_find(struct cdc_avl_tree *t, void *key,
-                       struct cdc_avl_tree_iter *it)
+static void set_iter(struct cdc_avl_tree *t, struct cdc_avl_tree_node *node,
+                     struct cdc_avl_tree_iter *it)
 {
-  assert(t != NULL);
-  assert(it != NULL);
-
-  struct cdc_avl_tree_node *node =
-      cdc_find_tree_node(t->root, key, t->dinfo->cmp);
   if (!node) {
     cdc_avl_tree_end(t, it);
     return;
@@ -400,6 +416,68 @@ void cdc_avl_tree_find(struct cdc_avl_tree *t, void *key,
   it->prev = cdc_tree_predecessor(node);
 }
 
+void cdc_avl_tree_find(struct cdc_avl_tree *t, void *key,
+                       struct cdc_avl_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_avl_tree_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
+  set_iter(t, node, it);
+}
+
+void cdc_avl_tree_lower_bound(struct cdc_avl_tree *t, void *key,
+                              struct cdc_avl_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_avl_tree_node *node = cdc_tree_lower_bound(t->root, key, t->dinfo);
+  set_iter(t, node, it);
+}
+
+void cdc_avl_tree_upper_bound(struct cdc_avl_tree *t, void *key,
+                              struct cdc_avl_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_avl_tree_node *node = cdc_tree_upper_bound(t->root, key, t->dinfo);
+  set_iter(t, node, it);
+}
+
+void cdc_avl_tree_equal_range(struct cdc_avl_tree *t, void *key,
+                              struct cdc_pair_avl_tree_iter *ret)
+{
+  assert(t != NULL);
+  assert(ret != NULL);
+
+  struct cdc_avl_tree_node *node = cdc_tree_lower_bound(t->root, key, t->dinfo);
+  set_iter(t, node, &ret->first);
+  if (node && !cdc_di_less(t->dinfo, key, node->key)) {
+    node = cdc_tree_successor(node);
+  }
+
+  set_iter(t, node, &ret->second);
+}
+
+size_t cdc_avl_tree_rank(struct cdc_avl_tree *t, void *key)
+{
+  assert(t != NULL);
+
+  return cdc_tree_rank(t->root, key, t->dinfo);
+}
+
+void cdc_avl_tree_select(struct cdc_avl_tree *t, size_t index,
+                         struct cdc_avl_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_avl_tree_node *node = cdc_tree_select(t->root, index);
+  set_iter(t, node, it);
+}
+
 enum cdc_stat cdc_avl_tree_insert(struct cdc_avl_tree *t, void *key,
                                   void *value,
                                   struct cdc_pair_avl_tree_iter_bool *ret)
@@ -422,10 +500,10 @@ enum cdc_stat cdc_avl_tree_insert1(struct cdc_avl_tree *t, void *key,
 {
   assert(t != NULL);
 
-  struct cdc_avl_tree_node *node = find_hint(t->root, key, t->dinfo->cmp);
-  bool finded = node && cdc_eq(t->dinfo->cmp, node->key, key);
+  struct cdc_avl_tree_node *node = find_hint(t->root, key, t->dinfo);
+  bool finded = node && cdc_di_cmp3(t->dinfo, node->key, key) == 0;
   if (!finded) {
-    struct cdc_avl_tree_node *new_node = make_new_node(key, value);
+    struct cdc_avl_tree_node *new_node = make_new_node(t, key, value);
     if (!new_node) {
       return CDC_STATUS_BAD_ALLOC;
     }
@@ -469,10 +547,10 @@ enum cdc_stat cdc_avl_tree_insert_or_assign1(struct cdc_avl_tree *t, void *key,
 {
   assert(t != NULL);
 
-  struct cdc_avl_tree_node *node = find_hint(t->root, key, t->dinfo->cmp);
-  bool finded = node && cdc_eq(t->dinfo->cmp, node->key, key);
+  struct cdc_avl_tree_node *node = find_hint(t->root, key, t->dinfo);
+  bool finded = node && cdc_di_cmp3(t->dinfo, node->key, key) == 0;
   if (!finded) {
-    struct cdc_avl_tree_node *new_node = make_new_node(key, value);
+    struct cdc_avl_tree_node *new_node = make_new_node(t, key, value);
     if (!new_node) {
       return CDC_STATUS_BAD_ALLOC;
     }
@@ -499,8 +577,7 @@ size_t cdc_avl_tree_erase(struct cdc_avl_tree *t, void *key)
 {
   assert(t != NULL);
 
-  struct cdc_avl_tree_node *node =
-      cdc_find_tree_node(t->root, key, t->dinfo->cmp);
+  struct cdc_avl_tree_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
   if (!node) {
     return 0;
   }
@@ -514,7 +591,7 @@ void cdc_avl_tree_clear(struct cdc_avl_tree *t)
 {
   assert(t != NULL);
 
-  free_avl_tree(t, t->root);
+  free_nodes(t);
   t->size = 0;
   t->root = NULL;
 }
@@ -527,6 +604,7 @@ void cdc_avl_tree_swap(struct cdc_avl_tree *a, struct cdc_avl_tree *b)
   CDC_SWAP(struct cdc_avl_tree_node *, a->root, b->root);
   CDC_SWAP(size_t, a->size, b->size);
   CDC_SWAP(struct cdc_data_info *, a->dinfo, b->dinfo);
+  CDC_SWAP(struct cdc_node_pool, a->pool, b->pool);
 }
 
 void cdc_avl_tree_begin(struct cdc_avl_tree *t, struct cdc_avl_tree_iter *it)
@@ -27,10 +27,12 @@
 #include <stdio.h>
 #include <string.h>
 
-static struct cdc_binomial_heap_node *new_node(void *key)
+static struct cdc_binomial_heap_node *new_node(struct cdc_binomial_heap *h,
+                                               void *key)
 {
-  struct cdc_binomial_heap_node *node = (struct cdc_binomial_heap_node *)calloc(
-      sizeof(struct cdc_binomial_heap_node), 1);
+  struct cdc_binomial_heap_node *node =
+      (struct cdc_binomial_heap_node *)cdc_di_calloc(
+          h->dinfo, sizeof(struct cdc_binomial_heap_node));
   if (!node) return NULL;
 
   node->key = key;
@@ -44,7 +46,7 @@ static void free_node(struct cdc_binomial_heap *h,
     h->dinfo->dfree(node->key);
   }
 
-  free(node);
+  cdc_di_free(h->dinfo, node);
 }
 
 static void free_heap(struct cdc_binomial_heap *h,
@@ -60,11 +62,11 @@ static void free_heap(struct cdc_binomial_heap *h,
 }
 
 static bool is_heap(struct cdc_binomial_heap_node *root,
-                    cdc_binary_pred_fn_t compar)
+                    struct cdc_data_info *dinfo)
 {
   while (root) {
-    if (!is_heap(root->child, compar) ||
-        (root->parent && compar(root->key, root->parent->key))) {
+    if (!is_heap(root->child, dinfo) ||
+        (root->parent && cdc_di_less(dinfo, root->key, root->parent->key))) {
       return false;
     }
 
@@ -85,7 +87,7 @@ static struct cdc_binomial_heap_node *find_prev_top(struct cdc_binomial_heap *h)
   struct cdc_binomial_heap_node *next = h->root;
   while (next->sibling) {
     prev = next;
-    if (h->dinfo->cmp(m->key, next->key)) {
+    if (cdc_di_less(h->dinfo, m->key, next->key)) {
       m = next->key;
     }
     next = next->sibling;
@@ -103,7 +105,7 @@ static struct cdc_binomial_heap_node *find_top(struct cdc_binomial_heap *h)
 static void update_top(struct cdc_binomial_heap *h,
                        struct cdc_binomial_heap_node *v)
 {
-  if (h->top == NULL || (v && h->dinfo->cmp(v->key, h->top->key))) {
+  if (h->top == NULL || (v && cdc_di_less(h->dinfo, v->key, h->top->key))) {
     h->top = v;
   }
 }
@@ -163,7 +165,7 @@ static struct cdc_binomial_heap_node *merge(struct cdc_binomial_heap_node *a,
 
 static struct cdc_binomial_heap_node *meld(struct cdc_binomial_heap_node *a,
                                            struct cdc_binomial_heap_node *b,
-                                           cdc_binary_pred_fn_t compare)
+                                           struct cdc_data_info *dinfo)
 {
   struct cdc_binomial_heap_node *result = merge(a, b);
   if (result == NULL) {
@@ -178,7 +180,7 @@ static struct cdc_binomial_heap_node *meld(struct cdc_binomial_heap_node *a,
         (next->sibling && (next->sibling->degree == curr->degree))) {
       prev = curr;
       curr = next;
-    } else if (compare(curr->key, next->key)) {
+    } else if (cdc_di_less(dinfo, curr->key, next->key)) {
       curr->sibling = next->sibling;
       link(next, curr);
     } else {
@@ -207,7 +209,7 @@ static struct cdc_binomial_heap_node *decrease_key(
 
   node->key = key;
   struct cdc_binomial_heap_node *p = node->parent;
-  while (p != NULL && h->dinfo->cmp(node->key, p->key)) {
+  while (p != NULL && cdc_di_less(h->dinfo, node->key, p->key)) {
     CDC_SWAP(void *, node->key, p->key);
     node = p;
     p = node->parent;
@@ -226,10 +228,10 @@ static struct cdc_binomial_heap_node *increase_key(
   pos->key = key;
   struct cdc_binomial_heap_node *ch = pos->child, *t = NULL;
   while (ch != NULL) {
-    if (h->dinfo->cmp(ch->key, pos->key)) {
+    if (cdc_di_less(h->dinfo, ch->key, pos->key)) {
       t = ch;
       while (ch->sibling != NULL) {
-        if (h->dinfo->cmp(ch->sibling->key, t->key)) {
+        if (cdc_di_less(h->dinfo, ch->sibling->key, t->key)) {
           t = ch->sibling;
         }
 
@@ -264,7 +266,7 @@ enum cdc_stat cdc_binomial_heap_ctor(struct cdc_binomial_heap **h,
                                      struct cdc_data_info *info)
 {
   assert(h != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   struct cdc_binomial_heap *tmp =
       (struct cdc_binomial_heap *)calloc(sizeof(struct cdc_binomial_heap), 1);
@@ -285,7 +287,7 @@ enum cdc_stat cdc_binomial_heap_ctorl(struct cdc_binomial_heap **h,
                                       struct cdc_data_info *info, ...)
 {
   assert(h != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   va_list args;
   va_start(args, info);
@@ -298,7 +300,7 @@ enum cdc_stat cdc_binomial_heap_ctorv(struct cdc_binomial_heap **h,
                                       struct cdc_data_info *info, va_list args)
 {
   assert(h != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   enum cdc_stat ret = cdc_binomial_heap_ctor(h, info);
   if (ret != CDC_STATUS_OK) {
@@ -339,7 +341,7 @@ enum cdc_stat cdc_binomial_heap_extract_top(struct cdc_binomial_heap *h)
     tmp = tmp->sibling;
   }
 
-  h->root = meld(h->root, root, h->dinfo->cmp);
+  h->root = meld(h->root, root, h->dinfo);
   h->top = find_top(h);
   --h->size;
   return CDC_STATUS_OK;
@@ -350,11 +352,11 @@ enum cdc_stat cdc_binomial_heap_riinsert(struct cdc_binomial_heap *h, void *key,
 {
   assert(h != NULL);
 
-  struct cdc_binomial_heap_node *node = new_node(key);
+  struct cdc_binomial_heap_node *node = new_node(h, key);
   if (!node) return CDC_STATUS_BAD_ALLOC;
 
   update_top(h, node);
-  h->root = meld(h->root, node, h->dinfo->cmp);
+  h->root = meld(h->root, node, h->dinfo);
   ++h->size;
   if (ret) {
     ret->container = h;
@@ -373,7 +375,7 @@ void cdc_binomial_heap_change_key(struct cdc_binomial_heap *h,
 
   struct cdc_binomial_heap_node *node = NULL;
   struct cdc_binomial_heap_node *curr = pos->current;
-  if (h->dinfo->cmp(key, curr->key)) {
+  if (cdc_di_less(h->dinfo, key, curr->key)) {
     node = decrease_key(h, curr, key);
     update_top(h, node);
 
@@ -415,7 +417,7 @@ void cdc_binomial_heap_merge(struct cdc_binomial_heap *h,
   assert(h != NULL);
   assert(other != NULL);
 
-  h->root = meld(h->root, other->root, h->dinfo->cmp);
+  h->root = meld(h->root, other->root, h->dinfo);
   update_top(h, other->top);
   h->size += other->size;
   other->size = 0;
@@ -427,5 +429,5 @@ bool cdc_binomial_heap_is_heap(struct cdc_binomial_heap *h)
 {
   assert(h != NULL);
 
-  return is_heap(h->root, h->dinfo->cmp);
+  return is_heap(h->root, h->dinfo);
 }
@@ -0,0 +1,915 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "cdcontainers/bplus-tree.h"
+
+#include "cdcontainers/data-info.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Every node except the root and the last leaf has at least MIN_KEYS keys.
+#define MIN_KEYS (CDC_BPLUS_TREE_ORDER / 2)
+// Enough for 2^64 keys.
+#define MAX_HEIGHT 64
+
+// A step of a descent from the root: an inner node and the index of the child
+// that was taken.
+struct path_item {
+  struct cdc_bplus_tree_inner *node;
+  size_t index;
+};
+
+// The nodes that a split can need. They are allocated before the tree is
+// changed, so that the split itself cannot fail.
+struct split_nodes {
+  struct cdc_bplus_tree_leaf *leaf;
+  struct cdc_bplus_tree_inner *inners[MAX_HEIGHT + 1];
+  size_t count;
+};
+
+static struct cdc_bplus_tree_leaf *to_leaf(struct cdc_bplus_tree_node *node)
+{
+  return (struct cdc_bplus_tree_leaf *)node;
+}
+
+static struct cdc_bplus_tree_inner *to_inner(struct cdc_bplus_tree_node *node)
+{
+  return (struct cdc_bplus_tree_inner *)node;
+}
+
+static struct cdc_bplus_tree_leaf *make_leaf(struct cdc_bplus_tree *t)
+{
+  struct cdc_bplus_tree_leaf *leaf =
+      (struct cdc_bplus_tree_leaf *)cdc_di_node_alloc(
+          t->dinfo, &t->leaf_pool, sizeof(struct cdc_bplus_tree_leaf));
+  if (!leaf) {
+    return NULL;
+  }
+
+  leaf->base.size = 0;
+  leaf->base.is_leaf = true;
+  leaf->prev = NULL;
+  leaf->next = NULL;
+  return leaf;
+}
+
+static struct cdc_bplus_tree_inner *make_inner(struct cdc_bplus_tree *t)
+{
+  struct cdc_bplus_tree_inner *inner =
+      (struct cdc_bplus_tree_inner *)cdc_di_node_alloc(
+          t->dinfo, &t->inner_pool, sizeof(struct cdc_bplus_tree_inner));
+  if (!inner) {
+    return NULL;
+  }
+
+  inner->base.size = 0;
+  inner->base.is_leaf = false;
+  return inner;
+}
+
+static void free_node(struct cdc_bplus_tree *t,
+                      struct cdc_bplus_tree_node *node)
+{
+  if (node->is_leaf) {
+    cdc_di_node_free(t->dinfo, &t->leaf_pool, node);
+  } else {
+    cdc_di_node_free(t->dinfo, &t->inner_pool, node);
+  }
+}
+
+static void free_subtree(struct cdc_bplus_tree *t,
+                         struct cdc_bplus_tree_node *node)
+{
+  if (node->is_leaf) {
+    struct cdc_bplus_tree_leaf *leaf = to_leaf(node);
+    if (CDC_HAS_DFREE(t->dinfo)) {
+      for (size_t i = 0; i < node->size; ++i) {
+        struct cdc_pair pair = {node->keys[i], leaf->values[i]};
+        t->dinfo->dfree(&pair);
+      }
+    }
+  } else {
+    struct cdc_bplus_tree_inner *inner = to_inner(node);
+    for (size_t i = 0; i <= node->size; ++i) {
+      free_subtree(t, inner->children[i]);
+    }
+  }
+
+  free_node(t, node);
+}
+
+static void free_nodes(struct cdc_bplus_tree *t)
+{
+  bool pooled = cdc_node_pool_enabled(&t->leaf_pool);
+  if (t->root && (!pooled || CDC_HAS_DFREE(t->dinfo))) {
+    free_subtree(t, t->root);
+  }
+
+  cdc_node_pool_release(&t->leaf_pool, t->dinfo);
+  cdc_node_pool_release(&t->inner_pool, t->dinfo);
+}
+
+// Returns the index of the child of inner whose subtree can hold key.
+static size_t child_index(struct cdc_data_info *dinfo,
+                          struct cdc_bplus_tree_node *inner, void *key)
+{
+  size_t lo = 0;
+  size_t hi = inner->size;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (cdc_di_less(dinfo, key, inner->keys[mid])) {
+      hi = mid;
+    } else {
+      lo = mid + 1;
+    }
+  }
+
+  return lo;
+}
+
+// Returns the index of the first key of leaf that is not less than key.
+static size_t lower_bound(struct cdc_data_info *dinfo,
+                          struct cdc_bplus_tree_node *leaf, void *key)
+{
+  size_t lo = 0;
+  size_t hi = leaf->size;
+  while (lo < hi) {
+    size_t mid = lo + (hi - lo) / 2;
+    if (cdc_di_less(dinfo, leaf->keys[mid], key)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+
+  return lo;
+}
+
+static bool is_eq_at(struct cdc_data_info *dinfo,
+                     struct cdc_bplus_tree_node *leaf, size_t pos, void *key)
+{
+  return pos < leaf->size && !cdc_di_less(dinfo, key, leaf->keys[pos]);
+}
+
+static struct cdc_bplus_tree_leaf *find_leaf(struct cdc_bplus_tree *t,
+                                             void *key, struct path_item *path)
+{
+  struct cdc_bplus_tree_node *node = t->root;
+  size_t depth = 0;
+  while (!node->is_leaf) {
+    size_t index = child_index(t->dinfo, node, key);
+    if (path) {
+      path[depth].node = to_inner(node);
+      path[depth].index = index;
+    }
+
+    ++depth;
+    node = to_inner(node)->children[index];
+  }
+
+  return to_leaf(node);
+}
+
+static bool find_pos(struct cdc_bplus_tree *t, void *key,
+                     struct cdc_bplus_tree_leaf **leaf, size_t *pos)
+{
+  if (!t->root) {
+    return false;
+  }
+
+  *leaf = find_leaf(t, key, NULL);
+  *pos = lower_bound(t->dinfo, &(*leaf)->base, key);
+  return is_eq_at(t->dinfo, &(*leaf)->base, *pos, key);
+}
+
+static void *min_key(struct cdc_bplus_tree_node *node)
+{
+  while (!node->is_leaf) {
+    node = to_inner(node)->children[0];
+  }
+
+  return node->keys[0];
+}
+
+static void leaf_insert_at(struct cdc_bplus_tree_leaf *leaf, size_t pos,
+                           void *key, void *value)
+{
+  size_t tail = leaf->base.size - pos;
+  memmove(leaf->base.keys + pos + 1, leaf->base.keys + pos,
+          tail * sizeof(void *));
+  memmove(leaf->values + pos + 1, leaf->values + pos, tail * sizeof(void *));
+  leaf->base.keys[pos] = key;
+  leaf->values[pos] = value;
+  ++leaf->base.size;
+}
+
+static void leaf_erase_at(struct cdc_bplus_tree_leaf *leaf, size_t pos)
+{
+  size_t tail = leaf->base.size - pos - 1;
+  memmove(leaf->base.keys + pos, leaf->base.keys + pos + 1,
+          tail * sizeof(void *));
+  memmove(leaf->values + pos, leaf->values + pos + 1, tail * sizeof(void *));
+  --leaf->base.size;
+}
+
+// Inserts the key and its right child at the position pos of inner.
+static void inner_insert_at(struct cdc_bplus_tree_inner *inner, size_t pos,
+                            void *key, struct cdc_bplus_tree_node *child)
+{
+  size_t tail = inner->base.size - pos;
+  memmove(inner->base.keys + pos + 1, inner->base.keys + pos,
+          tail * sizeof(void *));
+  memmove(inner->children + pos + 2, inner->children + pos + 1,
+          tail * sizeof(struct cdc_bplus_tree_node *));
+  inner->base.keys[pos] = key;
+  inner->children[pos + 1] = child;
+  ++inner->base.size;
+}
+
+// Removes the key and its right child at the position pos of inner.
+static void inner_erase_at(struct cdc_bplus_tree_inner *inner, size_t pos)
+{
+  size_t tail = inner->base.size - pos - 1;
+  memmove(inner->base.keys + pos, inner->base.keys + pos + 1,
+          tail * sizeof(void *));
+  memmove(inner->children + pos + 1, inner->children + pos + 2,
+          tail * sizeof(struct cdc_bplus_tree_node *));
+  --inner->base.size;
+}
+
+// Allocates the nodes for the split of a full leaf reached by path: the new
+// leaf, one inner node for every full inner node above it and a new root if
+// all of them are full. On failure nothing is left allocated.
+static enum cdc_stat alloc_split_nodes(struct cdc_bplus_tree *t,
+                                       struct path_item *path,
+                                       struct split_nodes *nodes)
+{
+  size_t need = 0;
+  size_t depth = t->height;
+  while (depth > 0 && path[depth - 1].node->base.size == CDC_BPLUS_TREE_ORDER) {
+    --depth;
+    ++need;
+  }
+
+  if (depth == 0) {
+    ++need;
+  }
+
+  nodes->count = 0;
+  if (!(nodes->leaf = make_leaf(t))) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  while (nodes->count < need) {
+    struct cdc_bplus_tree_inner *inner = make_inner(t);
+    if (!inner) {
+      free_node(t, &nodes->leaf->base);
+      while (nodes->count > 0) {
+        free_node(t, &nodes->inners[--nodes->count]->base);
+      }
+
+      return CDC_STATUS_BAD_ALLOC;
+    }
+
+    nodes->inners[nodes->count++] = inner;
+  }
+
+  return CDC_STATUS_OK;
+}
+
+// Splits a full leaf into it and new_leaf and inserts the pair. Then *leaf and
+// *pos point at the inserted pair.
+static void split_leaf(struct cdc_bplus_tree *t,
+                       struct cdc_bplus_tree_leaf **leaf, size_t *pos,
+                       void *key, void *value,
+                       struct cdc_bplus_tree_leaf *new_leaf)
+{
+  struct cdc_bplus_tree_leaf *left = *leaf;
+  // Appending to the last leaf leaves it full, so that keys inserted in
+  // ascending order fill the leaves completely.
+  size_t split = *pos == CDC_BPLUS_TREE_ORDER && !left->next
+                     ? CDC_BPLUS_TREE_ORDER
+                     : CDC_BPLUS_TREE_ORDER / 2;
+  size_t moved = CDC_BPLUS_TREE_ORDER - split;
+  memcpy(new_leaf->base.keys, left->base.keys + split, moved * sizeof(void *));
+  memcpy(new_leaf->values, left->values + split, moved * sizeof(void *));
+  new_leaf->base.size = moved;
+  left->base.size = split;
+
+  new_leaf->prev = left;
+  new_leaf->next = left->next;
+  if (left->next) {
+    left->next->prev = new_leaf;
+  } else {
+    t->tail = new_leaf;
+  }
+
+  left->next = new_leaf;
+  if (*pos < split) {
+    leaf_insert_at(left, *pos, key, value);
+  } else {
+    *pos -= split;
+    *leaf = new_leaf;
+    leaf_insert_at(new_leaf, *pos, key, value);
+  }
+}
+
+// Inserts the separator key and the child right after a split of the child
+// path[depth].index of path[depth].node, splitting the inner nodes up to the
+// root as needed. The new inner nodes are taken from nodes.
+static void insert_separator(struct cdc_bplus_tree *t, struct path_item *path,
+                             size_t depth, void *key,
+                             struct cdc_bplus_tree_node *right,
+                             struct split_nodes *nodes)
+{
+  while (depth-- > 0) {
+    struct cdc_bplus_tree_inner *inner = path[depth].node;
+    size_t pos = path[depth].index;
+    if (inner->base.size < CDC_BPLUS_TREE_ORDER) {
+      inner_insert_at(inner, pos, key, right);
+      return;
+    }
+
+    assert(nodes->count > 0);
+    struct cdc_bplus_tree_inner *new_inner = nodes->inners[--nodes->count];
+
+    // The middle one of the ORDER + 1 keys moves up and the keys after it
+    // move to the new node, so both halves get MIN_KEYS keys.
+    size_t mid = CDC_BPLUS_TREE_ORDER / 2;
+    if (pos == mid) {
+      size_t moved = CDC_BPLUS_TREE_ORDER - mid;
+      memcpy(new_inner->base.keys, inner->base.keys + mid,
+             moved * sizeof(void *));
+      memcpy(new_inner->children + 1, inner->children + mid + 1,
+             moved * sizeof(struct cdc_bplus_tree_node *));
+      new_inner->children[0] = right;
+      new_inner->base.size = moved;
+      inner->base.size = mid;
+    } else {
+      size_t split = pos < mid ? mid - 1 : mid;
+      size_t moved = CDC_BPLUS_TREE_ORDER - split - 1;
+      void *up = inner->base.keys[split];
+      memcpy(new_inner->base.keys, inner->base.keys + split + 1,
+             moved * sizeof(void *));
+      memcpy(new_inner->children, inner->children + split + 1,
+             (moved + 1) * sizeof(struct cdc_bplus_tree_node *));
+      new_inner->base.size = moved;
+      inner->base.size = split;
+      if (pos <= split) {
+        inner_insert_at(inner, pos, key, right);
+      } else {
+        inner_insert_at(new_inner, pos - split - 1, key, right);
+      }
+
+      key = up;
+    }
+
+    right = &new_inner->base;
+  }
+
+  assert(nodes->count > 0);
+  struct cdc_bplus_tree_inner *root = nodes->inners[--nodes->count];
+  root->base.size = 1;
+  root->base.keys[0] = key;
+  root->children[0] = t->root;
+  root->children[1] = right;
+  t->root = &root->base;
+  ++t->height;
+}
+
+static enum cdc_stat insert_pair(struct cdc_bplus_tree *t, void *key,
+                                 void *value, bool assign,
+                                 struct cdc_bplus_tree_iter *it,
+                                 bool *inserted)
+{
+  struct path_item path[MAX_HEIGHT];
+  struct cdc_bplus_tree_leaf *leaf = NULL;
+  size_t pos = 0;
+  bool finded = false;
+  if (!t->root) {
+    if (!(leaf = make_leaf(t))) {
+      return CDC_STATUS_BAD_ALLOC;
+    }
+
+    t->root = &leaf->base;
+    t->head = t->tail = leaf;
+  } else {
+    leaf = find_leaf(t, key, path);
+    pos = lower_bound(t->dinfo, &leaf->base, key);
+    finded = is_eq_at(t->dinfo, &leaf->base, pos, key);
+  }
+
+  if (finded) {
+    if (assign) {
+      leaf->values[pos] = value;
+    }
+  } else if (leaf->base.size < CDC_BPLUS_TREE_ORDER) {
+    leaf_insert_at(leaf, pos, key, value);
+    ++t->size;
+  } else {
+    struct split_nodes nodes;
+    enum cdc_stat stat = alloc_split_nodes(t, path, &nodes);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+
+    struct cdc_bplus_tree_leaf *right = nodes.leaf;
+    split_leaf(t, &leaf, &pos, key, value, right);
+    insert_separator(t, path, t->height, right->base.keys[0], &right->base,
+                     &nodes);
+    assert(nodes.count == 0);
+    ++t->size;
+  }
+
+  if (it) {
+    it->container = t;
+    it->leaf = leaf;
+    it->pos = pos;
+  }
+
+  if (inserted) {
+    *inserted = !finded;
+  }
+
+  return CDC_STATUS_OK;
+}
+
+static void unlink_leaf(struct cdc_bplus_tree *t,
+                        struct cdc_bplus_tree_leaf *leaf)
+{
+  if (leaf->prev) {
+    leaf->prev->next = leaf->next;
+  } else {
+    t->head = leaf->next;
+  }
+
+  if (leaf->next) {
+    leaf->next->prev = leaf->prev;
+  } else {
+    t->tail = leaf->prev;
+  }
+}
+
+static void rebalance_leaf(struct cdc_bplus_tree *t,
+                           struct cdc_bplus_tree_inner *parent, size_t index)
+{
+  struct cdc_bplus_tree_leaf *leaf = to_leaf(parent->children[index]);
+  struct cdc_bplus_tree_leaf *left =
+      index > 0 ? to_leaf(parent->children[index - 1]) : NULL;
+  struct cdc_bplus_tree_leaf *right = index < parent->base.size
+                                          ? to_leaf(parent->children[index + 1])
+                                          : NULL;
+  if (left && left->base.size > MIN_KEYS) {
+    size_t last = left->base.size - 1;
+    leaf_insert_at(leaf, 0, left->base.keys[last], left->values[last]);
+    --left->base.size;
+    parent->base.keys[index - 1] = leaf->base.keys[0];
+  } else if (right && right->base.size > MIN_KEYS) {
+    leaf_insert_at(leaf, leaf->base.size, right->base.keys[0],
+                   right->values[0]);
+    leaf_erase_at(right, 0);
+    parent->base.keys[index] = right->base.keys[0];
+  } else {
+    if (left) {
+      right = leaf;
+      leaf = left;
+      --index;
+    }
+
+    memcpy(leaf->base.keys + leaf->base.size, right->base.keys,
+           right->base.size * sizeof(void *));
+    memcpy(leaf->values + leaf->base.size, right->values,
+           right->base.size * sizeof(void *));
+    leaf->base.size += right->base.size;
+    unlink_leaf(t, right);
+    inner_erase_at(parent, index);
+    free_node(t, &right->base);
+  }
+}
+
+static void rebalance_inner(struct cdc_bplus_tree *t,
+                            struct cdc_bplus_tree_inner *parent, size_t index)
+{
+  struct cdc_bplus_tree_inner *node = to_inner(parent->children[index]);
+  struct cdc_bplus_tree_inner *left =
+      index > 0 ? to_inner(parent->children[index - 1]) : NULL;
+  struct cdc_bplus_tree_inner *right =
+      index < parent->base.size ? to_inner(parent->children[index + 1]) : NULL;
+  if (left && left->base.size > MIN_KEYS) {
+    size_t size = node->base.size;
+    memmove(node->base.keys + 1, node->base.keys, size * sizeof(void *));
+    memmove(node->children + 1, node->children,
+            (size + 1) * sizeof(struct cdc_bplus_tree_node *));
+    node->base.keys[0] = parent->base.keys[index - 1];
+    node->children[0] = left->children[left->base.size];
+    ++node->base.size;
+    parent->base.keys[index - 1] = left->base.keys[left->base.size - 1];
+    --left->base.size;
+  } else if (right && right->base.size > MIN_KEYS) {
+    node->base.keys[node->base.size] = parent->base.keys[index];
+    node->children[node->base.size + 1] = right->children[0];
+    ++node->base.size;
+    parent->base.keys[index] = right->base.keys[0];
+    size_t size = right->base.size - 1;
+    memmove(right->base.keys, right->base.keys + 1, size * sizeof(void *));
+    memmove(right->children, right->children + 1,
+            (size + 1) * sizeof(struct cdc_bplus_tree_node *));
+    right->base.size = size;
+  } else {
+    if (left) {
+      right = node;
+      node = left;
+      --index;
+    }
+
+    size_t size = node->base.size;
+    node->base.keys[size] = parent->base.keys[index];
+    memcpy(node->base.keys + size + 1, right->base.keys,
+           right->base.size * sizeof(void *));
+    memcpy(node->children + size + 1, right->children,
+           (right->base.size + 1) * sizeof(struct cdc_bplus_tree_node *));
+    node->base.size += right->base.size + 1;
+    inner_erase_at(parent, index);
+    free_node(t, &right->base);
+  }
+}
+
+static void erase_pair(struct cdc_bplus_tree *t, struct path_item *path,
+                       struct cdc_bplus_tree_leaf *leaf, size_t pos)
+{
+  void *key = leaf->base.keys[pos];
+  void *value = leaf->values[pos];
+  leaf_erase_at(leaf, pos);
+  --t->size;
+
+  struct cdc_bplus_tree_node *child = &leaf->base;
+  for (size_t depth = t->height; depth-- > 0;) {
+    struct cdc_bplus_tree_inner *parent = path[depth].node;
+    size_t index = path[depth].index;
+    // The erased key may still be a separator; replace it while the keys
+    // are still alive. An emptied last leaf is merged or refilled below,
+    // which updates the separator too.
+    if (index > 0 && parent->base.keys[index - 1] == key && child->size) {
+      parent->base.keys[index - 1] = min_key(child);
+    }
+
+    if (child->size < MIN_KEYS) {
+      if (child->is_leaf) {
+        rebalance_leaf(t, parent, index);
+      } else {
+        rebalance_inner(t, parent, index);
+      }
+    }
+
+    child = &parent->base;
+  }
+
+  if (!t->root->is_leaf && t->root->size == 0) {
+    struct cdc_bplus_tree_node *root = t->root;
+    t->root = to_inner(root)->children[0];
+    --t->height;
+    free_node(t, root);
+  } else if (t->root->is_leaf && t->root->size == 0) {
+    free_node(t, t->root);
+    t->root = NULL;
+    t->head = t->tail = NULL;
+  }
+
+  if (CDC_HAS_DFREE(t->dinfo)) {
+    struct cdc_pair pair = {key, value};
+    t->dinfo->dfree(&pair);
+  }
+}
+
+static enum cdc_stat init_varg(struct cdc_bplus_tree *t, va_list args)
+{
+  struct cdc_pair *pair = NULL;
+  while ((pair = va_arg(args, struct cdc_pair *)) != CDC_END) {
+    enum cdc_stat stat =
+        cdc_bplus_tree_insert(t, pair->first, pair->second, NULL);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  return CDC_STATUS_OK;
+}
+
+enum cdc_stat cdc_bplus_tree_ctor(struct cdc_bplus_tree **t,
+                                  struct cdc_data_info *info)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_ORDER(info));
+
+  struct cdc_bplus_tree *tmp =
+      (struct cdc_bplus_tree *)calloc(sizeof(struct cdc_bplus_tree), 1);
+  if (!tmp) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  if (info && !(tmp->dinfo = cdc_di_shared_ctorc(info))) {
+    free(tmp);
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  if (info->pool_chunk) {
+    cdc_node_pool_init(&tmp->leaf_pool, sizeof(struct cdc_bplus_tree_leaf),
+                       info->pool_chunk);
+    cdc_node_pool_init(&tmp->inner_pool, sizeof(struct cdc_bplus_tree_inner),
+                       info->pool_chunk);
+  }
+
+  *t = tmp;
+  return CDC_STATUS_OK;
+}
+
+enum cdc_stat cdc_bplus_tree_ctorl(struct cdc_bplus_tree **t,
+                                   struct cdc_data_info *info, ...)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_ORDER(info));
+
+  va_list args;
+  va_start(args, info);
+  enum cdc_stat stat = cdc_bplus_tree_ctorv(t, info, args);
+  va_end(args);
+  return stat;
+}
+
+enum cdc_stat cdc_bplus_tree_ctorv(struct cdc_bplus_tree **t,
+                                   struct cdc_data_info *info, va_list args)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_ORDER(info));
+
+  enum cdc_stat stat = cdc_bplus_tree_ctor(t, info);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  return init_varg(*t, args);
+}
+
+void cdc_bplus_tree_dtor(struct cdc_bplus_tree *t)
+{
+  assert(t != NULL);
+
+  free_nodes(t);
+  cdc_di_shared_dtor(t->dinfo);
+  free(t);
+}
+
+enum cdc_stat cdc_bplus_tree_get(struct cdc_bplus_tree *t, void *key,
+                                 void **value)
+{
+  assert(t != NULL);
+
+  struct cdc_bplus_tree_leaf *leaf = NULL;
+  size_t pos = 0;
+  if (find_pos(t, key, &leaf, &pos)) {
+    *value = leaf->values[pos];
+    return CDC_STATUS_OK;
+  }
+
+  return CDC_STATUS_NOT_FOUND;
+}
+
+size_t cdc_bplus_tree_count(struct cdc_bplus_tree *t, void *key)
+{
+  assert(t != NULL);
+
+  struct cdc_bplus_tree_leaf *leaf = NULL;
+  size_t pos = 0;
+  return (size_t)find_pos(t, key, &leaf, &pos);
+}
+
+void cdc_bplus_tree_find(struct cdc_bplus_tree *t, void *key,
+                         struct cdc_bplus_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_bplus_tree_leaf *leaf = NULL;
+  size_t pos = 0;
+  if (!find_pos(t, key, &leaf, &pos)) {
+    cdc_bplus_tree_end(t, it);
+    return;
+  }
+
+  it->container = t;
+  it->leaf = leaf;
+  it->pos = pos;
+}
+
+// Sets the iterator to the position pos of leaf, moving to the next leaf if
+// pos is past the last key of leaf.
+static void set_iter(struct cdc_bplus_tree *t, struct cdc_bplus_tree_leaf *leaf,
+                     size_t pos, struct cdc_bplus_tree_iter *it)
+{
+  while (leaf && pos == leaf->base.size) {
+    leaf = leaf->next;
+    pos = 0;
+  }
+
+  if (!leaf) {
+    cdc_bplus_tree_end(t, it);
+    return;
+  }
+
+  it->container = t;
+  it->leaf = leaf;
+  it->pos = pos;
+}
+
+void cdc_bplus_tree_lower_bound(struct cdc_bplus_tree *t, void *key,
+                                struct cdc_bplus_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  if (!t->root) {
+    cdc_bplus_tree_end(t, it);
+    return;
+  }
+
+  struct cdc_bplus_tree_leaf *leaf = find_leaf(t, key, NULL);
+  set_iter(t, leaf, lower_bound(t->dinfo, &leaf->base, key), it);
+}
+
+void cdc_bplus_tree_upper_bound(struct cdc_bplus_tree *t, void *key,
+                                struct cdc_bplus_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  if (!t->root) {
+    cdc_bplus_tree_end(t, it);
+    return;
+  }
+
+  // The first key greater than key is found as the child index of a node.
+  struct cdc_bplus_tree_leaf *leaf = find_leaf(t, key, NULL);
+  set_iter(t, leaf, child_index(t->dinfo, &leaf->base, key), it);
+}
+
+void cdc_bplus_tree_equal_range(struct cdc_bplus_tree *t, void *key,
+                                struct cdc_pair_bplus_tree_iter *ret)
+{
+  assert(t != NULL);
+  assert(ret != NULL);
+
+  if (!t->root) {
+    cdc_bplus_tree_end(t, &ret->first);
+    cdc_bplus_tree_end(t, &ret->second);
+    return;
+  }
+
+  struct cdc_bplus_tree_leaf *leaf = find_leaf(t, key, NULL);
+  size_t pos = lower_bound(t->dinfo, &leaf->base, key);
+  set_iter(t, leaf, pos, &ret->first);
+  if (is_eq_at(t->dinfo, &leaf->base, pos, key)) {
+    ++pos;
+  }
+
+  set_iter(t, leaf, pos, &ret->second);
+}
+
+enum cdc_stat cdc_bplus_tree_insert(struct cdc_bplus_tree *t, void *key,
+                                    void *value,
+                                    struct cdc_pair_bplus_tree_iter_bool *ret)
+{
+  assert(t != NULL);
+
+  struct cdc_bplus_tree_iter *it = NULL;
+  bool *inserted = NULL;
+  if (ret) {
+    it = &ret->first;
+    inserted = &ret->second;
+  }
+
+  return cdc_bplus_tree_insert1(t, key, value, it, inserted);
+}
+
+enum cdc_stat cdc_bplus_tree_insert1(struct cdc_bplus_tree *t, void *key,
+                                     void *value,
+                                     struct cdc_bplus_tree_iter *it,
+                                     bool *inserted)
+{
+  assert(t != NULL);
+
+  return insert_pair(t, key, value, false, it, inserted);
+}
+
+enum cdc_stat cdc_bplus_tree_insert_or_assign(
+    struct cdc_bplus_tree *t, void *key, void *value,
+    struct cdc_pair_bplus_tree_iter_bool *ret)
+{
+  assert(t != NULL);
+
+  struct cdc_bplus_tree_iter *it = NULL;
+  bool *inserted = NULL;
+  if (ret) {
+    it = &ret->first;
+    inserted = &ret->second;
+  }
+
+  return cdc_bplus_tree_insert_or_assign1(t, key, value, it, inserted);
+}
+
+enum cdc_stat cdc_bplus_tree_insert_or_assign1(struct cdc_bplus_tree *t,
+                                               void *key, void *value,
+                                               struct cdc_bplus_tree_iter *it,
+                                               bool *inserted)
+{
+  assert(t != NULL);
+
+  return insert_pair(t, key, value, true, it, inserted);
+}
+
+size_t cdc_bplus_tree_erase(struct cdc_bplus_tree *t, void *key)
+{
+  assert(t != NULL);
+
+  if (!t->root) {
+    return 0;
+  }
+
+  struct path_item path[MAX_HEIGHT];
+  struct cdc_bplus_tree_leaf *leaf = find_leaf(t, key, path);
+  size_t pos = lower_bound(t->dinfo, &leaf->base, key);
+  if (!is_eq_at(t->dinfo, &leaf->base, pos, key)) {
+    return 0;
+  }
+
+  erase_pair(t, path, leaf, pos);
+  return 1;
+}
+
+void cdc_bplus_tree_clear(struct cdc_bplus_tree *t)
+{
+  assert(t != NULL);
+
+  free_nodes(t);
+  t->root = NULL;
+  t->head = NULL;
+  t->tail = NULL;
+  t->size = 0;
+  t->height = 0;
+}
+
+void cdc_bplus_tree_swap(struct cdc_bplus_tree *a, struct cdc_bplus_tree *b)
+{
+  assert(a != NULL);
+  assert(b != NULL);
+
+  CDC_SWAP(struct cdc_bplus_tree_node *, a->root, b->root);
+  CDC_SWAP(struct cdc_bplus_tree_leaf *, a->head, b->head);
+  CDC_SWAP(struct cdc_bplus_tree_leaf *, a->tail, b->tail);
+  CDC_SWAP(size_t, a->size, b->size);
+  CDC_SWAP(size_t, a->height, b->height);
+  CDC_SWAP(struct cdc_data_info *, a->dinfo, b->dinfo);
+  CDC_SWAP(struct cdc_node_pool, a->leaf_pool, b->leaf_pool);
+  CDC_SWAP(struct cdc_node_pool, a->inner_pool, b->inner_pool);
+}
+
+void cdc_bplus_tree_begin(struct cdc_bplus_tree *t,
+                          struct cdc_bplus_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  it->container = t;
+  it->leaf = t->head;
+  it->pos = 0;
+}
+
+void cdc_bplus_tree_end(struct cdc_bplus_tree *t,
+                        struct cdc_bplus_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  it->container = t;
+  it->leaf = NULL;
+  it->pos = 0;
+}
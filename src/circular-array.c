@@ -50,7 +50,7 @@ static enum cdc_stat reallocate(struct cdc_circular_array *d, size_t capacity)
     return CDC_STATUS_OK;
   }
 
-  void **tmp = (void **)malloc(capacity * sizeof(void *));
+  void **tmp = (void **)cdc_di_alloc(d->dinfo, capacity * sizeof(void *));
   if (!tmp) {
     return CDC_STATUS_BAD_ALLOC;
   }
@@ -69,7 +69,7 @@ static enum cdc_stat reallocate(struct cdc_circular_array *d, size_t capacity)
     memcpy(tmp, d->buffer + d->head, d->size * sizeof(void *));
   }
 
-  free(d->buffer);
+  cdc_di_free(d->dinfo, d->buffer);
   d->tail = d->size;
   d->head = 0;
   d->capacity = capacity;
@@ -169,7 +169,7 @@ void cdc_circular_array_dtor(struct cdc_circular_array *d)
   assert(d != NULL);
 
   free_data(d);
-  free(d->buffer);
+  cdc_di_free(d->dinfo, d->buffer);
   cdc_di_shared_dtor(d->dinfo);
   free(d);
 }
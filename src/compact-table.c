@@ -0,0 +1,538 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "cdcontainers/compact-table.h"
+
+#include "cdcontainers/data-info.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define COMPACT_TABLE_MIN_CAPACITY 8  // must be pow 2
+#define COMPACT_TABLE_COPACITY_SHIFT 1
+#define COMPACT_TABLE_LOAD_FACTOR 1.0f
+#define COMPACT_TABLE_MAX_SIZE ((size_t)CDC_COMPACT_TABLE_NIL - 1)
+
+static uint32_t make_hash(struct cdc_compact_table *t, void *key)
+{
+  return (uint32_t)cdc_hash_u64(key ? t->dinfo->hash(key) : 0);
+}
+
+// The fingerprint mixes all bits of the hash, so entries of one bucket still
+// get different fingerprints.
+static uint32_t fingerprint(uint32_t hash)
+{
+  return (uint32_t)1 << ((hash * UINT32_C(0x9e3779b1)) >> 27);
+}
+
+static struct cdc_compact_table_bucket *get_bucket(struct cdc_compact_table *t,
+                                                   uint32_t hash)
+{
+  return &t->buckets[hash & (t->bcount - 1)];
+}
+
+static void free_entry(struct cdc_compact_table *t,
+                       struct cdc_compact_table_entry *entry)
+{
+  if (CDC_HAS_DFREE(t->dinfo)) {
+    struct cdc_pair pair = {.first = entry->key, .second = entry->value};
+    t->dinfo->dfree(&pair);
+  }
+}
+
+static void free_entries(struct cdc_compact_table *t)
+{
+  if (!CDC_HAS_DFREE(t->dinfo)) {
+    return;
+  }
+
+  for (size_t i = 0; i < t->size; ++i) {
+    free_entry(t, &t->entries[i]);
+  }
+}
+
+static void reset_buckets(struct cdc_compact_table_bucket *buckets,
+                          size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    buckets[i].head = CDC_COMPACT_TABLE_NIL;
+    buckets[i].filter = 0;
+  }
+}
+
+static void link_entry(struct cdc_compact_table *t, uint32_t index)
+{
+  struct cdc_compact_table_entry *entry = &t->entries[index];
+  struct cdc_compact_table_bucket *bucket = get_bucket(t, entry->hash);
+  entry->next = bucket->head;
+  bucket->head = index;
+  bucket->filter |= fingerprint(entry->hash);
+}
+
+static bool should_rehash(struct cdc_compact_table *t)
+{
+  return ((float)(t->size + 1) / (float)t->bcount) > t->load_factor;
+}
+
+static uint32_t find_entry(struct cdc_compact_table *t, void *key,
+                           uint32_t hash)
+{
+  struct cdc_compact_table_bucket *bucket = get_bucket(t, hash);
+  if (!(bucket->filter & fingerprint(hash))) {
+    return CDC_COMPACT_TABLE_NIL;
+  }
+
+  uint32_t index = bucket->head;
+  while (index != CDC_COMPACT_TABLE_NIL) {
+    struct cdc_compact_table_entry *entry = &t->entries[index];
+    if (entry->hash == hash && t->dinfo->eq(key, entry->key)) {
+      return index;
+    }
+
+    index = entry->next;
+  }
+
+  return CDC_COMPACT_TABLE_NIL;
+}
+
+// Returns the link that refers to the entry with the index.
+static uint32_t *find_link(struct cdc_compact_table *t, uint32_t index)
+{
+  uint32_t *link = &get_bucket(t, t->entries[index].hash)->head;
+  while (*link != index) {
+    link = &t->entries[*link].next;
+  }
+
+  return link;
+}
+
+static void update_filter(struct cdc_compact_table *t,
+                          struct cdc_compact_table_bucket *bucket)
+{
+  uint32_t filter = 0;
+  for (uint32_t i = bucket->head; i != CDC_COMPACT_TABLE_NIL;
+       i = t->entries[i].next) {
+    filter |= fingerprint(t->entries[i].hash);
+  }
+
+  bucket->filter = filter;
+}
+
+static void erase_entry(struct cdc_compact_table *t, uint32_t index)
+{
+  struct cdc_compact_table_entry *entry = &t->entries[index];
+  *find_link(t, index) = entry->next;
+  update_filter(t, get_bucket(t, entry->hash));
+  free_entry(t, entry);
+
+  uint32_t last = (uint32_t)(t->size - 1);
+  if (index != last) {
+    *find_link(t, last) = index;
+    t->entries[index] = t->entries[last];
+  }
+
+  --t->size;
+}
+
+static enum cdc_stat reserve_entries(struct cdc_compact_table *t, size_t count)
+{
+  if (count <= t->capacity) {
+    return CDC_STATUS_OK;
+  }
+
+  if (count > COMPACT_TABLE_MAX_SIZE) {
+    return CDC_STATUS_OVERFLOW;
+  }
+
+  struct cdc_compact_table_entry *entries =
+      (struct cdc_compact_table_entry *)cdc_di_realloc(
+          t->dinfo, t->entries,
+          t->capacity * sizeof(struct cdc_compact_table_entry),
+          count * sizeof(struct cdc_compact_table_entry));
+  if (!entries) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  t->entries = entries;
+  t->capacity = count;
+  return CDC_STATUS_OK;
+}
+
+static enum cdc_stat reallocate(struct cdc_compact_table *t, size_t count)
+{
+  if (count < COMPACT_TABLE_MIN_CAPACITY) {
+    count = COMPACT_TABLE_MIN_CAPACITY;
+  }
+
+  count = cdc_up_to_pow2(count);
+  while ((float)t->size / (float)count > t->load_factor) {
+    count <<= COMPACT_TABLE_COPACITY_SHIFT;
+  }
+
+  if (count == t->bcount) {
+    return CDC_STATUS_OK;
+  }
+
+  struct cdc_compact_table_bucket *buckets =
+      (struct cdc_compact_table_bucket *)cdc_di_alloc(
+          t->dinfo, count * sizeof(struct cdc_compact_table_bucket));
+  if (!buckets) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  reset_buckets(buckets, count);
+  cdc_di_free(t->dinfo, t->buckets);
+  t->buckets = buckets;
+  t->bcount = count;
+  for (size_t i = 0; i < t->size; ++i) {
+    link_entry(t, (uint32_t)i);
+  }
+
+  return CDC_STATUS_OK;
+}
+
+static enum cdc_stat make_and_insert_unique(struct cdc_compact_table *t,
+                                            void *key, void *value,
+                                            uint32_t hash, uint32_t *ret)
+{
+  if (t->size == t->capacity) {
+    enum cdc_stat stat = reserve_entries(
+        t, CDC_MIN(t->capacity << COMPACT_TABLE_COPACITY_SHIFT,
+                   COMPACT_TABLE_MAX_SIZE));
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+
+    if (t->size == t->capacity) {
+      return CDC_STATUS_OVERFLOW;
+    }
+  }
+
+  if (should_rehash(t)) {
+    enum cdc_stat stat =
+        reallocate(t, t->bcount << COMPACT_TABLE_COPACITY_SHIFT);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  uint32_t index = (uint32_t)t->size;
+  struct cdc_compact_table_entry *entry = &t->entries[index];
+  entry->key = key;
+  entry->value = value;
+  entry->hash = hash;
+  link_entry(t, index);
+  ++t->size;
+  *ret = index;
+  return CDC_STATUS_OK;
+}
+
+static enum cdc_stat init_varg(struct cdc_compact_table *t, va_list args)
+{
+  struct cdc_pair *pair = NULL;
+  while ((pair = va_arg(args, struct cdc_pair *)) != CDC_END) {
+    enum cdc_stat stat =
+        cdc_compact_table_insert(t, pair->first, pair->second, NULL, NULL);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  return CDC_STATUS_OK;
+}
+
+enum cdc_stat cdc_compact_table_ctor1(struct cdc_compact_table **t,
+                                      struct cdc_data_info *info,
+                                      float load_factor)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0);
+
+  struct cdc_compact_table *tmp =
+      (struct cdc_compact_table *)calloc(sizeof(struct cdc_compact_table), 1);
+  if (!tmp) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  tmp->load_factor = load_factor;
+  enum cdc_stat stat = CDC_STATUS_OK;
+  if (info && !(tmp->dinfo = cdc_di_shared_ctorc(info))) {
+    stat = CDC_STATUS_BAD_ALLOC;
+    goto free_compact_table;
+  }
+
+  stat = reserve_entries(tmp, COMPACT_TABLE_MIN_CAPACITY);
+  if (stat != CDC_STATUS_OK) {
+    goto free_di;
+  }
+
+  stat = reallocate(tmp, COMPACT_TABLE_MIN_CAPACITY);
+  if (stat != CDC_STATUS_OK) {
+    goto free_entries;
+  }
+
+  *t = tmp;
+  return stat;
+free_entries:
+  cdc_di_free(tmp->dinfo, tmp->entries);
+free_di:
+  cdc_di_shared_dtor(tmp->dinfo);
+free_compact_table:
+  free(tmp);
+  return stat;
+}
+
+enum cdc_stat cdc_compact_table_ctorl1(struct cdc_compact_table **t,
+                                       struct cdc_data_info *info,
+                                       float load_factor, ...)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0);
+
+  va_list args;
+  va_start(args, load_factor);
+  enum cdc_stat stat = cdc_compact_table_ctorv1(t, info, load_factor, args);
+  va_end(args);
+  return stat;
+}
+
+enum cdc_stat cdc_compact_table_ctorv1(struct cdc_compact_table **t,
+                                       struct cdc_data_info *info,
+                                       float load_factor, va_list args)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0);
+
+  enum cdc_stat stat = cdc_compact_table_ctor1(t, info, load_factor);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  return init_varg(*t, args);
+}
+
+enum cdc_stat cdc_compact_table_ctor(struct cdc_compact_table **t,
+                                     struct cdc_data_info *info)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  return cdc_compact_table_ctor1(t, info, COMPACT_TABLE_LOAD_FACTOR);
+}
+
+enum cdc_stat cdc_compact_table_ctorl(struct cdc_compact_table **t,
+                                      struct cdc_data_info *info, ...)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  va_list args;
+  va_start(args, info);
+  enum cdc_stat stat = cdc_compact_table_ctorv(t, info, args);
+  va_end(args);
+  return stat;
+}
+
+enum cdc_stat cdc_compact_table_ctorv(struct cdc_compact_table **t,
+                                      struct cdc_data_info *info, va_list args)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  return cdc_compact_table_ctorv1(t, info, COMPACT_TABLE_LOAD_FACTOR, args);
+}
+
+void cdc_compact_table_dtor(struct cdc_compact_table *t)
+{
+  assert(t != NULL);
+
+  free_entries(t);
+  cdc_di_free(t->dinfo, t->entries);
+  cdc_di_free(t->dinfo, t->buckets);
+  cdc_di_shared_dtor(t->dinfo);
+  free(t);
+}
+
+enum cdc_stat cdc_compact_table_get(struct cdc_compact_table *t, void *key,
+                                    void **value)
+{
+  assert(t != NULL);
+
+  uint32_t index = find_entry(t, key, make_hash(t, key));
+  if (index == CDC_COMPACT_TABLE_NIL) {
+    return CDC_STATUS_NOT_FOUND;
+  }
+
+  *value = t->entries[index].value;
+  return CDC_STATUS_OK;
+}
+
+size_t cdc_compact_table_count(struct cdc_compact_table *t, void *key)
+{
+  assert(t != NULL);
+
+  return (size_t)(find_entry(t, key, make_hash(t, key)) !=
+                  CDC_COMPACT_TABLE_NIL);
+}
+
+void cdc_compact_table_find(struct cdc_compact_table *t, void *key,
+                            struct cdc_compact_table_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  uint32_t index = find_entry(t, key, make_hash(t, key));
+  it->container = t;
+  it->current = t->entries +
+                (index != CDC_COMPACT_TABLE_NIL ? (size_t)index : t->size);
+}
+
+void cdc_compact_table_clear(struct cdc_compact_table *t)
+{
+  assert(t != NULL);
+
+  free_entries(t);
+  reset_buckets(t->buckets, t->bcount);
+  t->size = 0;
+}
+
+enum cdc_stat cdc_compact_table_insert(struct cdc_compact_table *t, void *key,
+                                       void *value,
+                                       struct cdc_compact_table_iter *it,
+                                       bool *inserted)
+{
+  assert(t != NULL);
+
+  uint32_t hash = make_hash(t, key);
+  uint32_t index = find_entry(t, key, hash);
+  bool finded = index != CDC_COMPACT_TABLE_NIL;
+  if (!finded) {
+    enum cdc_stat stat = make_and_insert_unique(t, key, value, hash, &index);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  if (it) {
+    it->container = t;
+    it->current = t->entries + index;
+  }
+
+  if (inserted) {
+    *inserted = !finded;
+  }
+
+  return CDC_STATUS_OK;
+}
+
+enum cdc_stat cdc_compact_table_insert_or_assign(
+    struct cdc_compact_table *t, void *key, void *value,
+    struct cdc_compact_table_iter *it, bool *inserted)
+{
+  assert(t != NULL);
+
+  uint32_t hash = make_hash(t, key);
+  uint32_t index = find_entry(t, key, hash);
+  bool finded = index != CDC_COMPACT_TABLE_NIL;
+  if (!finded) {
+    enum cdc_stat stat = make_and_insert_unique(t, key, value, hash, &index);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  } else {
+    t->entries[index].value = value;
+  }
+
+  if (it) {
+    it->container = t;
+    it->current = t->entries + index;
+  }
+
+  if (inserted) {
+    *inserted = !finded;
+  }
+
+  return CDC_STATUS_OK;
+}
+
+size_t cdc_compact_table_erase(struct cdc_compact_table *t, void *key)
+{
+  assert(t != NULL);
+
+  uint32_t index = find_entry(t, key, make_hash(t, key));
+  if (index == CDC_COMPACT_TABLE_NIL) {
+    return 0;
+  }
+
+  erase_entry(t, index);
+  return 1;
+}
+
+void cdc_compact_table_swap(struct cdc_compact_table *a,
+                            struct cdc_compact_table *b)
+{
+  assert(a != NULL);
+  assert(b != NULL);
+
+  CDC_SWAP(struct cdc_compact_table_entry *, a->entries, b->entries);
+  CDC_SWAP(size_t, a->capacity, b->capacity);
+  CDC_SWAP(struct cdc_compact_table_bucket *, a->buckets, b->buckets);
+  CDC_SWAP(size_t, a->bcount, b->bcount);
+  CDC_SWAP(float, a->load_factor, b->load_factor);
+  CDC_SWAP(size_t, a->size, b->size);
+  CDC_SWAP(struct cdc_data_info *, a->dinfo, b->dinfo);
+}
+
+enum cdc_stat cdc_compact_table_rehash(struct cdc_compact_table *t,
+                                       size_t count)
+{
+  assert(t != NULL);
+
+  if (count <= t->bcount) {
+    return CDC_STATUS_OK;
+  }
+
+  return reallocate(t, count);
+}
+
+enum cdc_stat cdc_compact_table_reserve(struct cdc_compact_table *t,
+                                        size_t count)
+{
+  assert(t != NULL);
+
+  enum cdc_stat stat = reserve_entries(t, count);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  return cdc_compact_table_rehash(t,
+                                  (size_t)((float)count / t->load_factor) + 1);
+}
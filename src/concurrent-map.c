@@ -0,0 +1,232 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "cdcontainers/concurrent-map.h"
+
+#include "cdcontainers/data-info.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#define CONCURRENT_MAP_CONCURRENCY 16
+#define CONCURRENT_MAP_SEGMENTS_PER_THREAD 4
+
+static size_t hash_key(struct cdc_concurrent_map *m, void *key)
+{
+  return key ? m->dinfo->hash(key) : 0;
+}
+
+// Segments are taken from the high bits of the mixed hash, while the tables of
+// segments use the low bits for buckets.
+static struct cdc_concurrent_map_segment *get_segment(
+    struct cdc_concurrent_map *m, size_t hash)
+{
+  return &m->segments[cdc_hash_u64(hash) >> m->segment_shift];
+}
+
+static void free_segments(struct cdc_concurrent_map *m, size_t count)
+{
+  for (size_t i = 0; i < count; ++i) {
+    cdc_hash_table_dtor(m->segments[i].table);
+    pthread_rwlock_destroy(&m->segments[i].lock);
+  }
+
+  free(m->segments);
+}
+
+// The segments share the data info of the map, which is a heap copy of the
+// data info given by the user.
+static enum cdc_stat init_segments(struct cdc_concurrent_map *m)
+{
+  m->segments = (struct cdc_concurrent_map_segment *)malloc(
+      m->segment_count * sizeof(struct cdc_concurrent_map_segment));
+  if (!m->segments) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  for (size_t i = 0; i < m->segment_count; ++i) {
+    struct cdc_concurrent_map_segment *segment = &m->segments[i];
+    enum cdc_stat stat = cdc_hash_table_ctor(&segment->table, m->dinfo);
+    if (stat != CDC_STATUS_OK) {
+      free_segments(m, i);
+      return stat;
+    }
+
+    if (pthread_rwlock_init(&segment->lock, NULL) != 0) {
+      cdc_hash_table_dtor(segment->table);
+      free_segments(m, i);
+      return CDC_STATUS_UNKN;
+    }
+  }
+
+  return CDC_STATUS_OK;
+}
+
+enum cdc_stat cdc_concurrent_map_ctor(struct cdc_concurrent_map **m,
+                                      struct cdc_data_info *info)
+{
+  assert(m != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  return cdc_concurrent_map_ctor1(m, info, CONCURRENT_MAP_CONCURRENCY);
+}
+
+enum cdc_stat cdc_concurrent_map_ctor1(struct cdc_concurrent_map **m,
+                                       struct cdc_data_info *info,
+                                       size_t concurrency)
+{
+  assert(m != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(concurrency > 0);
+
+  struct cdc_concurrent_map *tmp =
+      (struct cdc_concurrent_map *)calloc(sizeof(struct cdc_concurrent_map), 1);
+  if (!tmp) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  tmp->segment_count =
+      cdc_up_to_pow2(concurrency * CONCURRENT_MAP_SEGMENTS_PER_THREAD);
+  tmp->segment_shift = CDC_DIGITS_SIZE;
+  for (size_t count = tmp->segment_count; count > 1; count >>= 1) {
+    --tmp->segment_shift;
+  }
+
+  enum cdc_stat stat = CDC_STATUS_OK;
+  if (!(tmp->dinfo = cdc_di_shared_ctorc(info))) {
+    stat = CDC_STATUS_BAD_ALLOC;
+    goto free_concurrent_map;
+  }
+
+  stat = init_segments(tmp);
+  if (stat != CDC_STATUS_OK) {
+    goto free_di;
+  }
+
+  *m = tmp;
+  return stat;
+free_di:
+  cdc_di_shared_dtor(tmp->dinfo);
+free_concurrent_map:
+  free(tmp);
+  return stat;
+}
+
+void cdc_concurrent_map_dtor(struct cdc_concurrent_map *m)
+{
+  assert(m != NULL);
+
+  free_segments(m, m->segment_count);
+  cdc_di_shared_dtor(m->dinfo);
+  free(m);
+}
+
+enum cdc_stat cdc_concurrent_map_get(struct cdc_concurrent_map *m, void *key,
+                                     void **value)
+{
+  assert(m != NULL);
+
+  size_t hash = hash_key(m, key);
+  struct cdc_concurrent_map_segment *segment = get_segment(m, hash);
+  pthread_rwlock_rdlock(&segment->lock);
+  enum cdc_stat stat =
+      cdc_hash_table_get_hashed(segment->table, key, hash, value);
+  pthread_rwlock_unlock(&segment->lock);
+  return stat;
+}
+
+size_t cdc_concurrent_map_count(struct cdc_concurrent_map *m, void *key)
+{
+  assert(m != NULL);
+
+  void *value = NULL;
+  return (size_t)(cdc_concurrent_map_get(m, key, &value) == CDC_STATUS_OK);
+}
+
+size_t cdc_concurrent_map_size(struct cdc_concurrent_map *m)
+{
+  assert(m != NULL);
+
+  size_t size = 0;
+  for (size_t i = 0; i < m->segment_count; ++i) {
+    struct cdc_concurrent_map_segment *segment = &m->segments[i];
+    pthread_rwlock_rdlock(&segment->lock);
+    size += cdc_hash_table_size(segment->table);
+    pthread_rwlock_unlock(&segment->lock);
+  }
+
+  return size;
+}
+
+void cdc_concurrent_map_clear(struct cdc_concurrent_map *m)
+{
+  assert(m != NULL);
+
+  for (size_t i = 0; i < m->segment_count; ++i) {
+    struct cdc_concurrent_map_segment *segment = &m->segments[i];
+    pthread_rwlock_wrlock(&segment->lock);
+    cdc_hash_table_clear(segment->table);
+    pthread_rwlock_unlock(&segment->lock);
+  }
+}
+
+enum cdc_stat cdc_concurrent_map_insert(struct cdc_concurrent_map *m,
+                                        void *key, void *value, bool *inserted)
+{
+  assert(m != NULL);
+
+  size_t hash = hash_key(m, key);
+  struct cdc_concurrent_map_segment *segment = get_segment(m, hash);
+  pthread_rwlock_wrlock(&segment->lock);
+  enum cdc_stat stat = cdc_hash_table_insert_hashed(segment->table, key, hash,
+                                                    value, NULL, inserted);
+  pthread_rwlock_unlock(&segment->lock);
+  return stat;
+}
+
+enum cdc_stat cdc_concurrent_map_insert_or_assign(struct cdc_concurrent_map *m,
+                                                  void *key, void *value,
+                                                  bool *inserted)
+{
+  assert(m != NULL);
+
+  size_t hash = hash_key(m, key);
+  struct cdc_concurrent_map_segment *segment = get_segment(m, hash);
+  pthread_rwlock_wrlock(&segment->lock);
+  enum cdc_stat stat = cdc_hash_table_insert_or_assign_hashed(
+      segment->table, key, hash, value, NULL, inserted);
+  pthread_rwlock_unlock(&segment->lock);
+  return stat;
+}
+
+size_t cdc_concurrent_map_erase(struct cdc_concurrent_map *m, void *key)
+{
+  assert(m != NULL);
+
+  size_t hash = hash_key(m, key);
+  struct cdc_concurrent_map_segment *segment = get_segment(m, hash);
+  pthread_rwlock_wrlock(&segment->lock);
+  size_t count = cdc_hash_table_erase_hashed(segment->table, key, hash);
+  pthread_rwlock_unlock(&segment->lock);
+  return count;
+}
@@ -0,0 +1,536 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "cdcontainers/frozen-map.h"
+
+#include "cdcontainers/data-info.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Average number of keys in a bucket.
+#define FROZEN_MAP_BUCKET_SIZE 4
+// The pilot of a bucket with one key holds the slot of the key and this bit.
+#define FROZEN_MAP_SINGLE ((uint32_t)1 << 31)
+#define FROZEN_MAP_MAX_PILOT ((uint32_t)1 << 20)
+#define FROZEN_MAP_ATTEMPTS 32
+
+struct sort_item {
+  size_t hash;
+  size_t index;
+};
+
+struct builder {
+  struct cdc_frozen_map_entry *items;
+  size_t count;
+  // Indices of the items that get a slot, one per distinct hash, and of the
+  // items with a repeated hash.
+  size_t *primary;
+  size_t primary_count;
+  size_t *extra;
+  size_t extra_count;
+};
+
+static size_t user_hash(struct cdc_frozen_map *m, void *key)
+{
+  return key ? m->dinfo->hash(key) : 0;
+}
+
+static uint64_t key_hash(struct cdc_frozen_map *m, size_t hash)
+{
+  return cdc_hash_u64((uint64_t)hash ^ m->seed);
+}
+
+// Maps the hash to [0, count) without a division.
+static size_t reduce(uint64_t hash, size_t count)
+{
+  return (size_t)(((hash & UINT32_MAX) * (uint64_t)count) >> 32);
+}
+
+static size_t get_bucket(struct cdc_frozen_map *m, uint64_t hash)
+{
+  return reduce(hash >> 32, m->pilot_count);
+}
+
+// The result is mixed again, otherwise keys with close hashes would get the
+// same slot for every pilot.
+static size_t displace(struct cdc_frozen_map *m, uint64_t hash,
+                       uint64_t pilot_hash)
+{
+  return reduce(cdc_hash_u64(hash ^ pilot_hash), m->slot_count);
+}
+
+static size_t get_slot(struct cdc_frozen_map *m, uint64_t hash)
+{
+  uint32_t pilot = m->pilots[get_bucket(m, hash)];
+  if (pilot & FROZEN_MAP_SINGLE) {
+    return pilot & ~FROZEN_MAP_SINGLE;
+  }
+
+  return displace(m, hash, cdc_hash_u64(pilot));
+}
+
+static bool is_taken(uint64_t *taken, size_t slot)
+{
+  return (taken[slot / 64] >> (slot % 64)) & 1;
+}
+
+static void flip_taken(uint64_t *taken, size_t slot)
+{
+  taken[slot / 64] ^= (uint64_t)1 << (slot % 64);
+}
+
+static struct cdc_frozen_map_entry *find_extra(struct cdc_frozen_map *m,
+                                               void *key, size_t hash)
+{
+  size_t low = m->slot_count;
+  size_t high = m->size;
+  while (low < high) {
+    size_t mid = low + (high - low) / 2;
+    if (m->entries[mid].hash < hash) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+
+  for (; low < m->size && m->entries[low].hash == hash; ++low) {
+    if (m->dinfo->eq(key, m->entries[low].key)) {
+      return &m->entries[low];
+    }
+  }
+
+  return NULL;
+}
+
+static struct cdc_frozen_map_entry *find_entry(struct cdc_frozen_map *m,
+                                               void *key)
+{
+  if (m->slot_count == 0) {
+    return NULL;
+  }
+
+  size_t hash = user_hash(m, key);
+  struct cdc_frozen_map_entry *entry =
+      &m->entries[get_slot(m, key_hash(m, hash))];
+  if (entry->hash != hash) {
+    return NULL;
+  }
+
+  if (m->dinfo->eq(key, entry->key)) {
+    return entry;
+  }
+
+  return find_extra(m, key, hash);
+}
+
+static int sort_item_cmp(const void *l, const void *r)
+{
+  const struct sort_item *a = (const struct sort_item *)l;
+  const struct sort_item *b = (const struct sort_item *)r;
+  if (a->hash != b->hash) {
+    return a->hash < b->hash ? -1 : 1;
+  }
+
+  return a->index < b->index ? -1 : (a->index > b->index);
+}
+
+// Sorts the items by hash and splits them into the items that get a slot and
+// the items with a repeated hash. Of the equal keys only the first one is
+// kept.
+static enum cdc_stat split_items(struct cdc_frozen_map *m, struct builder *b)
+{
+  struct sort_item *sorted = (struct sort_item *)malloc(
+      (b->count + 1) * sizeof(struct sort_item));
+  b->primary = (size_t *)malloc((b->count + 1) * sizeof(size_t));
+  b->extra = (size_t *)malloc((b->count + 1) * sizeof(size_t));
+  if (!sorted || !b->primary || !b->extra) {
+    free(sorted);
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  for (size_t i = 0; i < b->count; ++i) {
+    b->items[i].hash = user_hash(m, b->items[i].key);
+    sorted[i].hash = b->items[i].hash;
+    sorted[i].index = i;
+  }
+
+  qsort(sorted, b->count, sizeof(struct sort_item), sort_item_cmp);
+  size_t run = 0;
+  for (size_t i = 0; i < b->count; ++i) {
+    if (i == 0 || sorted[i].hash != sorted[i - 1].hash) {
+      run = i;
+      b->primary[b->primary_count++] = sorted[i].index;
+      continue;
+    }
+
+    bool repeated = false;
+    for (size_t j = run; j < i && !repeated; ++j) {
+      repeated = m->dinfo->eq(b->items[sorted[i].index].key,
+                              b->items[sorted[j].index].key);
+    }
+
+    if (!repeated) {
+      b->extra[b->extra_count++] = sorted[i].index;
+    }
+  }
+
+  free(sorted);
+  return CDC_STATUS_OK;
+}
+
+// Searches pilots for all the buckets with the current seed. Returns false if
+// some bucket can not be placed.
+static bool place_buckets(struct cdc_frozen_map *m, struct builder *b,
+                          uint64_t *hashes, size_t *slots, size_t *start,
+                          size_t *keys, size_t *order, uint64_t *taken)
+{
+  size_t count = b->primary_count;
+  memset(start, 0, (m->pilot_count + 1) * sizeof(size_t));
+  memset(taken, 0, (count / 64 + 1) * sizeof(uint64_t));
+  for (size_t i = 0; i < count; ++i) {
+    hashes[i] = key_hash(m, b->items[b->primary[i]].hash);
+    ++start[get_bucket(m, hashes[i]) + 1];
+  }
+
+  size_t max_size = 0;
+  for (size_t i = 0; i < m->pilot_count; ++i) {
+    max_size = CDC_MAX(max_size, start[i + 1]);
+    start[i + 1] += start[i];
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    keys[start[get_bucket(m, hashes[i])]++] = i;
+  }
+
+  // Each start is now the end of its bucket, so the starts are shifted back.
+  memmove(start + 1, start, m->pilot_count * sizeof(size_t));
+  start[0] = 0;
+
+  // The largest buckets are placed first, while most slots are free.
+  size_t n = 0;
+  for (size_t size = max_size; size > 0; --size) {
+    for (size_t i = 0; i < m->pilot_count; ++i) {
+      if (start[i + 1] - start[i] == size) {
+        order[n++] = i;
+      }
+    }
+  }
+
+  size_t free_slot = 0;
+  for (size_t i = 0; i < n; ++i) {
+    size_t bucket = order[i];
+    size_t *bkeys = keys + start[bucket];
+    size_t size = start[bucket + 1] - start[bucket];
+    if (size == 1) {
+      while (is_taken(taken, free_slot)) {
+        ++free_slot;
+      }
+
+      flip_taken(taken, free_slot);
+      slots[bkeys[0]] = free_slot;
+      m->pilots[bucket] = FROZEN_MAP_SINGLE | (uint32_t)free_slot;
+      continue;
+    }
+
+    uint32_t pilot = 0;
+    for (; pilot < FROZEN_MAP_MAX_PILOT; ++pilot) {
+      uint64_t pilot_hash = cdc_hash_u64(pilot);
+      size_t j = 0;
+      for (; j < size; ++j) {
+        size_t slot = displace(m, hashes[bkeys[j]], pilot_hash);
+        if (is_taken(taken, slot)) {
+          break;
+        }
+
+        flip_taken(taken, slot);
+        slots[bkeys[j]] = slot;
+      }
+
+      if (j == size) {
+        break;
+      }
+
+      while (j-- > 0) {
+        flip_taken(taken, slots[bkeys[j]]);
+      }
+    }
+
+    if (pilot == FROZEN_MAP_MAX_PILOT) {
+      return false;
+    }
+
+    m->pilots[bucket] = pilot;
+  }
+
+  return true;
+}
+
+static enum cdc_stat build_pilots(struct cdc_frozen_map *m, struct builder *b,
+                                  size_t *slots)
+{
+  size_t count = b->primary_count;
+  uint64_t *hashes = (uint64_t *)malloc(count * sizeof(uint64_t));
+  size_t *start = (size_t *)malloc((m->pilot_count + 1) * sizeof(size_t));
+  size_t *keys = (size_t *)malloc(count * sizeof(size_t));
+  size_t *order = (size_t *)malloc(m->pilot_count * sizeof(size_t));
+  uint64_t *taken = (uint64_t *)malloc((count / 64 + 1) * sizeof(uint64_t));
+  enum cdc_stat stat = CDC_STATUS_BAD_ALLOC;
+  if (hashes && start && keys && order && taken) {
+    stat = CDC_STATUS_UNKN;
+    for (int attempt = 0; attempt < FROZEN_MAP_ATTEMPTS; ++attempt) {
+      m->seed = cdc_hash_u64((uint64_t)attempt);
+      if (place_buckets(m, b, hashes, slots, start, keys, order, taken)) {
+        stat = CDC_STATUS_OK;
+        break;
+      }
+    }
+  }
+
+  free(hashes);
+  free(start);
+  free(keys);
+  free(order);
+  free(taken);
+  return stat;
+}
+
+static enum cdc_stat build(struct cdc_frozen_map *m, struct builder *b)
+{
+  enum cdc_stat stat = split_items(m, b);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  if (b->primary_count >= FROZEN_MAP_SINGLE) {
+    return CDC_STATUS_OVERFLOW;
+  }
+
+  if (b->primary_count == 0) {
+    return CDC_STATUS_OK;
+  }
+
+  m->slot_count = b->primary_count;
+  m->pilot_count = b->primary_count / FROZEN_MAP_BUCKET_SIZE + 1;
+  m->size = b->primary_count + b->extra_count;
+  // Pilots of empty buckets stay 0, any pilot is valid for them.
+  m->pilots = (uint32_t *)cdc_di_calloc(m->dinfo,
+                                        m->pilot_count * sizeof(uint32_t));
+  m->entries = (struct cdc_frozen_map_entry *)cdc_di_alloc(
+      m->dinfo, m->size * sizeof(struct cdc_frozen_map_entry));
+  size_t *slots = (size_t *)malloc(b->primary_count * sizeof(size_t));
+  if (!m->pilots || !m->entries || !slots) {
+    free(slots);
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  stat = build_pilots(m, b, slots);
+  if (stat == CDC_STATUS_OK) {
+    for (size_t i = 0; i < b->primary_count; ++i) {
+      m->entries[slots[i]] = b->items[b->primary[i]];
+    }
+
+    for (size_t i = 0; i < b->extra_count; ++i) {
+      m->entries[m->slot_count + i] = b->items[b->extra[i]];
+    }
+  }
+
+  free(slots);
+  return stat;
+}
+
+static enum cdc_stat make_frozen_map(struct cdc_frozen_map **m,
+                                     struct cdc_data_info *info,
+                                     struct builder *b)
+{
+  struct cdc_frozen_map *tmp =
+      (struct cdc_frozen_map *)calloc(sizeof(struct cdc_frozen_map), 1);
+  if (!tmp) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  if (info && !(tmp->dinfo = cdc_di_shared_ctorc(info))) {
+    free(tmp);
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  enum cdc_stat stat = build(tmp, b);
+  free(b->primary);
+  free(b->extra);
+  if (stat != CDC_STATUS_OK) {
+    cdc_di_free(tmp->dinfo, tmp->entries);
+    cdc_di_free(tmp->dinfo, tmp->pilots);
+    cdc_di_shared_dtor(tmp->dinfo);
+    free(tmp);
+    return stat;
+  }
+
+  *m = tmp;
+  return CDC_STATUS_OK;
+}
+
+enum cdc_stat cdc_frozen_map_ctor(struct cdc_frozen_map **m,
+                                  struct cdc_data_info *info,
+                                  struct cdc_map *map)
+{
+  assert(m != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(map != NULL);
+
+  struct builder b = CDC_INIT_STRUCT;
+  b.count = cdc_map_size(map);
+  b.items = (struct cdc_frozen_map_entry *)malloc(
+      (b.count + 1) * sizeof(struct cdc_frozen_map_entry));
+  if (!b.items) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  struct cdc_map_iter it = CDC_INIT_STRUCT;
+  enum cdc_stat stat = cdc_map_iter_ctor(map, &it);
+  if (stat != CDC_STATUS_OK) {
+    free(b.items);
+    return stat;
+  }
+
+  size_t i = 0;
+  for (cdc_map_begin(map, &it); cdc_map_iter_has_next(&it);
+       cdc_map_iter_next(&it)) {
+    b.items[i].key = cdc_map_iter_key(&it);
+    b.items[i].value = cdc_map_iter_value(&it);
+    ++i;
+  }
+
+  cdc_map_iter_dtor(&it);
+  stat = make_frozen_map(m, info, &b);
+  free(b.items);
+  return stat;
+}
+
+enum cdc_stat cdc_frozen_map_ctorl(struct cdc_frozen_map **m,
+                                   struct cdc_data_info *info, ...)
+{
+  assert(m != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  va_list args;
+  va_start(args, info);
+  enum cdc_stat stat = cdc_frozen_map_ctorv(m, info, args);
+  va_end(args);
+  return stat;
+}
+
+enum cdc_stat cdc_frozen_map_ctorv(struct cdc_frozen_map **m,
+                                   struct cdc_data_info *info, va_list args)
+{
+  assert(m != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  va_list count_args;
+  va_copy(count_args, args);
+  struct builder b = CDC_INIT_STRUCT;
+  while (va_arg(count_args, struct cdc_pair *) != CDC_END) {
+    ++b.count;
+  }
+
+  va_end(count_args);
+  b.items = (struct cdc_frozen_map_entry *)malloc(
+      (b.count + 1) * sizeof(struct cdc_frozen_map_entry));
+  if (!b.items) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  for (size_t i = 0; i < b.count; ++i) {
+    struct cdc_pair *pair = va_arg(args, struct cdc_pair *);
+    b.items[i].key = pair->first;
+    b.items[i].value = pair->second;
+  }
+
+  enum cdc_stat stat = make_frozen_map(m, info, &b);
+  free(b.items);
+  return stat;
+}
+
+void cdc_frozen_map_dtor(struct cdc_frozen_map *m)
+{
+  assert(m != NULL);
+
+  if (CDC_HAS_DFREE(m->dinfo)) {
+    for (size_t i = 0; i < m->size; ++i) {
+      struct cdc_pair pair = {m->entries[i].key, m->entries[i].value};
+      m->dinfo->dfree(&pair);
+    }
+  }
+
+  cdc_di_free(m->dinfo, m->entries);
+  cdc_di_free(m->dinfo, m->pilots);
+  cdc_di_shared_dtor(m->dinfo);
+  free(m);
+}
+
+enum cdc_stat cdc_frozen_map_get(struct cdc_frozen_map *m, void *key,
+                                 void **value)
+{
+  assert(m != NULL);
+
+  struct cdc_frozen_map_entry *entry = find_entry(m, key);
+  if (!entry) {
+    return CDC_STATUS_NOT_FOUND;
+  }
+
+  *value = entry->value;
+  return CDC_STATUS_OK;
+}
+
+size_t cdc_frozen_map_count(struct cdc_frozen_map *m, void *key)
+{
+  assert(m != NULL);
+
+  return (size_t)(find_entry(m, key) != NULL);
+}
+
+void cdc_frozen_map_find(struct cdc_frozen_map *m, void *key,
+                         struct cdc_frozen_map_iter *it)
+{
+  assert(m != NULL);
+  assert(it != NULL);
+
+  struct cdc_frozen_map_entry *entry = find_entry(m, key);
+  it->container = m;
+  it->current = entry ? entry : m->entries + m->size;
+}
+
+void cdc_frozen_map_swap(struct cdc_frozen_map *a, struct cdc_frozen_map *b)
+{
+  assert(a != NULL);
+  assert(b != NULL);
+
+  CDC_SWAP(struct cdc_frozen_map_entry *, a->entries, b->entries);
+  CDC_SWAP(size_t, a->size, b->size);
+  CDC_SWAP(size_t, a->slot_count, b->slot_count);
+  CDC_SWAP(uint32_t *, a->pilots, b->pilots);
+  CDC_SWAP(size_t, a->pilot_count, b->pilot_count);
+  CDC_SWAP(uint64_t, a->seed, b->seed);
+  CDC_SWAP(struct cdc_data_info *, a->dinfo, b->dinfo);
+}
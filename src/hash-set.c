@@ -0,0 +1,504 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "cdcontainers/hash-set.h"
+
+#include "cdcontainers/data-info.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HASH_SET_MIN_CAPACITY 8  // must be pow 2
+#define HASH_SET_COPACITY_SHIFT 1
+#define HASH_SET_LOAD_FACTOR 0.8f
+// The highest bit is always set in the hash of a used slot, so 0 marks an
+// empty slot.
+#define HASH_SET_USED_BIT ((size_t)1 << (sizeof(size_t) * 8 - 1))
+
+static size_t make_hash(struct cdc_hash_set *s, void *key)
+{
+  return (size_t)cdc_hash_u64(key ? s->dinfo->hash(key) : 0) |
+         HASH_SET_USED_BIT;
+}
+
+static size_t probe_distance(struct cdc_hash_set *s, size_t hash, size_t pos)
+{
+  return (pos - hash) & (s->capacity - 1);
+}
+
+static void free_entries(struct cdc_hash_set *s)
+{
+  if (!CDC_HAS_DFREE(s->dinfo)) {
+    return;
+  }
+
+  for (size_t i = 0; i < s->capacity; ++i) {
+    if (s->entries[i].hash) {
+      s->dinfo->dfree(s->entries[i].key);
+    }
+  }
+}
+
+static bool should_rehash(struct cdc_hash_set *s)
+{
+  return s->size + 1 >= s->capacity ||
+         ((float)(s->size + 1) / (float)s->capacity) > s->load_factor;
+}
+
+static struct cdc_hash_set_entry *find_entry(struct cdc_hash_set *s, void *key,
+                                             size_t hash)
+{
+  size_t mask = s->capacity - 1;
+  size_t pos = hash & mask;
+  for (size_t dist = 0;; ++dist) {
+    struct cdc_hash_set_entry *entry = &s->entries[pos];
+    if (entry->hash == 0 || probe_distance(s, entry->hash, pos) < dist) {
+      return NULL;
+    }
+
+    if (entry->hash == hash && s->dinfo->eq(key, entry->key)) {
+      return entry;
+    }
+
+    pos = (pos + 1) & mask;
+  }
+}
+
+// Places the entry, that must not be in the set. Returns the slot of the
+// entry.
+static struct cdc_hash_set_entry *place_entry(struct cdc_hash_set *s,
+                                              struct cdc_hash_set_entry entry)
+{
+  struct cdc_hash_set_entry *result = NULL;
+  size_t mask = s->capacity - 1;
+  size_t pos = entry.hash & mask;
+  size_t dist = 0;
+  for (;;) {
+    struct cdc_hash_set_entry *curr = &s->entries[pos];
+    if (curr->hash == 0) {
+      *curr = entry;
+      return result ? result : curr;
+    }
+
+    size_t curr_dist = probe_distance(s, curr->hash, pos);
+    if (curr_dist < dist) {
+      CDC_SWAP(struct cdc_hash_set_entry, entry, *curr);
+      if (!result) {
+        result = curr;
+      }
+
+      dist = curr_dist;
+    }
+
+    pos = (pos + 1) & mask;
+    ++dist;
+  }
+}
+
+// Removes the entry and shifts the following entries back, so the slot of the
+// entry can hold another entry afterwards.
+static void erase_entry(struct cdc_hash_set *s,
+                        struct cdc_hash_set_entry *entry)
+{
+  size_t mask = s->capacity - 1;
+  size_t pos = (size_t)(entry - s->entries);
+  size_t next = (pos + 1) & mask;
+  if (CDC_HAS_DFREE(s->dinfo)) {
+    s->dinfo->dfree(entry->key);
+  }
+
+  while (s->entries[next].hash &&
+         probe_distance(s, s->entries[next].hash, next) != 0) {
+    s->entries[pos] = s->entries[next];
+    pos = next;
+    next = (next + 1) & mask;
+  }
+
+  s->entries[pos].hash = 0;
+  --s->size;
+}
+
+static enum cdc_stat reallocate(struct cdc_hash_set *s, size_t count)
+{
+  if (count < HASH_SET_MIN_CAPACITY) {
+    count = HASH_SET_MIN_CAPACITY;
+  }
+
+  count = cdc_up_to_pow2(count);
+  while (count <= s->size || (float)s->size / (float)count > s->load_factor) {
+    count <<= HASH_SET_COPACITY_SHIFT;
+  }
+
+  if (count == s->capacity) {
+    return CDC_STATUS_OK;
+  }
+
+  struct cdc_hash_set_entry *entries =
+      (struct cdc_hash_set_entry *)cdc_di_calloc(
+          s->dinfo, count * sizeof(struct cdc_hash_set_entry));
+  if (!entries) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  struct cdc_hash_set_entry *old_entries = s->entries;
+  size_t old_capacity = s->capacity;
+  s->entries = entries;
+  s->capacity = count;
+  for (size_t i = 0; i < old_capacity; ++i) {
+    if (old_entries[i].hash) {
+      place_entry(s, old_entries[i]);
+    }
+  }
+
+  cdc_di_free(s->dinfo, old_entries);
+  return CDC_STATUS_OK;
+}
+
+static enum cdc_stat insert_hashed(struct cdc_hash_set *s, void *key,
+                                   size_t hash,
+                                   struct cdc_hash_set_entry **ret,
+                                   bool *inserted)
+{
+  struct cdc_hash_set_entry *entry = find_entry(s, key, hash);
+  *inserted = entry == NULL;
+  if (entry) {
+    *ret = entry;
+    return CDC_STATUS_OK;
+  }
+
+  if (should_rehash(s)) {
+    enum cdc_stat stat = reallocate(s, s->capacity << HASH_SET_COPACITY_SHIFT);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  struct cdc_hash_set_entry new_entry = {hash, key};
+  *ret = place_entry(s, new_entry);
+  ++s->size;
+  return CDC_STATUS_OK;
+}
+
+static enum cdc_stat init_varg(struct cdc_hash_set *s, va_list args)
+{
+  void *key = NULL;
+  while ((key = va_arg(args, void *)) != CDC_END) {
+    enum cdc_stat stat = cdc_hash_set_insert(s, key, NULL, NULL);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  return CDC_STATUS_OK;
+}
+
+// Keeps the keys of s for which the presence in other is equal to keep.
+static void filter(struct cdc_hash_set *s, struct cdc_hash_set *other,
+                   bool keep)
+{
+  size_t i = 0;
+  while (i < s->capacity) {
+    struct cdc_hash_set_entry *entry = &s->entries[i];
+    // Both sets may use different hash functions, so the hash is not reused.
+    if (entry->hash && cdc_hash_set_contains(other, entry->key) != keep) {
+      // The erasure shifts the next entry into this slot.
+      erase_entry(s, entry);
+    } else {
+      ++i;
+    }
+  }
+}
+
+enum cdc_stat cdc_hash_set_ctor1(struct cdc_hash_set **s,
+                                 struct cdc_data_info *info, float load_factor)
+{
+  assert(s != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0 && load_factor < 1);
+
+  struct cdc_hash_set *tmp =
+      (struct cdc_hash_set *)calloc(sizeof(struct cdc_hash_set), 1);
+  if (!tmp) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  tmp->load_factor = load_factor;
+  enum cdc_stat stat = CDC_STATUS_OK;
+  if (info && !(tmp->dinfo = cdc_di_shared_ctorc(info))) {
+    stat = CDC_STATUS_BAD_ALLOC;
+    goto free_hash_set;
+  }
+
+  stat = reallocate(tmp, HASH_SET_MIN_CAPACITY);
+  if (stat != CDC_STATUS_OK) {
+    goto free_di;
+  }
+
+  *s = tmp;
+  return stat;
+free_di:
+  cdc_di_shared_dtor(tmp->dinfo);
+free_hash_set:
+  free(tmp);
+  return stat;
+}
+
+enum cdc_stat cdc_hash_set_ctorl1(struct cdc_hash_set **s,
+                                  struct cdc_data_info *info, float load_factor,
+                                  ...)
+{
+  assert(s != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0 && load_factor < 1);
+
+  va_list args;
+  va_start(args, load_factor);
+  enum cdc_stat stat = cdc_hash_set_ctorv1(s, info, load_factor, args);
+  va_end(args);
+  return stat;
+}
+
+enum cdc_stat cdc_hash_set_ctorv1(struct cdc_hash_set **s,
+                                  struct cdc_data_info *info, float load_factor,
+                                  va_list args)
+{
+  assert(s != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0 && load_factor < 1);
+
+  enum cdc_stat stat = cdc_hash_set_ctor1(s, info, load_factor);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  return init_varg(*s, args);
+}
+
+enum cdc_stat cdc_hash_set_ctor(struct cdc_hash_set **s,
+                                struct cdc_data_info *info)
+{
+  assert(s != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  return cdc_hash_set_ctor1(s, info, HASH_SET_LOAD_FACTOR);
+}
+
+enum cdc_stat cdc_hash_set_ctorl(struct cdc_hash_set **s,
+                                 struct cdc_data_info *info, ...)
+{
+  assert(s != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  va_list args;
+  va_start(args, info);
+  enum cdc_stat stat = cdc_hash_set_ctorv(s, info, args);
+  va_end(args);
+  return stat;
+}
+
+enum cdc_stat cdc_hash_set_ctorv(struct cdc_hash_set **s,
+                                 struct cdc_data_info *info, va_list args)
+{
+  assert(s != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  return cdc_hash_set_ctorv1(s, info, HASH_SET_LOAD_FACTOR, args);
+}
+
+void cdc_hash_set_dtor(struct cdc_hash_set *s)
+{
+  assert(s != NULL);
+
+  free_entries(s);
+  cdc_di_free(s->dinfo, s->entries);
+  cdc_di_shared_dtor(s->dinfo);
+  free(s);
+}
+
+bool cdc_hash_set_contains(struct cdc_hash_set *s, void *key)
+{
+  assert(s != NULL);
+
+  return find_entry(s, key, make_hash(s, key)) != NULL;
+}
+
+void cdc_hash_set_find(struct cdc_hash_set *s, void *key,
+                       struct cdc_hash_set_iter *it)
+{
+  assert(s != NULL);
+  assert(it != NULL);
+
+  struct cdc_hash_set_entry *entry = find_entry(s, key, make_hash(s, key));
+  it->container = s;
+  it->current = entry ? entry : s->entries + s->capacity;
+}
+
+void cdc_hash_set_clear(struct cdc_hash_set *s)
+{
+  assert(s != NULL);
+
+  free_entries(s);
+  memset(s->entries, 0, s->capacity * sizeof(struct cdc_hash_set_entry));
+  s->size = 0;
+}
+
+enum cdc_stat cdc_hash_set_insert(struct cdc_hash_set *s, void *key,
+                                  struct cdc_hash_set_iter *it, bool *inserted)
+{
+  assert(s != NULL);
+
+  struct cdc_hash_set_entry *entry = NULL;
+  bool is_inserted = false;
+  enum cdc_stat stat =
+      insert_hashed(s, key, make_hash(s, key), &entry, &is_inserted);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  if (it) {
+    it->container = s;
+    it->current = entry;
+  }
+
+  if (inserted) {
+    *inserted = is_inserted;
+  }
+
+  return CDC_STATUS_OK;
+}
+
+size_t cdc_hash_set_erase(struct cdc_hash_set *s, void *key)
+{
+  assert(s != NULL);
+
+  struct cdc_hash_set_entry *entry = find_entry(s, key, make_hash(s, key));
+  if (!entry) {
+    return 0;
+  }
+
+  erase_entry(s, entry);
+  return 1;
+}
+
+void cdc_hash_set_swap(struct cdc_hash_set *a, struct cdc_hash_set *b)
+{
+  assert(a != NULL);
+  assert(b != NULL);
+
+  CDC_SWAP(struct cdc_hash_set_entry *, a->entries, b->entries);
+  CDC_SWAP(size_t, a->capacity, b->capacity);
+  CDC_SWAP(float, a->load_factor, b->load_factor);
+  CDC_SWAP(size_t, a->size, b->size);
+  CDC_SWAP(struct cdc_data_info *, a->dinfo, b->dinfo);
+}
+
+enum cdc_stat cdc_hash_set_union(struct cdc_hash_set *s,
+                                 struct cdc_hash_set *other)
+{
+  assert(s != NULL);
+  assert(other != NULL);
+
+  if (s == other) {
+    return CDC_STATUS_OK;
+  }
+
+  enum cdc_stat stat = cdc_hash_set_reserve(s, s->size + other->size);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  bool same_hash = s->dinfo->hash == other->dinfo->hash;
+  for (size_t i = 0; i < other->capacity; ++i) {
+    struct cdc_hash_set_entry *entry = &other->entries[i];
+    if (!entry->hash) {
+      continue;
+    }
+
+    struct cdc_hash_set_entry *ret = NULL;
+    bool inserted = false;
+    size_t hash = same_hash ? entry->hash : make_hash(s, entry->key);
+    stat = insert_hashed(s, entry->key, hash, &ret, &inserted);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  return CDC_STATUS_OK;
+}
+
+void cdc_hash_set_intersection(struct cdc_hash_set *s,
+                               struct cdc_hash_set *other)
+{
+  assert(s != NULL);
+  assert(other != NULL);
+
+  if (s != other) {
+    filter(s, other, true);
+  }
+}
+
+void cdc_hash_set_difference(struct cdc_hash_set *s,
+                             struct cdc_hash_set *other)
+{
+  assert(s != NULL);
+  assert(other != NULL);
+
+  if (s == other) {
+    cdc_hash_set_clear(s);
+    return;
+  }
+
+  if (s->size <= other->size) {
+    filter(s, other, false);
+    return;
+  }
+
+  for (size_t i = 0; i < other->capacity; ++i) {
+    if (other->entries[i].hash) {
+      cdc_hash_set_erase(s, other->entries[i].key);
+    }
+  }
+}
+
+enum cdc_stat cdc_hash_set_rehash(struct cdc_hash_set *s, size_t count)
+{
+  assert(s != NULL);
+
+  if (count <= s->capacity) {
+    return CDC_STATUS_OK;
+  }
+
+  return reallocate(s, count);
+}
+
+enum cdc_stat cdc_hash_set_reserve(struct cdc_hash_set *s, size_t count)
+{
+  assert(s != NULL);
+
+  return cdc_hash_set_rehash(s, (size_t)((float)count / s->load_factor) + 1);
+}
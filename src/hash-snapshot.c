@@ -0,0 +1,627 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "cdcontainers/hash-snapshot.h"
+
+#include "cdcontainers/hash.h"
+
+#include <assert.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define HASH_SNAPSHOT_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define HASH_SNAPSHOT_VERSION 1
+#define HASH_SNAPSHOT_BYTE_ORDER 0x01020304
+#define HASH_SNAPSHOT_SEED UINT64_C(0x9e3779b97f4a7c15)
+// All the regions and the records of the blob start at this alignment.
+#define HASH_SNAPSHOT_ALIGN 8
+// Size of the lengths of the key and the value at the start of a record, if
+// one of them has a variable size.
+#define HASH_SNAPSHOT_PREFIX 8
+
+static const char hash_snapshot_magic[8] = "CDCSNAP";
+
+struct snapshot_header {
+  char magic[8];
+  uint32_t version;
+  uint32_t byte_order;
+  uint32_t size_t_bits;
+  uint32_t reserved;
+  uint64_t seed;
+  uint64_t size;
+  uint64_t bucket_count;
+  uint64_t key_size;
+  uint64_t value_size;
+  uint64_t buckets_offset;
+  uint64_t entries_offset;
+  uint64_t blob_offset;
+  uint64_t blob_size;
+};
+
+struct item {
+  uint64_t hash;
+  void *key;
+  void *value;
+  uint64_t key_size;
+  uint64_t value_size;
+};
+
+struct writer {
+  struct cdc_hash_snapshot_codec *codec;
+  FILE *file;
+  unsigned char *buf;
+  size_t buf_size;
+};
+
+static uint64_t align_up(uint64_t n)
+{
+  return (n + HASH_SNAPSHOT_ALIGN - 1) & ~(uint64_t)(HASH_SNAPSHOT_ALIGN - 1);
+}
+
+static size_t prefix_size(size_t key_size, size_t value_size)
+{
+  return key_size == 0 || value_size == 0 ? HASH_SNAPSHOT_PREFIX : 0;
+}
+
+static uint64_t record_size(struct cdc_hash_snapshot_codec *codec,
+                            struct item *item)
+{
+  return prefix_size(codec->key_size, codec->value_size) +
+         align_up(item->key_size) + align_up(item->value_size);
+}
+
+static enum cdc_stat reserve_buf(struct writer *w, size_t size)
+{
+  if (size <= w->buf_size) {
+    return CDC_STATUS_OK;
+  }
+
+  unsigned char *buf = (unsigned char *)realloc(w->buf, size);
+  if (!buf) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  w->buf = buf;
+  w->buf_size = size;
+  return CDC_STATUS_OK;
+}
+
+static enum cdc_stat write_bytes(struct writer *w, const void *data,
+                                 size_t size)
+{
+  if (size != 0 && fwrite(data, 1, size, w->file) != size) {
+    return CDC_STATUS_IO_ERROR;
+  }
+
+  return CDC_STATUS_OK;
+}
+
+static enum cdc_stat write_padding(struct writer *w, uint64_t size)
+{
+  static const unsigned char zeros[HASH_SNAPSHOT_ALIGN] = {0};
+  return write_bytes(w, zeros, (size_t)(align_up(size) - size));
+}
+
+// Computes the sizes and the hashes of the pairs and counts the items of
+// every bucket.
+static enum cdc_stat collect_items(struct writer *w, struct cdc_hash_table *t,
+                                   struct item *items, uint64_t *bounds,
+                                   size_t bucket_mask)
+{
+  struct cdc_hash_snapshot_codec *codec = w->codec;
+  struct cdc_hash_table_iter it = CDC_INIT_STRUCT;
+  struct cdc_hash_table_iter end = CDC_INIT_STRUCT;
+  size_t i = 0;
+  cdc_hash_table_begin(t, &it);
+  cdc_hash_table_end(t, &end);
+  for (; !cdc_hash_table_iter_is_eq(&it, &end);
+       cdc_hash_table_iter_next(&it), ++i) {
+    struct item *item = &items[i];
+    item->key = cdc_hash_table_iter_key(&it);
+    item->value = cdc_hash_table_iter_value(&it);
+    item->key_size =
+        codec->key_size ? codec->key_size : codec->key_size_of(item->key);
+    item->value_size = codec->value_size ? codec->value_size
+                                         : codec->value_size_of(item->value);
+    if ((!codec->key_size && item->key_size > UINT32_MAX) ||
+        (!codec->value_size && item->value_size > UINT32_MAX)) {
+      return CDC_STATUS_OVERFLOW;
+    }
+
+    enum cdc_stat stat = reserve_buf(w, (size_t)item->key_size);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+
+    codec->key_write(item->key, w->buf);
+    item->hash = (uint64_t)cdc_hash_bytes(w->buf, (size_t)item->key_size,
+                                          HASH_SNAPSHOT_SEED);
+    ++bounds[item->hash & bucket_mask];
+  }
+
+  return CDC_STATUS_OK;
+}
+
+// Sorts the items by bucket. After the call bounds[b] is the index of the
+// first item of bucket b.
+static void sort_items(struct item *items, size_t count, size_t *order,
+                       uint64_t *bounds, size_t bucket_count)
+{
+  for (size_t b = 1; b < bucket_count; ++b) {
+    bounds[b] += bounds[b - 1];
+  }
+
+  for (size_t i = count; i > 0; --i) {
+    size_t b = (size_t)(items[i - 1].hash & (bucket_count - 1));
+    order[--bounds[b]] = i - 1;
+  }
+
+  bounds[bucket_count] = count;
+}
+
+static enum cdc_stat write_record(struct writer *w, struct item *item)
+{
+  struct cdc_hash_snapshot_codec *codec = w->codec;
+  enum cdc_stat stat;
+  if (prefix_size(codec->key_size, codec->value_size) != 0) {
+    uint32_t lengths[2] = {(uint32_t)item->key_size,
+                           (uint32_t)item->value_size};
+    stat = write_bytes(w, lengths, sizeof(lengths));
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  stat = reserve_buf(w, (size_t)CDC_MAX(item->key_size, item->value_size));
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  codec->key_write(item->key, w->buf);
+  stat = write_bytes(w, w->buf, (size_t)item->key_size);
+  if (stat == CDC_STATUS_OK) {
+    stat = write_padding(w, item->key_size);
+  }
+
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  codec->value_write(item->value, w->buf);
+  stat = write_bytes(w, w->buf, (size_t)item->value_size);
+  if (stat == CDC_STATUS_OK) {
+    stat = write_padding(w, item->value_size);
+  }
+
+  return stat;
+}
+
+static enum cdc_stat write_file(struct writer *w, struct item *items,
+                                size_t count, size_t *order, uint64_t *bounds,
+                                size_t bucket_count)
+{
+  struct cdc_hash_snapshot_codec *codec = w->codec;
+  struct snapshot_header header;
+  memset(&header, 0, sizeof(header));
+  memcpy(header.magic, hash_snapshot_magic, sizeof(header.magic));
+  header.version = HASH_SNAPSHOT_VERSION;
+  header.byte_order = HASH_SNAPSHOT_BYTE_ORDER;
+  header.size_t_bits = (uint32_t)(sizeof(size_t) * CHAR_BIT);
+  header.seed = HASH_SNAPSHOT_SEED;
+  header.size = count;
+  header.bucket_count = bucket_count;
+  header.key_size = codec->key_size;
+  header.value_size = codec->value_size;
+  header.buckets_offset = align_up(sizeof(header));
+  header.entries_offset =
+      header.buckets_offset + (bucket_count + 1) * sizeof(uint64_t);
+  header.blob_offset = header.entries_offset +
+                       count * sizeof(struct cdc_hash_snapshot_entry);
+  for (size_t i = 0; i < count; ++i) {
+    header.blob_size += record_size(codec, &items[i]);
+  }
+
+  enum cdc_stat stat = write_bytes(w, &header, sizeof(header));
+  if (stat == CDC_STATUS_OK) {
+    stat = write_padding(w, sizeof(header));
+  }
+
+  if (stat == CDC_STATUS_OK) {
+    stat = write_bytes(w, bounds, (bucket_count + 1) * sizeof(uint64_t));
+  }
+
+  uint64_t offset = 0;
+  for (size_t i = 0; i < count && stat == CDC_STATUS_OK; ++i) {
+    struct item *item = &items[order[i]];
+    struct cdc_hash_snapshot_entry entry = {item->hash, offset};
+    stat = write_bytes(w, &entry, sizeof(entry));
+    offset += record_size(codec, item);
+  }
+
+  for (size_t i = 0; i < count && stat == CDC_STATUS_OK; ++i) {
+    stat = write_record(w, &items[order[i]]);
+  }
+
+  return stat;
+}
+
+enum cdc_stat cdc_hash_snapshot_write(struct cdc_hash_table *t,
+                                      struct cdc_hash_snapshot_codec *codec,
+                                      const char *path)
+{
+  assert(t != NULL);
+  assert(codec != NULL);
+  assert(codec->key_size != 0 || codec->key_size_of != NULL);
+  assert(codec->value_size != 0 || codec->value_size_of != NULL);
+  assert(codec->key_write != NULL);
+  assert(codec->value_write != NULL);
+  assert(path != NULL);
+
+  size_t count = cdc_hash_table_size(t);
+  size_t bucket_count = 1;
+  while (bucket_count < count) {
+    bucket_count <<= 1;
+  }
+
+  struct writer w = {codec, NULL, NULL, 0};
+  struct item *items = (struct item *)malloc((count ? count : 1) *
+                                             sizeof(struct item));
+  size_t *order = (size_t *)malloc((count ? count : 1) * sizeof(size_t));
+  uint64_t *bounds = (uint64_t *)calloc(bucket_count + 1, sizeof(uint64_t));
+  enum cdc_stat stat = CDC_STATUS_BAD_ALLOC;
+  if (!items || !order || !bounds) {
+    goto free_items;
+  }
+
+  stat = collect_items(&w, t, items, bounds, bucket_count - 1);
+  if (stat != CDC_STATUS_OK) {
+    goto free_items;
+  }
+
+  sort_items(items, count, order, bounds, bucket_count);
+  w.file = fopen(path, "wb");
+  if (!w.file) {
+    stat = CDC_STATUS_IO_ERROR;
+    goto free_items;
+  }
+
+  stat = write_file(&w, items, count, order, bounds, bucket_count);
+  if (fclose(w.file) != 0 && stat == CDC_STATUS_OK) {
+    stat = CDC_STATUS_IO_ERROR;
+  }
+
+  if (stat != CDC_STATUS_OK) {
+    remove(path);
+  }
+
+free_items:
+  free(w.buf);
+  free(bounds);
+  free(order);
+  free(items);
+  return stat;
+}
+
+#ifdef HASH_SNAPSHOT_MMAP
+static enum cdc_stat load_file(struct cdc_hash_snapshot *s, const char *path)
+{
+  int fd = open(path, O_RDONLY);
+  if (fd == -1) {
+    return CDC_STATUS_IO_ERROR;
+  }
+
+  struct stat st;
+  if (fstat(fd, &st) == -1) {
+    close(fd);
+    return CDC_STATUS_IO_ERROR;
+  }
+
+  if ((uint64_t)st.st_size < sizeof(struct snapshot_header)) {
+    close(fd);
+    return CDC_STATUS_BAD_FORMAT;
+  }
+
+  if ((uint64_t)st.st_size > SIZE_MAX) {
+    close(fd);
+    return CDC_STATUS_OVERFLOW;
+  }
+
+  void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if (data == MAP_FAILED) {
+    return CDC_STATUS_IO_ERROR;
+  }
+
+  s->data = (const unsigned char *)data;
+  s->length = (size_t)st.st_size;
+  s->mapped = true;
+  return CDC_STATUS_OK;
+}
+
+static void unload_file(struct cdc_hash_snapshot *s)
+{
+  munmap((void *)s->data, s->length);
+}
+#else
+// Without mmap the file is read in one piece. The lookups still use the
+// layout of the file, so nothing is rebuilt.
+static enum cdc_stat load_file(struct cdc_hash_snapshot *s, const char *path)
+{
+  FILE *file = fopen(path, "rb");
+  if (!file) {
+    return CDC_STATUS_IO_ERROR;
+  }
+
+  long length = -1;
+  if (fseek(file, 0, SEEK_END) == 0) {
+    length = ftell(file);
+  }
+
+  if (length < 0 || fseek(file, 0, SEEK_SET) != 0) {
+    fclose(file);
+    return CDC_STATUS_IO_ERROR;
+  }
+
+  if ((unsigned long)length < sizeof(struct snapshot_header)) {
+    fclose(file);
+    return CDC_STATUS_BAD_FORMAT;
+  }
+
+  unsigned char *data = (unsigned char *)malloc((size_t)length);
+  if (!data) {
+    fclose(file);
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  if (fread(data, 1, (size_t)length, file) != (size_t)length) {
+    free(data);
+    fclose(file);
+    return CDC_STATUS_IO_ERROR;
+  }
+
+  fclose(file);
+  s->data = data;
+  s->length = (size_t)length;
+  s->mapped = false;
+  return CDC_STATUS_OK;
+}
+
+static void unload_file(struct cdc_hash_snapshot *s)
+{
+  free((void *)s->data);
+}
+#endif
+
+static bool is_region(uint64_t offset, uint64_t count, uint64_t item_size,
+                      size_t length)
+{
+  return offset % HASH_SNAPSHOT_ALIGN == 0 && offset <= length &&
+         count <= (length - offset) / item_size;
+}
+
+static enum cdc_stat read_header(struct cdc_hash_snapshot *s)
+{
+  struct snapshot_header h;
+  memcpy(&h, s->data, sizeof(h));
+  if (memcmp(h.magic, hash_snapshot_magic, sizeof(h.magic)) != 0 ||
+      h.version != HASH_SNAPSHOT_VERSION ||
+      h.byte_order != HASH_SNAPSHOT_BYTE_ORDER ||
+      h.size_t_bits != sizeof(size_t) * CHAR_BIT) {
+    return CDC_STATUS_BAD_FORMAT;
+  }
+
+  if (h.bucket_count == 0 || (h.bucket_count & (h.bucket_count - 1)) != 0 ||
+      h.size > h.bucket_count ||
+      !is_region(h.buckets_offset, h.bucket_count + 1, sizeof(uint64_t),
+                 s->length) ||
+      !is_region(h.entries_offset, h.size,
+                 sizeof(struct cdc_hash_snapshot_entry), s->length) ||
+      !is_region(h.blob_offset, h.blob_size, 1, s->length)) {
+    return CDC_STATUS_BAD_FORMAT;
+  }
+
+  s->buckets = (const uint64_t *)(s->data + h.buckets_offset);
+  s->entries =
+      (const struct cdc_hash_snapshot_entry *)(s->data + h.entries_offset);
+  s->blob = s->data + h.blob_offset;
+  s->size = (size_t)h.size;
+  s->bucket_mask = (size_t)h.bucket_count - 1;
+  s->key_size = (size_t)h.key_size;
+  s->value_size = (size_t)h.value_size;
+  s->seed = h.seed;
+  return CDC_STATUS_OK;
+}
+
+static const unsigned char *get_record(struct cdc_hash_snapshot *s,
+                                       size_t index)
+{
+  return s->blob + s->entries[index].offset;
+}
+
+static size_t record_key_size(struct cdc_hash_snapshot *s,
+                              const unsigned char *record)
+{
+  if (s->key_size != 0) {
+    return s->key_size;
+  }
+
+  uint32_t size;
+  memcpy(&size, record, sizeof(size));
+  return size;
+}
+
+static size_t record_value_size(struct cdc_hash_snapshot *s,
+                                const unsigned char *record)
+{
+  if (s->value_size != 0) {
+    return s->value_size;
+  }
+
+  uint32_t size;
+  memcpy(&size, record + sizeof(size), sizeof(size));
+  return size;
+}
+
+static const unsigned char *record_key(struct cdc_hash_snapshot *s,
+                                       const unsigned char *record)
+{
+  return record + prefix_size(s->key_size, s->value_size);
+}
+
+static const unsigned char *record_value(struct cdc_hash_snapshot *s,
+                                         const unsigned char *record)
+{
+  return record_key(s, record) + align_up(record_key_size(s, record));
+}
+
+static size_t find_index(struct cdc_hash_snapshot *s, const void *key,
+                         size_t key_size)
+{
+  uint64_t hash = (uint64_t)cdc_hash_bytes(key, key_size, s->seed);
+  size_t bucket = (size_t)(hash & s->bucket_mask);
+  size_t end = (size_t)s->buckets[bucket + 1];
+  for (size_t i = (size_t)s->buckets[bucket]; i < end; ++i) {
+    if (s->entries[i].hash != hash) {
+      continue;
+    }
+
+    const unsigned char *record = get_record(s, i);
+    if (record_key_size(s, record) == key_size &&
+        memcmp(record_key(s, record), key, key_size) == 0) {
+      return i;
+    }
+  }
+
+  return s->size;
+}
+
+enum cdc_stat cdc_hash_snapshot_ctor(struct cdc_hash_snapshot **s,
+                                     const char *path)
+{
+  assert(s != NULL);
+  assert(path != NULL);
+
+  struct cdc_hash_snapshot *tmp =
+      (struct cdc_hash_snapshot *)calloc(sizeof(struct cdc_hash_snapshot), 1);
+  if (!tmp) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  enum cdc_stat stat = load_file(tmp, path);
+  if (stat != CDC_STATUS_OK) {
+    free(tmp);
+    return stat;
+  }
+
+  stat = read_header(tmp);
+  if (stat != CDC_STATUS_OK) {
+    cdc_hash_snapshot_dtor(tmp);
+    return stat;
+  }
+
+  *s = tmp;
+  return CDC_STATUS_OK;
+}
+
+void cdc_hash_snapshot_dtor(struct cdc_hash_snapshot *s)
+{
+  assert(s != NULL);
+
+  unload_file(s);
+  free(s);
+}
+
+enum cdc_stat cdc_hash_snapshot_get(struct cdc_hash_snapshot *s,
+                                    const void *key, size_t key_size,
+                                    const void **value, size_t *value_size)
+{
+  assert(s != NULL);
+  assert(value != NULL);
+
+  size_t index = find_index(s, key, key_size);
+  if (index == s->size) {
+    return CDC_STATUS_NOT_FOUND;
+  }
+
+  const unsigned char *record = get_record(s, index);
+  *value = record_value(s, record);
+  if (value_size) {
+    *value_size = record_value_size(s, record);
+  }
+
+  return CDC_STATUS_OK;
+}
+
+size_t cdc_hash_snapshot_count(struct cdc_hash_snapshot *s, const void *key,
+                               size_t key_size)
+{
+  assert(s != NULL);
+
+  return (size_t)(find_index(s, key, key_size) != s->size);
+}
+
+void cdc_hash_snapshot_find(struct cdc_hash_snapshot *s, const void *key,
+                            size_t key_size,
+                            struct cdc_hash_snapshot_iter *it)
+{
+  assert(s != NULL);
+  assert(it != NULL);
+
+  it->container = s;
+  it->current = find_index(s, key, key_size);
+}
+
+const void *cdc_hash_snapshot_iter_key(struct cdc_hash_snapshot_iter *it,
+                                       size_t *size)
+{
+  assert(it != NULL);
+  assert(it->current < it->container->size);
+
+  const unsigned char *record = get_record(it->container, it->current);
+  if (size) {
+    *size = record_key_size(it->container, record);
+  }
+
+  return record_key(it->container, record);
+}
+
+const void *cdc_hash_snapshot_iter_value(struct cdc_hash_snapshot_iter *it,
+                                         size_t *size)
+{
+  assert(it != NULL);
+  assert(it->current < it->container->size);
+
+  const unsigned char *record = get_record(it->container, it->current);
+  if (size) {
+    *size = record_value_size(it->container, record);
+  }
+
+  return record_value(it->container, record);
+}
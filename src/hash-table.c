@@ -23,21 +23,54 @@
 #include "cdcontainers/data-info.h"
 
 #include <assert.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #define HASH_TABLE_MIN_CAPACITY 8  // must be pow 2
 #define HASH_TABLE_COPACITY_SHIFT 1
 #define HASH_TABLE_LOAD_FACTOR 0.7f
-
-static struct cdc_hash_table_entry *new_node(void *key, void *value,
+#define HASH_TABLE_BATCH_SIZE 32
+// Number of entries linked ahead of the prefetched bucket in a bulk insert.
+#define HASH_TABLE_PREFETCH_DISTANCE 8
+#define HASH_TABLE_MAX_BULK_THREADS 64
+// Minimal number of keys hashed by one thread.
+#define HASH_TABLE_MIN_THREAD_WORK ((size_t)1 << 16)
+// Chunk size of the node pool that a bulk insert sets for a table without it.
+#define HASH_TABLE_POOL_CHUNK 64
+// A scan step stops after budget * HASH_TABLE_SCAN_EMPTY_FACTOR empty buckets.
+#define HASH_TABLE_SCAN_EMPTY_FACTOR 10
+
+#ifdef CDC_HASH_TABLE_STATS
+// Lookups update the counters, and several readers can look up at once (see
+// cdc_concurrent_map_get), so the counters are updated atomically. The order
+// of the updates does not matter, so they are relaxed.
+#define HASH_TABLE_COUNT(t, field, n) \
+  ((void)__atomic_fetch_add(&(t)->counters.field, (n), __ATOMIC_RELAXED))
+#define HASH_TABLE_LOAD(t, field) \
+  __atomic_load_n(&(t)->counters.field, __ATOMIC_RELAXED)
+#define HASH_TABLE_CLOCK() clock()
+#define HASH_TABLE_ADD_TIME(t, start) \
+  ((t)->counters.rehash_time +=       \
+   (double)(clock() - (start)) / CLOCKS_PER_SEC)
+#else
+#define HASH_TABLE_COUNT(t, field, n) ((void)0)
+#define HASH_TABLE_LOAD(t, field) ((t)->counters.field)
+#define HASH_TABLE_CLOCK() ((clock_t)0)
+#define HASH_TABLE_ADD_TIME(t, start) ((void)(start))
+#endif
+
+static struct cdc_hash_table_entry *new_node(struct cdc_hash_table *t,
+                                             void *key, void *value,
                                              size_t hash)
 {
   struct cdc_hash_table_entry *new_entry =
-      (struct cdc_hash_table_entry *)malloc(
-          sizeof(struct cdc_hash_table_entry));
+      (struct cdc_hash_table_entry *)cdc_di_node_alloc(
+          t->dinfo, &t->pool, sizeof(struct cdc_hash_table_entry));
   if (!new_entry) {
     return NULL;
   }
@@ -57,12 +90,19 @@ static void free_entry(struct cdc_hash_table *t,
     t->dinfo->dfree(&pair);
   }
 
-  free(entry);
+  cdc_di_node_free(t->dinfo, &t->pool, entry);
 }
 
-static void free_entries(struct cdc_hash_table *t)
+// With a node pool and without dfree the entries are not visited, their
+// chunks are released by the caller.
+static void free_entries(struct cdc_hash_table *t,
+                         struct cdc_hash_table_entry *nil)
 {
-  struct cdc_hash_table_entry *curr = t->buckets[0]->next;
+  if (cdc_node_pool_enabled(&t->pool) && !CDC_HAS_DFREE(t->dinfo)) {
+    return;
+  }
+
+  struct cdc_hash_table_entry *curr = nil->next;
   while (curr) {
     struct cdc_hash_table_entry *next = curr->next;
     free_entry(t, curr);
@@ -70,11 +110,28 @@ static void free_entries(struct cdc_hash_table *t)
   }
 }
 
+static void free_old_buckets(struct cdc_hash_table *t)
+{
+  if (!t->old_buckets) {
+    return;
+  }
+
+  free_entries(t, t->old_buckets[0]);
+  // free nil entry
+  cdc_di_free(t->dinfo, t->old_buckets[0]);
+  cdc_di_free(t->dinfo, t->old_buckets);
+  t->old_buckets = NULL;
+  t->old_tail = NULL;
+  t->old_bcount = 0;
+}
+
 static void free_all_entries(struct cdc_hash_table *t)
 {
-  free_entries(t);
+  free_old_buckets(t);
+  free_entries(t, t->buckets[0]);
   // free nil entry
-  free(t->buckets[0]);
+  cdc_di_free(t->dinfo, t->buckets[0]);
+  cdc_node_pool_release(&t->pool, t->dinfo);
 }
 
 static bool should_rehash(struct cdc_hash_table *t)
@@ -82,9 +139,21 @@ static bool should_rehash(struct cdc_hash_table *t)
   return ((float)t->size / (float)t->bcount) >= t->load_factor;
 }
 
-static enum cdc_stat rehash(struct cdc_hash_table *t)
+static size_t user_hash(struct cdc_hash_table *t, void *key)
 {
-  return cdc_hash_table_rehash(t, t->bcount << HASH_TABLE_COPACITY_SHIFT);
+  return key ? t->dinfo->hash(key) : 0;
+}
+
+// The user hash is mixed with the seed, so that buckets taken from the low
+// bits are well distributed even for sequential or aligned keys.
+static size_t mix_hash(struct cdc_hash_table *t, void *key, size_t hash)
+{
+  return key ? cdc_hash_u64((uint64_t)(hash ^ t->seed)) : 0;
+}
+
+static size_t hash_key(struct cdc_hash_table *t, void *key)
+{
+  return mix_hash(t, key, user_hash(t, key));
 }
 
 static size_t get_bucket(size_t hash, size_t count)
@@ -92,20 +161,28 @@ static size_t get_bucket(size_t hash, size_t count)
   return hash & (count - 1);
 }
 
+static size_t get_entry_bucket(struct cdc_hash_table_entry *entry,
+                               size_t count)
+{
+  return entry->key ? get_bucket(entry->hash, count) : 0;
+}
+
 static struct cdc_hash_table_entry *find_entry_by_bucket(
-    struct cdc_hash_table *t, void *key, size_t bucket)
+    struct cdc_hash_table *t, struct cdc_hash_table_entry **buckets,
+    size_t count, void *key, size_t bucket)
 {
-  struct cdc_hash_table_entry *entry = t->buckets[bucket];
+  struct cdc_hash_table_entry *entry = buckets[bucket];
   if (entry == NULL) {
     return NULL;
   }
 
   while (entry->next) {
+    HASH_TABLE_COUNT(t, probes, 1);
     if (t->dinfo->eq(key, entry->next->key)) {
       return entry;
     }
 
-    if (bucket != get_bucket(entry->next->hash, t->bcount)) {
+    if (bucket != get_bucket(entry->next->hash, count)) {
       return NULL;
     }
 
@@ -116,10 +193,17 @@ static struct cdc_hash_table_entry *find_entry_by_bucket(
 }
 
 static struct cdc_hash_table_entry *find_entry(struct cdc_hash_table *t,
-                                               void *key)
+                                               void *key, size_t hash)
 {
-  size_t bucket = key ? get_bucket(t->dinfo->hash(key), t->bcount) : 0;
-  return find_entry_by_bucket(t, key, bucket);
+  HASH_TABLE_COUNT(t, lookups, 1);
+  struct cdc_hash_table_entry *entry = find_entry_by_bucket(
+      t, t->buckets, t->bcount, key, get_bucket(hash, t->bcount));
+  if (!entry && t->old_buckets) {
+    entry = find_entry_by_bucket(t, t->old_buckets, t->old_bcount, key,
+                                 get_bucket(hash, t->old_bcount));
+  }
+
+  return entry;
 }
 
 static struct cdc_hash_table_entry *add_entry(
@@ -154,74 +238,171 @@ static struct cdc_hash_table_entry *add_entry(
   return prev_entry;
 }
 
-static enum cdc_stat make_and_insert_unique(struct cdc_hash_table *t, void *key,
-                                            void *value,
-                                            struct cdc_hash_table_entry **ret)
-{
-  if (should_rehash(t)) {
-    enum cdc_stat stat = rehash(t);
-    if (stat != CDC_STATUS_OK) {
-      return stat;
-    }
-  }
-
-  struct cdc_hash_table_entry *entry =
-      new_node(key, value, t->dinfo->hash(key));
-  if (!entry) {
-    return CDC_STATUS_BAD_ALLOC;
-  }
-
-  *ret = add_entry(t, entry);
-  ++t->size;
-  return CDC_STATUS_OK;
-}
-
-static struct cdc_hash_table_entry *erase_entry(
-    struct cdc_hash_table *t, struct cdc_hash_table_entry *entry, size_t bucket)
+// Unlinks entry->next from the list of the bucket array |buckets|.
+static struct cdc_hash_table_entry *unlink_entry(
+    struct cdc_hash_table_entry **buckets, size_t count,
+    struct cdc_hash_table_entry **tail, struct cdc_hash_table_entry *entry,
+    size_t bucket)
 {
   assert(entry != NULL);
   assert(entry->next != NULL);
 
   struct cdc_hash_table_entry *next = entry->next->next;
-  size_t e_hash = get_bucket(entry->hash, t->bcount);
-  size_t en_hash = get_bucket(entry->next->hash, t->bcount);
-  free_entry(t, entry->next);
+  size_t e_hash = get_bucket(entry->hash, count);
+  size_t en_hash = get_bucket(entry->next->hash, count);
   if (next != NULL) {
-    size_t n_hash = get_bucket(next->hash, t->bcount);
+    size_t n_hash = get_bucket(next->hash, count);
     if (e_hash != en_hash && en_hash != n_hash) {
       entry->next = next;
-      if (entry == t->buckets[0]) {
-        t->buckets[bucket] = t->buckets[0];
+      if (entry == buckets[0]) {
+        buckets[bucket] = buckets[0];
       } else {
-        t->buckets[bucket] = NULL;
+        buckets[bucket] = NULL;
       }
 
-      bucket = get_bucket(next->hash, t->bcount);
-      t->buckets[bucket] = entry;
+      bucket = get_bucket(next->hash, count);
+      buckets[bucket] = entry;
     } else if (en_hash == n_hash) {
       entry->next = next;
     } else {
       entry->next = next;
-      bucket = get_bucket(next->hash, t->bcount);
-      t->buckets[bucket] = entry;
+      bucket = get_bucket(next->hash, count);
+      buckets[bucket] = entry;
     }
   } else {
     if (e_hash != en_hash) {
-      t->buckets[bucket] = NULL;
+      buckets[bucket] = NULL;
     }
 
     entry->next = NULL;
-    t->tail = entry;
+    *tail = entry;
   }
 
-  --t->size;
   return next;
 }
 
+static void erase_entry(struct cdc_hash_table *t,
+                        struct cdc_hash_table_entry *entry, size_t bucket)
+{
+  struct cdc_hash_table_entry *victim = entry->next;
+  unlink_entry(t->buckets, t->bcount, &t->tail, entry, bucket);
+  free_entry(t, victim);
+  --t->size;
+}
+
+static void erase_old_entry(struct cdc_hash_table *t,
+                            struct cdc_hash_table_entry *entry, size_t bucket)
+{
+  struct cdc_hash_table_entry *victim = entry->next;
+  unlink_entry(t->old_buckets, t->old_bcount, &t->old_tail, entry, bucket);
+  free_entry(t, victim);
+  --t->size;
+  if (!t->old_buckets[0]->next) {
+    free_old_buckets(t);
+  }
+}
+
+// Moves up to |count| entries from the head of the old list to the new bucket
+// array. The old bucket array is freed when it becomes empty.
+static void migrate(struct cdc_hash_table *t, size_t count)
+{
+  clock_t start = HASH_TABLE_CLOCK();
+  struct cdc_hash_table_entry *nil = t->old_buckets[0];
+  while (count-- && nil->next) {
+    struct cdc_hash_table_entry *entry = nil->next;
+    size_t bucket = get_entry_bucket(entry, t->old_bcount);
+    unlink_entry(t->old_buckets, t->old_bcount, &t->old_tail, nil, bucket);
+    entry->next = NULL;
+    add_entry(t, entry);
+  }
+
+  if (!nil->next) {
+    free_old_buckets(t);
+  }
+
+  HASH_TABLE_ADD_TIME(t, start);
+}
+
+static void finish_rehash(struct cdc_hash_table *t)
+{
+  if (t->old_buckets) {
+    migrate(t, SIZE_MAX);
+  }
+}
+
+// Sets an empty bucket array of double size. Entries are moved to it by
+// migrate().
+static enum cdc_stat start_rehash(struct cdc_hash_table *t)
+{
+  size_t count = t->bcount << HASH_TABLE_COPACITY_SHIFT;
+  struct cdc_hash_table_entry **new_buckets =
+      (struct cdc_hash_table_entry **)cdc_di_calloc(t->dinfo,
+                                                    count * sizeof(void *));
+  if (!new_buckets) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  struct cdc_hash_table_entry *nil =
+      (struct cdc_hash_table_entry *)cdc_di_calloc(
+          t->dinfo, sizeof(struct cdc_hash_table_entry));
+  if (!nil) {
+    cdc_di_free(t->dinfo, new_buckets);
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  t->old_buckets = t->buckets;
+  t->old_tail = t->tail;
+  t->old_bcount = t->bcount;
+  t->buckets = new_buckets;
+  t->buckets[0] = nil;
+  t->tail = nil;
+  t->bcount = count;
+  HASH_TABLE_COUNT(t, rehashes, 1);
+  return CDC_STATUS_OK;
+}
+
+static enum cdc_stat rehash(struct cdc_hash_table *t)
+{
+  if (!t->rehash_step) {
+    return cdc_hash_table_rehash(t, t->bcount << HASH_TABLE_COPACITY_SHIFT);
+  }
+
+  // The previous rehash has not finished in time, so the rest of it is done
+  // at once.
+  finish_rehash(t);
+  return start_rehash(t);
+}
+
+static enum cdc_stat make_and_insert_unique(struct cdc_hash_table *t, void *key,
+                                            void *value, size_t hash,
+                                            struct cdc_hash_table_entry **ret)
+{
+  if (should_rehash(t)) {
+    enum cdc_stat stat = rehash(t);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  if (t->old_buckets) {
+    migrate(t, t->rehash_step);
+  }
+
+  struct cdc_hash_table_entry *entry = new_node(t, key, value, hash);
+  if (!entry) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  *ret = add_entry(t, entry);
+  ++t->size;
+  return CDC_STATUS_OK;
+}
+
 static struct cdc_hash_table_entry **transfer(
     struct cdc_hash_table *t, struct cdc_hash_table_entry **buckets,
     size_t count)
 {
+  clock_t start = HASH_TABLE_CLOCK();
   struct cdc_hash_table_entry *entry = t->buckets[0]->next;
   struct cdc_hash_table_entry **old_buffer = t->buckets;
   // Set a new buffer and a new tail.
@@ -239,6 +420,8 @@ static struct cdc_hash_table_entry **transfer(
     entry = next_entry;
   }
 
+  HASH_TABLE_COUNT(t, rehashes, 1);
+  HASH_TABLE_ADD_TIME(t, start);
   return old_buffer;
 }
 
@@ -253,19 +436,21 @@ static enum cdc_stat reallocate(struct cdc_hash_table *t, size_t count)
   }
 
   struct cdc_hash_table_entry **new_buckets =
-      (struct cdc_hash_table_entry **)calloc(count * sizeof(void *), 1);
+      (struct cdc_hash_table_entry **)cdc_di_calloc(t->dinfo,
+                                                    count * sizeof(void *));
   if (!new_buckets) {
     return CDC_STATUS_BAD_ALLOC;
   }
 
   if (t->buckets) {
     struct cdc_hash_table_entry **old_buffer = transfer(t, new_buckets, count);
-    free(old_buffer);
+    cdc_di_free(t->dinfo, old_buffer);
   } else {
-    struct cdc_hash_table_entry *nil = (struct cdc_hash_table_entry *)calloc(
-        sizeof(struct cdc_hash_table_entry), 1);
+    struct cdc_hash_table_entry *nil =
+        (struct cdc_hash_table_entry *)cdc_di_calloc(
+            t->dinfo, sizeof(struct cdc_hash_table_entry));
     if (!nil) {
-      free(new_buckets);
+      cdc_di_free(t->dinfo, new_buckets);
       return CDC_STATUS_BAD_ALLOC;
     }
 
@@ -278,6 +463,96 @@ static enum cdc_stat reallocate(struct cdc_hash_table *t, size_t count)
   return CDC_STATUS_OK;
 }
 
+struct fill_job {
+  struct cdc_hash_table *table;
+  char *block;
+  void **keys;
+  void **values;
+  size_t begin;
+  size_t end;
+};
+
+static struct cdc_hash_table_entry *block_entry(struct cdc_hash_table *t,
+                                                char *block, size_t index)
+{
+  return (struct cdc_hash_table_entry *)(block + index * t->pool.node_size);
+}
+
+static void *fill_entries(void *arg)
+{
+  struct fill_job *job = (struct fill_job *)arg;
+  struct cdc_hash_table *t = job->table;
+  for (size_t i = job->begin; i < job->end; ++i) {
+    struct cdc_hash_table_entry *entry = block_entry(t, job->block, i);
+    entry->next = NULL;
+    entry->key = job->keys[i];
+    entry->value = job->values[i];
+    entry->hash = hash_key(t, entry->key);
+  }
+
+  return NULL;
+}
+
+// Hashes the keys in up to t->bulk_threads threads. If a thread can not be
+// started, its part is done by the calling thread.
+static void fill_entries_parallel(struct cdc_hash_table *t, char *block,
+                                  void **keys, void **values, size_t n)
+{
+  size_t threads = CDC_MIN(t->bulk_threads, HASH_TABLE_MAX_BULK_THREADS);
+  threads = CDC_MIN(threads, n / HASH_TABLE_MIN_THREAD_WORK);
+  if (threads <= 1) {
+    struct fill_job job = {t, block, keys, values, 0, n};
+    fill_entries(&job);
+    return;
+  }
+
+  pthread_t ids[HASH_TABLE_MAX_BULK_THREADS];
+  bool started[HASH_TABLE_MAX_BULK_THREADS];
+  struct fill_job jobs[HASH_TABLE_MAX_BULK_THREADS];
+  size_t step = n / threads;
+  for (size_t i = 0; i < threads; ++i) {
+    struct fill_job job = {t, block, keys, values, i * step,
+                           i + 1 == threads ? n : (i + 1) * step};
+    jobs[i] = job;
+    started[i] =
+        i != 0 && pthread_create(&ids[i], NULL, fill_entries, &jobs[i]) == 0;
+  }
+
+  for (size_t i = 0; i < threads; ++i) {
+    if (!started[i]) {
+      fill_entries(&jobs[i]);
+    }
+  }
+
+  for (size_t i = 1; i < threads; ++i) {
+    if (started[i]) {
+      pthread_join(ids[i], NULL);
+    }
+  }
+}
+
+// Links the hashed entries of the block into the table. The buckets are
+// large enough, so there is no rehash.
+static void link_entries(struct cdc_hash_table *t, char *block, size_t n)
+{
+  for (size_t i = 0; i < n; ++i) {
+    if (i + HASH_TABLE_PREFETCH_DISTANCE < n) {
+      struct cdc_hash_table_entry *ahead =
+          block_entry(t, block, i + HASH_TABLE_PREFETCH_DISTANCE);
+      CDC_PREFETCH(&t->buckets[get_bucket(ahead->hash, t->bcount)]);
+    }
+
+    struct cdc_hash_table_entry *entry = block_entry(t, block, i);
+    if (find_entry(t, entry->key, entry->hash)) {
+      cdc_node_pool_free(&t->pool, entry);
+      continue;
+    }
+
+    add_entry(t, entry);
+    ++t->size;
+  }
+}
+
 static enum cdc_stat init_varg(struct cdc_hash_table *t, va_list args)
 {
   struct cdc_pair *pair = NULL;
@@ -308,12 +583,18 @@ enum cdc_stat cdc_hash_table_ctor1(struct cdc_hash_table **t,
   }
 
   tmp->load_factor = load_factor;
+  tmp->bulk_threads = 1;
   enum cdc_stat stat = CDC_STATUS_OK;
   if (info && !(tmp->dinfo = cdc_di_shared_ctorc(info))) {
     stat = CDC_STATUS_BAD_ALLOC;
     goto free_hash_table;
   }
 
+  if (info->pool_chunk) {
+    cdc_node_pool_init(&tmp->pool, sizeof(struct cdc_hash_table_entry),
+                       info->pool_chunk);
+  }
+
   stat = reallocate(tmp, HASH_TABLE_MIN_CAPACITY);
   if (stat != CDC_STATUS_OK) {
     goto free_di;
@@ -395,12 +676,36 @@ enum cdc_stat cdc_hash_table_ctorv(struct cdc_hash_table **t,
   return cdc_hash_table_ctorv1(t, info, HASH_TABLE_LOAD_FACTOR, args);
 }
 
+enum cdc_stat cdc_hash_table_ctor_from(struct cdc_hash_table **t,
+                                       struct cdc_data_info *info,
+                                       void **keys, void **values, size_t n)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  struct cdc_hash_table *tmp = NULL;
+  enum cdc_stat stat = cdc_hash_table_ctor(&tmp, info);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  stat = cdc_hash_table_insert_range(tmp, keys, values, n);
+  if (stat != CDC_STATUS_OK) {
+    cdc_hash_table_dtor(tmp);
+    return stat;
+  }
+
+  *t = tmp;
+  return CDC_STATUS_OK;
+}
+
 void cdc_hash_table_dtor(struct cdc_hash_table *t)
 {
   assert(t != NULL);
 
   free_all_entries(t);
-  free(t->buckets);
+  cdc_di_free(t->dinfo, t->buckets);
   cdc_di_shared_dtor(t->dinfo);
   free(t);
 }
@@ -410,7 +715,16 @@ enum cdc_stat cdc_hash_table_get(struct cdc_hash_table *t, void *key,
 {
   assert(t != NULL);
 
-  struct cdc_hash_table_entry *entry = find_entry(t, key);
+  return cdc_hash_table_get_hashed(t, key, user_hash(t, key), value);
+}
+
+enum cdc_stat cdc_hash_table_get_hashed(struct cdc_hash_table *t, void *key,
+                                        size_t hash, void **value)
+{
+  assert(t != NULL);
+
+  struct cdc_hash_table_entry *entry =
+      find_entry(t, key, mix_hash(t, key, hash));
   if (!entry) {
     return CDC_STATUS_NOT_FOUND;
   }
@@ -419,11 +733,59 @@ enum cdc_stat cdc_hash_table_get(struct cdc_hash_table *t, void *key,
   return CDC_STATUS_OK;
 }
 
+size_t cdc_hash_table_get_many(struct cdc_hash_table *t, void **keys,
+                               size_t n, void **values, bool *found)
+{
+  assert(t != NULL);
+  assert(keys != NULL || n == 0);
+  assert(values != NULL || n == 0);
+
+  size_t hashes[HASH_TABLE_BATCH_SIZE];
+  struct cdc_hash_table_entry *heads[HASH_TABLE_BATCH_SIZE];
+  size_t count = 0;
+  for (size_t offset = 0; offset < n; offset += HASH_TABLE_BATCH_SIZE) {
+    size_t batch = CDC_MIN(n - offset, (size_t)HASH_TABLE_BATCH_SIZE);
+    void **batch_keys = keys + offset;
+    // Each pass only starts loads for the next one, so the cache misses of
+    // all keys of the batch overlap.
+    for (size_t i = 0; i < batch; ++i) {
+      hashes[i] = hash_key(t, batch_keys[i]);
+      CDC_PREFETCH(&t->buckets[get_bucket(hashes[i], t->bcount)]);
+    }
+
+    for (size_t i = 0; i < batch; ++i) {
+      heads[i] = t->buckets[get_bucket(hashes[i], t->bcount)];
+      if (heads[i]) {
+        CDC_PREFETCH(heads[i]);
+      }
+    }
+
+    for (size_t i = 0; i < batch; ++i) {
+      if (heads[i] && heads[i]->next) {
+        CDC_PREFETCH(heads[i]->next);
+      }
+    }
+
+    for (size_t i = 0; i < batch; ++i) {
+      struct cdc_hash_table_entry *entry =
+          find_entry(t, batch_keys[i], hashes[i]);
+      values[offset + i] = entry ? entry->next->value : NULL;
+      if (found) {
+        found[offset + i] = entry != NULL;
+      }
+
+      count += entry != NULL;
+    }
+  }
+
+  return count;
+}
+
 size_t cdc_hash_table_count(struct cdc_hash_table *t, void *key)
 {
   assert(t != NULL);
 
-  return (size_t)(find_entry(t, key) != NULL);
+  return (size_t)(find_entry(t, key, hash_key(t, key)) != NULL);
 }
 
 void cdc_hash_table_find(struct cdc_hash_table *t, void *key,
@@ -432,7 +794,17 @@ void cdc_hash_table_find(struct cdc_hash_table *t, void *key,
   assert(t != NULL);
   assert(it != NULL);
 
-  struct cdc_hash_table_entry *entry = find_entry(t, key);
+  cdc_hash_table_find_hashed(t, key, user_hash(t, key), it);
+}
+
+void cdc_hash_table_find_hashed(struct cdc_hash_table *t, void *key,
+                                size_t hash, struct cdc_hash_table_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_hash_table_entry *entry =
+      find_entry(t, key, mix_hash(t, key, hash));
   it->container = t;
   it->current = entry ? entry->next : NULL;
 }
@@ -441,7 +813,9 @@ void cdc_hash_table_clear(struct cdc_hash_table *t)
 {
   assert(t != NULL);
 
-  free_entries(t);
+  free_old_buckets(t);
+  free_entries(t, t->buckets[0]);
+  cdc_node_pool_release(&t->pool, t->dinfo);
   t->buckets[0]->next = NULL;
   t->tail = t->buckets[0];
   t->size = 0;
@@ -453,10 +827,22 @@ enum cdc_stat cdc_hash_table_insert(struct cdc_hash_table *t, void *key,
 {
   assert(t != NULL);
 
-  struct cdc_hash_table_entry *entry = find_entry(t, key);
+  return cdc_hash_table_insert_hashed(t, key, user_hash(t, key), value, it,
+                                      inserted);
+}
+
+enum cdc_stat cdc_hash_table_insert_hashed(struct cdc_hash_table *t, void *key,
+                                           size_t hash, void *value,
+                                           struct cdc_hash_table_iter *it,
+                                           bool *inserted)
+{
+  assert(t != NULL);
+
+  hash = mix_hash(t, key, hash);
+  struct cdc_hash_table_entry *entry = find_entry(t, key, hash);
   bool finded = entry;
   if (!finded) {
-    enum cdc_stat stat = make_and_insert_unique(t, key, value, &entry);
+    enum cdc_stat stat = make_and_insert_unique(t, key, value, hash, &entry);
     if (stat != CDC_STATUS_OK) {
       return stat;
     }
@@ -481,10 +867,21 @@ enum cdc_stat cdc_hash_table_insert_or_assign(struct cdc_hash_table *t,
 {
   assert(t != NULL);
 
-  struct cdc_hash_table_entry *entry = find_entry(t, key);
+  return cdc_hash_table_insert_or_assign_hashed(t, key, user_hash(t, key),
+                                                value, it, inserted);
+}
+
+enum cdc_stat cdc_hash_table_insert_or_assign_hashed(
+    struct cdc_hash_table *t, void *key, size_t hash, void *value,
+    struct cdc_hash_table_iter *it, bool *inserted)
+{
+  assert(t != NULL);
+
+  hash = mix_hash(t, key, hash);
+  struct cdc_hash_table_entry *entry = find_entry(t, key, hash);
   bool finded = entry;
   if (!finded) {
-    enum cdc_stat stat = make_and_insert_unique(t, key, value, &entry);
+    enum cdc_stat stat = make_and_insert_unique(t, key, value, hash, &entry);
     if (stat != CDC_STATUS_OK) {
       return stat;
     }
@@ -504,18 +901,187 @@ enum cdc_stat cdc_hash_table_insert_or_assign(struct cdc_hash_table *t,
   return CDC_STATUS_OK;
 }
 
+enum cdc_stat cdc_hash_table_insert_range(struct cdc_hash_table *t,
+                                          void **keys, void **values,
+                                          size_t n)
+{
+  assert(t != NULL);
+  assert(keys != NULL || n == 0);
+  assert(values != NULL || n == 0);
+
+  if (n == 0) {
+    return CDC_STATUS_OK;
+  }
+
+  if (n > SIZE_MAX - t->size) {
+    return CDC_STATUS_OVERFLOW;
+  }
+
+  enum cdc_stat stat = cdc_hash_table_reserve(t, t->size + n);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  if (!cdc_node_pool_enabled(&t->pool)) {
+    // Entries allocated one by one can not be returned to a pool.
+    if (t->size != 0) {
+      for (size_t i = 0; i < n; ++i) {
+        stat = cdc_hash_table_insert(t, keys[i], values[i], NULL, NULL);
+        if (stat != CDC_STATUS_OK) {
+          return stat;
+        }
+      }
+
+      return CDC_STATUS_OK;
+    }
+
+    cdc_node_pool_init(&t->pool, sizeof(struct cdc_hash_table_entry),
+                       HASH_TABLE_POOL_CHUNK);
+  }
+
+  char *block = (char *)cdc_node_pool_alloc_block(&t->pool, t->dinfo, n);
+  if (!block) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  fill_entries_parallel(t, block, keys, values, n);
+  link_entries(t, block, n);
+  return CDC_STATUS_OK;
+}
+
 size_t cdc_hash_table_erase(struct cdc_hash_table *t, void *key)
 {
   assert(t != NULL);
 
-  size_t bucket = key ? get_bucket(t->dinfo->hash(key), t->bcount) : 0;
-  struct cdc_hash_table_entry *entry = find_entry_by_bucket(t, key, bucket);
-  if (!entry) {
-    return 0;
+  return cdc_hash_table_erase_hashed(t, key, user_hash(t, key));
+}
+
+size_t cdc_hash_table_erase_hashed(struct cdc_hash_table *t, void *key,
+                                   size_t hash)
+{
+  assert(t != NULL);
+
+  HASH_TABLE_COUNT(t, lookups, 1);
+  hash = mix_hash(t, key, hash);
+  size_t bucket = key ? get_bucket(hash, t->bcount) : 0;
+  struct cdc_hash_table_entry *entry =
+      find_entry_by_bucket(t, t->buckets, t->bcount, key, bucket);
+  if (entry) {
+    erase_entry(t, entry, bucket);
+    return 1;
+  }
+
+  if (t->old_buckets) {
+    bucket = key ? get_bucket(hash, t->old_bcount) : 0;
+    entry = find_entry_by_bucket(t, t->old_buckets, t->old_bcount, key, bucket);
+    if (entry) {
+      erase_old_entry(t, entry, bucket);
+      return 1;
+    }
+  }
+
+  return 0;
+}
+
+static size_t reverse_bits(size_t v)
+{
+  size_t shift = CHAR_BIT * sizeof(v);
+  size_t mask = ~(size_t)0;
+  while ((shift >>= 1) > 0) {
+    mask ^= mask << shift;
+    v = ((v >> shift) & mask) | ((v << shift) & ~mask);
+  }
+
+  return v;
+}
+
+// Increments the high bits of the cursor that are not masked, starting from
+// the highest one. A cursor of a smaller table then covers all its expansions
+// in a bigger one.
+static size_t next_cursor(size_t cursor, size_t mask)
+{
+  cursor |= ~mask;
+  cursor = reverse_bits(cursor);
+  ++cursor;
+  return reverse_bits(cursor);
+}
+
+// Passes the entries of the bucket to cb and erases the ones for which it
+// returns true. Returns the number of the visited entries.
+static size_t scan_bucket(struct cdc_hash_table *t, bool old, size_t bucket,
+                          bool (*cb)(void *, void *, void *), void *ctx)
+{
+  struct cdc_hash_table_entry **buckets = old ? t->old_buckets : t->buckets;
+  size_t count = old ? t->old_bcount : t->bcount;
+  struct cdc_hash_table_entry *prev = buckets[bucket];
+  size_t visited = 0;
+  while (prev && prev->next &&
+         get_bucket(prev->next->hash, count) == bucket) {
+    struct cdc_hash_table_entry *entry = prev->next;
+    ++visited;
+    if (!cb(entry->key, entry->value, ctx)) {
+      prev = entry;
+    } else if (!old) {
+      erase_entry(t, prev, bucket);
+    } else {
+      erase_old_entry(t, prev, bucket);
+      // The old bucket array is freed with its last entry.
+      if (!t->old_buckets) {
+        break;
+      }
+    }
+  }
+
+  return visited;
+}
+
+static size_t scan_step(struct cdc_hash_table *t, size_t *cursor,
+                        bool (*cb)(void *, void *, void *), void *ctx)
+{
+  size_t mask = t->bcount - 1;
+  size_t visited = 0;
+  if (!t->old_buckets) {
+    visited = scan_bucket(t, false, *cursor & mask, cb, ctx);
+    *cursor = next_cursor(*cursor, mask);
+    return visited;
   }
 
-  erase_entry(t, entry, bucket);
-  return 1;
+  // The old bucket array is always the smaller one, the entries of its bucket
+  // go to the buckets of the new array with the same low bits.
+  assert(t->old_bcount < t->bcount);
+  size_t old_mask = t->old_bcount - 1;
+  size_t v = *cursor;
+  visited = scan_bucket(t, true, v & old_mask, cb, ctx);
+  do {
+    visited += scan_bucket(t, false, v & mask, cb, ctx);
+    v = next_cursor(v, mask);
+  } while (v & (old_mask ^ mask));
+
+  *cursor = v;
+  return visited;
+}
+
+size_t cdc_hash_table_scan(struct cdc_hash_table *t, size_t cursor,
+                           bool (*cb)(void *key, void *value, void *ctx),
+                           void *ctx, size_t budget)
+{
+  assert(t != NULL);
+  assert(cb != NULL);
+
+  size_t empty_limit = budget > SIZE_MAX / HASH_TABLE_SCAN_EMPTY_FACTOR
+                           ? SIZE_MAX
+                           : CDC_MAX(budget, (size_t)1) *
+                                 HASH_TABLE_SCAN_EMPTY_FACTOR;
+  size_t visited = 0;
+  do {
+    size_t step = scan_step(t, &cursor, cb, ctx);
+    visited += step;
+    if (step == 0) {
+      --empty_limit;
+    }
+  } while (cursor != 0 && visited < budget && empty_limit != 0);
+
+  return cursor;
 }
 
 void cdc_hash_table_swap(struct cdc_hash_table *a, struct cdc_hash_table *b)
@@ -529,12 +1095,21 @@ void cdc_hash_table_swap(struct cdc_hash_table *a, struct cdc_hash_table *b)
   CDC_SWAP(float, a->load_factor, b->load_factor);
   CDC_SWAP(size_t, a->size, b->size);
   CDC_SWAP(struct cdc_data_info *, a->dinfo, b->dinfo);
+  CDC_SWAP(struct cdc_hash_table_entry *, a->old_tail, b->old_tail);
+  CDC_SWAP(struct cdc_hash_table_entry **, a->old_buckets, b->old_buckets);
+  CDC_SWAP(size_t, a->old_bcount, b->old_bcount);
+  CDC_SWAP(size_t, a->rehash_step, b->rehash_step);
+  CDC_SWAP(size_t, a->seed, b->seed);
+  CDC_SWAP(struct cdc_hash_table_counters, a->counters, b->counters);
+  CDC_SWAP(struct cdc_node_pool, a->pool, b->pool);
+  CDC_SWAP(size_t, a->bulk_threads, b->bulk_threads);
 }
 
 enum cdc_stat cdc_hash_table_rehash(struct cdc_hash_table *t, size_t count)
 {
   assert(t != NULL);
 
+  finish_rehash(t);
   if (count <= t->bcount) {
     return CDC_STATUS_OK;
   }
@@ -550,3 +1125,75 @@ enum cdc_stat cdc_hash_table_reserve(struct cdc_hash_table *t, size_t count)
 
   return cdc_hash_table_rehash(t, (size_t)((float)count / t->load_factor) + 1);
 }
+
+enum cdc_stat cdc_hash_table_set_seed(struct cdc_hash_table *t, size_t seed)
+{
+  assert(t != NULL);
+
+  finish_rehash(t);
+  struct cdc_hash_table_entry **new_buckets =
+      (struct cdc_hash_table_entry **)cdc_di_calloc(t->dinfo,
+                                                    t->bcount * sizeof(void *));
+  if (!new_buckets) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  t->seed = seed;
+  for (struct cdc_hash_table_entry *entry = t->buckets[0]->next; entry;
+       entry = entry->next) {
+    entry->hash = hash_key(t, entry->key);
+  }
+
+  struct cdc_hash_table_entry **old_buffer =
+      transfer(t, new_buckets, t->bcount);
+  cdc_di_free(t->dinfo, old_buffer);
+  return CDC_STATUS_OK;
+}
+
+static void add_chain_stats(struct cdc_hash_table_stats *stats,
+                            struct cdc_hash_table_entry *nil, size_t count)
+{
+  struct cdc_hash_table_entry *entry = nil->next;
+  while (entry) {
+    size_t bucket = get_entry_bucket(entry, count);
+    size_t length = 0;
+    do {
+      ++length;
+      entry = entry->next;
+    } while (entry && get_entry_bucket(entry, count) == bucket);
+
+    ++stats->used_buckets;
+    stats->max_chain = CDC_MAX(stats->max_chain, length);
+    ++stats->chains[CDC_MIN(length, (size_t)CDC_HASH_TABLE_STATS_CHAINS - 1)];
+  }
+}
+
+void cdc_hash_table_stats(struct cdc_hash_table *t,
+                          struct cdc_hash_table_stats *stats)
+{
+  assert(t != NULL);
+  assert(stats != NULL);
+
+  memset(stats, 0, sizeof(*stats));
+  stats->size = t->size;
+  stats->bucket_count = t->bcount + t->old_bcount;
+  add_chain_stats(stats, t->buckets[0], t->bcount);
+  if (t->old_buckets) {
+    add_chain_stats(stats, t->old_buckets[0], t->old_bcount);
+  }
+
+  stats->chains[0] = stats->bucket_count - stats->used_buckets;
+  stats->rehashes = HASH_TABLE_LOAD(t, rehashes);
+  stats->rehash_time = t->counters.rehash_time;
+  stats->lookups = HASH_TABLE_LOAD(t, lookups);
+  stats->probes = HASH_TABLE_LOAD(t, probes);
+  stats->avg_probe_length =
+      stats->lookups ? (double)stats->probes / (double)stats->lookups : 0.0;
+}
+
+void cdc_hash_table_reset_stats(struct cdc_hash_table *t)
+{
+  assert(t != NULL);
+
+  memset(&t->counters, 0, sizeof(t->counters));
+}
@@ -0,0 +1,134 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "cdcontainers/hash.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+static const uint64_t kSecret[4] = {
+    UINT64_C(0x2d358dccaa6c78a5), UINT64_C(0x8bb84b93962eacc9),
+    UINT64_C(0x4b33a62ed433d4a3), UINT64_C(0x4d5a2da51de1aa47)};
+
+// Computes the 128-bit product of a and b. The low half is stored in a, the
+// high half is stored in b.
+static void mum(uint64_t *a, uint64_t *b)
+{
+#ifdef __SIZEOF_INT128__
+  __extension__ typedef unsigned __int128 uint128_t;
+  uint128_t r = (uint128_t)*a * *b;
+  *a = (uint64_t)r;
+  *b = (uint64_t)(r >> 64);
+#else
+  uint64_t ha = *a >> 32, hb = *b >> 32;
+  uint64_t la = (uint32_t)*a, lb = (uint32_t)*b;
+  uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t t = rl + (rm0 << 32);
+  uint64_t c = t < rl;
+  uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  *a = lo;
+  *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static uint64_t mix(uint64_t a, uint64_t b)
+{
+  mum(&a, &b);
+  return a ^ b;
+}
+
+static uint64_t read8(const uint8_t *p)
+{
+  uint64_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static uint64_t read4(const uint8_t *p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
+
+static uint64_t read3(const uint8_t *p, size_t k)
+{
+  return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+size_t cdc_hash_bytes(const void *data, size_t length, uint64_t seed)
+{
+  const uint8_t *p = (const uint8_t *)data;
+  uint64_t a = 0;
+  uint64_t b = 0;
+  seed ^= mix(seed ^ kSecret[0], kSecret[1]);
+  if (length <= 16) {
+    if (length >= 4) {
+      a = (read4(p) << 32) | read4(p + ((length >> 3) << 2));
+      b = (read4(p + length - 4) << 32) |
+          read4(p + length - 4 - ((length >> 3) << 2));
+    } else if (length > 0) {
+      a = read3(p, length);
+    }
+  } else {
+    size_t i = length;
+    if (i > 48) {
+      uint64_t seed1 = seed;
+      uint64_t seed2 = seed;
+      do {
+        seed = mix(read8(p) ^ kSecret[1], read8(p + 8) ^ seed);
+        seed1 = mix(read8(p + 16) ^ kSecret[2], read8(p + 24) ^ seed1);
+        seed2 = mix(read8(p + 32) ^ kSecret[3], read8(p + 40) ^ seed2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= seed1 ^ seed2;
+    }
+
+    while (i > 16) {
+      seed = mix(read8(p) ^ kSecret[1], read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+
+    a = read8(p + i - 16);
+    b = read8(p + i - 8);
+  }
+
+  a ^= kSecret[1];
+  b ^= seed;
+  mum(&a, &b);
+  return (size_t)mix(a ^ kSecret[0] ^ length, b ^ kSecret[1]);
+}
+
+uint64_t cdc_hash_random_seed(void)
+{
+  static uint64_t counter = 0;
+  int local = 0;
+  uint64_t seed = cdc_hash_u64((uint64_t)time(NULL));
+  seed = cdc_hash_u64(seed ^ (uint64_t)clock());
+  seed = cdc_hash_u64(seed ^ (uint64_t)(uintptr_t)&local);
+  seed = cdc_hash_u64(seed ^ (uint64_t)(uintptr_t)&counter);
+  // Tables are often created on several threads at once.
+  return cdc_hash_u64(seed ^
+                      (__atomic_fetch_add(&counter, 1, __ATOMIC_RELAXED) + 1));
+}
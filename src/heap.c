@@ -43,13 +43,13 @@ static size_t sift_down(struct cdc_heap *h, size_t i)
     size_t l = left(i);
     size_t r = right(i);
 
-    if (l < size && h->array->dinfo->cmp(data[l], data[i])) {
+    if (l < size && cdc_di_less(h->array->dinfo, data[l], data[i])) {
       largest = l;
     } else {
       largest = i;
     }
 
-    if (r < size && h->array->dinfo->cmp(data[r], data[largest])) {
+    if (r < size && cdc_di_less(h->array->dinfo, data[r], data[largest])) {
       largest = r;
     }
 
@@ -67,7 +67,7 @@ static size_t sift_up(struct cdc_heap *h, size_t i)
 {
   void **data = cdc_array_data(h->array);
   size_t p = parent(i);
-  while (i > 0 && h->array->dinfo->cmp(data[i], data[p])) {
+  while (i > 0 && cdc_di_less(h->array->dinfo, data[i], data[p])) {
     CDC_SWAP(void *, data[i], data[p]);
     i = parent(i);
     p = parent(i);
@@ -101,7 +101,7 @@ static enum cdc_stat init_varg(struct cdc_heap *h, va_list args)
 enum cdc_stat cdc_heap_ctor(struct cdc_heap **h, struct cdc_data_info *info)
 {
   assert(h != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   struct cdc_heap *tmp = (struct cdc_heap *)calloc(sizeof(struct cdc_heap), 1);
   if (!tmp) {
@@ -122,7 +122,7 @@ enum cdc_stat cdc_heap_ctorl(struct cdc_heap **h, struct cdc_data_info *info,
                              ...)
 {
   assert(h != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   va_list args;
   va_start(args, info);
@@ -135,7 +135,7 @@ enum cdc_stat cdc_heap_ctorv(struct cdc_heap **h, struct cdc_data_info *info,
                              va_list args)
 {
   assert(h != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   enum cdc_stat ret = cdc_heap_ctor(h, info);
   if (ret != CDC_STATUS_OK) {
@@ -177,7 +177,7 @@ void cdc_heap_change_key(struct cdc_heap *h, struct cdc_heap_iter *pos,
   assert(h->array == pos->container);
 
   void **data = cdc_array_data(h->array);
-  bool is_sift_down = h->array->dinfo->cmp(data[pos->current], key);
+  bool is_sift_down = cdc_di_less(h->array->dinfo, data[pos->current], key);
   cdc_array_set(h->array, pos->current, key);
   if (is_sift_down) {
     pos->current = sift_down(h, pos->current);
@@ -239,7 +239,7 @@ bool cdc_heap_is_heap(struct cdc_heap *h)
 
   void **data = cdc_array_data(h->array);
   for (size_t i = 1; i < size; ++i) {
-    if (h->array->dinfo->cmp(data[i], data[parent(i)])) {
+    if (cdc_di_less(h->array->dinfo, data[i], data[parent(i)])) {
       return false;
     }
   }
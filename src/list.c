@@ -21,14 +21,15 @@
 #include "cdcontainers/list.h"
 
 #include "cdcontainers/data-info.h"
+#include "cdcontainers/global.h"
 
 #include <stdint.h>
 #include <string.h>
 
-static struct cdc_list_node *make_new_node(void *val)
+static struct cdc_list_node *make_new_node(struct cdc_list *l, void *val)
 {
-  struct cdc_list_node *node =
-      (struct cdc_list_node *)malloc(sizeof(struct cdc_list_node));
+  struct cdc_list_node *node = (struct cdc_list_node *)cdc_di_node_alloc(
+      l->dinfo, &l->pool, sizeof(struct cdc_list_node));
   if (node) {
     node->data = val;
   }
@@ -44,11 +45,22 @@ static void free_node(struct cdc_list *l, struct cdc_list_node *node)
     l->dinfo->dfree(node->data);
   }
 
-  free(node);
+  cdc_di_node_free(l->dinfo, &l->pool, node);
 }
 
 static void free_nodes(struct cdc_list *l)
 {
+  if (cdc_node_pool_enabled(&l->pool)) {
+    if (CDC_HAS_DFREE(l->dinfo)) {
+      for (struct cdc_list_node *node = l->head; node; node = node->next) {
+        l->dinfo->dfree(node->data);
+      }
+    }
+
+    cdc_node_pool_release(&l->pool, l->dinfo);
+    return;
+  }
+
   struct cdc_list_node *current = l->head;
   struct cdc_list_node *next = NULL;
   while (current) {
@@ -61,7 +73,7 @@ static void free_nodes(struct cdc_list *l)
 static enum cdc_stat insert_mid(struct cdc_list *l, struct cdc_list_node *n,
                                 void *value)
 {
-  struct cdc_list_node *node = make_new_node(value);
+  struct cdc_list_node *node = make_new_node(l, value);
   if (node == NULL) {
     return CDC_STATUS_BAD_ALLOC;
   }
@@ -131,9 +143,31 @@ static void erase_node(struct cdc_list *l, struct cdc_list_node *node)
   }
 }
 
+// The order of a sort or a merge: the predicate less or, if it is NULL, the
+// three-way comparison cmp3.
+struct order {
+  cdc_binary_pred_fn_t less;
+  cdc_cmp3_fn_t cmp3;
+};
+
+static bool is_less(struct order *order, const void *l, const void *r)
+{
+  return order->less ? order->less(l, r) : order->cmp3(l, r) < 0;
+}
+
+static struct order get_order(struct cdc_list *l)
+{
+  struct order order = {NULL, l->dinfo->cmp3};
+  if (!order.cmp3) {
+    order.less = l->dinfo->cmp;
+  }
+
+  return order;
+}
+
 static void cmerge(struct cdc_list_node **ha, struct cdc_list_node **ta,
                    struct cdc_list_node *hb, struct cdc_list_node *tb,
-                   cdc_binary_pred_fn_t compare)
+                   struct order *order)
 {
   struct cdc_list_node *a = *ha;
   struct cdc_list_node *b = hb;
@@ -149,7 +183,7 @@ static void cmerge(struct cdc_list_node **ha, struct cdc_list_node **ta,
   struct cdc_list_node *head = NULL;
   struct cdc_list_node *tail = NULL;
   while (b != NULL && a != NULL) {
-    if (compare(a->data, b->data)) {
+    if (is_less(order, a->data, b->data)) {
       if (head == NULL) {
         head = tail = a;
       } else {
@@ -210,7 +244,7 @@ static void halve(struct cdc_list_node **ha, struct cdc_list_node **ta,
 }
 
 static void merge_sort(struct cdc_list_node **head, struct cdc_list_node **tail,
-                       cdc_binary_pred_fn_t compare)
+                       struct order *order)
 {
   struct cdc_list_node *ha = *head;
   struct cdc_list_node *ta = *tail;
@@ -221,13 +255,26 @@ static void merge_sort(struct cdc_list_node **head, struct cdc_list_node **tail,
   struct cdc_list_node *hb = NULL;
   struct cdc_list_node *tb = NULL;
   halve(&ha, &ta, &hb, &tb);
-  merge_sort(&ha, &ta, compare);
-  merge_sort(&hb, &tb, compare);
-  cmerge(&ha, &ta, hb, tb, compare);
+  merge_sort(&ha, &ta, order);
+  merge_sort(&hb, &tb, order);
+  cmerge(&ha, &ta, hb, tb, order);
   *head = ha;
   *tail = ta;
 }
 
+static void move_pool(struct cdc_list *l, struct cdc_list *other)
+{
+  // The nodes of a list with a node pool cannot be freed with free and vice
+  // versa, so such lists cannot exchange nodes.
+  CDC_CHECK(cdc_node_pool_enabled(&l->pool) ==
+                cdc_node_pool_enabled(&other->pool),
+            "Lists with and without a node pool cannot exchange nodes.");
+
+  if (l != other && cdc_node_pool_enabled(&l->pool)) {
+    cdc_node_pool_merge(&l->pool, &other->pool);
+  }
+}
+
 static enum cdc_stat init_varg(struct cdc_list *l, va_list args)
 {
   void *elem = NULL;
@@ -255,6 +302,11 @@ enum cdc_stat cdc_list_ctor(struct cdc_list **l, struct cdc_data_info *info)
     return CDC_STATUS_BAD_ALLOC;
   }
 
+  if (info && info->pool_chunk) {
+    cdc_node_pool_init(&tmp->pool, sizeof(struct cdc_list_node),
+                       info->pool_chunk);
+  }
+
   *l = tmp;
   return CDC_STATUS_OK;
 }
@@ -304,7 +356,7 @@ enum cdc_stat cdc_list_push_back(struct cdc_list *l, void *value)
 {
   assert(l != NULL);
 
-  struct cdc_list_node *node = make_new_node(value);
+  struct cdc_list_node *node = make_new_node(l, value);
   if (!node) {
     return CDC_STATUS_BAD_ALLOC;
   }
@@ -347,7 +399,7 @@ enum cdc_stat cdc_list_push_front(struct cdc_list *l, void *value)
 {
   assert(l != NULL);
 
-  struct cdc_list_node *node = make_new_node(value);
+  struct cdc_list_node *node = make_new_node(l, value);
   if (!node) {
     return CDC_STATUS_BAD_ALLOC;
   }
@@ -469,15 +521,12 @@ void cdc_list_swap(struct cdc_list *a, struct cdc_list *b)
   CDC_SWAP(struct cdc_list_node *, a->tail, b->tail);
   CDC_SWAP(size_t, a->size, b->size);
   CDC_SWAP(struct cdc_data_info *, a->dinfo, b->dinfo);
+  CDC_SWAP(struct cdc_node_pool, a->pool, b->pool);
 }
 
-void cdc_list_splice(struct cdc_list_iter *position,
-                     struct cdc_list_iter *first, struct cdc_list_iter *last)
+static void splice(struct cdc_list_iter *position, struct cdc_list_iter *first,
+                   struct cdc_list_iter *last)
 {
-  assert(position != NULL);
-  assert(first != NULL);
-  assert(last != NULL);
-
   struct cdc_list_iter prev_last = *last;
   size_t len = distance(first->current, last->current);
   cdc_list_iter_prev(&prev_last);
@@ -528,6 +577,20 @@ void cdc_list_splice(struct cdc_list_iter *position,
   first->container->size -= len;
 }
 
+void cdc_list_splice(struct cdc_list_iter *position,
+                     struct cdc_list_iter *first, struct cdc_list_iter *last)
+{
+  assert(position != NULL);
+  assert(first != NULL);
+  assert(last != NULL);
+  CDC_CHECK(position->container == first->container ||
+                (!cdc_node_pool_enabled(&position->container->pool) &&
+                 !cdc_node_pool_enabled(&first->container->pool)),
+            "Lists with a node pool cannot exchange a part of the nodes.");
+
+  splice(position, first, last);
+}
+
 void cdc_list_ssplice(struct cdc_list_iter *position,
                       struct cdc_list_iter *first)
 {
@@ -548,7 +611,19 @@ void cdc_list_lsplice(struct cdc_list_iter *position, struct cdc_list *other)
   struct cdc_list_iter end;
   cdc_list_begin(other, &beg);
   cdc_list_end(other, &end);
-  cdc_list_splice(position, &beg, &end);
+  move_pool(position->container, other);
+  splice(position, &beg, &end);
+}
+
+static void merge_lists(struct cdc_list *l, struct cdc_list *other,
+                        struct order *order)
+{
+  move_pool(l, other);
+  cmerge(&l->head, &l->tail, other->head, other->tail, order);
+  l->size = l->size + other->size;
+  other->head = NULL;
+  other->tail = NULL;
+  other->size = 0;
 }
 
 void cdc_list_cmerge(struct cdc_list *l, struct cdc_list *other,
@@ -558,19 +633,18 @@ void cdc_list_cmerge(struct cdc_list *l, struct cdc_list *other,
   assert(other != NULL);
   assert(compare != NULL);
 
-  cmerge(&l->head, &l->tail, other->head, other->tail, compare);
-  l->size = l->size + other->size;
-  other->head = NULL;
-  other->tail = NULL;
-  other->size = 0;
+  struct order order = {compare, NULL};
+  merge_lists(l, other, &order);
 }
 
 void cdc_list_merge(struct cdc_list *l, struct cdc_list *other)
 {
   assert(l != NULL);
-  assert(CDC_HAS_CMP(l->dinfo));
+  assert(other != NULL);
+  assert(CDC_HAS_ORDER(l->dinfo));
 
-  cdc_list_cmerge(l, other, l->dinfo->cmp);
+  struct order order = get_order(l);
+  merge_lists(l, other, &order);
 }
 
 void cdc_list_erase_if(struct cdc_list *l, cdc_unary_pred_fn_t pred)
@@ -642,13 +716,15 @@ void cdc_list_csort(struct cdc_list *l, cdc_binary_pred_fn_t compare)
   assert(l != NULL);
   assert(compare != NULL);
 
-  merge_sort(&l->head, &l->tail, compare);
+  struct order order = {compare, NULL};
+  merge_sort(&l->head, &l->tail, &order);
 }
 
 void cdc_list_sort(struct cdc_list *l)
 {
   assert(l != NULL);
-  assert(CDC_HAS_CMP(l->dinfo));
+  assert(CDC_HAS_ORDER(l->dinfo));
 
-  cdc_list_csort(l, l->dinfo->cmp);
+  struct order order = get_order(l);
+  merge_sort(&l->head, &l->tail, &order);
 }
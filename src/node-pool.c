@@ -0,0 +1,166 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "cdcontainers/node-pool.h"
+
+#include "cdcontainers/data-info.h"
+
+#include <assert.h>
+#include <stdint.h>
+
+// The header of a chunk, aligned for any node.
+union chunk_header {
+  union chunk_header *next;
+  void *ptr;
+  long long ll;
+  double d;
+};
+
+static size_t chunk_bytes(struct cdc_node_pool *p)
+{
+  return sizeof(union chunk_header) + p->node_size * p->chunk_size;
+}
+
+void cdc_node_pool_init(struct cdc_node_pool *p, size_t node_size,
+                        size_t chunk_size)
+{
+  assert(p != NULL);
+
+  const size_t align = sizeof(union chunk_header);
+  if (node_size < sizeof(void *)) {
+    node_size = sizeof(void *);
+  }
+
+  p->chunks = NULL;
+  p->free_nodes = NULL;
+  p->next = NULL;
+  p->end = NULL;
+  p->node_size = (node_size + align - 1) / align * align;
+  p->chunk_size = chunk_size;
+}
+
+enum cdc_stat cdc_node_pool_grow(struct cdc_node_pool *p,
+                                 struct cdc_data_info *dinfo)
+{
+  assert(p != NULL);
+  assert(cdc_node_pool_enabled(p));
+
+  if (p->chunk_size > (SIZE_MAX - sizeof(union chunk_header)) / p->node_size) {
+    return CDC_STATUS_OVERFLOW;
+  }
+
+  union chunk_header *chunk =
+      (union chunk_header *)cdc_di_alloc(dinfo, chunk_bytes(p));
+  if (!chunk) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  chunk->next = (union chunk_header *)p->chunks;
+  p->chunks = chunk;
+  p->next = (char *)(chunk + 1);
+  p->end = p->next + p->node_size * p->chunk_size;
+  return CDC_STATUS_OK;
+}
+
+void *cdc_node_pool_alloc_block(struct cdc_node_pool *p,
+                                struct cdc_data_info *dinfo, size_t count)
+{
+  assert(p != NULL);
+  assert(cdc_node_pool_enabled(p));
+
+  if (count > (SIZE_MAX - sizeof(union chunk_header)) / p->node_size) {
+    return NULL;
+  }
+
+  size_t bytes = count * p->node_size;
+  if (p->next && (size_t)(p->end - p->next) >= bytes) {
+    void *block = p->next;
+    p->next += bytes;
+    return block;
+  }
+
+  // The rest of the current chunk stays available for single nodes.
+  union chunk_header *chunk = (union chunk_header *)cdc_di_alloc(
+      dinfo, sizeof(union chunk_header) + bytes);
+  if (!chunk) {
+    return NULL;
+  }
+
+  chunk->next = (union chunk_header *)p->chunks;
+  p->chunks = chunk;
+  return chunk + 1;
+}
+
+void cdc_node_pool_release(struct cdc_node_pool *p,
+                           struct cdc_data_info *dinfo)
+{
+  assert(p != NULL);
+
+  union chunk_header *chunk = (union chunk_header *)p->chunks;
+  while (chunk) {
+    union chunk_header *next = chunk->next;
+    cdc_di_free(dinfo, chunk);
+    chunk = next;
+  }
+
+  p->chunks = NULL;
+  p->free_nodes = NULL;
+  p->next = NULL;
+  p->end = NULL;
+}
+
+void cdc_node_pool_merge(struct cdc_node_pool *dst, struct cdc_node_pool *src)
+{
+  assert(dst != NULL);
+  assert(src != NULL);
+  assert(dst->node_size == src->node_size);
+
+  if (src->chunks == NULL) {
+    return;
+  }
+
+  union chunk_header *last = (union chunk_header *)src->chunks;
+  while (last->next) {
+    last = last->next;
+  }
+
+  last->next = (union chunk_header *)dst->chunks;
+  dst->chunks = src->chunks;
+  // The untouched rest of the current chunk of src becomes free nodes too.
+  while (src->next != src->end) {
+    cdc_node_pool_free(src, src->next);
+    src->next += src->node_size;
+  }
+
+  if (src->free_nodes) {
+    void *tail = src->free_nodes;
+    while (*(void **)tail) {
+      tail = *(void **)tail;
+    }
+
+    *(void **)tail = dst->free_nodes;
+    dst->free_nodes = src->free_nodes;
+  }
+
+  src->chunks = NULL;
+  src->free_nodes = NULL;
+  src->next = NULL;
+  src->end = NULL;
+}
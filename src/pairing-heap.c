@@ -34,7 +34,7 @@ static void free_node(struct cdc_pairing_heap *h,
     h->dinfo->dfree(node->key);
   }
 
-  free(node);
+  cdc_di_free(h->dinfo, node);
 }
 
 static void free_heap(struct cdc_pairing_heap *h,
@@ -49,11 +49,11 @@ static void free_heap(struct cdc_pairing_heap *h,
 }
 
 static bool is_heap(struct cdc_pairing_heap_node *root,
-                    cdc_binary_pred_fn_t compar)
+                    struct cdc_data_info *dinfo)
 {
   while (root) {
-    if (!is_heap(root->child, compar) ||
-        (root->parent && compar(root->key, root->parent->key))) {
+    if (!is_heap(root->child, dinfo) ||
+        (root->parent && cdc_di_less(dinfo, root->key, root->parent->key))) {
       return false;
     }
 
@@ -72,7 +72,7 @@ static void link(struct cdc_pairing_heap_node *a,
 
 static struct cdc_pairing_heap_node *meld(struct cdc_pairing_heap_node *a,
                                           struct cdc_pairing_heap_node *b,
-                                          cdc_binary_pred_fn_t compare)
+                                          struct cdc_data_info *dinfo)
 {
   if (a == NULL) {
     return b;
@@ -82,7 +82,7 @@ static struct cdc_pairing_heap_node *meld(struct cdc_pairing_heap_node *a,
     return a;
   }
 
-  if (compare(a->key, b->key)) {
+  if (cdc_di_less(dinfo, a->key, b->key)) {
     CDC_SWAP(struct cdc_pairing_heap_node *, a, b);
   }
 
@@ -91,7 +91,7 @@ static struct cdc_pairing_heap_node *meld(struct cdc_pairing_heap_node *a,
 }
 
 static struct cdc_pairing_heap_node *two_pass_meld(
-    struct cdc_pairing_heap_node *root, cdc_binary_pred_fn_t compare)
+    struct cdc_pairing_heap_node *root, struct cdc_data_info *dinfo)
 {
   if (root == NULL || root->sibling == NULL) {
     return root;
@@ -104,7 +104,7 @@ static struct cdc_pairing_heap_node *two_pass_meld(
   a->sibling = NULL;
   b->parent = NULL;
   b->sibling = NULL;
-  return meld(meld(a, b, compare), two_pass_meld(c, compare), compare);
+  return meld(meld(a, b, dinfo), two_pass_meld(c, dinfo), dinfo);
 }
 
 static struct cdc_pairing_heap_node *decrease_key(
@@ -117,7 +117,7 @@ static struct cdc_pairing_heap_node *decrease_key(
 
   node->key = key;
   struct cdc_pairing_heap_node *p = node->parent;
-  while (p != NULL && h->dinfo->cmp(node->key, p->key)) {
+  while (p != NULL && cdc_di_less(h->dinfo, node->key, p->key)) {
     CDC_SWAP(void *, node->key, p->key);
     node = p;
     p = node->parent;
@@ -136,10 +136,10 @@ static struct cdc_pairing_heap_node *increase_key(
   struct cdc_pairing_heap_node *ch = pos->child;
   pos->key = key;
   while (ch != NULL) {
-    if (h->dinfo->cmp(ch->key, pos->key)) {
+    if (cdc_di_less(h->dinfo, ch->key, pos->key)) {
       struct cdc_pairing_heap_node *t = ch;
       while (ch->sibling != NULL) {
-        if (h->dinfo->cmp(ch->sibling->key, t->key)) {
+        if (cdc_di_less(h->dinfo, ch->sibling->key, t->key)) {
           t = ch->sibling;
         }
 
@@ -174,7 +174,7 @@ enum cdc_stat cdc_pairing_heap_ctor(struct cdc_pairing_heap **h,
                                     struct cdc_data_info *info)
 {
   assert(h != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   struct cdc_pairing_heap *tmp =
       (struct cdc_pairing_heap *)calloc(sizeof(struct cdc_pairing_heap), 1);
@@ -195,7 +195,7 @@ enum cdc_stat cdc_pairing_heap_ctorl(struct cdc_pairing_heap **h,
                                      struct cdc_data_info *info, ...)
 {
   assert(h != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   va_list args;
   va_start(args, info);
@@ -208,7 +208,7 @@ enum cdc_stat cdc_pairing_heap_ctorv(struct cdc_pairing_heap **h,
                                      struct cdc_data_info *info, va_list args)
 {
   assert(h != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   enum cdc_stat ret = cdc_pairing_heap_ctor(h, info);
   if (ret != CDC_STATUS_OK) {
@@ -232,7 +232,7 @@ enum cdc_stat cdc_pairing_heap_extract_top(struct cdc_pairing_heap *h)
   assert(h != NULL);
 
   struct cdc_pairing_heap_node *node = h->root;
-  h->root = two_pass_meld(h->root->child, h->dinfo->cmp);
+  h->root = two_pass_meld(h->root->child, h->dinfo);
   free_node(h, node);
   --h->size;
   return CDC_STATUS_OK;
@@ -243,14 +243,15 @@ enum cdc_stat cdc_pairing_heap_riinsert(struct cdc_pairing_heap *h, void *key,
 {
   assert(h != NULL);
 
-  struct cdc_pairing_heap_node *root = (struct cdc_pairing_heap_node *)calloc(
-      sizeof(struct cdc_pairing_heap_node), 1);
+  struct cdc_pairing_heap_node *root =
+      (struct cdc_pairing_heap_node *)cdc_di_calloc(
+          h->dinfo, sizeof(struct cdc_pairing_heap_node));
   if (!root) {
     return CDC_STATUS_BAD_ALLOC;
   }
 
   root->key = key;
-  h->root = meld(h->root, root, h->dinfo->cmp);
+  h->root = meld(h->root, root, h->dinfo);
   ++h->size;
   if (ret) {
     ret->container = h;
@@ -270,7 +271,7 @@ void cdc_pairing_heap_change_key(struct cdc_pairing_heap *h,
   //        struct cdc_pairing_heap_node *node;
   //        struct cdc_pairing_heap_node *curr = pos->current;
 
-  //        if (h->compar(key, curr->key))
+  //        if (h->cdc_di_less(dinfo, key, curr->key))
   //                node = decrease_key(h, curr, key);
   //        else
   //                node = increase_key(h, curr, key);
@@ -304,7 +305,7 @@ void cdc_pairing_heap_merge(struct cdc_pairing_heap *h,
   assert(h);
   assert(other);
 
-  h->root = meld(h->root, other->root, h->dinfo->cmp);
+  h->root = meld(h->root, other->root, h->dinfo);
   h->size += other->size;
   other->size = 0;
   other->root = NULL;
@@ -314,5 +315,5 @@ bool cdc_pairing_heap_is_heap(struct cdc_pairing_heap *h)
 {
   assert(h != NULL);
 
-  return is_heap(h->root, h->dinfo->cmp);
+  return is_heap(h->root, h->dinfo);
 }
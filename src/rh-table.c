@@ -0,0 +1,462 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "cdcontainers/rh-table.h"
+
+#include "cdcontainers/data-info.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RH_TABLE_MIN_CAPACITY 8  // must be pow 2
+#define RH_TABLE_COPACITY_SHIFT 1
+#define RH_TABLE_LOAD_FACTOR 0.8f
+// The highest bit is always set in the hash of a used slot, so 0 marks an
+// empty slot.
+#define RH_TABLE_USED_BIT ((size_t)1 << (sizeof(size_t) * 8 - 1))
+
+static size_t make_hash(struct cdc_rh_table *t, void *key)
+{
+  return (key ? t->dinfo->hash(key) : 0) | RH_TABLE_USED_BIT;
+}
+
+static size_t probe_distance(struct cdc_rh_table *t, size_t hash, size_t pos)
+{
+  return (pos - hash) & (t->capacity - 1);
+}
+
+static void free_entry(struct cdc_rh_table *t, struct cdc_rh_table_entry *entry)
+{
+  if (CDC_HAS_DFREE(t->dinfo)) {
+    struct cdc_pair pair = {.first = entry->key, .second = entry->value};
+    t->dinfo->dfree(&pair);
+  }
+}
+
+static void free_entries(struct cdc_rh_table *t)
+{
+  if (!CDC_HAS_DFREE(t->dinfo)) {
+    return;
+  }
+
+  for (size_t i = 0; i < t->capacity; ++i) {
+    if (t->entries[i].hash) {
+      free_entry(t, &t->entries[i]);
+    }
+  }
+}
+
+static bool should_rehash(struct cdc_rh_table *t)
+{
+  return t->size + 1 >= t->capacity ||
+         ((float)(t->size + 1) / (float)t->capacity) > t->load_factor;
+}
+
+static struct cdc_rh_table_entry *find_entry(struct cdc_rh_table *t, void *key,
+                                             size_t hash)
+{
+  size_t mask = t->capacity - 1;
+  size_t pos = hash & mask;
+  for (size_t dist = 0;; ++dist) {
+    struct cdc_rh_table_entry *entry = &t->entries[pos];
+    if (entry->hash == 0 || probe_distance(t, entry->hash, pos) < dist) {
+      return NULL;
+    }
+
+    if (entry->hash == hash && t->dinfo->eq(key, entry->key)) {
+      return entry;
+    }
+
+    pos = (pos + 1) & mask;
+  }
+}
+
+// Places the entry, that must not be in the table. Returns the slot of the
+// entry.
+static struct cdc_rh_table_entry *place_entry(struct cdc_rh_table *t,
+                                              struct cdc_rh_table_entry entry)
+{
+  struct cdc_rh_table_entry *result = NULL;
+  size_t mask = t->capacity - 1;
+  size_t pos = entry.hash & mask;
+  size_t dist = 0;
+  for (;;) {
+    struct cdc_rh_table_entry *curr = &t->entries[pos];
+    if (curr->hash == 0) {
+      *curr = entry;
+      return result ? result : curr;
+    }
+
+    size_t curr_dist = probe_distance(t, curr->hash, pos);
+    if (curr_dist < dist) {
+      CDC_SWAP(struct cdc_rh_table_entry, entry, *curr);
+      if (!result) {
+        result = curr;
+      }
+
+      dist = curr_dist;
+    }
+
+    pos = (pos + 1) & mask;
+    ++dist;
+  }
+}
+
+static void erase_entry(struct cdc_rh_table *t,
+                        struct cdc_rh_table_entry *entry)
+{
+  size_t mask = t->capacity - 1;
+  size_t pos = (size_t)(entry - t->entries);
+  size_t next = (pos + 1) & mask;
+  free_entry(t, entry);
+  while (t->entries[next].hash &&
+         probe_distance(t, t->entries[next].hash, next) != 0) {
+    t->entries[pos] = t->entries[next];
+    pos = next;
+    next = (next + 1) & mask;
+  }
+
+  t->entries[pos].hash = 0;
+  --t->size;
+}
+
+static enum cdc_stat reallocate(struct cdc_rh_table *t, size_t count)
+{
+  if (count < RH_TABLE_MIN_CAPACITY) {
+    count = RH_TABLE_MIN_CAPACITY;
+  }
+
+  count = cdc_up_to_pow2(count);
+  while (count <= t->size || (float)t->size / (float)count > t->load_factor) {
+    count <<= RH_TABLE_COPACITY_SHIFT;
+  }
+
+  if (count == t->capacity) {
+    return CDC_STATUS_OK;
+  }
+
+  struct cdc_rh_table_entry *entries =
+      (struct cdc_rh_table_entry *)cdc_di_calloc(
+          t->dinfo, count * sizeof(struct cdc_rh_table_entry));
+  if (!entries) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  struct cdc_rh_table_entry *old_entries = t->entries;
+  size_t old_capacity = t->capacity;
+  t->entries = entries;
+  t->capacity = count;
+  for (size_t i = 0; i < old_capacity; ++i) {
+    if (old_entries[i].hash) {
+      place_entry(t, old_entries[i]);
+    }
+  }
+
+  cdc_di_free(t->dinfo, old_entries);
+  return CDC_STATUS_OK;
+}
+
+static enum cdc_stat make_and_insert_unique(struct cdc_rh_table *t, void *key,
+                                            void *value, size_t hash,
+                                            struct cdc_rh_table_entry **ret)
+{
+  if (should_rehash(t)) {
+    enum cdc_stat stat =
+        reallocate(t, t->capacity << RH_TABLE_COPACITY_SHIFT);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  struct cdc_rh_table_entry entry = {hash, key, value};
+  *ret = place_entry(t, entry);
+  ++t->size;
+  return CDC_STATUS_OK;
+}
+
+static enum cdc_stat init_varg(struct cdc_rh_table *t, va_list args)
+{
+  struct cdc_pair *pair = NULL;
+  while ((pair = va_arg(args, struct cdc_pair *)) != CDC_END) {
+    enum cdc_stat stat =
+        cdc_rh_table_insert(t, pair->first, pair->second, NULL, NULL);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  return CDC_STATUS_OK;
+}
+
+enum cdc_stat cdc_rh_table_ctor1(struct cdc_rh_table **t,
+                                 struct cdc_data_info *info, float load_factor)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0 && load_factor < 1);
+
+  struct cdc_rh_table *tmp =
+      (struct cdc_rh_table *)calloc(sizeof(struct cdc_rh_table), 1);
+  if (!tmp) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  tmp->load_factor = load_factor;
+  enum cdc_stat stat = CDC_STATUS_OK;
+  if (info && !(tmp->dinfo = cdc_di_shared_ctorc(info))) {
+    stat = CDC_STATUS_BAD_ALLOC;
+    goto free_rh_table;
+  }
+
+  stat = reallocate(tmp, RH_TABLE_MIN_CAPACITY);
+  if (stat != CDC_STATUS_OK) {
+    goto free_di;
+  }
+
+  *t = tmp;
+  return stat;
+free_di:
+  cdc_di_shared_dtor(tmp->dinfo);
+free_rh_table:
+  free(tmp);
+  return stat;
+}
+
+enum cdc_stat cdc_rh_table_ctorl1(struct cdc_rh_table **t,
+                                  struct cdc_data_info *info, float load_factor,
+                                  ...)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0 && load_factor < 1);
+
+  va_list args;
+  va_start(args, load_factor);
+  enum cdc_stat stat = cdc_rh_table_ctorv1(t, info, load_factor, args);
+  va_end(args);
+  return stat;
+}
+
+enum cdc_stat cdc_rh_table_ctorv1(struct cdc_rh_table **t,
+                                  struct cdc_data_info *info, float load_factor,
+                                  va_list args)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0 && load_factor < 1);
+
+  enum cdc_stat stat = cdc_rh_table_ctor1(t, info, load_factor);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  return init_varg(*t, args);
+}
+
+enum cdc_stat cdc_rh_table_ctor(struct cdc_rh_table **t,
+                                struct cdc_data_info *info)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  return cdc_rh_table_ctor1(t, info, RH_TABLE_LOAD_FACTOR);
+}
+
+enum cdc_stat cdc_rh_table_ctorl(struct cdc_rh_table **t,
+                                 struct cdc_data_info *info, ...)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  va_list args;
+  va_start(args, info);
+  enum cdc_stat stat = cdc_rh_table_ctorv(t, info, args);
+  va_end(args);
+  return stat;
+}
+
+enum cdc_stat cdc_rh_table_ctorv(struct cdc_rh_table **t,
+                                 struct cdc_data_info *info, va_list args)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  return cdc_rh_table_ctorv1(t, info, RH_TABLE_LOAD_FACTOR, args);
+}
+
+void cdc_rh_table_dtor(struct cdc_rh_table *t)
+{
+  assert(t != NULL);
+
+  free_entries(t);
+  cdc_di_free(t->dinfo, t->entries);
+  cdc_di_shared_dtor(t->dinfo);
+  free(t);
+}
+
+enum cdc_stat cdc_rh_table_get(struct cdc_rh_table *t, void *key, void **value)
+{
+  assert(t != NULL);
+
+  struct cdc_rh_table_entry *entry = find_entry(t, key, make_hash(t, key));
+  if (!entry) {
+    return CDC_STATUS_NOT_FOUND;
+  }
+
+  *value = entry->value;
+  return CDC_STATUS_OK;
+}
+
+size_t cdc_rh_table_count(struct cdc_rh_table *t, void *key)
+{
+  assert(t != NULL);
+
+  return (size_t)(find_entry(t, key, make_hash(t, key)) != NULL);
+}
+
+void cdc_rh_table_find(struct cdc_rh_table *t, void *key,
+                       struct cdc_rh_table_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_rh_table_entry *entry = find_entry(t, key, make_hash(t, key));
+  it->container = t;
+  it->current = entry ? entry : t->entries + t->capacity;
+}
+
+void cdc_rh_table_clear(struct cdc_rh_table *t)
+{
+  assert(t != NULL);
+
+  free_entries(t);
+  memset(t->entries, 0, t->capacity * sizeof(struct cdc_rh_table_entry));
+  t->size = 0;
+}
+
+enum cdc_stat cdc_rh_table_insert(struct cdc_rh_table *t, void *key,
+                                  void *value, struct cdc_rh_table_iter *it,
+                                  bool *inserted)
+{
+  assert(t != NULL);
+
+  size_t hash = make_hash(t, key);
+  struct cdc_rh_table_entry *entry = find_entry(t, key, hash);
+  bool finded = entry;
+  if (!finded) {
+    enum cdc_stat stat = make_and_insert_unique(t, key, value, hash, &entry);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  if (it) {
+    it->container = t;
+    it->current = entry;
+  }
+
+  if (inserted) {
+    *inserted = !finded;
+  }
+
+  return CDC_STATUS_OK;
+}
+
+enum cdc_stat cdc_rh_table_insert_or_assign(struct cdc_rh_table *t, void *key,
+                                            void *value,
+                                            struct cdc_rh_table_iter *it,
+                                            bool *inserted)
+{
+  assert(t != NULL);
+
+  size_t hash = make_hash(t, key);
+  struct cdc_rh_table_entry *entry = find_entry(t, key, hash);
+  bool finded = entry;
+  if (!finded) {
+    enum cdc_stat stat = make_and_insert_unique(t, key, value, hash, &entry);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  } else {
+    entry->value = value;
+  }
+
+  if (it) {
+    it->container = t;
+    it->current = entry;
+  }
+
+  if (inserted) {
+    *inserted = !finded;
+  }
+
+  return CDC_STATUS_OK;
+}
+
+size_t cdc_rh_table_erase(struct cdc_rh_table *t, void *key)
+{
+  assert(t != NULL);
+
+  struct cdc_rh_table_entry *entry = find_entry(t, key, make_hash(t, key));
+  if (!entry) {
+    return 0;
+  }
+
+  erase_entry(t, entry);
+  return 1;
+}
+
+void cdc_rh_table_swap(struct cdc_rh_table *a, struct cdc_rh_table *b)
+{
+  assert(a != NULL);
+  assert(b != NULL);
+
+  CDC_SWAP(struct cdc_rh_table_entry *, a->entries, b->entries);
+  CDC_SWAP(size_t, a->capacity, b->capacity);
+  CDC_SWAP(float, a->load_factor, b->load_factor);
+  CDC_SWAP(size_t, a->size, b->size);
+  CDC_SWAP(struct cdc_data_info *, a->dinfo, b->dinfo);
+}
+
+enum cdc_stat cdc_rh_table_rehash(struct cdc_rh_table *t, size_t count)
+{
+  assert(t != NULL);
+
+  if (count <= t->capacity) {
+    return CDC_STATUS_OK;
+  }
+
+  return reallocate(t, count);
+}
+
+enum cdc_stat cdc_rh_table_reserve(struct cdc_rh_table *t, size_t count)
+{
+  assert(t != NULL);
+
+  return cdc_rh_table_rehash(t, (size_t)((float)count / t->load_factor) + 1);
+}
@@ -37,11 +37,15 @@ CDC_MAKE_MIN_NODE_FN(struct cdc_splay_tree_node *)
 CDC_MAKE_MAX_NODE_FN(struct cdc_splay_tree_node *)
 CDC_MAKE_SUCCESSOR_FN(struct cdc_splay_tree_node *)
 CDC_MAKE_PREDECESSOR_FN(struct cdc_splay_tree_node *)
+CDC_MAKE_LOWER_BOUND_FN(struct cdc_splay_tree_node *)
+CDC_MAKE_UPPER_BOUND_FN(struct cdc_splay_tree_node *)
 
-static struct cdc_splay_tree_node *make_new_node(void *key, void *val)
+static struct cdc_splay_tree_node *make_new_node(struct cdc_splay_tree *t,
+                                                 void *key, void *val)
 {
   struct cdc_splay_tree_node *node =
-      (struct cdc_splay_tree_node *)malloc(sizeof(struct cdc_splay_tree_node));
+      (struct cdc_splay_tree_node *)cdc_di_node_alloc(
+          t->dinfo, &t->pool, sizeof(struct cdc_splay_tree_node));
   if (node) {
     node->key = key;
     node->value = val;
@@ -61,7 +65,7 @@ static void free_node(struct cdc_splay_tree *t,
     t->dinfo->dfree(&pair);
   }
 
-  free(node);
+  cdc_di_node_free(t->dinfo, &t->pool, node);
 }
 
 static void free_splay_tree(struct cdc_splay_tree *t,
@@ -78,6 +82,15 @@ static void free_splay_tree(struct cdc_splay_tree *t,
   free_node(t, root);
 }
 
+static void free_nodes(struct cdc_splay_tree *t)
+{
+  if (!cdc_node_pool_enabled(&t->pool) || CDC_HAS_DFREE(t->dinfo)) {
+    free_splay_tree(t, t->root);
+  }
+
+  cdc_node_pool_release(&t->pool, t->dinfo);
+}
+
 static void update_link(struct cdc_splay_tree_node *parent,
                         struct cdc_splay_tree_node *old,
                         struct cdc_splay_tree_node *node)
@@ -184,22 +197,15 @@ static struct cdc_splay_tree_node *splay(struct cdc_splay_tree_node *node)
 
 static struct cdc_splay_tree_node *find_hint(struct cdc_splay_tree_node *node,
                                              void *key,
-                                             cdc_binary_pred_fn_t compar)
+                                             struct cdc_data_info *dinfo)
 {
   struct cdc_splay_tree_node *tmp = node;
   while (node) {
-    if (compar(key, node->key)) {
-      if (node->left) {
-        node = node->left;
-      } else {
-        break;
-      }
-    } else if (compar(node->key, key)) {
-      if (node->right) {
-        node = node->right;
-      } else {
-        break;
-      }
+    int cmp = cdc_di_cmp3(dinfo, key, node->key);
+    if (cmp < 0 && node->left) {
+      node = node->left;
+    } else if (cmp > 0 && node->right) {
+      node = node->right;
     } else {
       break;
     }
@@ -209,11 +215,11 @@ static struct cdc_splay_tree_node *find_hint(struct cdc_splay_tree_node *node,
 }
 
 static struct node_pair split(struct cdc_splay_tree_node *node, void *key,
-                              cdc_binary_pred_fn_t compar)
+                              struct cdc_data_info *dinfo)
 {
   struct node_pair ret;
   node = splay(node);
-  if (compar(key, node->key)) {
+  if (cdc_di_less(dinfo, key, node->key)) {
     ret.left = node->left;
     ret.right = node;
     node->left = NULL;
@@ -250,17 +256,24 @@ static struct cdc_splay_tree_node *merge(struct cdc_splay_tree_node *a,
   return a;
 }
 
-static struct cdc_splay_tree_node *sfind(struct cdc_splay_tree *t, void *key)
+// Splays the node found by a lookup if it is the turn of the splay period.
+static void splay_found(struct cdc_splay_tree *t,
+                        struct cdc_splay_tree_node *node)
 {
-  struct cdc_splay_tree_node *node =
-      cdc_find_tree_node(t->root, key, t->dinfo->cmp);
+  if (!node || t->splay_period == 0) {
+    return;
+  }
 
-  if (!node) {
-    return node;
+  if (++t->lookups >= t->splay_period) {
+    t->lookups = 0;
+    t->root = splay(node);
   }
+}
 
-  node = splay(node);
-  t->root = node;
+static struct cdc_splay_tree_node *sfind(struct cdc_splay_tree *t, void *key)
+{
+  struct cdc_splay_tree_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
+  splay_found(t, node);
   return node;
 }
 
@@ -272,7 +285,7 @@ static struct cdc_splay_tree_node *insert_unique(
   if (t->root == NULL) {
     t->root = node;
   } else {
-    pair = split(nearest, node->key, t->dinfo->cmp);
+    pair = split(nearest, node->key, t->dinfo);
     node->left = pair.left;
     if (node->left) {
       node->left->parent = node;
@@ -307,7 +320,7 @@ enum cdc_stat cdc_splay_tree_ctor(struct cdc_splay_tree **t,
                                   struct cdc_data_info *info)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   struct cdc_splay_tree *tmp =
       (struct cdc_splay_tree *)calloc(sizeof(struct cdc_splay_tree), 1);
@@ -320,6 +333,12 @@ enum cdc_stat cdc_splay_tree_ctor(struct cdc_splay_tree **t,
     return CDC_STATUS_BAD_ALLOC;
   }
 
+  if (info->pool_chunk) {
+    cdc_node_pool_init(&tmp->pool, sizeof(struct cdc_splay_tree_node),
+                       info->pool_chunk);
+  }
+
+  tmp->splay_period = 1;
   *t = tmp;
   return CDC_STATUS_OK;
 }
@@ -328,7 +347,7 @@ enum cdc_stat cdc_splay_tree_ctorl(struct cdc_splay_tree **t,
                                    struct cdc_data_info *info, ...)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   va_list args;
   va_start(args, info);
@@ -341,7 +360,7 @@ enum cdc_stat cdc_splay_tree_ctorv(struct cdc_splay_tree **t,
                                    struct cdc_data_info *info, va_list args)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   enum cdc_stat stat = cdc_splay_tree_ctor(t, info);
   if (stat != CDC_STATUS_OK) {
@@ -355,7 +374,7 @@ void cdc_splay_tree_dtor(struct cdc_splay_tree *t)
 {
   assert(t != NULL);
 
-  free_splay_tree(t, t->root);
+  free_nodes(t);
   cdc_di_shared_dtor(t->dinfo);
   free(t);
 }
@@ -380,13 +399,9 @@ size_t cdc_splay_tree_count(struct cdc_splay_tree *t, void *key)
   return (size_t)(sfind(t, key) != NULL);
 }
 
-void cdc_splay_tree_find(struct cdc_splay_tree *t, void *key,
-                         struct cdc_splay_tree_iter *it)
+static void set_iter(struct cdc_splay_tree *t, struct cdc_splay_tree_node *node,
+                     struct cdc_splay_tree_iter *it)
 {
-  assert(t != NULL);
-  assert(it != NULL);
-
-  struct cdc_splay_tree_node *node = sfind(t, key);
   if (!node) {
     cdc_splay_tree_end(t, it);
     return;
@@ -397,6 +412,80 @@ void cdc_splay_tree_find(struct cdc_splay_tree *t, void *key,
   it->prev = cdc_tree_predecessor(node);
 }
 
+void cdc_splay_tree_find(struct cdc_splay_tree *t, void *key,
+                         struct cdc_splay_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_splay_tree_node *node = sfind(t, key);
+  set_iter(t, node, it);
+}
+
+enum cdc_stat cdc_splay_tree_peek(struct cdc_splay_tree *t, void *key,
+                                  void **value)
+{
+  assert(t != NULL);
+
+  struct cdc_splay_tree_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
+  if (node) {
+    *value = node->value;
+  }
+
+  return node ? CDC_STATUS_OK : CDC_STATUS_NOT_FOUND;
+}
+
+void cdc_splay_tree_peek_find(struct cdc_splay_tree *t, void *key,
+                              struct cdc_splay_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_splay_tree_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
+  set_iter(t, node, it);
+}
+
+void cdc_splay_tree_lower_bound(struct cdc_splay_tree *t, void *key,
+                                struct cdc_splay_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_splay_tree_node *node =
+      cdc_tree_lower_bound(t->root, key, t->dinfo);
+  splay_found(t, node);
+  set_iter(t, node, it);
+}
+
+void cdc_splay_tree_upper_bound(struct cdc_splay_tree *t, void *key,
+                                struct cdc_splay_tree_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_splay_tree_node *node =
+      cdc_tree_upper_bound(t->root, key, t->dinfo);
+  splay_found(t, node);
+  set_iter(t, node, it);
+}
+
+void cdc_splay_tree_equal_range(struct cdc_splay_tree *t, void *key,
+                                struct cdc_pair_splay_tree_iter *ret)
+{
+  assert(t != NULL);
+  assert(ret != NULL);
+
+  struct cdc_splay_tree_node *node =
+      cdc_tree_lower_bound(t->root, key, t->dinfo);
+  splay_found(t, node);
+  set_iter(t, node, &ret->first);
+  if (node && !cdc_di_less(t->dinfo, key, node->key)) {
+    node = cdc_tree_successor(node);
+  }
+
+  set_iter(t, node, &ret->second);
+}
+
 enum cdc_stat cdc_splay_tree_insert(struct cdc_splay_tree *t, void *key,
                                     void *value,
                                     struct cdc_pair_splay_tree_iter_bool *ret)
@@ -420,10 +509,10 @@ enum cdc_stat cdc_splay_tree_insert1(struct cdc_splay_tree *t, void *key,
 {
   assert(t != NULL);
 
-  struct cdc_splay_tree_node *node = find_hint(t->root, key, t->dinfo->cmp);
-  bool finded = node && cdc_eq(t->dinfo->cmp, node->key, key);
+  struct cdc_splay_tree_node *node = find_hint(t->root, key, t->dinfo);
+  bool finded = node && cdc_di_cmp3(t->dinfo, node->key, key) == 0;
   if (!finded) {
-    struct cdc_splay_tree_node *new_node = make_new_node(key, value);
+    struct cdc_splay_tree_node *new_node = make_new_node(t, key, value);
     if (!new_node) {
       return CDC_STATUS_BAD_ALLOC;
     }
@@ -467,10 +556,10 @@ enum cdc_stat cdc_splay_tree_insert_or_assign1(struct cdc_splay_tree *t,
 {
   assert(t != NULL);
 
-  struct cdc_splay_tree_node *node = find_hint(t->root, key, t->dinfo->cmp);
-  bool finded = node && cdc_eq(t->dinfo->cmp, node->key, key);
+  struct cdc_splay_tree_node *node = find_hint(t->root, key, t->dinfo);
+  bool finded = node && cdc_di_cmp3(t->dinfo, node->key, key) == 0;
   if (!finded) {
-    struct cdc_splay_tree_node *new_node = make_new_node(key, value);
+    struct cdc_splay_tree_node *new_node = make_new_node(t, key, value);
     if (!new_node) {
       return CDC_STATUS_BAD_ALLOC;
     }
@@ -497,8 +586,7 @@ size_t cdc_splay_tree_erase(struct cdc_splay_tree *t, void *key)
 {
   assert(t != NULL);
 
-  struct cdc_splay_tree_node *node =
-      cdc_find_tree_node(t->root, key, t->dinfo->cmp);
+  struct cdc_splay_tree_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
   if (!node) {
     return 0;
   }
@@ -522,7 +610,7 @@ void cdc_splay_tree_clear(struct cdc_splay_tree *t)
 {
   assert(t != NULL);
 
-  free_splay_tree(t, t->root);
+  free_nodes(t);
   t->size = 0;
   t->root = NULL;
 }
@@ -535,6 +623,9 @@ void cdc_splay_tree_swap(struct cdc_splay_tree *a, struct cdc_splay_tree *b)
   CDC_SWAP(struct cdc_splay_tree_node *, a->root, b->root);
   CDC_SWAP(size_t, a->size, b->size);
   CDC_SWAP(struct cdc_data_info *, a->dinfo, b->dinfo);
+  CDC_SWAP(struct cdc_node_pool, a->pool, b->pool);
+  CDC_SWAP(size_t, a->splay_period, b->splay_period);
+  CDC_SWAP(size_t, a->lookups, b->lookups);
 }
 
 void cdc_splay_tree_begin(struct cdc_splay_tree *t,
@@ -30,6 +30,9 @@ void cdc_print_stat(enum cdc_stat s)
                                        "CDC_STATUS_OVERFLOW",
                                        "CDC_STATUS_ALREADY_EXISTS",
                                        "CDC_STATUS_NOT_FOUND",
+                                       "CDC_STATUS_IO_ERROR",
+                                       "CDC_STATUS_BAD_FORMAT",
+                                       "CDC_STATUS_NOT_SUPPORTED",
                                        "CDC_STATUS_UNKN"};
   if (s < CDC_STATUS_OK || s > CDC_STATUS_UNKN) {
     s = CDC_STATUS_UNKN;
@@ -0,0 +1,544 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "cdcontainers/swiss-table.h"
+
+#include "cdcontainers/data-info.h"
+
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define SWISS_TABLE_GROUP_SIZE 16
+#define SWISS_TABLE_MIN_CAPACITY SWISS_TABLE_GROUP_SIZE  // must be pow 2
+#define SWISS_TABLE_COPACITY_SHIFT 1
+#define SWISS_TABLE_LOAD_FACTOR 0.875f
+
+// Control bytes. A full slot keeps 7 bits of the hash, so it is non-negative.
+#define SWISS_TABLE_EMPTY ((int8_t)-128)
+#define SWISS_TABLE_DELETED ((int8_t)-2)
+
+#define SWISS_TABLE_H2_SHIFT (sizeof(size_t) * 8 - 7)
+
+#ifdef __SSE2__
+static unsigned match_byte(const int8_t *group, int8_t byte)
+{
+  __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+  return (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(byte), ctrl));
+}
+
+static unsigned match_empty_or_deleted(const int8_t *group)
+{
+  __m128i ctrl = _mm_loadu_si128((const __m128i *)group);
+  return (unsigned)_mm_movemask_epi8(ctrl);
+}
+#else
+static unsigned match_byte(const int8_t *group, int8_t byte)
+{
+  unsigned mask = 0;
+  for (unsigned i = 0; i < SWISS_TABLE_GROUP_SIZE; ++i) {
+    mask |= (unsigned)(group[i] == byte) << i;
+  }
+
+  return mask;
+}
+
+static unsigned match_empty_or_deleted(const int8_t *group)
+{
+  unsigned mask = 0;
+  for (unsigned i = 0; i < SWISS_TABLE_GROUP_SIZE; ++i) {
+    mask |= (unsigned)(group[i] < 0) << i;
+  }
+
+  return mask;
+}
+#endif
+
+static unsigned lowest_bit(unsigned mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return (unsigned)__builtin_ctz(mask);
+#else
+  unsigned i = 0;
+  while (!(mask & 1)) {
+    mask >>= 1;
+    ++i;
+  }
+
+  return i;
+#endif
+}
+
+static size_t mix_hash(struct cdc_swiss_table *t, void *key)
+{
+  // Multiplication spreads the low bits of weak hashes over the high bits,
+  // which are used for the control bytes.
+  size_t hash = key ? t->dinfo->hash(key) : 0;
+  return hash * (size_t)UINT64_C(0x9E3779B97F4A7C15);
+}
+
+static int8_t get_h2(size_t hash)
+{
+  return (int8_t)(hash >> SWISS_TABLE_H2_SHIFT);
+}
+
+static size_t first_group(struct cdc_swiss_table *t, size_t hash)
+{
+  return (hash & (t->capacity - 1)) & ~(size_t)(SWISS_TABLE_GROUP_SIZE - 1);
+}
+
+// Groups are visited with triangular steps, which covers all groups of a
+// power of two table.
+static size_t next_group(struct cdc_swiss_table *t, size_t group, size_t step)
+{
+  return (group + step * SWISS_TABLE_GROUP_SIZE) & (t->capacity - 1);
+}
+
+static size_t max_growth(struct cdc_swiss_table *t, size_t capacity)
+{
+  size_t growth = (size_t)((float)capacity * t->load_factor);
+  return CDC_MIN(growth, capacity - 1);
+}
+
+static void free_slot(struct cdc_swiss_table *t,
+                      struct cdc_swiss_table_slot *slot)
+{
+  if (CDC_HAS_DFREE(t->dinfo)) {
+    struct cdc_pair pair = {.first = slot->key, .second = slot->value};
+    t->dinfo->dfree(&pair);
+  }
+}
+
+static void free_slots(struct cdc_swiss_table *t)
+{
+  if (!CDC_HAS_DFREE(t->dinfo)) {
+    return;
+  }
+
+  for (size_t i = 0; i < t->capacity; ++i) {
+    if (t->ctrl[i] >= 0) {
+      free_slot(t, &t->slots[i]);
+    }
+  }
+}
+
+static size_t find_slot(struct cdc_swiss_table *t, void *key, size_t hash)
+{
+  int8_t h2 = get_h2(hash);
+  size_t group = first_group(t, hash);
+  for (size_t step = 1;; ++step) {
+    const int8_t *ctrl = t->ctrl + group;
+    unsigned mask = match_byte(ctrl, h2);
+    while (mask) {
+      size_t i = group + lowest_bit(mask);
+      if (t->dinfo->eq(key, t->slots[i].key)) {
+        return i;
+      }
+
+      mask &= mask - 1;
+    }
+
+    if (match_byte(ctrl, SWISS_TABLE_EMPTY)) {
+      return t->capacity;
+    }
+
+    group = next_group(t, group, step);
+  }
+}
+
+static size_t find_free_slot(struct cdc_swiss_table *t, size_t hash)
+{
+  size_t group = first_group(t, hash);
+  for (size_t step = 1;; ++step) {
+    unsigned mask = match_empty_or_deleted(t->ctrl + group);
+    if (mask) {
+      return group + lowest_bit(mask);
+    }
+
+    group = next_group(t, group, step);
+  }
+}
+
+static enum cdc_stat reallocate(struct cdc_swiss_table *t, size_t count)
+{
+  if (count < SWISS_TABLE_MIN_CAPACITY) {
+    count = SWISS_TABLE_MIN_CAPACITY;
+  }
+
+  count = cdc_up_to_pow2(count);
+  while (max_growth(t, count) < t->size) {
+    count <<= SWISS_TABLE_COPACITY_SHIFT;
+  }
+
+  struct cdc_swiss_table_slot *slots =
+      (struct cdc_swiss_table_slot *)cdc_di_alloc(
+          t->dinfo, count * (sizeof(struct cdc_swiss_table_slot) + 1));
+  if (!slots) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  int8_t *old_ctrl = t->ctrl;
+  struct cdc_swiss_table_slot *old_slots = t->slots;
+  size_t old_capacity = t->capacity;
+  t->slots = slots;
+  t->ctrl = (int8_t *)(slots + count);
+  t->capacity = count;
+  memset(t->ctrl, SWISS_TABLE_EMPTY, count);
+  for (size_t i = 0; i < old_capacity; ++i) {
+    if (old_ctrl[i] >= 0) {
+      size_t hash = mix_hash(t, old_slots[i].key);
+      size_t pos = find_free_slot(t, hash);
+      t->ctrl[pos] = get_h2(hash);
+      t->slots[pos] = old_slots[i];
+    }
+  }
+
+  t->growth_left = max_growth(t, count) - t->size;
+  cdc_di_free(t->dinfo, old_slots);
+  return CDC_STATUS_OK;
+}
+
+static enum cdc_stat make_and_insert_unique(struct cdc_swiss_table *t,
+                                            void *key, void *value, size_t hash,
+                                            size_t *ret)
+{
+  size_t pos = find_free_slot(t, hash);
+  if (t->growth_left == 0 && t->ctrl[pos] == SWISS_TABLE_EMPTY) {
+    // Rebuilding at the same capacity is enough to drop the deleted slots if
+    // they take a lot of space.
+    size_t count = t->capacity;
+    if (t->size > max_growth(t, t->capacity) / 2) {
+      count <<= SWISS_TABLE_COPACITY_SHIFT;
+    }
+
+    enum cdc_stat stat = reallocate(t, count);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+
+    pos = find_free_slot(t, hash);
+  }
+
+  if (t->ctrl[pos] == SWISS_TABLE_EMPTY) {
+    --t->growth_left;
+  }
+
+  t->ctrl[pos] = get_h2(hash);
+  t->slots[pos].key = key;
+  t->slots[pos].value = value;
+  ++t->size;
+  *ret = pos;
+  return CDC_STATUS_OK;
+}
+
+static void erase_slot(struct cdc_swiss_table *t, size_t pos)
+{
+  free_slot(t, &t->slots[pos]);
+  // If the group has an empty slot, no probe sequence went past this group, so
+  // the slot can become empty instead of deleted.
+  size_t group = pos & ~(size_t)(SWISS_TABLE_GROUP_SIZE - 1);
+  if (match_byte(t->ctrl + group, SWISS_TABLE_EMPTY)) {
+    t->ctrl[pos] = SWISS_TABLE_EMPTY;
+    ++t->growth_left;
+  } else {
+    t->ctrl[pos] = SWISS_TABLE_DELETED;
+  }
+
+  --t->size;
+}
+
+static enum cdc_stat init_varg(struct cdc_swiss_table *t, va_list args)
+{
+  struct cdc_pair *pair = NULL;
+  while ((pair = va_arg(args, struct cdc_pair *)) != CDC_END) {
+    enum cdc_stat stat =
+        cdc_swiss_table_insert(t, pair->first, pair->second, NULL, NULL);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  return CDC_STATUS_OK;
+}
+
+enum cdc_stat cdc_swiss_table_ctor1(struct cdc_swiss_table **t,
+                                    struct cdc_data_info *info,
+                                    float load_factor)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0 && load_factor < 1);
+
+  struct cdc_swiss_table *tmp =
+      (struct cdc_swiss_table *)calloc(sizeof(struct cdc_swiss_table), 1);
+  if (!tmp) {
+    return CDC_STATUS_BAD_ALLOC;
+  }
+
+  tmp->load_factor = load_factor;
+  enum cdc_stat stat = CDC_STATUS_OK;
+  if (info && !(tmp->dinfo = cdc_di_shared_ctorc(info))) {
+    stat = CDC_STATUS_BAD_ALLOC;
+    goto free_swiss_table;
+  }
+
+  stat = reallocate(tmp, SWISS_TABLE_MIN_CAPACITY);
+  if (stat != CDC_STATUS_OK) {
+    goto free_di;
+  }
+
+  *t = tmp;
+  return stat;
+free_di:
+  cdc_di_shared_dtor(tmp->dinfo);
+free_swiss_table:
+  free(tmp);
+  return stat;
+}
+
+enum cdc_stat cdc_swiss_table_ctorl1(struct cdc_swiss_table **t,
+                                     struct cdc_data_info *info,
+                                     float load_factor, ...)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0 && load_factor < 1);
+
+  va_list args;
+  va_start(args, load_factor);
+  enum cdc_stat stat = cdc_swiss_table_ctorv1(t, info, load_factor, args);
+  va_end(args);
+  return stat;
+}
+
+enum cdc_stat cdc_swiss_table_ctorv1(struct cdc_swiss_table **t,
+                                     struct cdc_data_info *info,
+                                     float load_factor, va_list args)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+  assert(load_factor > 0 && load_factor < 1);
+
+  enum cdc_stat stat = cdc_swiss_table_ctor1(t, info, load_factor);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  return init_varg(*t, args);
+}
+
+enum cdc_stat cdc_swiss_table_ctor(struct cdc_swiss_table **t,
+                                   struct cdc_data_info *info)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  return cdc_swiss_table_ctor1(t, info, SWISS_TABLE_LOAD_FACTOR);
+}
+
+enum cdc_stat cdc_swiss_table_ctorl(struct cdc_swiss_table **t,
+                                    struct cdc_data_info *info, ...)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  va_list args;
+  va_start(args, info);
+  enum cdc_stat stat = cdc_swiss_table_ctorv(t, info, args);
+  va_end(args);
+  return stat;
+}
+
+enum cdc_stat cdc_swiss_table_ctorv(struct cdc_swiss_table **t,
+                                    struct cdc_data_info *info, va_list args)
+{
+  assert(t != NULL);
+  assert(CDC_HAS_HASH(info));
+  assert(CDC_HAS_EQ(info));
+
+  return cdc_swiss_table_ctorv1(t, info, SWISS_TABLE_LOAD_FACTOR, args);
+}
+
+void cdc_swiss_table_dtor(struct cdc_swiss_table *t)
+{
+  assert(t != NULL);
+
+  free_slots(t);
+  cdc_di_free(t->dinfo, t->slots);
+  cdc_di_shared_dtor(t->dinfo);
+  free(t);
+}
+
+enum cdc_stat cdc_swiss_table_get(struct cdc_swiss_table *t, void *key,
+                                  void **value)
+{
+  assert(t != NULL);
+
+  size_t pos = find_slot(t, key, mix_hash(t, key));
+  if (pos == t->capacity) {
+    return CDC_STATUS_NOT_FOUND;
+  }
+
+  *value = t->slots[pos].value;
+  return CDC_STATUS_OK;
+}
+
+size_t cdc_swiss_table_count(struct cdc_swiss_table *t, void *key)
+{
+  assert(t != NULL);
+
+  return (size_t)(find_slot(t, key, mix_hash(t, key)) != t->capacity);
+}
+
+void cdc_swiss_table_find(struct cdc_swiss_table *t, void *key,
+                          struct cdc_swiss_table_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  it->container = t;
+  it->current = find_slot(t, key, mix_hash(t, key));
+}
+
+void cdc_swiss_table_clear(struct cdc_swiss_table *t)
+{
+  assert(t != NULL);
+
+  free_slots(t);
+  memset(t->ctrl, SWISS_TABLE_EMPTY, t->capacity);
+  t->size = 0;
+  t->growth_left = max_growth(t, t->capacity);
+}
+
+enum cdc_stat cdc_swiss_table_insert(struct cdc_swiss_table *t, void *key,
+                                     void *value,
+                                     struct cdc_swiss_table_iter *it,
+                                     bool *inserted)
+{
+  assert(t != NULL);
+
+  size_t hash = mix_hash(t, key);
+  size_t pos = find_slot(t, key, hash);
+  bool finded = pos != t->capacity;
+  if (!finded) {
+    enum cdc_stat stat = make_and_insert_unique(t, key, value, hash, &pos);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  }
+
+  if (it) {
+    it->container = t;
+    it->current = pos;
+  }
+
+  if (inserted) {
+    *inserted = !finded;
+  }
+
+  return CDC_STATUS_OK;
+}
+
+enum cdc_stat cdc_swiss_table_insert_or_assign(struct cdc_swiss_table *t,
+                                               void *key, void *value,
+                                               struct cdc_swiss_table_iter *it,
+                                               bool *inserted)
+{
+  assert(t != NULL);
+
+  size_t hash = mix_hash(t, key);
+  size_t pos = find_slot(t, key, hash);
+  bool finded = pos != t->capacity;
+  if (!finded) {
+    enum cdc_stat stat = make_and_insert_unique(t, key, value, hash, &pos);
+    if (stat != CDC_STATUS_OK) {
+      return stat;
+    }
+  } else {
+    t->slots[pos].value = value;
+  }
+
+  if (it) {
+    it->container = t;
+    it->current = pos;
+  }
+
+  if (inserted) {
+    *inserted = !finded;
+  }
+
+  return CDC_STATUS_OK;
+}
+
+size_t cdc_swiss_table_erase(struct cdc_swiss_table *t, void *key)
+{
+  assert(t != NULL);
+
+  size_t pos = find_slot(t, key, mix_hash(t, key));
+  if (pos == t->capacity) {
+    return 0;
+  }
+
+  erase_slot(t, pos);
+  return 1;
+}
+
+void cdc_swiss_table_swap(struct cdc_swiss_table *a, struct cdc_swiss_table *b)
+{
+  assert(a != NULL);
+  assert(b != NULL);
+
+  CDC_SWAP(int8_t *, a->ctrl, b->ctrl);
+  CDC_SWAP(struct cdc_swiss_table_slot *, a->slots, b->slots);
+  CDC_SWAP(size_t, a->capacity, b->capacity);
+  CDC_SWAP(size_t, a->growth_left, b->growth_left);
+  CDC_SWAP(float, a->load_factor, b->load_factor);
+  CDC_SWAP(size_t, a->size, b->size);
+  CDC_SWAP(struct cdc_data_info *, a->dinfo, b->dinfo);
+}
+
+enum cdc_stat cdc_swiss_table_rehash(struct cdc_swiss_table *t, size_t count)
+{
+  assert(t != NULL);
+
+  if (count <= t->capacity) {
+    return CDC_STATUS_OK;
+  }
+
+  return reallocate(t, count);
+}
+
+enum cdc_stat cdc_swiss_table_reserve(struct cdc_swiss_table *t, size_t count)
+{
+  assert(t != NULL);
+
+  return cdc_swiss_table_rehash(t,
+                                (size_t)((float)count / t->load_factor) + 1);
+}
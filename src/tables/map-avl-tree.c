@@ -19,6 +19,7 @@
 // FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
 // IN THE SOFTWARE.
 #include "cdcontainers/avl-tree.h"
+#include "cdcontainers/data-info.h"
 #include "cdcontainers/tables/imap.h"
 
 #include <assert.h>
@@ -74,6 +75,48 @@ static void find(void *cntr, void *key, void *it)
   cdc_avl_tree_find(tree, key, iter);
 }
 
+static void lower_bound(void *cntr, void *key, void *it)
+{
+  assert(cntr != NULL);
+
+  struct cdc_avl_tree *tree = (struct cdc_avl_tree *)cntr;
+  struct cdc_avl_tree_iter *iter = (struct cdc_avl_tree_iter *)it;
+  cdc_avl_tree_lower_bound(tree, key, iter);
+}
+
+static void upper_bound(void *cntr, void *key, void *it)
+{
+  assert(cntr != NULL);
+
+  struct cdc_avl_tree *tree = (struct cdc_avl_tree *)cntr;
+  struct cdc_avl_tree_iter *iter = (struct cdc_avl_tree_iter *)it;
+  cdc_avl_tree_upper_bound(tree, key, iter);
+}
+
+static void range(void *cntr, void *lo, void *hi,
+                  bool (*cb)(void *key, void *value, void *ctx), void *ctx)
+{
+  assert(cntr != NULL);
+
+  struct cdc_avl_tree *tree = (struct cdc_avl_tree *)cntr;
+  if (!cdc_di_less(tree->dinfo, lo, hi)) {
+    return;
+  }
+
+  struct cdc_avl_tree_iter it;
+  struct cdc_avl_tree_iter last;
+  cdc_avl_tree_lower_bound(tree, lo, &it);
+  cdc_avl_tree_lower_bound(tree, hi, &last);
+  while (!cdc_avl_tree_iter_is_eq(&it, &last)) {
+    void *key = cdc_avl_tree_iter_key(&it);
+    if (!cb(key, cdc_avl_tree_iter_value(&it), ctx)) {
+      break;
+    }
+
+    cdc_avl_tree_iter_next(&it);
+  }
+}
+
 static size_t size(void *cntr)
 {
   assert(cntr != NULL);
@@ -246,6 +289,9 @@ static const struct cdc_map_table _table = {
     .get = get,
     .count = count,
     .find = find,
+    .lower_bound = lower_bound,
+    .upper_bound = upper_bound,
+    .range = range,
     .size = size,
     .empty = empty,
     .clear = clear,
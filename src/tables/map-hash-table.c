@@ -75,6 +75,36 @@ static void find(void *cntr, void *key, void *it)
   cdc_hash_table_find(tree, key, iter);
 }
 
+static void lower_bound(void *cntr, void *key, void *it)
+{
+  CDC_UNUSED(cntr);
+  CDC_UNUSED(key);
+  CDC_UNUSED(it);
+
+  CDC_CHECK(false, "Hash tables do not support lower_bound().");
+}
+
+static void upper_bound(void *cntr, void *key, void *it)
+{
+  CDC_UNUSED(cntr);
+  CDC_UNUSED(key);
+  CDC_UNUSED(it);
+
+  CDC_CHECK(false, "Hash tables do not support upper_bound().");
+}
+
+static void range(void *cntr, void *lo, void *hi,
+                  bool (*cb)(void *key, void *value, void *ctx), void *ctx)
+{
+  CDC_UNUSED(cntr);
+  CDC_UNUSED(lo);
+  CDC_UNUSED(hi);
+  CDC_UNUSED(cb);
+  CDC_UNUSED(ctx);
+
+  CDC_CHECK(false, "Hash tables do not support range().");
+}
+
 static size_t size(void *cntr)
 {
   assert(cntr != NULL);
@@ -245,6 +275,9 @@ static const struct cdc_map_table _table = {
     .get = get,
     .count = count,
     .find = find,
+    .lower_bound = lower_bound,
+    .upper_bound = upper_bound,
+    .range = range,
     .size = size,
     .empty = empty,
     .clear = clear,
@@ -20,6 +20,7 @@
 // IN THE SOFTWARE.
 #include "cdcontainers/tables/imap.h"
 #include "cdcontainers/treap.h"
+#include "cdcontainers/data-info.h"
 
 #include <assert.h>
 #include <stdlib.h>
@@ -74,6 +75,48 @@ static void find(void *cntr, void *key, void *it)
   cdc_treap_find(tree, key, iter);
 }
 
+static void lower_bound(void *cntr, void *key, void *it)
+{
+  assert(cntr != NULL);
+
+  struct cdc_treap *tree = (struct cdc_treap *)cntr;
+  struct cdc_treap_iter *iter = (struct cdc_treap_iter *)it;
+  cdc_treap_lower_bound(tree, key, iter);
+}
+
+static void upper_bound(void *cntr, void *key, void *it)
+{
+  assert(cntr != NULL);
+
+  struct cdc_treap *tree = (struct cdc_treap *)cntr;
+  struct cdc_treap_iter *iter = (struct cdc_treap_iter *)it;
+  cdc_treap_upper_bound(tree, key, iter);
+}
+
+static void range(void *cntr, void *lo, void *hi,
+                  bool (*cb)(void *key, void *value, void *ctx), void *ctx)
+{
+  assert(cntr != NULL);
+
+  struct cdc_treap *tree = (struct cdc_treap *)cntr;
+  if (!cdc_di_less(tree->dinfo, lo, hi)) {
+    return;
+  }
+
+  struct cdc_treap_iter it;
+  struct cdc_treap_iter last;
+  cdc_treap_lower_bound(tree, lo, &it);
+  cdc_treap_lower_bound(tree, hi, &last);
+  while (!cdc_treap_iter_is_eq(&it, &last)) {
+    void *key = cdc_treap_iter_key(&it);
+    if (!cb(key, cdc_treap_iter_value(&it), ctx)) {
+      break;
+    }
+
+    cdc_treap_iter_next(&it);
+  }
+}
+
 static size_t size(void *cntr)
 {
   assert(cntr != NULL);
@@ -246,6 +289,9 @@ static const struct cdc_map_table _table = {
     .get = get,
     .count = count,
     .find = find,
+    .lower_bound = lower_bound,
+    .upper_bound = upper_bound,
+    .range = range,
     .size = size,
     .empty = empty,
     .clear = clear,
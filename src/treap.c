@@ -24,35 +24,84 @@
 #include "cdcontainers/global.h"
 #include "cdcontainers/tree-utils.h"
 
+#include <pthread.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
+// Minimal number of nodes in the inputs of a set operation task that is run
+// in a new thread.
+#define TREAP_MIN_THREAD_WORK ((size_t)1 << 14)
+
 struct node_pair {
   struct cdc_treap_node *left;
   struct cdc_treap_node *right;
 };
 
+enum set_op { SET_UNION, SET_INTERSECTION, SET_DIFFERENCE };
+
+// A set operation on the subtrees a and b. The nodes that do not get into the
+// result are not freed, because the task can run in its own thread. They are
+// collected in the list of subtrees dropped, linked by the parent field.
+struct set_task {
+  enum set_op op;
+  struct cdc_treap_node *a;
+  struct cdc_treap_node *b;
+  struct cdc_data_info *dinfo;
+  size_t threads;
+  struct cdc_treap_node *result;
+  struct cdc_treap_node *dropped;
+  struct cdc_treap_node *dropped_tail;
+};
+
 CDC_MAKE_FIND_NODE_FN(struct cdc_treap_node *)
 CDC_MAKE_MIN_NODE_FN(struct cdc_treap_node *)
 CDC_MAKE_MAX_NODE_FN(struct cdc_treap_node *)
 CDC_MAKE_SUCCESSOR_FN(struct cdc_treap_node *)
 CDC_MAKE_PREDECESSOR_FN(struct cdc_treap_node *)
-
-static int default_prior(void *value)
+CDC_MAKE_LOWER_BOUND_FN(struct cdc_treap_node *)
+CDC_MAKE_UPPER_BOUND_FN(struct cdc_treap_node *)
+CDC_MAKE_RANK_FN(struct cdc_treap_node *)
+CDC_MAKE_SELECT_FN(struct cdc_treap_node *)
+
+// The generator is splitmix64: a Weyl sequence passed through the
+// finalizer of cdc_hash_u64. The priority is a non-negative int, like the
+// result of rand().
+static int next_priority(struct cdc_treap *t, void *key, void *value)
 {
-  CDC_UNUSED(value);
+  if (t->prior) {
+    return t->prior(value);
+  }
 
-  return rand();
+  uint64_t bits = 0;
+  if (t->prior_mode == CDC_TREAP_PRIORITY_HASH) {
+    bits = cdc_hash_u64((uint64_t)t->dinfo->hash(key) ^ t->seed);
+  } else {
+    t->rng += UINT64_C(0x9e3779b97f4a7c15);
+    bits = cdc_hash_u64(t->rng);
+  }
+
+  return (int)(bits >> 33);
+}
+
+// The new treap gets the settings of src, with its own generator state.
+static void copy_settings(struct cdc_treap *dst, struct cdc_treap *src)
+{
+  dst->prior_mode = src->prior_mode;
+  dst->seed = src->seed;
+  dst->rng = cdc_hash_u64(src->rng ^ (uint64_t)(uintptr_t)dst);
+  dst->threads = src->threads;
 }
 
-static struct cdc_treap_node *make_new_node(void *key, int prior, void *val)
+static struct cdc_treap_node *make_new_node(struct cdc_treap *t, void *key,
+                                            int prior, void *val)
 {
-  struct cdc_treap_node *node =
-      (struct cdc_treap_node *)malloc(sizeof(struct cdc_treap_node));
+  struct cdc_treap_node *node = (struct cdc_treap_node *)cdc_di_node_alloc(
+      t->dinfo, &t->pool, sizeof(struct cdc_treap_node));
   if (!node) return NULL;
 
   node->priority = prior;
+  node->size = 1;
   node->key = key;
   node->value = val;
   node->parent = NULL;
@@ -68,7 +117,7 @@ static void free_node(struct cdc_treap *t, struct cdc_treap_node *node)
     t->dinfo->dfree(&pair);
   }
 
-  free(node);
+  cdc_di_node_free(t->dinfo, &t->pool, node);
 }
 
 static void free_treap(struct cdc_treap *t, struct cdc_treap_node *root)
@@ -82,8 +131,35 @@ static void free_treap(struct cdc_treap *t, struct cdc_treap_node *root)
   free_node(t, root);
 }
 
+static void free_nodes(struct cdc_treap *t)
+{
+  if (!cdc_node_pool_enabled(&t->pool) || CDC_HAS_DFREE(t->dinfo)) {
+    free_treap(t, t->root);
+  }
+
+  cdc_node_pool_release(&t->pool, t->dinfo);
+}
+
+static size_t subtree_size(struct cdc_treap_node *node)
+{
+  return node ? node->size : 0;
+}
+
+static void update_size(struct cdc_treap_node *node)
+{
+  node->size = subtree_size(node->left) + subtree_size(node->right) + 1;
+}
+
+// Updates the subtree sizes of the node and all its ancestors.
+static void update_sizes_up(struct cdc_treap_node *node)
+{
+  for (; node; node = node->parent) {
+    update_size(node);
+  }
+}
+
 static struct node_pair split(struct cdc_treap_node *root, void *key,
-                              cdc_binary_pred_fn_t compar)
+                              struct cdc_data_info *dinfo)
 {
   struct node_pair pair;
   if (root == NULL) {
@@ -92,8 +168,8 @@ static struct node_pair split(struct cdc_treap_node *root, void *key,
     return pair;
   }
 
-  if (compar(root->key, key)) {
-    pair = split(root->right, key, compar);
+  if (cdc_di_less(dinfo, root->key, key)) {
+    pair = split(root->right, key, dinfo);
     root->right = pair.left;
     if (pair.left) {
       pair.left->parent = root;
@@ -103,11 +179,12 @@ static struct node_pair split(struct cdc_treap_node *root, void *key,
       pair.right->parent = NULL;
     }
 
+    update_size(root);
     pair.left = root;
     pair.right = pair.right;
     return pair;
   } else {
-    pair = split(root->left, key, compar);
+    pair = split(root->left, key, dinfo);
     root->left = pair.right;
     if (pair.left) {
       pair.left->parent = NULL;
@@ -117,6 +194,7 @@ static struct node_pair split(struct cdc_treap_node *root, void *key,
       pair.right->parent = root;
     }
 
+    update_size(root);
     pair.left = pair.left;
     pair.right = root;
     return pair;
@@ -140,6 +218,7 @@ static struct cdc_treap_node *merge(struct cdc_treap_node *l,
       l->right->parent = l;
     }
 
+    update_size(l);
     return l;
   } else {
     r->left = merge(l, r->left);
@@ -147,6 +226,7 @@ static struct cdc_treap_node *merge(struct cdc_treap_node *l,
       r->left->parent = r;
     }
 
+    update_size(r);
     return r;
   }
 }
@@ -160,7 +240,7 @@ static struct cdc_treap_node *find_nearest(struct cdc_treap *t, void *key,
       break;
     }
 
-    if (t->dinfo->cmp(key, node->key)) {
+    if (cdc_di_less(t->dinfo, key, node->key)) {
       if (node->left) {
         node = node->left;
       } else {
@@ -196,6 +276,8 @@ static void erase_node(struct cdc_treap *t, struct cdc_treap_node *node)
     } else {
       node->parent->right = tmp;
     }
+
+    update_sizes_up(node->parent);
   }
 
   --t->size;
@@ -208,16 +290,17 @@ static struct cdc_treap_node *insert_unique(struct cdc_treap *t,
 {
   if (t->root) {
     if (nearest->priority > node->priority) {
-      if (t->dinfo->cmp(node->key, nearest->key)) {
+      if (cdc_di_less(t->dinfo, node->key, nearest->key)) {
         nearest->left = node;
       } else {
         nearest->right = node;
       }
 
       node->parent = nearest;
+      update_sizes_up(nearest);
     } else {
       struct cdc_treap_node *pnode = nearest->parent;
-      struct node_pair pair = split(nearest, node->key, t->dinfo->cmp);
+      struct node_pair pair = split(nearest, node->key, t->dinfo);
       node->left = pair.left;
       if (pair.left) {
         pair.left->parent = node;
@@ -238,6 +321,8 @@ static struct cdc_treap_node *insert_unique(struct cdc_treap *t,
         node->parent = pnode;
         pnode->right = node;
       }
+
+      update_sizes_up(node);
     }
   } else {
     t->root = node;
@@ -247,6 +332,254 @@ static struct cdc_treap_node *insert_unique(struct cdc_treap *t,
   return node;
 }
 
+// Splits the tree into the nodes less than key and the nodes greater than key.
+// The node with key equal to key is detached and stored in eq.
+static struct node_pair split3(struct cdc_treap_node *root, void *key,
+                               struct cdc_data_info *dinfo,
+                               struct cdc_treap_node **eq)
+{
+  struct node_pair pair = {NULL, NULL};
+  if (root == NULL) {
+    return pair;
+  }
+
+  int cmp = cdc_di_cmp3(dinfo, root->key, key);
+  if (cmp < 0) {
+    pair = split3(root->right, key, dinfo, eq);
+    root->right = pair.left;
+    if (pair.left) {
+      pair.left->parent = root;
+    }
+
+    update_size(root);
+    pair.left = root;
+  } else if (cmp > 0) {
+    pair = split3(root->left, key, dinfo, eq);
+    root->left = pair.right;
+    if (pair.right) {
+      pair.right->parent = root;
+    }
+
+    update_size(root);
+    pair.right = root;
+  } else {
+    pair.left = root->left;
+    pair.right = root->right;
+    root->left = NULL;
+    root->right = NULL;
+    root->size = 1;
+    *eq = root;
+  }
+
+  if (pair.left) {
+    pair.left->parent = NULL;
+  }
+
+  if (pair.right) {
+    pair.right->parent = NULL;
+  }
+
+  return pair;
+}
+
+static void drop_subtree(struct set_task *task, struct cdc_treap_node *node)
+{
+  if (!node) {
+    return;
+  }
+
+  node->parent = NULL;
+  if (task->dropped_tail) {
+    task->dropped_tail->parent = node;
+  } else {
+    task->dropped = node;
+  }
+
+  task->dropped_tail = node;
+}
+
+static void drop_list(struct set_task *task, struct set_task *sub)
+{
+  if (!sub->dropped) {
+    return;
+  }
+
+  if (task->dropped_tail) {
+    task->dropped_tail->parent = sub->dropped;
+  } else {
+    task->dropped = sub->dropped;
+  }
+
+  task->dropped_tail = sub->dropped_tail;
+}
+
+static void set_children(struct cdc_treap_node *node,
+                         struct cdc_treap_node *left,
+                         struct cdc_treap_node *right)
+{
+  node->left = left;
+  node->right = right;
+  if (left) {
+    left->parent = node;
+  }
+
+  if (right) {
+    right->parent = node;
+  }
+
+  update_size(node);
+}
+
+static void run_set_task(struct set_task *task);
+
+static void *set_task_thread(void *arg)
+{
+  run_set_task((struct set_task *)arg);
+  return NULL;
+}
+
+// Runs the subtasks, the first one in a new thread if the task has more than
+// one thread and the inputs are large enough. If a thread can not be started,
+// the subtasks are run by the calling thread.
+static void run_subtasks(struct set_task *task, struct set_task *left,
+                         struct set_task *right)
+{
+  pthread_t id;
+  bool started = false;
+  left->threads = task->threads;
+  right->threads = task->threads;
+  if (task->threads > 1 &&
+      subtree_size(left->a) + subtree_size(left->b) >= TREAP_MIN_THREAD_WORK &&
+      subtree_size(right->a) + subtree_size(right->b) >=
+          TREAP_MIN_THREAD_WORK) {
+    left->threads = task->threads / 2;
+    right->threads = task->threads - left->threads;
+    started = pthread_create(&id, NULL, set_task_thread, left) == 0;
+  }
+
+  if (!started) {
+    run_set_task(left);
+  }
+
+  run_set_task(right);
+  if (started) {
+    pthread_join(id, NULL);
+  }
+
+  drop_list(task, left);
+  drop_list(task, right);
+}
+
+// The join-based set operations. The root of the union is the node with the
+// highest priority, so the heap order holds without rotations. The result of
+// the intersection and the difference has only the nodes of a.
+static void run_set_task(struct set_task *task)
+{
+  struct cdc_treap_node *a = task->a;
+  struct cdc_treap_node *b = task->b;
+  task->result = NULL;
+  task->dropped = NULL;
+  task->dropped_tail = NULL;
+  if (!a || !b) {
+    if (task->op == SET_UNION) {
+      task->result = a ? a : b;
+    } else if (task->op == SET_DIFFERENCE) {
+      task->result = a;
+      drop_subtree(task, b);
+    } else {
+      drop_subtree(task, a);
+      drop_subtree(task, b);
+    }
+
+    return;
+  }
+
+  bool root_from_a = task->op != SET_UNION || a->priority >= b->priority;
+  struct cdc_treap_node *root = root_from_a ? a : b;
+  struct cdc_treap_node *other = root_from_a ? b : a;
+  struct cdc_treap_node *eq = NULL;
+  struct node_pair pair = split3(other, root->key, task->dinfo, &eq);
+  struct cdc_treap_node *root_left = root->left;
+  struct cdc_treap_node *root_right = root->right;
+  if (root_left) {
+    root_left->parent = NULL;
+  }
+
+  if (root_right) {
+    root_right->parent = NULL;
+  }
+
+  struct set_task left = *task;
+  struct set_task right = *task;
+  left.a = root_from_a ? root_left : pair.left;
+  left.b = root_from_a ? pair.left : root_left;
+  right.a = root_from_a ? root_right : pair.right;
+  right.b = root_from_a ? pair.right : root_right;
+  run_subtasks(task, &left, &right);
+
+  if (task->op == SET_UNION) {
+    if (eq && !root_from_a) {
+      // The element of a is kept.
+      CDC_SWAP(void *, root->key, eq->key);
+      CDC_SWAP(void *, root->value, eq->value);
+    }
+
+    drop_subtree(task, eq);
+    set_children(root, left.result, right.result);
+    task->result = root;
+    return;
+  }
+
+  bool keep = (task->op == SET_INTERSECTION) == (eq != NULL);
+  drop_subtree(task, eq);
+  if (keep) {
+    set_children(root, left.result, right.result);
+    task->result = root;
+  } else {
+    set_children(root, NULL, NULL);
+    drop_subtree(task, root);
+    task->result = merge(left.result, right.result);
+  }
+}
+
+static void set_operation(struct cdc_treap *a, struct cdc_treap *b,
+                          enum set_op op)
+{
+  assert(a != NULL);
+  assert(b != NULL);
+  assert(a != b);
+  CDC_CHECK(cdc_node_pool_enabled(&a->pool) ==
+                cdc_node_pool_enabled(&b->pool),
+            "Treaps with and without a node pool cannot be combined.");
+
+  if (cdc_node_pool_enabled(&a->pool)) {
+    cdc_node_pool_merge(&a->pool, &b->pool);
+  }
+
+  struct set_task task;
+  task.op = op;
+  task.a = a->root;
+  task.b = b->root;
+  task.dinfo = a->dinfo;
+  task.threads = a->threads;
+  run_set_task(&task);
+
+  a->root = task.result;
+  if (a->root) {
+    a->root->parent = NULL;
+  }
+
+  a->size = subtree_size(a->root);
+  b->root = NULL;
+  b->size = 0;
+  struct cdc_treap_node *node = task.dropped;
+  while (node) {
+    struct cdc_treap_node *next = node->parent;
+    free_treap(a, node);
+    node = next;
+  }
+}
+
 static enum cdc_stat init_varg(struct cdc_treap *t, va_list args)
 {
   struct cdc_pair *pair = NULL;
@@ -264,7 +597,7 @@ enum cdc_stat cdc_treap_ctor1(struct cdc_treap **t, struct cdc_data_info *info,
                               cdc_priority_fn_t prior)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   struct cdc_treap *tmp =
       (struct cdc_treap *)calloc(sizeof(struct cdc_treap), 1);
@@ -277,7 +610,15 @@ enum cdc_stat cdc_treap_ctor1(struct cdc_treap **t, struct cdc_data_info *info,
     return CDC_STATUS_BAD_ALLOC;
   }
 
-  tmp->prior = prior ? prior : default_prior;
+  if (info->pool_chunk) {
+    cdc_node_pool_init(&tmp->pool, sizeof(struct cdc_treap_node),
+                       info->pool_chunk);
+  }
+
+  tmp->prior = prior;
+  tmp->threads = 1;
+  tmp->seed = cdc_hash_u64((uint64_t)(uintptr_t)tmp);
+  tmp->rng = tmp->seed;
   *t = tmp;
   return CDC_STATUS_OK;
 }
@@ -286,7 +627,7 @@ enum cdc_stat cdc_treap_ctorl1(struct cdc_treap **t, struct cdc_data_info *info,
                                cdc_priority_fn_t prior, ...)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   va_list args;
   va_start(args, prior);
@@ -299,7 +640,7 @@ enum cdc_stat cdc_treap_ctorv1(struct cdc_treap **t, struct cdc_data_info *info,
                                cdc_priority_fn_t prior, va_list args)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   enum cdc_stat stat = cdc_treap_ctor1(t, info, prior);
   if (stat != CDC_STATUS_OK) {
@@ -312,7 +653,7 @@ enum cdc_stat cdc_treap_ctorv1(struct cdc_treap **t, struct cdc_data_info *info,
 enum cdc_stat cdc_treap_ctor(struct cdc_treap **t, struct cdc_data_info *info)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   return cdc_treap_ctor1(t, info, NULL);
 }
@@ -321,7 +662,7 @@ enum cdc_stat cdc_treap_ctorl(struct cdc_treap **t, struct cdc_data_info *info,
                               ...)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   va_list args;
   va_start(args, info);
@@ -334,7 +675,7 @@ enum cdc_stat cdc_treap_ctorv(struct cdc_treap **t, struct cdc_data_info *info,
                               va_list args)
 {
   assert(t != NULL);
-  assert(CDC_HAS_CMP(info));
+  assert(CDC_HAS_ORDER(info));
 
   return cdc_treap_ctorv1(t, info, NULL, args);
 }
@@ -343,7 +684,7 @@ void cdc_treap_dtor(struct cdc_treap *t)
 {
   assert(t != NULL);
 
-  free_treap(t, t->root);
+  free_nodes(t);
   cdc_di_shared_dtor(t->dinfo);
   free(t);
 }
@@ -352,7 +693,7 @@ enum cdc_stat cdc_treap_get(struct cdc_treap *t, void *key, void **value)
 {
   assert(t != NULL);
 
-  struct cdc_treap_node *node = cdc_find_tree_node(t->root, key, t->dinfo->cmp);
+  struct cdc_treap_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
   if (node) {
     *value = node->value;
     return CDC_STATUS_OK;
@@ -365,15 +706,12 @@ size_t cdc_treap_count(struct cdc_treap *t, void *key)
 {
   assert(t != NULL);
 
-  return (size_t)(cdc_find_tree_node(t->root, key, t->dinfo->cmp) != NULL);
+  return (size_t)(cdc_find_tree_node(t->root, key, t->dinfo) != NULL);
 }
 
-void cdc_treap_find(struct cdc_treap *t, void *key, struct cdc_treap_iter *it)
+static void set_iter(struct cdc_treap *t, struct cdc_treap_node *node,
+                     struct cdc_treap_iter *it)
 {
-  assert(t != NULL);
-  assert(it != NULL);
-
-  struct cdc_treap_node *node = cdc_find_tree_node(t->root, key, t->dinfo->cmp);
   if (!node) {
     cdc_treap_end(t, it);
     return;
@@ -384,6 +722,67 @@ void cdc_treap_find(struct cdc_treap *t, void *key, struct cdc_treap_iter *it)
   it->prev = cdc_tree_predecessor(node);
 }
 
+void cdc_treap_find(struct cdc_treap *t, void *key, struct cdc_treap_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_treap_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
+  set_iter(t, node, it);
+}
+
+void cdc_treap_lower_bound(struct cdc_treap *t, void *key,
+                           struct cdc_treap_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_treap_node *node = cdc_tree_lower_bound(t->root, key, t->dinfo);
+  set_iter(t, node, it);
+}
+
+void cdc_treap_upper_bound(struct cdc_treap *t, void *key,
+                           struct cdc_treap_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_treap_node *node = cdc_tree_upper_bound(t->root, key, t->dinfo);
+  set_iter(t, node, it);
+}
+
+void cdc_treap_equal_range(struct cdc_treap *t, void *key,
+                           struct cdc_pair_treap_iter *ret)
+{
+  assert(t != NULL);
+  assert(ret != NULL);
+
+  struct cdc_treap_node *node = cdc_tree_lower_bound(t->root, key, t->dinfo);
+  set_iter(t, node, &ret->first);
+  if (node && !cdc_di_less(t->dinfo, key, node->key)) {
+    node = cdc_tree_successor(node);
+  }
+
+  set_iter(t, node, &ret->second);
+}
+
+size_t cdc_treap_rank(struct cdc_treap *t, void *key)
+{
+  assert(t != NULL);
+
+  return cdc_tree_rank(t->root, key, t->dinfo);
+}
+
+void cdc_treap_select(struct cdc_treap *t, size_t index,
+                      struct cdc_treap_iter *it)
+{
+  assert(t != NULL);
+  assert(it != NULL);
+
+  struct cdc_treap_node *node = cdc_tree_select(t->root, index);
+  set_iter(t, node, it);
+}
+
 enum cdc_stat cdc_treap_insert(struct cdc_treap *t, void *key, void *value,
                                struct cdc_pair_treap_iter_bool *ret)
 {
@@ -404,10 +803,10 @@ enum cdc_stat cdc_treap_insert1(struct cdc_treap *t, void *key, void *value,
 {
   assert(t != NULL);
 
-  struct cdc_treap_node *node = cdc_find_tree_node(t->root, key, t->dinfo->cmp);
+  struct cdc_treap_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
   bool finded = node;
   if (!node) {
-    node = make_new_node(key, t->prior(value), value);
+    node = make_new_node(t, key, next_priority(t, key, value), value);
     if (!node) {
       return CDC_STATUS_BAD_ALLOC;
     }
@@ -452,10 +851,10 @@ enum cdc_stat cdc_treap_insert_or_assign1(struct cdc_treap *t, void *key,
 {
   assert(t != NULL);
 
-  struct cdc_treap_node *node = cdc_find_tree_node(t->root, key, t->dinfo->cmp);
+  struct cdc_treap_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
   bool finded = node;
   if (!node) {
-    node = make_new_node(key, t->prior(value), value);
+    node = make_new_node(t, key, next_priority(t, key, value), value);
     if (!node) {
       return CDC_STATUS_BAD_ALLOC;
     }
@@ -483,7 +882,7 @@ size_t cdc_treap_erase(struct cdc_treap *t, void *key)
 {
   assert(t != NULL);
 
-  struct cdc_treap_node *node = cdc_find_tree_node(t->root, key, t->dinfo->cmp);
+  struct cdc_treap_node *node = cdc_find_tree_node(t->root, key, t->dinfo);
   if (node == NULL) {
     return 0;
   }
@@ -496,7 +895,7 @@ void cdc_treap_clear(struct cdc_treap *t)
 {
   assert(t != NULL);
 
-  free_treap(t, t->root);
+  free_nodes(t);
   t->size = 0;
   t->root = NULL;
 }
@@ -510,6 +909,100 @@ void cdc_treap_swap(struct cdc_treap *a, struct cdc_treap *b)
   CDC_SWAP(size_t, a->size, b->size);
   CDC_SWAP(cdc_priority_fn_t, a->prior, b->prior);
   CDC_SWAP(struct cdc_data_info *, a->dinfo, b->dinfo);
+  CDC_SWAP(struct cdc_node_pool, a->pool, b->pool);
+  CDC_SWAP(size_t, a->threads, b->threads);
+  CDC_SWAP(uint64_t, a->seed, b->seed);
+  CDC_SWAP(uint64_t, a->rng, b->rng);
+  CDC_SWAP(enum cdc_treap_priority, a->prior_mode, b->prior_mode);
+}
+
+enum cdc_stat cdc_treap_split(struct cdc_treap *t, void *key,
+                              struct cdc_treap **left,
+                              struct cdc_treap **right)
+{
+  assert(t != NULL);
+  assert(left != NULL);
+  assert(right != NULL);
+
+  // The nodes of a node pool cannot be shared between two treaps.
+  if (cdc_node_pool_enabled(&t->pool)) {
+    return CDC_STATUS_NOT_SUPPORTED;
+  }
+
+  struct cdc_treap *l = NULL;
+  struct cdc_treap *r = NULL;
+  enum cdc_stat stat = cdc_treap_ctor1(&l, t->dinfo, t->prior);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  stat = cdc_treap_ctor1(&r, t->dinfo, t->prior);
+  if (stat != CDC_STATUS_OK) {
+    cdc_treap_dtor(l);
+    return stat;
+  }
+
+  struct node_pair pair = split(t->root, key, t->dinfo);
+  l->root = pair.left;
+  l->size = subtree_size(pair.left);
+  r->root = pair.right;
+  r->size = subtree_size(pair.right);
+  copy_settings(l, t);
+  copy_settings(r, t);
+  t->root = NULL;
+  t->size = 0;
+  *left = l;
+  *right = r;
+  return CDC_STATUS_OK;
+}
+
+void cdc_treap_join(struct cdc_treap *a, struct cdc_treap *b)
+{
+  assert(a != NULL);
+  assert(b != NULL);
+  assert(a != b);
+  CDC_CHECK(cdc_node_pool_enabled(&a->pool) ==
+                cdc_node_pool_enabled(&b->pool),
+            "Treaps with and without a node pool cannot be joined.");
+
+  if (!a->root) {
+    a->root = b->root;
+  } else if (b->root) {
+    void *a_max = cdc_max_tree_node(a->root)->key;
+    void *b_min = cdc_min_tree_node(b->root)->key;
+    if (cdc_di_less(a->dinfo, a_max, b_min)) {
+      a->root = merge(a->root, b->root);
+    } else {
+      void *b_max = cdc_max_tree_node(b->root)->key;
+      void *a_min = cdc_min_tree_node(a->root)->key;
+      CDC_CHECK(cdc_di_less(a->dinfo, b_max, a_min),
+                "Treaps with overlapping key ranges cannot be joined.");
+      a->root = merge(b->root, a->root);
+    }
+  }
+
+  a->size += b->size;
+  if (cdc_node_pool_enabled(&a->pool)) {
+    cdc_node_pool_merge(&a->pool, &b->pool);
+  }
+
+  b->root = NULL;
+  b->size = 0;
+}
+
+void cdc_treap_union(struct cdc_treap *a, struct cdc_treap *b)
+{
+  set_operation(a, b, SET_UNION);
+}
+
+void cdc_treap_intersection(struct cdc_treap *a, struct cdc_treap *b)
+{
+  set_operation(a, b, SET_INTERSECTION);
+}
+
+void cdc_treap_difference(struct cdc_treap *a, struct cdc_treap *b)
+{
+  set_operation(a, b, SET_DIFFERENCE);
 }
 
 void cdc_treap_begin(struct cdc_treap *t, struct cdc_treap_iter *it)
@@ -47,10 +47,20 @@ static int lt(const void *l, const void *r)
   return CDC_TO_INT(l) < CDC_TO_INT(r);
 }
 
+static int cmp_int(const void *l, const void *r)
+{
+  return (CDC_TO_INT(l) > CDC_TO_INT(r)) - (CDC_TO_INT(l) < CDC_TO_INT(r));
+}
+
 static inline void test_tree_links(struct cdc_avl_tree_node *node)
 {
   if (!node) return;
 
+  size_t size = 1;
+  size += node->left ? node->left->size : 0;
+  size += node->right ? node->right->size : 0;
+  CU_ASSERT_EQUAL(node->size, size);
+
   if (node->left) {
     CU_ASSERT_EQUAL(node->left->parent, node);
     test_tree_links(node->left);
@@ -394,3 +404,200 @@ void test_avl_tree_height()
   CU_ASSERT(experimental_height <= theoretical_max_height);
   cdc_avl_tree_dtor(t);
 }
+
+void test_avl_tree_pool()
+{
+  struct cdc_avl_tree *t = NULL;
+  struct cdc_avl_tree *w = NULL;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.pool_chunk = 64;
+
+  CU_ASSERT_EQUAL(cdc_avl_tree_ctor(&t, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_avl_tree_ctor(&w, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_avl_tree_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(cdc_avl_tree_erase(t, CDC_FROM_INT(i)), 1);
+  }
+
+  CU_ASSERT_EQUAL(cdc_avl_tree_size(t), kCount / 2);
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(
+        cdc_avl_tree_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_avl_tree_size(t), kCount);
+  for (int i = 0; i < kCount; ++i) {
+    void *value = NULL;
+    CU_ASSERT_EQUAL(cdc_avl_tree_get(t, CDC_FROM_INT(i), &value),
+                    CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(CDC_TO_INT(value), i);
+  }
+
+  cdc_avl_tree_swap(t, w);
+  CU_ASSERT(cdc_avl_tree_empty(t));
+  CU_ASSERT_EQUAL(cdc_avl_tree_size(w), kCount);
+  cdc_avl_tree_clear(w);
+  CU_ASSERT(cdc_avl_tree_empty(w));
+  CU_ASSERT_EQUAL(
+      cdc_avl_tree_insert(w, CDC_FROM_INT(1), CDC_FROM_INT(1), NULL),
+      CDC_STATUS_OK);
+  cdc_avl_tree_dtor(t);
+  cdc_avl_tree_dtor(w);
+}
+
+void test_avl_tree_cmp3()
+{
+  struct cdc_avl_tree *t = NULL;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp3 = cmp_int;
+
+  CU_ASSERT_EQUAL(cdc_avl_tree_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount;
+    CU_ASSERT_EQUAL(
+        cdc_avl_tree_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(cdc_avl_tree_erase(t, CDC_FROM_INT(i)), 1);
+  }
+
+  CU_ASSERT_EQUAL(cdc_avl_tree_size(t), kCount / 2);
+  for (int i = 0; i < kCount; ++i) {
+    void *value = NULL;
+    enum cdc_stat stat = cdc_avl_tree_get(t, CDC_FROM_INT(i), &value);
+    CU_ASSERT_EQUAL(stat, i % 2 ? CDC_STATUS_OK : CDC_STATUS_NOT_FOUND);
+  }
+
+  struct cdc_avl_tree_iter it = CDC_INIT_STRUCT;
+  int expected = 1;
+  cdc_avl_tree_begin(t, &it);
+  while (cdc_avl_tree_iter_has_next(&it)) {
+    CU_ASSERT_EQUAL(CDC_TO_INT(cdc_avl_tree_iter_key(&it)), expected);
+    expected += 2;
+    cdc_avl_tree_iter_next(&it);
+  }
+
+  CU_ASSERT_EQUAL(expected, kCount + 1);
+  cdc_avl_tree_dtor(t);
+}
+
+void test_avl_tree_rank_select()
+{
+  struct cdc_avl_tree *t = NULL;
+  struct cdc_avl_tree_iter it = CDC_INIT_STRUCT;
+  struct cdc_avl_tree_iter it_end = CDC_INIT_STRUCT;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_avl_tree_ctor(&t, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_avl_tree_rank(t, CDC_FROM_INT(0)), 0);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount;
+    CU_ASSERT_EQUAL(
+        cdc_avl_tree_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; i += 3) {
+    CU_ASSERT_EQUAL(cdc_avl_tree_erase(t, CDC_FROM_INT(i)), 1);
+  }
+
+  test_tree_links(t->root);
+
+  // The keys left are the ones not divisible by 3.
+  size_t index = 0;
+  for (int i = 0; i < kCount; ++i) {
+    size_t rank = (size_t)(i - (i + 2) / 3);
+    CU_ASSERT_EQUAL(cdc_avl_tree_rank(t, CDC_FROM_INT(i)), rank);
+    if (i % 3 != 0) {
+      cdc_avl_tree_select(t, index, &it);
+      CU_ASSERT_EQUAL(CDC_TO_INT(cdc_avl_tree_iter_key(&it)), i);
+      ++index;
+    }
+  }
+
+  CU_ASSERT_EQUAL(index, cdc_avl_tree_size(t));
+  CU_ASSERT_EQUAL(cdc_avl_tree_rank(t, CDC_FROM_INT(kCount)), index);
+  cdc_avl_tree_select(t, index, &it);
+  cdc_avl_tree_end(t, &it_end);
+  CU_ASSERT(cdc_avl_tree_iter_is_eq(&it, &it_end));
+  cdc_avl_tree_dtor(t);
+}
+
+void test_avl_tree_erase_two_children()
+{
+  struct cdc_avl_tree *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  // The successor of b is its right child c, which has the right child d.
+  CU_ASSERT_EQUAL(cdc_avl_tree_ctorl(&t, &info, &b, &a, &c, &d, CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_avl_tree_erase(t, b.first), 1);
+  CU_ASSERT(avl_tree_key_int_eq(t, 3, &a, &c, &d));
+  cdc_avl_tree_dtor(t);
+}
+
+static int avl_tree_bound_key(struct cdc_avl_tree *t,
+                              struct cdc_avl_tree_iter *it)
+{
+  struct cdc_avl_tree_iter it_end = CDC_INIT_STRUCT;
+  cdc_avl_tree_end(t, &it_end);
+  if (cdc_avl_tree_iter_is_eq(it, &it_end)) {
+    return -1;
+  }
+
+  return CDC_TO_INT(cdc_avl_tree_iter_key(it));
+}
+
+void test_avl_tree_bounds()
+{
+  struct cdc_avl_tree *t = NULL;
+  struct cdc_avl_tree_iter it = CDC_INIT_STRUCT;
+  struct cdc_pair_avl_tree_iter range = CDC_INIT_STRUCT;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_avl_tree_ctor(&t, &info), CDC_STATUS_OK);
+  cdc_avl_tree_lower_bound(t, CDC_FROM_INT(0), &it);
+  CU_ASSERT_EQUAL(avl_tree_bound_key(t, &it), -1);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount * 2;
+    CU_ASSERT_EQUAL(
+        cdc_avl_tree_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  // The keys are the even numbers in [0, 2 * kCount).
+  for (int i = -1; i <= 2 * kCount; ++i) {
+    int lower = (i + 1) / 2 * 2;
+    int upper = (i + 2) / 2 * 2;
+    lower = lower < 2 * kCount ? lower : -1;
+    upper = upper < 2 * kCount ? upper : -1;
+    cdc_avl_tree_lower_bound(t, CDC_FROM_INT(i), &it);
+    CU_ASSERT_EQUAL(avl_tree_bound_key(t, &it), lower);
+    cdc_avl_tree_upper_bound(t, CDC_FROM_INT(i), &it);
+    CU_ASSERT_EQUAL(avl_tree_bound_key(t, &it), upper);
+    cdc_avl_tree_equal_range(t, CDC_FROM_INT(i), &range);
+    CU_ASSERT_EQUAL(avl_tree_bound_key(t, &range.first), lower);
+    CU_ASSERT_EQUAL(avl_tree_bound_key(t, &range.second), upper);
+  }
+
+  cdc_avl_tree_lower_bound(t, CDC_FROM_INT(7), &it);
+  cdc_avl_tree_iter_prev(&it);
+  CU_ASSERT_EQUAL(CDC_TO_INT(cdc_avl_tree_iter_key(&it)), 6);
+  cdc_avl_tree_dtor(t);
+}
@@ -0,0 +1,593 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "test-common.h"
+
+#include "cdcontainers/bplus-tree.h"
+#include "cdcontainers/casts.h"
+#include "cdcontainers/common.h"
+
+#include <stdarg.h>
+#include <stdlib.h>
+
+#include <CUnit/Basic.h>
+
+static struct cdc_pair a = {CDC_FROM_INT(0), CDC_FROM_INT(0)};
+static struct cdc_pair b = {CDC_FROM_INT(1), CDC_FROM_INT(1)};
+static struct cdc_pair c = {CDC_FROM_INT(2), CDC_FROM_INT(2)};
+static struct cdc_pair d = {CDC_FROM_INT(3), CDC_FROM_INT(3)};
+static struct cdc_pair e = {CDC_FROM_INT(4), CDC_FROM_INT(4)};
+static struct cdc_pair f = {CDC_FROM_INT(5), CDC_FROM_INT(5)};
+static struct cdc_pair g = {CDC_FROM_INT(6), CDC_FROM_INT(6)};
+static struct cdc_pair h = {CDC_FROM_INT(7), CDC_FROM_INT(7)};
+
+static size_t freed_count = 0;
+
+static int lt(const void *l, const void *r)
+{
+  return CDC_TO_INT(l) < CDC_TO_INT(r);
+}
+
+static int cmp_int(const void *l, const void *r)
+{
+  return (CDC_TO_INT(l) > CDC_TO_INT(r)) - (CDC_TO_INT(l) < CDC_TO_INT(r));
+}
+
+static void count_free(void *pair)
+{
+  (void)pair;
+  ++freed_count;
+}
+
+// Checks the invariants of the subtree and returns its depth.
+static size_t check_node(struct cdc_bplus_tree *t,
+                         struct cdc_bplus_tree_node *node)
+{
+  // The last leaf can be underfull after keys were appended in order.
+  bool is_tail = node == &t->tail->base;
+  CU_ASSERT(node == t->root || is_tail ||
+            node->size >= CDC_BPLUS_TREE_ORDER / 2);
+  CU_ASSERT(node->size > 0);
+  CU_ASSERT(node->size <= CDC_BPLUS_TREE_ORDER);
+  for (size_t i = 1; i < node->size; ++i) {
+    CU_ASSERT(CDC_TO_INT(node->keys[i - 1]) < CDC_TO_INT(node->keys[i]));
+  }
+
+  if (node->is_leaf) {
+    return 1;
+  }
+
+  struct cdc_bplus_tree_inner *inner = (struct cdc_bplus_tree_inner *)node;
+  size_t depth = check_node(t, inner->children[0]);
+  for (size_t i = 0; i < node->size; ++i) {
+    struct cdc_bplus_tree_node *child = inner->children[i + 1];
+    CU_ASSERT_EQUAL(check_node(t, child), depth);
+    while (!child->is_leaf) {
+      child = ((struct cdc_bplus_tree_inner *)child)->children[0];
+    }
+
+    CU_ASSERT_EQUAL(node->keys[i], child->keys[0]);
+  }
+
+  return depth + 1;
+}
+
+static void check_tree(struct cdc_bplus_tree *t)
+{
+  if (t->root) {
+    CU_ASSERT_EQUAL(check_node(t, t->root), t->height + 1);
+  } else {
+    CU_ASSERT(t->head == NULL && t->tail == NULL);
+  }
+
+  size_t count = 0;
+  struct cdc_bplus_tree_leaf *prev = NULL;
+  for (struct cdc_bplus_tree_leaf *leaf = t->head; leaf; leaf = leaf->next) {
+    CU_ASSERT_EQUAL(leaf->prev, prev);
+    count += leaf->base.size;
+    prev = leaf;
+  }
+
+  CU_ASSERT_EQUAL(t->tail, prev);
+  CU_ASSERT_EQUAL(count, t->size);
+}
+
+static bool bplus_tree_key_int_eq(struct cdc_bplus_tree *t, size_t count, ...)
+{
+  check_tree(t);
+  va_list args;
+  va_start(args, count);
+  for (size_t i = 0; i < count; ++i) {
+    struct cdc_pair *val = va_arg(args, struct cdc_pair *);
+    void *tmp = NULL;
+    if (cdc_bplus_tree_get(t, val->first, &tmp) != CDC_STATUS_OK ||
+        tmp != val->second) {
+      va_end(args);
+      return false;
+    }
+  }
+  va_end(args);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), count);
+  return true;
+}
+
+void test_bplus_tree_ctor()
+{
+  struct cdc_bplus_tree *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctor(&t, &info), CDC_STATUS_OK);
+  CU_ASSERT(cdc_bplus_tree_empty(t));
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_ctorl()
+{
+  struct cdc_bplus_tree *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctorl(&t, &info, &a, &g, &h, &d, CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), 4);
+  CU_ASSERT(bplus_tree_key_int_eq(t, 4, &a, &g, &h, &d));
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_get()
+{
+  struct cdc_bplus_tree *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(
+      cdc_bplus_tree_ctorl(&t, &info, &a, &b, &c, &d, &g, &h, &e, &f, CDC_END),
+      CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), 8);
+  CU_ASSERT(bplus_tree_key_int_eq(t, 8, &a, &b, &c, &d, &g, &h, &e, &f));
+
+  void *value = NULL;
+  CU_ASSERT_EQUAL(cdc_bplus_tree_get(t, CDC_FROM_INT(10), &value),
+                  CDC_STATUS_NOT_FOUND);
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_count()
+{
+  struct cdc_bplus_tree *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctorl(&t, &info, &a, &b, CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), 2);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_count(t, a.first), 1);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_count(t, b.first), 1);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_count(t, CDC_FROM_INT(10)), 0);
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_find()
+{
+  struct cdc_bplus_tree *t = NULL;
+  struct cdc_bplus_tree_iter it = CDC_INIT_STRUCT;
+  struct cdc_bplus_tree_iter it_end = CDC_INIT_STRUCT;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(
+      cdc_bplus_tree_ctorl(&t, &info, &a, &b, &c, &d, &g, CDC_END),
+      CDC_STATUS_OK);
+  cdc_bplus_tree_find(t, a.first, &it);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_iter_value(&it), a.second);
+  cdc_bplus_tree_find(t, b.first, &it);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_iter_value(&it), b.second);
+  cdc_bplus_tree_find(t, g.first, &it);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_iter_value(&it), g.second);
+  cdc_bplus_tree_find(t, h.first, &it);
+  cdc_bplus_tree_end(t, &it_end);
+  CU_ASSERT(cdc_bplus_tree_iter_is_eq(&it, &it_end));
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_clear()
+{
+  struct cdc_bplus_tree *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctorl(&t, &info, &a, &b, CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), 2);
+  cdc_bplus_tree_clear(t);
+  CU_ASSERT(cdc_bplus_tree_empty(t));
+  check_tree(t);
+  cdc_bplus_tree_clear(t);
+  CU_ASSERT(cdc_bplus_tree_empty(t));
+  CU_ASSERT_EQUAL(cdc_bplus_tree_insert(t, a.first, a.second, NULL),
+                  CDC_STATUS_OK);
+  CU_ASSERT(bplus_tree_key_int_eq(t, 1, &a));
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_insert()
+{
+  struct cdc_bplus_tree *t = NULL;
+  struct cdc_pair_bplus_tree_iter_bool ret = CDC_INIT_STRUCT;
+  const int kCount = 10000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount;
+    CU_ASSERT_EQUAL(
+        cdc_bplus_tree_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), &ret),
+        CDC_STATUS_OK);
+    CU_ASSERT(ret.second);
+    CU_ASSERT_EQUAL(CDC_TO_INT(cdc_bplus_tree_iter_key(&ret.first)), key);
+  }
+
+  check_tree(t);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), kCount);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_insert(t, CDC_FROM_INT(5), NULL, &ret),
+                  CDC_STATUS_OK);
+  CU_ASSERT(!ret.second);
+  CU_ASSERT_EQUAL(CDC_TO_INT(cdc_bplus_tree_iter_value(&ret.first)), 5);
+  for (int i = 0; i < kCount; ++i) {
+    void *val = NULL;
+    CU_ASSERT_EQUAL(cdc_bplus_tree_get(t, CDC_FROM_INT(i), &val),
+                    CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(CDC_TO_INT(val), i);
+  }
+
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_insert_or_assign()
+{
+  struct cdc_bplus_tree *t = NULL;
+  struct cdc_pair_bplus_tree_iter_bool ret = CDC_INIT_STRUCT;
+  void *value = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctor(&t, &info), CDC_STATUS_OK);
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_insert_or_assign(t, a.first, a.second, &ret),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), 1);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_iter_value(&ret.first), a.second);
+  CU_ASSERT(ret.second);
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_insert_or_assign(t, a.first, b.second, &ret),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), 1);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_get(t, a.first, &value), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(value, b.second);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_iter_value(&ret.first), b.second);
+  CU_ASSERT(!ret.second);
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_insert_or_assign(t, c.first, c.second, &ret),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), 2);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_iter_value(&ret.first), c.second);
+  CU_ASSERT(ret.second);
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_erase()
+{
+  struct cdc_bplus_tree *t = NULL;
+  void *value = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(
+      cdc_bplus_tree_ctorl(&t, &info, &a, &b, &c, &d, &g, &h, &e, &f, CDC_END),
+      CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, a.first), 1);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_get(t, a.first, &value), CDC_STATUS_NOT_FOUND);
+  CU_ASSERT(bplus_tree_key_int_eq(t, 7, &b, &c, &d, &g, &h, &e, &f));
+  CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, h.first), 1);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, h.first), 0);
+  CU_ASSERT(bplus_tree_key_int_eq(t, 6, &b, &c, &d, &g, &e, &f));
+  CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, b.first), 1);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, c.first), 1);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, d.first), 1);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, g.first), 1);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, e.first), 1);
+  CU_ASSERT(bplus_tree_key_int_eq(t, 1, &f));
+  CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, f.first), 1);
+  CU_ASSERT(cdc_bplus_tree_empty(t));
+  check_tree(t);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, f.first), 0);
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_erase_many()
+{
+  struct cdc_bplus_tree *t = NULL;
+  const int kCount = 20000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.dfree = count_free;
+
+  freed_count = 0;
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_bplus_tree_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  // Removes the keys in a scattered order to hit every kind of rebalancing.
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount;
+    if (key % 3 != 0) {
+      CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, CDC_FROM_INT(key)), 1);
+    }
+
+    if (i % 1000 == 0) {
+      check_tree(t);
+    }
+  }
+
+  check_tree(t);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), (kCount + 2) / 3);
+  CU_ASSERT_EQUAL(freed_count, kCount - (kCount + 2) / 3);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_bplus_tree_count(t, CDC_FROM_INT(i)), i % 3 == 0);
+  }
+
+  for (int i = kCount - 1; i >= 0; --i) {
+    cdc_bplus_tree_erase(t, CDC_FROM_INT(i));
+  }
+
+  check_tree(t);
+  CU_ASSERT(cdc_bplus_tree_empty(t));
+  CU_ASSERT_EQUAL(freed_count, kCount);
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_iterators()
+{
+  struct cdc_bplus_tree *t = NULL;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = kCount - 1; i >= 0; --i) {
+    CU_ASSERT_EQUAL(
+        cdc_bplus_tree_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(-i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  struct cdc_bplus_tree_iter it1 = CDC_INIT_STRUCT;
+  struct cdc_bplus_tree_iter it2 = CDC_INIT_STRUCT;
+  int i = 0;
+  cdc_bplus_tree_begin(t, &it1);
+  cdc_bplus_tree_end(t, &it2);
+  CU_ASSERT(!cdc_bplus_tree_iter_has_prev(&it1));
+  for (; !cdc_bplus_tree_iter_is_eq(&it1, &it2);
+       cdc_bplus_tree_iter_next(&it1)) {
+    struct cdc_pair pair = cdc_bplus_tree_iter_key_value(&it1);
+    CU_ASSERT_EQUAL(CDC_TO_INT(pair.first), i);
+    CU_ASSERT_EQUAL(CDC_TO_INT(pair.second), -i);
+    ++i;
+  }
+  CU_ASSERT_EQUAL(i, kCount);
+  CU_ASSERT(!cdc_bplus_tree_iter_has_next(&it1));
+
+  cdc_bplus_tree_end(t, &it1);
+  CU_ASSERT(cdc_bplus_tree_iter_has_prev(&it1));
+  while (cdc_bplus_tree_iter_has_prev(&it1)) {
+    cdc_bplus_tree_iter_prev(&it1);
+    --i;
+    CU_ASSERT_EQUAL(CDC_TO_INT(cdc_bplus_tree_iter_key(&it1)), i);
+  }
+  CU_ASSERT_EQUAL(i, 0);
+  cdc_bplus_tree_begin(t, &it2);
+  CU_ASSERT(cdc_bplus_tree_iter_is_eq(&it1, &it2));
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_swap()
+{
+  struct cdc_bplus_tree *v = NULL;
+  struct cdc_bplus_tree *w = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctorl(&v, &info, &b, CDC_END), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctorl(&w, &info, &a, &g, &h, &d, CDC_END),
+                  CDC_STATUS_OK);
+  cdc_bplus_tree_swap(v, w);
+  CU_ASSERT(bplus_tree_key_int_eq(v, 4, &a, &g, &h, &d));
+  CU_ASSERT(bplus_tree_key_int_eq(w, 1, &b));
+  cdc_bplus_tree_dtor(v);
+  cdc_bplus_tree_dtor(w);
+}
+
+void test_bplus_tree_pool()
+{
+  struct cdc_bplus_tree *t = NULL;
+  const int kCount = 5000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.pool_chunk = 16;
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_bplus_tree_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, CDC_FROM_INT(i)), 1);
+  }
+
+  check_tree(t);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), kCount / 2);
+  cdc_bplus_tree_clear(t);
+  CU_ASSERT(cdc_bplus_tree_empty(t));
+  cdc_bplus_tree_dtor(t);
+}
+
+// Fails when the budget of allocations is spent.
+static void *limited_alloc(size_t size, void *ctx)
+{
+  size_t *budget = (size_t *)ctx;
+  if (*budget == 0) {
+    return NULL;
+  }
+
+  --*budget;
+  return malloc(size);
+}
+
+static void limited_free(void *ptr, void *ctx)
+{
+  (void)ctx;
+  free(ptr);
+}
+
+void test_bplus_tree_bad_alloc()
+{
+  struct cdc_bplus_tree *t = NULL;
+  const int kCount = 20000;
+  size_t budget = 0;
+  size_t failures = 0;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.allocator.allocate = limited_alloc;
+  info.allocator.deallocate = limited_free;
+  info.allocator.ctx = &budget;
+
+  budget = 1;
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (int)((size_t)i * 7919 % (size_t)kCount);
+    // Every insertion is tried with no memory, then with one more node each
+    // time. A failed insertion must leave the tree unchanged.
+    size_t nodes = 0;
+    budget = nodes;
+    enum cdc_stat stat;
+    while ((stat = cdc_bplus_tree_insert(t, CDC_FROM_INT(key),
+                                         CDC_FROM_INT(key), NULL)) ==
+           CDC_STATUS_BAD_ALLOC) {
+      ++failures;
+      CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), (size_t)i);
+      CU_ASSERT_EQUAL(cdc_bplus_tree_count(t, CDC_FROM_INT(key)), 0);
+      if (failures % 64 == 0) {
+        check_tree(t);
+      }
+
+      budget = ++nodes;
+    }
+
+    CU_ASSERT_EQUAL(stat, CDC_STATUS_OK);
+  }
+
+  check_tree(t);
+  CU_ASSERT(t->height >= 2);
+  CU_ASSERT(failures > 0);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), (size_t)kCount);
+  cdc_bplus_tree_dtor(t);
+}
+
+void test_bplus_tree_cmp3()
+{
+  struct cdc_bplus_tree *t = NULL;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp3 = cmp_int;
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount;
+    CU_ASSERT_EQUAL(
+        cdc_bplus_tree_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(cdc_bplus_tree_erase(t, CDC_FROM_INT(i)), 1);
+  }
+
+  check_tree(t);
+  CU_ASSERT_EQUAL(cdc_bplus_tree_size(t), kCount / 2);
+  cdc_bplus_tree_dtor(t);
+}
+
+static int bplus_tree_bound_key(struct cdc_bplus_tree *t,
+                                struct cdc_bplus_tree_iter *it)
+{
+  struct cdc_bplus_tree_iter it_end = CDC_INIT_STRUCT;
+  cdc_bplus_tree_end(t, &it_end);
+  if (cdc_bplus_tree_iter_is_eq(it, &it_end)) {
+    return -1;
+  }
+
+  return CDC_TO_INT(cdc_bplus_tree_iter_key(it));
+}
+
+void test_bplus_tree_bounds()
+{
+  struct cdc_bplus_tree *t = NULL;
+  struct cdc_bplus_tree_iter it = CDC_INIT_STRUCT;
+  struct cdc_pair_bplus_tree_iter range = CDC_INIT_STRUCT;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_bplus_tree_ctor(&t, &info), CDC_STATUS_OK);
+  cdc_bplus_tree_lower_bound(t, CDC_FROM_INT(0), &it);
+  CU_ASSERT_EQUAL(bplus_tree_bound_key(t, &it), -1);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount * 2;
+    CU_ASSERT_EQUAL(
+        cdc_bplus_tree_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  // The keys are the even numbers in [0, 2 * kCount).
+  for (int i = -1; i <= 2 * kCount; ++i) {
+    int lower = (i + 1) / 2 * 2;
+    int upper = (i + 2) / 2 * 2;
+    lower = lower < 2 * kCount ? lower : -1;
+    upper = upper < 2 * kCount ? upper : -1;
+    cdc_bplus_tree_lower_bound(t, CDC_FROM_INT(i), &it);
+    CU_ASSERT_EQUAL(bplus_tree_bound_key(t, &it), lower);
+    cdc_bplus_tree_upper_bound(t, CDC_FROM_INT(i), &it);
+    CU_ASSERT_EQUAL(bplus_tree_bound_key(t, &it), upper);
+    cdc_bplus_tree_equal_range(t, CDC_FROM_INT(i), &range);
+    CU_ASSERT_EQUAL(bplus_tree_bound_key(t, &range.first), lower);
+    CU_ASSERT_EQUAL(bplus_tree_bound_key(t, &range.second), upper);
+  }
+
+  cdc_bplus_tree_lower_bound(t, CDC_FROM_INT(7), &it);
+  cdc_bplus_tree_iter_prev(&it);
+  CU_ASSERT_EQUAL(CDC_TO_INT(cdc_bplus_tree_iter_key(&it)), 6);
+  cdc_bplus_tree_dtor(t);
+}
@@ -20,10 +20,48 @@
 // IN THE SOFTWARE.
 #include "test-common.h"
 
+#include "cdcontainers/array.h"
+#include "cdcontainers/avl-tree.h"
+#include "cdcontainers/binomial-heap.h"
 #include "cdcontainers/casts.h"
+#include "cdcontainers/circular-array.h"
+#include "cdcontainers/hash-table.h"
+#include "cdcontainers/list.h"
+#include "cdcontainers/pairing-heap.h"
+#include "cdcontainers/splay-tree.h"
+#include "cdcontainers/treap.h"
 
 #include <CUnit/Basic.h>
 
+struct alloc_counter {
+  size_t allocs;
+  size_t deallocs;
+};
+
+static void *counting_alloc(size_t size, void *ctx)
+{
+  ((struct alloc_counter *)ctx)->allocs++;
+  return malloc(size);
+}
+
+static void counting_dealloc(void *ptr, void *ctx)
+{
+  ((struct alloc_counter *)ctx)->deallocs++;
+  free(ptr);
+}
+
+static int lt(const void *l, const void *r)
+{
+  return CDC_TO_INT(l) < CDC_TO_INT(r);
+}
+
+static int eq(const void *l, const void *r)
+{
+  return CDC_TO_INT(l) == CDC_TO_INT(r);
+}
+
+static size_t hash(const void *val) { return cdc_hash_int(CDC_TO_INT(val)); }
+
 void test_ptr_float_cast()
 {
 #ifdef CDC_FLOAT_CAST
@@ -41,3 +79,74 @@ void test_ptr_double_cast()
   CU_ASSERT_EQUAL(CDC_TO_DOUBLE(CDC_FROM_DOUBLE(value)), value);
 #endif
 }
+
+void test_allocator()
+{
+  const int count = 100;
+  struct alloc_counter counter = {0, 0};
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.eq = eq;
+  info.hash = hash;
+  info.allocator.allocate = counting_alloc;
+  info.allocator.deallocate = counting_dealloc;
+  info.allocator.ctx = &counter;
+
+  struct cdc_array *arr = NULL;
+  struct cdc_circular_array *carr = NULL;
+  struct cdc_list *l = NULL;
+  struct cdc_hash_table *ht = NULL;
+  struct cdc_avl_tree *avl = NULL;
+  struct cdc_splay_tree *splay = NULL;
+  struct cdc_treap *treap = NULL;
+  struct cdc_binomial_heap *bheap = NULL;
+  struct cdc_pairing_heap *pheap = NULL;
+  CU_ASSERT_EQUAL(cdc_array_ctor(&arr, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_circular_array_ctor(&carr, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_list_ctor(&l, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&ht, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_avl_tree_ctor(&avl, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_splay_tree_ctor(&splay, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&treap, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_binomial_heap_ctor(&bheap, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_pairing_heap_ctor(&pheap, &info), CDC_STATUS_OK);
+
+  for (int i = 0; i < count; ++i) {
+    void *val = CDC_FROM_INT(i);
+    CU_ASSERT_EQUAL(cdc_array_push_back(arr, val), CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(cdc_circular_array_push_back(carr, val), CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(cdc_list_push_back(l, val), CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(cdc_hash_table_insert(ht, val, val, NULL, NULL),
+                    CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(cdc_avl_tree_insert(avl, val, val, NULL), CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(cdc_splay_tree_insert(splay, val, val, NULL),
+                    CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(cdc_treap_insert(treap, val, val, NULL), CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(cdc_binomial_heap_insert(bheap, val), CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(cdc_pairing_heap_insert(pheap, val), CDC_STATUS_OK);
+  }
+
+  // every node-based container allocates at least one node per item
+  CU_ASSERT(counter.allocs >= 6 * (size_t)count);
+  CU_ASSERT(counter.deallocs < counter.allocs);
+
+  cdc_list_erase(l, 0);
+  cdc_hash_table_erase(ht, CDC_FROM_INT(0));
+  cdc_avl_tree_erase(avl, CDC_FROM_INT(0));
+  cdc_splay_tree_erase(splay, CDC_FROM_INT(0));
+  cdc_treap_erase(treap, CDC_FROM_INT(0));
+  cdc_binomial_heap_extract_top(bheap);
+  cdc_pairing_heap_extract_top(pheap);
+  CU_ASSERT_EQUAL(cdc_array_shrink_to_fit(arr), CDC_STATUS_OK);
+
+  cdc_array_dtor(arr);
+  cdc_circular_array_dtor(carr);
+  cdc_list_dtor(l);
+  cdc_hash_table_dtor(ht);
+  cdc_avl_tree_dtor(avl);
+  cdc_splay_tree_dtor(splay);
+  cdc_treap_dtor(treap);
+  cdc_binomial_heap_dtor(bheap);
+  cdc_pairing_heap_dtor(pheap);
+  CU_ASSERT_EQUAL(counter.allocs, counter.deallocs);
+}
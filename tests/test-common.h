@@ -28,6 +28,7 @@
 // Common tests
 void test_ptr_float_cast();
 void test_ptr_double_cast();
+void test_allocator();
 
 // Array tests
 void test_array_ctor();
@@ -72,6 +73,9 @@ void test_list_erase_if();
 void test_list_reverse();
 void test_list_unique();
 void test_list_sort();
+void test_list_cmp3();
+void test_list_pool();
+void test_list_pool_free_nodes();
 
 // Stackv tests
 void test_stackv_ctor();
@@ -133,6 +137,7 @@ void test_heap_insert();
 void test_heap_change_key();
 void test_heap_merge();
 void test_heap_swap();
+void test_heap_cmp3();
 
 // Binomial heap tests
 void test_binomial_heap_ctor();
@@ -179,6 +184,15 @@ void test_treap_clear();
 void test_treap_insert_or_assign();
 void test_treap_erase();
 void test_treap_height();
+void test_treap_pool();
+void test_treap_cmp3();
+void test_treap_rank_select();
+void test_treap_bounds();
+void test_treap_split_join();
+void test_treap_join_pool();
+void test_treap_set_operations();
+void test_treap_union_keeps_a();
+void test_treap_priority();
 
 // Hash table tests
 void test_hash_table_ctor();
@@ -193,6 +207,123 @@ void test_hash_table_erase();
 void test_hash_table_swap();
 void test_hash_table_rehash();
 void test_hash_table_reserve();
+void test_hash_table_incremental_rehash();
+void test_hash_table_seed();
+void test_hash_table_hashed();
+void test_hash_table_get_many();
+void test_hash_table_stats();
+void test_hash_table_stats_threads();
+void test_hash_table_ctor_from();
+void test_hash_table_insert_range();
+void test_hash_table_bulk_threads();
+void test_hash_table_scan();
+void test_hash_table_scan_rehash();
+void test_hash_table_scan_erase();
+
+// Robin Hood table tests
+void test_rh_table_ctor();
+void test_rh_table_ctorl();
+void test_rh_table_get();
+void test_rh_table_count();
+void test_rh_table_find();
+void test_rh_table_clear();
+void test_rh_table_insert();
+void test_rh_table_insert_or_assign();
+void test_rh_table_erase();
+void test_rh_table_swap();
+void test_rh_table_rehash();
+void test_rh_table_reserve();
+void test_rh_table_collisions();
+
+// Swiss table tests
+void test_swiss_table_ctor();
+void test_swiss_table_ctorl();
+void test_swiss_table_get();
+void test_swiss_table_count();
+void test_swiss_table_find();
+void test_swiss_table_clear();
+void test_swiss_table_insert();
+void test_swiss_table_insert_or_assign();
+void test_swiss_table_erase();
+void test_swiss_table_swap();
+void test_swiss_table_rehash();
+void test_swiss_table_reserve();
+void test_swiss_table_collisions();
+void test_swiss_table_erase_reinsert();
+
+// Concurrent map tests
+void test_concurrent_map_ctor();
+void test_concurrent_map_insert();
+void test_concurrent_map_erase();
+void test_concurrent_map_scoped_info();
+void test_concurrent_map_threads();
+
+// Compact table tests
+void test_compact_table_ctor();
+void test_compact_table_ctorl();
+void test_compact_table_get();
+void test_compact_table_count();
+void test_compact_table_find();
+void test_compact_table_clear();
+void test_compact_table_insert();
+void test_compact_table_insert_or_assign();
+void test_compact_table_erase();
+void test_compact_table_swap();
+void test_compact_table_rehash();
+void test_compact_table_reserve();
+void test_compact_table_collisions();
+void test_compact_table_erase_last_moved();
+
+// Hash set tests
+void test_hash_set_ctor();
+void test_hash_set_ctorl();
+void test_hash_set_insert();
+void test_hash_set_find();
+void test_hash_set_erase();
+void test_hash_set_clear();
+void test_hash_set_swap();
+void test_hash_set_reserve();
+void test_hash_set_iterators();
+void test_hash_set_union();
+void test_hash_set_intersection();
+void test_hash_set_difference();
+
+// Frozen map tests
+void test_frozen_map_ctorl();
+void test_frozen_map_ctor();
+void test_frozen_map_find();
+void test_frozen_map_iterators();
+void test_frozen_map_swap();
+void test_frozen_map_collisions();
+void test_frozen_map_dtor();
+
+// Hash snapshot tests
+void test_hash_snapshot_get();
+void test_hash_snapshot_count();
+void test_hash_snapshot_find();
+void test_hash_snapshot_iterators();
+void test_hash_snapshot_string_keys();
+void test_hash_snapshot_empty();
+void test_hash_snapshot_many();
+void test_hash_snapshot_bad_file();
+
+// B+ tree tests
+void test_bplus_tree_ctor();
+void test_bplus_tree_ctorl();
+void test_bplus_tree_get();
+void test_bplus_tree_count();
+void test_bplus_tree_find();
+void test_bplus_tree_clear();
+void test_bplus_tree_insert();
+void test_bplus_tree_insert_or_assign();
+void test_bplus_tree_erase();
+void test_bplus_tree_erase_many();
+void test_bplus_tree_iterators();
+void test_bplus_tree_swap();
+void test_bplus_tree_pool();
+void test_bplus_tree_bad_alloc();
+void test_bplus_tree_cmp3();
+void test_bplus_tree_bounds();
 
 // Splay tree tests
 void test_splay_tree_ctor();
@@ -208,6 +339,10 @@ void test_splay_tree_clear();
 void test_splay_tree_insert_or_assign();
 void test_splay_tree_erase();
 void test_splay_tree_height();
+void test_splay_tree_pool();
+void test_splay_tree_cmp3();
+void test_splay_tree_bounds();
+void test_splay_tree_splay_period();
 
 // Avl tree tests
 void test_avl_tree_ctor();
@@ -223,6 +358,11 @@ void test_avl_tree_clear();
 void test_avl_tree_insert_or_assign();
 void test_avl_tree_erase();
 void test_avl_tree_height();
+void test_avl_tree_pool();
+void test_avl_tree_cmp3();
+void test_avl_tree_rank_select();
+void test_avl_tree_erase_two_children();
+void test_avl_tree_bounds();
 
 // Map tests
 void test_map_ctor();
@@ -238,5 +378,7 @@ void test_map_clear();
 void test_map_insert_or_assign();
 void test_map_erase();
 void test_map_iter_type();
+void test_map_bounds();
+void test_map_range();
 
 #endif  // CDSTRUCTURES_TESTS_TESTS_COMMON_H
@@ -0,0 +1,217 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "test-common.h"
+
+#include "cdcontainers/casts.h"
+#include "cdcontainers/concurrent-map.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <CUnit/Basic.h>
+
+#define THREADS 4
+#define KEYS_PER_THREAD 1000
+
+static int eq(const void *l, const void *r)
+{
+  return CDC_TO_INT(l) == CDC_TO_INT(r);
+}
+
+static size_t hash(const void *val) { return cdc_hash_int(CDC_TO_INT(val)); }
+
+struct worker_arg {
+  struct cdc_concurrent_map *m;
+  int first;
+  size_t failures;
+};
+
+static void *worker(void *ptr)
+{
+  struct worker_arg *arg = (struct worker_arg *)ptr;
+  void *value = NULL;
+  for (int i = arg->first; i < arg->first + KEYS_PER_THREAD; ++i) {
+    bool inserted = false;
+    if (cdc_concurrent_map_insert(arg->m, CDC_FROM_INT(i), CDC_FROM_INT(i),
+                                  &inserted) != CDC_STATUS_OK ||
+        !inserted) {
+      ++arg->failures;
+    }
+
+    if (cdc_concurrent_map_get(arg->m, CDC_FROM_INT(i), &value) !=
+            CDC_STATUS_OK ||
+        CDC_TO_INT(value) != i) {
+      ++arg->failures;
+    }
+  }
+
+  for (int i = arg->first; i < arg->first + KEYS_PER_THREAD; i += 2) {
+    if (cdc_concurrent_map_erase(arg->m, CDC_FROM_INT(i)) != 1) {
+      ++arg->failures;
+    }
+  }
+
+  return NULL;
+}
+
+void test_concurrent_map_ctor()
+{
+  struct cdc_concurrent_map *m = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(cdc_concurrent_map_ctor(&m, &info), CDC_STATUS_OK);
+  CU_ASSERT(cdc_concurrent_map_empty(m));
+  cdc_concurrent_map_dtor(m);
+
+  CU_ASSERT_EQUAL(cdc_concurrent_map_ctor1(&m, &info, 1), CDC_STATUS_OK);
+  CU_ASSERT(cdc_concurrent_map_empty(m));
+  cdc_concurrent_map_dtor(m);
+}
+
+void test_concurrent_map_insert()
+{
+  struct cdc_concurrent_map *m = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  void *value = NULL;
+  bool inserted = false;
+
+  CU_ASSERT_EQUAL(cdc_concurrent_map_ctor(&m, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_insert(m, CDC_FROM_INT(1),
+                                            CDC_FROM_INT(2), &inserted),
+                  CDC_STATUS_OK);
+  CU_ASSERT(inserted);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_insert(m, CDC_FROM_INT(1),
+                                            CDC_FROM_INT(3), &inserted),
+                  CDC_STATUS_OK);
+  CU_ASSERT(!inserted);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_get(m, CDC_FROM_INT(1), &value),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(CDC_TO_INT(value), 2);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_insert_or_assign(
+                      m, CDC_FROM_INT(1), CDC_FROM_INT(3), &inserted),
+                  CDC_STATUS_OK);
+  CU_ASSERT(!inserted);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_get(m, CDC_FROM_INT(1), &value),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(CDC_TO_INT(value), 3);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_insert(m, NULL, CDC_FROM_INT(4), NULL),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_size(m), 2);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_count(m, NULL), 1);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_get(m, CDC_FROM_INT(5), &value),
+                  CDC_STATUS_NOT_FOUND);
+  cdc_concurrent_map_dtor(m);
+}
+
+void test_concurrent_map_erase()
+{
+  struct cdc_concurrent_map *m = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(cdc_concurrent_map_ctor(&m, &info), CDC_STATUS_OK);
+  for (int i = 0; i < 100; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_concurrent_map_insert(m, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_concurrent_map_size(m), 100);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_erase(m, CDC_FROM_INT(10)), 1);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_erase(m, CDC_FROM_INT(10)), 0);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_count(m, CDC_FROM_INT(10)), 0);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_size(m), 99);
+  cdc_concurrent_map_clear(m);
+  CU_ASSERT(cdc_concurrent_map_empty(m));
+  cdc_concurrent_map_dtor(m);
+}
+
+// Builds a map from a data info that does not outlive the call. The info is
+// wiped before the return, so the map must not keep a pointer to it.
+static struct cdc_concurrent_map *make_map_with_scoped_info()
+{
+  struct cdc_concurrent_map *m = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(cdc_concurrent_map_ctor(&m, &info), CDC_STATUS_OK);
+  memset(&info, 0, sizeof(info));
+  return m;
+}
+
+void test_concurrent_map_scoped_info()
+{
+  struct cdc_concurrent_map *m = make_map_with_scoped_info();
+  void *value = NULL;
+
+  for (int i = 0; i < 100; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_concurrent_map_insert(m, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_concurrent_map_get(m, CDC_FROM_INT(42), &value),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(CDC_TO_INT(value), 42);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_erase(m, CDC_FROM_INT(42)), 1);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_count(m, CDC_FROM_INT(42)), 0);
+  CU_ASSERT_EQUAL(cdc_concurrent_map_size(m), 99);
+  cdc_concurrent_map_dtor(m);
+}
+
+void test_concurrent_map_threads()
+{
+  struct cdc_concurrent_map *m = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  pthread_t threads[THREADS];
+  struct worker_arg args[THREADS];
+
+  CU_ASSERT_EQUAL(cdc_concurrent_map_ctor1(&m, &info, THREADS),
+                  CDC_STATUS_OK);
+  for (int i = 0; i < THREADS; ++i) {
+    args[i].m = m;
+    args[i].first = i * KEYS_PER_THREAD;
+    args[i].failures = 0;
+    CU_ASSERT_EQUAL(pthread_create(&threads[i], NULL, worker, &args[i]), 0);
+  }
+
+  for (int i = 0; i < THREADS; ++i) {
+    pthread_join(threads[i], NULL);
+    CU_ASSERT_EQUAL(args[i].failures, 0);
+  }
+
+  CU_ASSERT_EQUAL(cdc_concurrent_map_size(m), THREADS * KEYS_PER_THREAD / 2);
+  for (int i = 0; i < THREADS * KEYS_PER_THREAD; ++i) {
+    CU_ASSERT_EQUAL(cdc_concurrent_map_count(m, CDC_FROM_INT(i)),
+                    (size_t)(i % 2));
+  }
+
+  cdc_concurrent_map_dtor(m);
+}
@@ -0,0 +1,255 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "test-common.h"
+
+#include "cdcontainers/casts.h"
+#include "cdcontainers/frozen-map.h"
+#include "cdcontainers/global.h"
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <CUnit/Basic.h>
+
+static struct cdc_pair a = {CDC_FROM_INT(0), CDC_FROM_INT(0)};
+static struct cdc_pair b = {CDC_FROM_INT(1), CDC_FROM_INT(1)};
+static struct cdc_pair c = {CDC_FROM_INT(2), CDC_FROM_INT(2)};
+static struct cdc_pair d = {CDC_FROM_INT(3), CDC_FROM_INT(3)};
+static struct cdc_pair e = {CDC_FROM_INT(4), CDC_FROM_INT(4)};
+
+static int eq(const void *l, const void *r)
+{
+  return CDC_TO_INT(l) == CDC_TO_INT(r);
+}
+
+static int lt(const void *l, const void *r)
+{
+  return CDC_TO_INT(l) < CDC_TO_INT(r);
+}
+
+static size_t hash(const void *val) { return cdc_hash_int(CDC_TO_INT(val)); }
+
+static size_t bad_hash(const void *val) { return (size_t)CDC_TO_INT(val) % 4; }
+
+static bool frozen_map_key_int_eq(struct cdc_frozen_map *m, size_t count, ...)
+{
+  if (cdc_frozen_map_size(m) != count) {
+    return false;
+  }
+
+  va_list args;
+  va_start(args, count);
+  for (size_t i = 0; i < count; ++i) {
+    struct cdc_pair *val = va_arg(args, struct cdc_pair *);
+    void *tmp = NULL;
+    if (cdc_frozen_map_get(m, val->first, &tmp) != CDC_STATUS_OK ||
+        tmp != val->second) {
+      va_end(args);
+      return false;
+    }
+  }
+
+  va_end(args);
+  return true;
+}
+
+void test_frozen_map_ctorl()
+{
+  struct cdc_frozen_map *m = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  struct cdc_pair a1 = {CDC_FROM_INT(0), CDC_FROM_INT(10)};
+  void *value = NULL;
+
+  CU_ASSERT_EQUAL(cdc_frozen_map_ctorl(&m, &info, CDC_END), CDC_STATUS_OK);
+  CU_ASSERT(cdc_frozen_map_empty(m));
+  CU_ASSERT_EQUAL(cdc_frozen_map_get(m, a.first, &value),
+                  CDC_STATUS_NOT_FOUND);
+  cdc_frozen_map_dtor(m);
+
+  CU_ASSERT_EQUAL(
+      cdc_frozen_map_ctorl(&m, &info, &a, &b, &c, &a1, &d, CDC_END),
+      CDC_STATUS_OK);
+  CU_ASSERT(frozen_map_key_int_eq(m, 4, &a, &b, &c, &d));
+  CU_ASSERT_EQUAL(cdc_frozen_map_count(m, e.first), 0);
+  cdc_frozen_map_dtor(m);
+}
+
+void test_frozen_map_ctor()
+{
+  const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_htable};
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.eq = eq;
+  info.hash = hash;
+  const int kCount = 1000;
+  for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
+    struct cdc_map *map = NULL;
+    struct cdc_frozen_map *m = NULL;
+    void *value = NULL;
+
+    CU_ASSERT_EQUAL(cdc_map_ctor(tables[t], &map, &info), CDC_STATUS_OK);
+    for (int i = 0; i < kCount; ++i) {
+      CU_ASSERT_EQUAL(cdc_map_insert(map, CDC_FROM_INT(i), CDC_FROM_INT(-i),
+                                     NULL, NULL),
+                      CDC_STATUS_OK);
+    }
+
+    CU_ASSERT_EQUAL(cdc_frozen_map_ctor(&m, &info, map), CDC_STATUS_OK);
+    cdc_map_dtor(map);
+    CU_ASSERT_EQUAL(cdc_frozen_map_size(m), kCount);
+    for (int i = 0; i < kCount; ++i) {
+      CU_ASSERT_EQUAL(cdc_frozen_map_get(m, CDC_FROM_INT(i), &value),
+                      CDC_STATUS_OK);
+      CU_ASSERT_EQUAL(CDC_TO_INT(value), -i);
+    }
+
+    for (int i = kCount; i < 2 * kCount; ++i) {
+      CU_ASSERT_EQUAL(cdc_frozen_map_count(m, CDC_FROM_INT(i)), 0);
+    }
+
+    cdc_frozen_map_dtor(m);
+  }
+}
+
+void test_frozen_map_find()
+{
+  struct cdc_frozen_map *m = NULL;
+  struct cdc_frozen_map_iter it = CDC_INIT_STRUCT;
+  struct cdc_frozen_map_iter it_end = CDC_INIT_STRUCT;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(cdc_frozen_map_ctorl(&m, &info, &a, &b, &c, CDC_END),
+                  CDC_STATUS_OK);
+  cdc_frozen_map_find(m, b.first, &it);
+  CU_ASSERT_EQUAL(cdc_frozen_map_iter_key(&it), b.first);
+  CU_ASSERT_EQUAL(cdc_frozen_map_iter_value(&it), b.second);
+  cdc_frozen_map_find(m, d.first, &it);
+  cdc_frozen_map_end(m, &it_end);
+  CU_ASSERT(cdc_frozen_map_iter_is_eq(&it, &it_end));
+  cdc_frozen_map_dtor(m);
+}
+
+void test_frozen_map_iterators()
+{
+  struct cdc_frozen_map *m = NULL;
+  struct cdc_frozen_map_iter it = CDC_INIT_STRUCT;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  int sum = 0;
+  size_t count = 0;
+
+  CU_ASSERT_EQUAL(cdc_frozen_map_ctorl(&m, &info, &a, &b, &c, &d, &e, CDC_END),
+                  CDC_STATUS_OK);
+  for (cdc_frozen_map_begin(m, &it); cdc_frozen_map_iter_has_next(&it);
+       cdc_frozen_map_iter_next(&it)) {
+    struct cdc_pair pair = cdc_frozen_map_iter_key_value(&it);
+    CU_ASSERT_EQUAL(pair.first, pair.second);
+    sum += CDC_TO_INT(pair.first);
+    ++count;
+  }
+
+  CU_ASSERT_EQUAL(count, 5);
+  CU_ASSERT_EQUAL(sum, 0 + 1 + 2 + 3 + 4);
+  cdc_frozen_map_dtor(m);
+}
+
+void test_frozen_map_swap()
+{
+  struct cdc_frozen_map *ma = NULL;
+  struct cdc_frozen_map *mb = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(cdc_frozen_map_ctorl(&ma, &info, &a, &b, CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_frozen_map_ctorl(&mb, &info, &c, &d, &e, CDC_END),
+                  CDC_STATUS_OK);
+  cdc_frozen_map_swap(ma, mb);
+  CU_ASSERT(frozen_map_key_int_eq(ma, 3, &c, &d, &e));
+  CU_ASSERT(frozen_map_key_int_eq(mb, 2, &a, &b));
+  cdc_frozen_map_dtor(ma);
+  cdc_frozen_map_dtor(mb);
+}
+
+void test_frozen_map_collisions()
+{
+  struct cdc_map *map = NULL;
+  struct cdc_frozen_map *m = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.eq = eq;
+  info.hash = bad_hash;
+  const int kCount = 200;
+  void *value = NULL;
+
+  CU_ASSERT_EQUAL(cdc_map_ctor(cdc_map_htable, &map, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_map_insert(map, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL, NULL),
+        CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_frozen_map_ctor(&m, &info, map), CDC_STATUS_OK);
+  cdc_map_dtor(map);
+  CU_ASSERT_EQUAL(cdc_frozen_map_size(m), kCount);
+  for (int i = 0; i < 2 * kCount; ++i) {
+    enum cdc_stat stat = cdc_frozen_map_get(m, CDC_FROM_INT(i), &value);
+    if (i < kCount) {
+      CU_ASSERT_EQUAL(stat, CDC_STATUS_OK);
+      CU_ASSERT_EQUAL(CDC_TO_INT(value), i);
+    } else {
+      CU_ASSERT_EQUAL(stat, CDC_STATUS_NOT_FOUND);
+    }
+  }
+
+  cdc_frozen_map_dtor(m);
+}
+
+static int freed_count;
+
+static void count_free(void *val)
+{
+  CDC_UNUSED(val);
+  ++freed_count;
+}
+
+void test_frozen_map_dtor()
+{
+  struct cdc_frozen_map *m = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  info.dfree = count_free;
+
+  freed_count = 0;
+  CU_ASSERT_EQUAL(cdc_frozen_map_ctorl(&m, &info, &a, &b, &c, CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(freed_count, 0);
+  cdc_frozen_map_dtor(m);
+  CU_ASSERT_EQUAL(freed_count, 3);
+}
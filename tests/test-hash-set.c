@@ -0,0 +1,355 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "test-common.h"
+
+#include "cdcontainers/casts.h"
+#include "cdcontainers/hash-set.h"
+
+#include <assert.h>
+#include <stdarg.h>
+#include <stdio.h>
+
+#include <CUnit/Basic.h>
+
+static int eq(const void *l, const void *r)
+{
+  return CDC_TO_INT(l) == CDC_TO_INT(r);
+}
+
+static size_t hash(const void *val) { return cdc_hash_int(CDC_TO_INT(val)); }
+
+static size_t bad_hash(const void *val) { return (size_t)CDC_TO_INT(val) % 4; }
+
+static bool hash_set_int_eq(struct cdc_hash_set *s, size_t count, ...)
+{
+  if (cdc_hash_set_size(s) != count) {
+    return false;
+  }
+
+  va_list args;
+  va_start(args, count);
+  for (size_t i = 0; i < count; ++i) {
+    int key = va_arg(args, int);
+    if (!cdc_hash_set_contains(s, CDC_FROM_INT(key))) {
+      va_end(args);
+      return false;
+    }
+  }
+
+  va_end(args);
+  return true;
+}
+
+static struct cdc_data_info make_info()
+{
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  return info;
+}
+
+void test_hash_set_ctor()
+{
+  struct cdc_hash_set *s = NULL;
+  struct cdc_data_info info = make_info();
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctor(&s, &info), CDC_STATUS_OK);
+  CU_ASSERT(cdc_hash_set_empty(s));
+  cdc_hash_set_dtor(s);
+}
+
+void test_hash_set_ctorl()
+{
+  struct cdc_hash_set *s = NULL;
+  struct cdc_data_info info = make_info();
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctorl(&s, &info, CDC_FROM_INT(0),
+                                     CDC_FROM_INT(1), CDC_FROM_INT(2),
+                                     CDC_FROM_INT(1), CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT(hash_set_int_eq(s, 3, 0, 1, 2));
+  cdc_hash_set_dtor(s);
+}
+
+void test_hash_set_insert()
+{
+  struct cdc_hash_set *s = NULL;
+  struct cdc_hash_set_iter it = CDC_INIT_STRUCT;
+  struct cdc_data_info info = make_info();
+  bool inserted = false;
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctor(&s, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_set_insert(s, CDC_FROM_INT(1), &it, &inserted),
+                  CDC_STATUS_OK);
+  CU_ASSERT(inserted);
+  CU_ASSERT_EQUAL(CDC_TO_INT(cdc_hash_set_iter_key(&it)), 1);
+  CU_ASSERT_EQUAL(cdc_hash_set_insert(s, CDC_FROM_INT(1), &it, &inserted),
+                  CDC_STATUS_OK);
+  CU_ASSERT(!inserted);
+  CU_ASSERT_EQUAL(CDC_TO_INT(cdc_hash_set_iter_key(&it)), 1);
+  CU_ASSERT(hash_set_int_eq(s, 1, 1));
+
+  for (int i = 0; i < 100; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_set_insert(s, CDC_FROM_INT(i), NULL, NULL),
+                    CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_set_size(s), 100);
+  for (int i = 0; i < 100; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_set_count(s, CDC_FROM_INT(i)), 1);
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_set_count(s, CDC_FROM_INT(100)), 0);
+  cdc_hash_set_dtor(s);
+}
+
+void test_hash_set_find()
+{
+  struct cdc_hash_set *s = NULL;
+  struct cdc_hash_set_iter it = CDC_INIT_STRUCT;
+  struct cdc_hash_set_iter it_end = CDC_INIT_STRUCT;
+  struct cdc_data_info info = make_info();
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctorl(&s, &info, CDC_FROM_INT(1),
+                                     CDC_FROM_INT(2), CDC_END),
+                  CDC_STATUS_OK);
+  cdc_hash_set_find(s, CDC_FROM_INT(2), &it);
+  CU_ASSERT_EQUAL(CDC_TO_INT(cdc_hash_set_iter_key(&it)), 2);
+  cdc_hash_set_find(s, CDC_FROM_INT(3), &it);
+  cdc_hash_set_end(s, &it_end);
+  CU_ASSERT(cdc_hash_set_iter_is_eq(&it, &it_end));
+  cdc_hash_set_dtor(s);
+}
+
+void test_hash_set_erase()
+{
+  struct cdc_hash_set *s = NULL;
+  const int kCount = 200;
+  struct cdc_data_info info = make_info();
+  info.hash = bad_hash;
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctor(&s, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_set_insert(s, CDC_FROM_INT(i), NULL, NULL),
+                    CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(cdc_hash_set_erase(s, CDC_FROM_INT(i)), 1);
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_set_erase(s, CDC_FROM_INT(0)), 0);
+  CU_ASSERT_EQUAL(cdc_hash_set_size(s), kCount / 2);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_set_contains(s, CDC_FROM_INT(i)), i % 2 == 1);
+  }
+
+  cdc_hash_set_dtor(s);
+}
+
+void test_hash_set_clear()
+{
+  struct cdc_hash_set *s = NULL;
+  struct cdc_hash_set_iter it = CDC_INIT_STRUCT;
+  struct cdc_data_info info = make_info();
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctorl(&s, &info, CDC_FROM_INT(1),
+                                     CDC_FROM_INT(2), CDC_END),
+                  CDC_STATUS_OK);
+  cdc_hash_set_clear(s);
+  CU_ASSERT(cdc_hash_set_empty(s));
+  cdc_hash_set_begin(s, &it);
+  CU_ASSERT(!cdc_hash_set_iter_has_next(&it));
+  cdc_hash_set_dtor(s);
+}
+
+void test_hash_set_swap()
+{
+  struct cdc_hash_set *a = NULL;
+  struct cdc_hash_set *b = NULL;
+  struct cdc_data_info info = make_info();
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctorl1(&a, &info, 0.5, CDC_FROM_INT(1),
+                                      CDC_FROM_INT(2), CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_set_ctorl1(&b, &info, 0.9, CDC_FROM_INT(3),
+                                      CDC_END),
+                  CDC_STATUS_OK);
+  cdc_hash_set_swap(a, b);
+  CU_ASSERT(hash_set_int_eq(a, 1, 3));
+  CU_ASSERT_EQUAL(cdc_hash_set_max_load_factor(a), 0.9f);
+  CU_ASSERT(hash_set_int_eq(b, 2, 1, 2));
+  CU_ASSERT_EQUAL(cdc_hash_set_max_load_factor(b), 0.5f);
+  cdc_hash_set_dtor(a);
+  cdc_hash_set_dtor(b);
+}
+
+void test_hash_set_reserve()
+{
+  struct cdc_hash_set *s = NULL;
+  struct cdc_data_info info = make_info();
+  size_t count = 1000;
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctor(&s, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_set_reserve(s, count), CDC_STATUS_OK);
+  size_t bcount = cdc_hash_set_bucket_count(s);
+  CU_ASSERT((size_t)(bcount * cdc_hash_set_max_load_factor(s)) >= count);
+  for (size_t i = 0; i < count; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_set_insert(s, CDC_FROM_INT(i), NULL, NULL),
+                    CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_set_bucket_count(s), bcount);
+  CU_ASSERT_EQUAL(cdc_hash_set_rehash(s, bcount * 4), CDC_STATUS_OK);
+  CU_ASSERT(cdc_hash_set_bucket_count(s) >= bcount * 4);
+  CU_ASSERT_EQUAL(cdc_hash_set_size(s), count);
+  cdc_hash_set_dtor(s);
+}
+
+void test_hash_set_iterators()
+{
+  struct cdc_hash_set *s = NULL;
+  struct cdc_hash_set_iter it = CDC_INIT_STRUCT;
+  struct cdc_data_info info = make_info();
+  const int kCount = 50;
+  int sum = 0;
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctor(&s, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_set_insert(s, CDC_FROM_INT(i), NULL, NULL),
+                    CDC_STATUS_OK);
+  }
+
+  size_t count = 0;
+  for (cdc_hash_set_begin(s, &it); cdc_hash_set_iter_has_next(&it);
+       cdc_hash_set_iter_next(&it)) {
+    sum += CDC_TO_INT(cdc_hash_set_iter_key(&it));
+    ++count;
+  }
+
+  CU_ASSERT_EQUAL(count, kCount);
+  CU_ASSERT_EQUAL(sum, kCount * (kCount - 1) / 2);
+  cdc_hash_set_dtor(s);
+}
+
+void test_hash_set_union()
+{
+  struct cdc_hash_set *a = NULL;
+  struct cdc_hash_set *b = NULL;
+  struct cdc_data_info info = make_info();
+  struct cdc_data_info info_bad = make_info();
+  info_bad.hash = bad_hash;
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctorl(&a, &info, CDC_FROM_INT(1),
+                                     CDC_FROM_INT(2), CDC_FROM_INT(3), CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_set_ctorl(&b, &info, CDC_FROM_INT(3),
+                                     CDC_FROM_INT(4), CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_set_union(a, b), CDC_STATUS_OK);
+  CU_ASSERT(hash_set_int_eq(a, 4, 1, 2, 3, 4));
+  CU_ASSERT(hash_set_int_eq(b, 2, 3, 4));
+  cdc_hash_set_dtor(b);
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctorl(&b, &info_bad, CDC_FROM_INT(4),
+                                     CDC_FROM_INT(5), CDC_FROM_INT(6), CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_set_union(a, b), CDC_STATUS_OK);
+  CU_ASSERT(hash_set_int_eq(a, 6, 1, 2, 3, 4, 5, 6));
+  CU_ASSERT_EQUAL(cdc_hash_set_union(a, a), CDC_STATUS_OK);
+  CU_ASSERT(hash_set_int_eq(a, 6, 1, 2, 3, 4, 5, 6));
+  cdc_hash_set_dtor(a);
+  cdc_hash_set_dtor(b);
+}
+
+void test_hash_set_intersection()
+{
+  struct cdc_hash_set *a = NULL;
+  struct cdc_hash_set *b = NULL;
+  struct cdc_data_info info = make_info();
+  const int kCount = 300;
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctor(&a, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_set_ctor(&b, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_set_insert(a, CDC_FROM_INT(i), NULL, NULL),
+                    CDC_STATUS_OK);
+    if (i % 3 == 0) {
+      CU_ASSERT_EQUAL(cdc_hash_set_insert(b, CDC_FROM_INT(i), NULL, NULL),
+                      CDC_STATUS_OK);
+    }
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_set_insert(b, CDC_FROM_INT(kCount), NULL, NULL),
+                  CDC_STATUS_OK);
+  cdc_hash_set_intersection(a, b);
+  CU_ASSERT_EQUAL(cdc_hash_set_size(a), kCount / 3);
+  for (int i = 0; i <= kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_set_contains(a, CDC_FROM_INT(i)),
+                    i % 3 == 0 && i != kCount);
+  }
+
+  cdc_hash_set_intersection(a, a);
+  CU_ASSERT_EQUAL(cdc_hash_set_size(a), kCount / 3);
+  cdc_hash_set_dtor(a);
+  cdc_hash_set_dtor(b);
+}
+
+void test_hash_set_difference()
+{
+  struct cdc_hash_set *a = NULL;
+  struct cdc_hash_set *b = NULL;
+  struct cdc_data_info info = make_info();
+  const int kCount = 300;
+
+  CU_ASSERT_EQUAL(cdc_hash_set_ctor(&a, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_set_ctor(&b, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_set_insert(a, CDC_FROM_INT(i), NULL, NULL),
+                    CDC_STATUS_OK);
+    if (i % 3 == 0) {
+      CU_ASSERT_EQUAL(cdc_hash_set_insert(b, CDC_FROM_INT(i), NULL, NULL),
+                      CDC_STATUS_OK);
+    }
+  }
+
+  // b is smaller, so it is iterated.
+  cdc_hash_set_difference(a, b);
+  CU_ASSERT_EQUAL(cdc_hash_set_size(a), kCount - kCount / 3);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_set_contains(a, CDC_FROM_INT(i)), i % 3 != 0);
+  }
+
+  // a is smaller, so it is iterated.
+  for (int i = 0; i < 2 * kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_set_insert(b, CDC_FROM_INT(i), NULL, NULL),
+                    CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_set_erase(b, CDC_FROM_INT(1)), 1);
+  cdc_hash_set_difference(a, b);
+  CU_ASSERT(hash_set_int_eq(a, 1, 1));
+
+  cdc_hash_set_difference(a, a);
+  CU_ASSERT(cdc_hash_set_empty(a));
+  cdc_hash_set_dtor(a);
+  cdc_hash_set_dtor(b);
+}
@@ -0,0 +1,342 @@
+// The MIT License (MIT)
+// Copyright (c) 2018 Maksim Andrianov
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to
+// deal in the Software without restriction, including without limitation the
+// rights to use, copy, modify, merge, publish, distribute, sublicense, and/or
+// sell copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+// FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS
+// IN THE SOFTWARE.
+#include "test-common.h"
+
+#include "cdcontainers/casts.h"
+#include "cdcontainers/global.h"
+#include "cdcontainers/hash-snapshot.h"
+#include "cdcontainers/hash-table.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <CUnit/Basic.h>
+
+static const char *snapshot_path = "test-hash-snapshot.bin";
+
+static struct cdc_pair a = {CDC_FROM_INT(0), "zero"};
+static struct cdc_pair b = {CDC_FROM_INT(1), "one"};
+static struct cdc_pair c = {CDC_FROM_INT(2), "two"};
+static struct cdc_pair d = {CDC_FROM_INT(3), ""};
+static struct cdc_pair e = {CDC_FROM_INT(4), "four"};
+
+static int eq(const void *l, const void *r)
+{
+  return CDC_TO_INT(l) == CDC_TO_INT(r);
+}
+
+static size_t hash(const void *val) { return cdc_hash_int(CDC_TO_INT(val)); }
+
+static int str_eq(const void *l, const void *r)
+{
+  return strcmp((const char *)l, (const char *)r) == 0;
+}
+
+static size_t str_hash(const void *val)
+{
+  return cdc_hash_str((const char *)val);
+}
+
+static void int_write(void *item, void *buf)
+{
+  int val = CDC_TO_INT(item);
+  memcpy(buf, &val, sizeof(val));
+}
+
+static size_t str_size_of(void *item) { return strlen((const char *)item); }
+
+static void str_write(void *item, void *buf)
+{
+  memcpy(buf, item, strlen((const char *)item));
+}
+
+static struct cdc_hash_snapshot_codec int_str_codec = {
+    sizeof(int), NULL, int_write, 0, str_size_of, str_write};
+
+static enum cdc_stat write_and_open(struct cdc_hash_table *t,
+                                    struct cdc_hash_snapshot_codec *codec,
+                                    struct cdc_hash_snapshot **s)
+{
+  enum cdc_stat stat = cdc_hash_snapshot_write(t, codec, snapshot_path);
+  if (stat != CDC_STATUS_OK) {
+    return stat;
+  }
+
+  return cdc_hash_snapshot_ctor(s, snapshot_path);
+}
+
+static bool snapshot_value_eq(struct cdc_hash_snapshot *s, int key,
+                              const char *value)
+{
+  const void *tmp = NULL;
+  size_t size = 0;
+  return cdc_hash_snapshot_get(s, &key, sizeof(key), &tmp, &size) ==
+             CDC_STATUS_OK &&
+         size == strlen(value) && memcmp(tmp, value, size) == 0;
+}
+
+void test_hash_snapshot_get()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(
+      cdc_hash_table_ctorl(&t, &info, &a, &b, &c, &d, &e, CDC_END),
+      CDC_STATUS_OK);
+  struct cdc_hash_snapshot *s = NULL;
+  CU_ASSERT_EQUAL(write_and_open(t, &int_str_codec, &s), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_size(s), 5);
+  CU_ASSERT(snapshot_value_eq(s, 0, "zero"));
+  CU_ASSERT(snapshot_value_eq(s, 1, "one"));
+  CU_ASSERT(snapshot_value_eq(s, 2, "two"));
+  CU_ASSERT(snapshot_value_eq(s, 3, ""));
+  CU_ASSERT(snapshot_value_eq(s, 4, "four"));
+
+  int key = 5;
+  const void *value = NULL;
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_get(s, &key, sizeof(key), &value, NULL),
+                  CDC_STATUS_NOT_FOUND);
+  cdc_hash_snapshot_dtor(s);
+  cdc_hash_table_dtor(t);
+  remove(snapshot_path);
+}
+
+void test_hash_snapshot_count()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctorl(&t, &info, &a, &b, CDC_END),
+                  CDC_STATUS_OK);
+  struct cdc_hash_snapshot *s = NULL;
+  CU_ASSERT_EQUAL(write_and_open(t, &int_str_codec, &s), CDC_STATUS_OK);
+
+  int key = 0;
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_count(s, &key, sizeof(key)), 1);
+  key = 1;
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_count(s, &key, sizeof(key)), 1);
+  key = 2;
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_count(s, &key, sizeof(key)), 0);
+  // The size is a part of the key.
+  key = 0;
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_count(s, &key, sizeof(key) - 1), 0);
+  cdc_hash_snapshot_dtor(s);
+  cdc_hash_table_dtor(t);
+  remove(snapshot_path);
+}
+
+void test_hash_snapshot_find()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctorl(&t, &info, &a, &b, &c, CDC_END),
+                  CDC_STATUS_OK);
+  struct cdc_hash_snapshot *s = NULL;
+  CU_ASSERT_EQUAL(write_and_open(t, &int_str_codec, &s), CDC_STATUS_OK);
+
+  struct cdc_hash_snapshot_iter it = CDC_INIT_STRUCT;
+  struct cdc_hash_snapshot_iter end = CDC_INIT_STRUCT;
+  cdc_hash_snapshot_end(s, &end);
+  int key = 2;
+  cdc_hash_snapshot_find(s, &key, sizeof(key), &it);
+  CU_ASSERT(!cdc_hash_snapshot_iter_is_eq(&it, &end));
+
+  size_t size = 0;
+  const void *tmp = cdc_hash_snapshot_iter_key(&it, &size);
+  CU_ASSERT_EQUAL(size, sizeof(int));
+  CU_ASSERT_EQUAL(memcmp(tmp, &key, sizeof(key)), 0);
+  tmp = cdc_hash_snapshot_iter_value(&it, &size);
+  CU_ASSERT_EQUAL(size, 3);
+  CU_ASSERT_EQUAL(memcmp(tmp, "two", 3), 0);
+
+  key = 10;
+  cdc_hash_snapshot_find(s, &key, sizeof(key), &it);
+  CU_ASSERT(cdc_hash_snapshot_iter_is_eq(&it, &end));
+  cdc_hash_snapshot_dtor(s);
+  cdc_hash_table_dtor(t);
+  remove(snapshot_path);
+}
+
+void test_hash_snapshot_iterators()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(
+      cdc_hash_table_ctorl(&t, &info, &a, &b, &c, &d, &e, CDC_END),
+      CDC_STATUS_OK);
+  struct cdc_hash_snapshot *s = NULL;
+  CU_ASSERT_EQUAL(write_and_open(t, &int_str_codec, &s), CDC_STATUS_OK);
+
+  struct cdc_hash_snapshot_iter it = CDC_INIT_STRUCT;
+  cdc_hash_snapshot_begin(s, &it);
+  int sum = 0;
+  size_t count = 0;
+  for (; cdc_hash_snapshot_iter_has_next(&it);
+       cdc_hash_snapshot_iter_next(&it)) {
+    int key = 0;
+    memcpy(&key, cdc_hash_snapshot_iter_key(&it, NULL), sizeof(key));
+    sum += key;
+    ++count;
+  }
+
+  CU_ASSERT_EQUAL(count, 5);
+  CU_ASSERT_EQUAL(sum, 0 + 1 + 2 + 3 + 4);
+  cdc_hash_snapshot_dtor(s);
+  cdc_hash_table_dtor(t);
+  remove(snapshot_path);
+}
+
+void test_hash_snapshot_string_keys()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = str_eq;
+  info.hash = str_hash;
+  struct cdc_pair x = {"alpha", CDC_FROM_INT(1)};
+  struct cdc_pair y = {"beta", CDC_FROM_INT(2)};
+  struct cdc_pair z = {"gamma", CDC_FROM_INT(3)};
+  struct cdc_hash_snapshot_codec codec = {0,           str_size_of, str_write,
+                                          sizeof(int), NULL,        int_write};
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctorl(&t, &info, &x, &y, &z, CDC_END),
+                  CDC_STATUS_OK);
+  struct cdc_hash_snapshot *s = NULL;
+  CU_ASSERT_EQUAL(write_and_open(t, &codec, &s), CDC_STATUS_OK);
+
+  const void *value = NULL;
+  size_t size = 0;
+  int tmp = 0;
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_get(s, "beta", 4, &value, &size),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(size, sizeof(int));
+  memcpy(&tmp, value, sizeof(tmp));
+  CU_ASSERT_EQUAL(tmp, 2);
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_get(s, "gamma", 5, &value, NULL),
+                  CDC_STATUS_OK);
+  memcpy(&tmp, value, sizeof(tmp));
+  CU_ASSERT_EQUAL(tmp, 3);
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_count(s, "alpha", 5), 1);
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_count(s, "alph", 4), 0);
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_count(s, "delta", 5), 0);
+  cdc_hash_snapshot_dtor(s);
+  cdc_hash_table_dtor(t);
+  remove(snapshot_path);
+}
+
+void test_hash_snapshot_empty()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  struct cdc_hash_snapshot *s = NULL;
+  CU_ASSERT_EQUAL(write_and_open(t, &int_str_codec, &s), CDC_STATUS_OK);
+  CU_ASSERT(cdc_hash_snapshot_empty(s));
+
+  int key = 0;
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_count(s, &key, sizeof(key)), 0);
+
+  struct cdc_hash_snapshot_iter it = CDC_INIT_STRUCT;
+  cdc_hash_snapshot_begin(s, &it);
+  CU_ASSERT(!cdc_hash_snapshot_iter_has_next(&it));
+  cdc_hash_snapshot_dtor(s);
+  cdc_hash_table_dtor(t);
+  remove(snapshot_path);
+}
+
+void test_hash_snapshot_many()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  struct cdc_hash_snapshot_codec codec = {sizeof(int), NULL, int_write,
+                                          sizeof(int), NULL, int_write};
+  const int count = 1000;
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < count; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_table_insert(t, CDC_FROM_INT(i),
+                                          CDC_FROM_INT(i * 2), NULL, NULL),
+                    CDC_STATUS_OK);
+  }
+
+  struct cdc_hash_snapshot *s = NULL;
+  CU_ASSERT_EQUAL(write_and_open(t, &codec, &s), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_size(s), (size_t)count);
+
+  bool found = true;
+  for (int i = 0; i < count; ++i) {
+    const void *value = NULL;
+    int tmp = 0;
+    if (cdc_hash_snapshot_get(s, &i, sizeof(i), &value, NULL) !=
+        CDC_STATUS_OK) {
+      found = false;
+      break;
+    }
+
+    memcpy(&tmp, value, sizeof(tmp));
+    found = found && tmp == i * 2;
+  }
+
+  CU_ASSERT(found);
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_count(s, &count, sizeof(count)), 0);
+  cdc_hash_snapshot_dtor(s);
+  cdc_hash_table_dtor(t);
+  remove(snapshot_path);
+}
+
+void test_hash_snapshot_bad_file()
+{
+  struct cdc_hash_snapshot *s = NULL;
+
+  remove(snapshot_path);
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_ctor(&s, snapshot_path),
+                  CDC_STATUS_IO_ERROR);
+
+  FILE *file = fopen(snapshot_path, "wb");
+  for (int i = 0; i < 64; ++i) {
+    fputs("not a snapshot", file);
+  }
+
+  fclose(file);
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_ctor(&s, snapshot_path),
+                  CDC_STATUS_BAD_FORMAT);
+
+  file = fopen(snapshot_path, "wb");
+  fputs("short", file);
+  fclose(file);
+  CU_ASSERT_EQUAL(cdc_hash_snapshot_ctor(&s, snapshot_path),
+                  CDC_STATUS_BAD_FORMAT);
+  remove(snapshot_path);
+}
@@ -21,12 +21,16 @@
 #include "test-common.h"
 
 #include "cdcontainers/casts.h"
+#include "cdcontainers/global.h"
 #include "cdcontainers/hash-table.h"
 
 #include <assert.h>
 #include <float.h>
+#include <pthread.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include <CUnit/Basic.h>
 
@@ -393,3 +397,576 @@ void test_hash_table_reserve()
                      cdc_hash_table_max_load_factor(t)) >= count);
   cdc_hash_table_dtor(t);
 }
+
+void test_hash_table_incremental_rehash()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_hash_table_iter it = CDC_INIT_STRUCT;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  void *value = NULL;
+  bool rehashing = false;
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  cdc_hash_table_set_rehash_step(t, 2);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_hash_table_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL, NULL),
+        CDC_STATUS_OK);
+    if (cdc_hash_table_is_rehashing(t)) {
+      rehashing = true;
+      CU_ASSERT_EQUAL(cdc_hash_table_get(t, CDC_FROM_INT(0), &value),
+                      CDC_STATUS_OK);
+      CU_ASSERT_EQUAL(cdc_hash_table_get(t, CDC_FROM_INT(i), &value),
+                      CDC_STATUS_OK);
+    }
+  }
+
+  CU_ASSERT(rehashing);
+  CU_ASSERT_EQUAL(cdc_hash_table_size(t), kCount);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_table_get(t, CDC_FROM_INT(i), &value),
+                    CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(CDC_TO_INT(value), i);
+  }
+
+  size_t count = 0;
+  int sum = 0;
+  for (cdc_hash_table_begin(t, &it); cdc_hash_table_iter_has_next(&it);
+       cdc_hash_table_iter_next(&it)) {
+    sum += CDC_TO_INT(cdc_hash_table_iter_key(&it));
+    ++count;
+  }
+
+  CU_ASSERT_EQUAL(count, kCount);
+  CU_ASSERT_EQUAL(sum, kCount * (kCount - 1) / 2);
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(cdc_hash_table_erase(t, CDC_FROM_INT(i)), 1);
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_table_size(t), kCount / 2);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_table_count(t, CDC_FROM_INT(i)), (size_t)(i % 2));
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_table_rehash(t, 0), CDC_STATUS_OK);
+  CU_ASSERT(!cdc_hash_table_is_rehashing(t));
+  CU_ASSERT_EQUAL(cdc_hash_table_size(t), kCount / 2);
+  cdc_hash_table_clear(t);
+  CU_ASSERT(cdc_hash_table_empty(t));
+  cdc_hash_table_dtor(t);
+}
+
+void test_hash_table_seed()
+{
+  struct cdc_hash_table *t = NULL;
+  const int kCount = 100;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  void *value = NULL;
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_table_insert(t, CDC_FROM_INT(i * 64),
+                                          CDC_FROM_INT(i), NULL, NULL),
+                    CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_table_set_seed(t, cdc_hash_random_seed()),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_table_size(t), kCount);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_table_get(t, CDC_FROM_INT(i * 64), &value),
+                    CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(CDC_TO_INT(value), i);
+    CU_ASSERT_EQUAL(cdc_hash_table_count(t, CDC_FROM_INT(i * 64 + 1)), 0);
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_table_erase(t, CDC_FROM_INT(0)), 1);
+  CU_ASSERT_EQUAL(cdc_hash_table_size(t), kCount - 1);
+  cdc_hash_table_dtor(t);
+}
+
+static size_t hash_calls = 0;
+
+static size_t counting_hash(const void *val)
+{
+  ++hash_calls;
+  return hash(val);
+}
+
+void test_hash_table_hashed()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_hash_table_iter it = CDC_INIT_STRUCT;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = counting_hash;
+  void *value = NULL;
+  bool inserted = false;
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  hash_calls = 0;
+  CU_ASSERT_EQUAL(cdc_hash_table_insert(t, c.first, c.second, NULL, NULL),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(hash_calls, 1);
+  CU_ASSERT_EQUAL(cdc_hash_table_erase(t, c.first), 1);
+  CU_ASSERT_EQUAL(hash_calls, 2);
+
+  hash_calls = 0;
+  CU_ASSERT_EQUAL(cdc_hash_table_insert_hashed(t, b.first, hash(b.first),
+                                               b.second, &it, &inserted),
+                  CDC_STATUS_OK);
+  CU_ASSERT(inserted);
+  CU_ASSERT_EQUAL(cdc_hash_table_iter_value(&it), b.second);
+  CU_ASSERT_EQUAL(cdc_hash_table_insert_or_assign_hashed(
+                      t, b.first, hash(b.first), c.second, NULL, &inserted),
+                  CDC_STATUS_OK);
+  CU_ASSERT(!inserted);
+  CU_ASSERT_EQUAL(cdc_hash_table_get_hashed(t, b.first, hash(b.first), &value),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(value, c.second);
+  cdc_hash_table_find_hashed(t, b.first, hash(b.first), &it);
+  CU_ASSERT_EQUAL(cdc_hash_table_iter_key(&it), b.first);
+  CU_ASSERT_EQUAL(cdc_hash_table_erase_hashed(t, b.first, hash(b.first)), 1);
+  CU_ASSERT_EQUAL(cdc_hash_table_erase_hashed(t, b.first, hash(b.first)), 0);
+  CU_ASSERT_EQUAL(hash_calls, 0);
+  CU_ASSERT(cdc_hash_table_empty(t));
+  cdc_hash_table_dtor(t);
+}
+
+void test_hash_table_get_many()
+{
+  struct cdc_hash_table *t = NULL;
+  const int kCount = 100;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  void *keys[2 * 100];
+  void *values[2 * 100];
+  bool found[2 * 100];
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_hash_table_insert(t, CDC_FROM_INT(i),
+                                          CDC_FROM_INT(i + 1), NULL, NULL),
+                    CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < 2 * kCount; ++i) {
+    keys[i] = CDC_FROM_INT(2 * kCount - 1 - i);
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_table_get_many(t, keys, 2 * kCount, values, found),
+                  (size_t)kCount);
+  for (int i = 0; i < 2 * kCount; ++i) {
+    int key = CDC_TO_INT(keys[i]);
+    CU_ASSERT_EQUAL(found[i], key < kCount);
+    CU_ASSERT_EQUAL(CDC_TO_INT(values[i]), key < kCount ? key + 1 : 0);
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_table_get_many(t, keys, 0, values, NULL), 0);
+  cdc_hash_table_dtor(t);
+}
+
+void test_hash_table_stats()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_hash_table_stats stats;
+  const int kCount = 100;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  cdc_hash_table_stats(t, &stats);
+  CU_ASSERT_EQUAL(stats.size, 0);
+  CU_ASSERT_EQUAL(stats.used_buckets, 0);
+  CU_ASSERT_EQUAL(stats.chains[0], stats.bucket_count);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_hash_table_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL, NULL),
+        CDC_STATUS_OK);
+  }
+
+  cdc_hash_table_stats(t, &stats);
+  CU_ASSERT_EQUAL(stats.size, (size_t)kCount);
+  CU_ASSERT_EQUAL(stats.bucket_count, cdc_hash_table_bucket_count(t));
+  CU_ASSERT(stats.max_chain >= 1);
+  size_t buckets = 0;
+  size_t elements = 0;
+  for (size_t i = 0; i < CDC_HASH_TABLE_STATS_CHAINS; ++i) {
+    buckets += stats.chains[i];
+    elements += i * stats.chains[i];
+  }
+
+  CU_ASSERT_EQUAL(buckets, stats.bucket_count);
+  CU_ASSERT_EQUAL(stats.bucket_count - stats.chains[0], stats.used_buckets);
+  if (stats.max_chain < CDC_HASH_TABLE_STATS_CHAINS - 1) {
+    CU_ASSERT_EQUAL(elements, (size_t)kCount);
+  }
+
+#ifdef CDC_HASH_TABLE_STATS
+  CU_ASSERT(stats.rehashes > 0);
+  CU_ASSERT_EQUAL(stats.lookups, (size_t)kCount);
+  CU_ASSERT(stats.avg_probe_length >= 0.0);
+#else
+  CU_ASSERT_EQUAL(stats.rehashes, 0);
+  CU_ASSERT_EQUAL(stats.lookups, 0);
+#endif
+  cdc_hash_table_reset_stats(t);
+  cdc_hash_table_stats(t, &stats);
+  CU_ASSERT_EQUAL(stats.rehashes, 0);
+  CU_ASSERT_EQUAL(stats.lookups, 0);
+  cdc_hash_table_dtor(t);
+}
+
+#define STATS_THREADS 4
+#define STATS_LOOKUPS 10000
+
+struct stats_reader {
+  struct cdc_hash_table *t;
+  int keys;
+  size_t failures;
+};
+
+static void *stats_read(void *ptr)
+{
+  struct stats_reader *arg = (struct stats_reader *)ptr;
+  void *value = NULL;
+  for (int i = 0; i < STATS_LOOKUPS; ++i) {
+    int key = i % arg->keys;
+    if (cdc_hash_table_get(arg->t, CDC_FROM_INT(key), &value) !=
+            CDC_STATUS_OK ||
+        CDC_TO_INT(value) != key) {
+      ++arg->failures;
+    }
+  }
+
+  return NULL;
+}
+
+void test_hash_table_stats_threads()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_hash_table_stats stats;
+  struct stats_reader args[STATS_THREADS];
+  pthread_t threads[STATS_THREADS];
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_hash_table_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL, NULL),
+        CDC_STATUS_OK);
+  }
+
+  cdc_hash_table_reset_stats(t);
+  for (int i = 0; i < STATS_THREADS; ++i) {
+    args[i].t = t;
+    args[i].keys = kCount;
+    args[i].failures = 0;
+    CU_ASSERT_EQUAL(pthread_create(&threads[i], NULL, stats_read, &args[i]),
+                    0);
+  }
+
+  for (int i = 0; i < STATS_THREADS; ++i) {
+    CU_ASSERT_EQUAL(pthread_join(threads[i], NULL), 0);
+    CU_ASSERT_EQUAL(args[i].failures, 0);
+  }
+
+  cdc_hash_table_stats(t, &stats);
+#ifdef CDC_HASH_TABLE_STATS
+  CU_ASSERT_EQUAL(stats.lookups, (size_t)STATS_THREADS * STATS_LOOKUPS);
+  CU_ASSERT(stats.probes >= stats.lookups);
+#else
+  CU_ASSERT_EQUAL(stats.lookups, 0);
+#endif
+  cdc_hash_table_dtor(t);
+}
+
+static size_t freed_pairs = 0;
+
+static void count_free(void *pair)
+{
+  CDC_UNUSED(pair);
+  ++freed_pairs;
+}
+
+void test_hash_table_ctor_from()
+{
+  struct cdc_hash_table *t = NULL;
+  const int kCount = 100;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  void *keys[100 + 1];
+  void *values[100 + 1];
+
+  for (int i = 0; i < kCount; ++i) {
+    keys[i] = CDC_FROM_INT(i);
+    values[i] = CDC_FROM_INT(i + 1);
+  }
+
+  // The first pair with a key is kept.
+  keys[kCount] = CDC_FROM_INT(5);
+  values[kCount] = CDC_FROM_INT(-1);
+  CU_ASSERT_EQUAL(
+      cdc_hash_table_ctor_from(&t, &info, keys, values, kCount + 1),
+      CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_table_size(t), (size_t)kCount);
+  bool all_found = true;
+  for (int i = 0; i < kCount; ++i) {
+    void *value = NULL;
+    all_found = all_found &&
+                cdc_hash_table_get(t, CDC_FROM_INT(i), &value) ==
+                    CDC_STATUS_OK &&
+                CDC_TO_INT(value) == i + 1;
+  }
+
+  CU_ASSERT(all_found);
+  CU_ASSERT_EQUAL(cdc_hash_table_erase(t, CDC_FROM_INT(0)), 1);
+  CU_ASSERT_EQUAL(cdc_hash_table_insert(t, CDC_FROM_INT(kCount),
+                                        CDC_FROM_INT(0), NULL, NULL),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_table_size(t), (size_t)kCount);
+  cdc_hash_table_clear(t);
+  CU_ASSERT(cdc_hash_table_empty(t));
+  CU_ASSERT(hash_table_key_int_eq(t, 0));
+  cdc_hash_table_dtor(t);
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor_from(&t, &info, NULL, NULL, 0),
+                  CDC_STATUS_OK);
+  CU_ASSERT(cdc_hash_table_empty(t));
+  cdc_hash_table_dtor(t);
+}
+
+void test_hash_table_insert_range()
+{
+  struct cdc_hash_table *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  info.dfree = count_free;
+  void *keys[] = {CDC_FROM_INT(1), CDC_FROM_INT(2), CDC_FROM_INT(3),
+                  CDC_FROM_INT(3), CDC_FROM_INT(4)};
+  void *values[] = {CDC_FROM_INT(10), CDC_FROM_INT(2), CDC_FROM_INT(3),
+                    CDC_FROM_INT(30), CDC_FROM_INT(4)};
+
+  // Entries allocated one by one.
+  freed_pairs = 0;
+  CU_ASSERT_EQUAL(cdc_hash_table_ctorl(&t, &info, &a, &b, CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(
+      cdc_hash_table_insert_range(t, keys, values, CDC_ARRAY_SIZE(keys)),
+      CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_table_size(t), 5);
+  CU_ASSERT(hash_table_key_int_eq(t, 5, &a, &b, &c, &d, &e));
+  cdc_hash_table_dtor(t);
+  CU_ASSERT_EQUAL(freed_pairs, 5);
+
+  // Entries allocated from a node pool.
+  freed_pairs = 0;
+  info.pool_chunk = 2;
+  CU_ASSERT_EQUAL(cdc_hash_table_ctorl(&t, &info, &a, &b, CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(
+      cdc_hash_table_insert_range(t, keys, values, CDC_ARRAY_SIZE(keys)),
+      CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_table_size(t), 5);
+  CU_ASSERT(hash_table_key_int_eq(t, 5, &a, &b, &c, &d, &e));
+  CU_ASSERT_EQUAL(cdc_hash_table_erase(t, CDC_FROM_INT(3)), 1);
+  CU_ASSERT_EQUAL(cdc_hash_table_insert(t, CDC_FROM_INT(7), CDC_FROM_INT(7),
+                                        NULL, NULL),
+                  CDC_STATUS_OK);
+  CU_ASSERT(hash_table_key_int_eq(t, 5, &a, &b, &c, &e, &h));
+  cdc_hash_table_dtor(t);
+  CU_ASSERT_EQUAL(freed_pairs, 6);
+}
+
+void test_hash_table_bulk_threads()
+{
+  struct cdc_hash_table *t = NULL;
+  const size_t kCount = 200000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  void **keys = (void **)malloc(kCount * sizeof(void *));
+  void **values = (void **)malloc(kCount * sizeof(void *));
+  for (size_t i = 0; i < kCount; ++i) {
+    keys[i] = CDC_FROM_SIZE(i);
+    values[i] = CDC_FROM_SIZE(i * 2);
+  }
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  cdc_hash_table_set_bulk_threads(t, 4);
+  CU_ASSERT_EQUAL(cdc_hash_table_insert_range(t, keys, values, kCount),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_hash_table_size(t), kCount);
+  CU_ASSERT(cdc_hash_table_load_factor(t) <=
+            cdc_hash_table_max_load_factor(t));
+  bool all_found = true;
+  for (size_t i = 0; i < kCount; ++i) {
+    void *value = NULL;
+    all_found = all_found &&
+                cdc_hash_table_get(t, keys[i], &value) == CDC_STATUS_OK &&
+                CDC_TO_SIZE(value) == i * 2;
+  }
+
+  CU_ASSERT(all_found);
+  cdc_hash_table_dtor(t);
+  free(values);
+  free(keys);
+}
+
+struct scan_state {
+  int visits[1000];
+};
+
+static bool count_visit(void *key, void *value, void *ctx)
+{
+  CDC_UNUSED(value);
+  struct scan_state *state = (struct scan_state *)ctx;
+  int i = CDC_TO_INT(key);
+  if (i >= 0 && i < 1000) {
+    ++state->visits[i];
+  }
+
+  return false;
+}
+
+static bool erase_even(void *key, void *value, void *ctx)
+{
+  CDC_UNUSED(value);
+  CDC_UNUSED(ctx);
+  return CDC_TO_INT(key) % 2 == 0;
+}
+
+void test_hash_table_scan()
+{
+  struct cdc_hash_table *t = NULL;
+  const int kCount = 500;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  struct scan_state state;
+  memset(&state, 0, sizeof(state));
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_hash_table_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL, NULL),
+        CDC_STATUS_OK);
+  }
+
+  size_t cursor = 0;
+  size_t calls = 0;
+  do {
+    cursor = cdc_hash_table_scan(t, cursor, count_visit, &state, 1);
+    ++calls;
+  } while (cursor != 0);
+
+  CU_ASSERT(calls > 1);
+  bool exactly_once = true;
+  for (int i = 0; i < kCount; ++i) {
+    exactly_once = exactly_once && state.visits[i] == 1;
+  }
+
+  CU_ASSERT(exactly_once);
+  memset(&state, 0, sizeof(state));
+  CU_ASSERT_EQUAL(
+      cdc_hash_table_scan(t, 0, count_visit, &state, (size_t)kCount * 2), 0);
+  exactly_once = true;
+  for (int i = 0; i < kCount; ++i) {
+    exactly_once = exactly_once && state.visits[i] == 1;
+  }
+
+  CU_ASSERT(exactly_once);
+  cdc_hash_table_dtor(t);
+}
+
+static void scan_with_growth(size_t rehash_step)
+{
+  struct cdc_hash_table *t = NULL;
+  const int kCount = 100;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  struct scan_state state;
+  memset(&state, 0, sizeof(state));
+
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  cdc_hash_table_set_rehash_step(t, rehash_step);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_hash_table_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL, NULL),
+        CDC_STATUS_OK);
+  }
+
+  // The keys inserted during the scan are not checked.
+  size_t cursor = 0;
+  int next_key = 1000;
+  do {
+    cursor = cdc_hash_table_scan(t, cursor, count_visit, &state, 2);
+    for (int i = 0; i < 20; ++i, ++next_key) {
+      cdc_hash_table_insert(t, CDC_FROM_INT(next_key), NULL, NULL, NULL);
+    }
+  } while (cursor != 0);
+
+  CU_ASSERT(cdc_hash_table_bucket_count(t) > 256);
+  bool at_least_once = true;
+  for (int i = 0; i < kCount; ++i) {
+    at_least_once = at_least_once && state.visits[i] >= 1;
+  }
+
+  CU_ASSERT(at_least_once);
+  cdc_hash_table_dtor(t);
+}
+
+void test_hash_table_scan_rehash()
+{
+  scan_with_growth(0);
+  scan_with_growth(1);
+}
+
+void test_hash_table_scan_erase()
+{
+  struct cdc_hash_table *t = NULL;
+  const int kCount = 300;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.eq = eq;
+  info.hash = hash;
+  info.dfree = count_free;
+
+  freed_pairs = 0;
+  CU_ASSERT_EQUAL(cdc_hash_table_ctor(&t, &info), CDC_STATUS_OK);
+  cdc_hash_table_set_rehash_step(t, 1);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_hash_table_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL, NULL),
+        CDC_STATUS_OK);
+  }
+
+  size_t cursor = 0;
+  do {
+    cursor = cdc_hash_table_scan(t, cursor, erase_even, NULL, 3);
+  } while (cursor != 0);
+
+  CU_ASSERT_EQUAL(cdc_hash_table_size(t), (size_t)kCount / 2);
+  CU_ASSERT_EQUAL(freed_pairs, (size_t)kCount / 2);
+  bool only_odd = true;
+  for (int i = 0; i < kCount; ++i) {
+    only_odd = only_odd &&
+               cdc_hash_table_count(t, CDC_FROM_INT(i)) == (size_t)(i % 2);
+  }
+
+  CU_ASSERT(only_odd);
+  cdc_hash_table_dtor(t);
+  CU_ASSERT_EQUAL(freed_pairs, (size_t)kCount);
+}
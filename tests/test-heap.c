@@ -35,6 +35,11 @@ static int gt(const void *a, const void *b)
   return CDC_TO_INT(a) > CDC_TO_INT(b);
 }
 
+static int cmp_int(const void *l, const void *r)
+{
+  return (CDC_TO_INT(l) > CDC_TO_INT(r)) - (CDC_TO_INT(l) < CDC_TO_INT(r));
+}
+
 static inline void heap_int_print(struct cdc_heap *h)
 {
   for (size_t i = 0; i < cdc_heap_size(h); ++i) {
@@ -210,3 +215,25 @@ void test_heap_swap()
   cdc_heap_dtor(v);
   cdc_heap_dtor(w);
 }
+
+void test_heap_cmp3()
+{
+  struct cdc_heap *h = NULL;
+  const int kCount = 100;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp3 = cmp_int;
+
+  CU_ASSERT_EQUAL(cdc_heap_ctor(&h, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_heap_insert(h, CDC_FROM_INT((i * 37) % kCount)),
+                    CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(CDC_TO_INT(cdc_heap_top(h)), i);
+    cdc_heap_extract_top(h);
+  }
+
+  CU_ASSERT(cdc_heap_empty(h));
+  cdc_heap_dtor(h);
+}
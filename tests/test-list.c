@@ -22,10 +22,12 @@
 
 #include "cdcontainers/casts.h"
 #include "cdcontainers/common.h"
+#include "cdcontainers/global.h"
 #include "cdcontainers/list.h"
 
 #include <float.h>
 #include <stdarg.h>
+#include <stdlib.h>
 
 #include <CUnit/Basic.h>
 
@@ -65,6 +67,11 @@ static int lt(const void *l, const void *r)
   return CDC_TO_INT(l) < CDC_TO_INT(r);
 }
 
+static int cmp_int(const void *l, const void *r)
+{
+  return (CDC_TO_INT(l) > CDC_TO_INT(r)) - (CDC_TO_INT(l) < CDC_TO_INT(r));
+}
+
 static int eq(const void *l, const void *r)
 {
   return CDC_TO_INT(l) == CDC_TO_INT(r);
@@ -798,3 +805,132 @@ void test_list_sort()
   CU_ASSERT(list_range_int_eq(l, 3, b, a, c));
   cdc_list_dtor(l);
 }
+
+void test_list_pool()
+{
+  struct cdc_list *l1 = NULL;
+  struct cdc_list *l2 = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.pool_chunk = 4;
+  int a = 0, b = 1, c = 2, d = 3, e = 4, f = 5, g = 6, h = 7;
+
+  CU_ASSERT_EQUAL(cdc_list_ctorl(&l1, &info, CDC_FROM_INT(a), CDC_FROM_INT(c),
+                                 CDC_FROM_INT(e), CDC_FROM_INT(g), CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_list_ctorl(&l2, &info, CDC_FROM_INT(b), CDC_FROM_INT(d),
+                                 CDC_FROM_INT(f), CDC_FROM_INT(h), CDC_END),
+                  CDC_STATUS_OK);
+
+  cdc_list_pop_front(l1);
+  cdc_list_erase(l1, 1);
+  CU_ASSERT(list_range_int_eq(l1, 2, c, g));
+  CU_ASSERT_EQUAL(cdc_list_push_front(l1, CDC_FROM_INT(a)), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_list_insert(l1, 2, CDC_FROM_INT(e)), CDC_STATUS_OK);
+  CU_ASSERT(list_range_int_eq(l1, 4, a, c, e, g));
+
+  cdc_list_merge(l1, l2);
+  CU_ASSERT_EQUAL(cdc_list_size(l2), 0);
+  CU_ASSERT(list_range_int_eq(l1, 8, a, b, c, d, e, f, g, h));
+
+  cdc_list_swap(l1, l2);
+  CU_ASSERT_EQUAL(cdc_list_size(l1), 0);
+  CU_ASSERT(list_range_int_eq(l2, 8, a, b, c, d, e, f, g, h));
+
+  cdc_list_clear(l2);
+  CU_ASSERT_EQUAL(cdc_list_size(l2), 0);
+  for (int i = 0; i < 100; ++i) {
+    CU_ASSERT_EQUAL(cdc_list_push_back(l2, CDC_FROM_INT(i)), CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_list_size(l2), 100);
+  CU_ASSERT_EQUAL(CDC_TO_INT(cdc_list_back(l2)), 99);
+
+  struct cdc_list_iter it = CDC_INIT_STRUCT;
+  cdc_list_begin(l1, &it);
+  cdc_list_lsplice(&it, l2);
+  CU_ASSERT_EQUAL(cdc_list_size(l1), 100);
+  CU_ASSERT_EQUAL(cdc_list_size(l2), 0);
+  CU_ASSERT_EQUAL(CDC_TO_INT(cdc_list_front(l1)), 0);
+
+  cdc_list_dtor(l2);
+  CU_ASSERT_EQUAL(CDC_TO_INT(cdc_list_back(l1)), 99);
+  cdc_list_dtor(l1);
+}
+
+static void *counting_alloc(size_t size, void *ctx)
+{
+  ++*(size_t *)ctx;
+  return malloc(size);
+}
+
+static void plain_free(void *ptr, void *ctx)
+{
+  CDC_UNUSED(ctx);
+  free(ptr);
+}
+
+void test_list_pool_free_nodes()
+{
+  struct cdc_list *l1 = NULL;
+  struct cdc_list *l2 = NULL;
+  size_t allocs = 0;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.pool_chunk = 4;
+  info.allocator.allocate = counting_alloc;
+  info.allocator.deallocate = plain_free;
+  info.allocator.ctx = &allocs;
+
+  CU_ASSERT_EQUAL(cdc_list_ctor(&l1, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_list_ctor(&l2, &info), CDC_STATUS_OK);
+  for (int i = 0; i < 4; ++i) {
+    CU_ASSERT_EQUAL(cdc_list_push_back(l1, CDC_FROM_INT(2 * i)),
+                    CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(cdc_list_push_back(l2, CDC_FROM_INT(2 * i + 1)),
+                    CDC_STATUS_OK);
+  }
+
+  // Both lists have two free nodes and no room in their chunks.
+  cdc_list_pop_back(l1);
+  cdc_list_pop_back(l1);
+  cdc_list_pop_back(l2);
+  cdc_list_pop_back(l2);
+  cdc_list_merge(l1, l2);
+  CU_ASSERT(list_range_int_eq(l1, 4, 0, 1, 2, 3));
+
+  // The free nodes of both lists are reused without new chunks.
+  size_t before = allocs;
+  for (int i = 4; i < 8; ++i) {
+    CU_ASSERT_EQUAL(cdc_list_push_back(l1, CDC_FROM_INT(i)), CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(allocs, before);
+  CU_ASSERT(list_range_int_eq(l1, 8, 0, 1, 2, 3, 4, 5, 6, 7));
+  cdc_list_dtor(l2);
+  cdc_list_dtor(l1);
+}
+
+void test_list_cmp3()
+{
+  struct cdc_list *l = NULL;
+  struct cdc_list *w = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp3 = cmp_int;
+
+  CU_ASSERT_EQUAL(cdc_list_ctorl(&l, &info, CDC_FROM_INT(4), CDC_FROM_INT(1),
+                                 CDC_FROM_INT(3), CDC_FROM_INT(2), CDC_END),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_list_ctorl(&w, &info, CDC_FROM_INT(5), CDC_FROM_INT(0),
+                                 CDC_END),
+                  CDC_STATUS_OK);
+  cdc_list_sort(l);
+  CU_ASSERT(list_range_int_eq(l, 4, 1, 2, 3, 4));
+  cdc_list_sort(w);
+  CU_ASSERT(list_range_int_eq(w, 2, 0, 5));
+  cdc_list_merge(l, w);
+  CU_ASSERT(list_range_int_eq(l, 6, 0, 1, 2, 3, 4, 5));
+  CU_ASSERT(cdc_list_empty(w));
+  cdc_list_dtor(w);
+  cdc_list_dtor(l);
+}
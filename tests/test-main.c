@@ -41,7 +41,8 @@ int main(int argc, char** argv)
   }
 
   if (CU_add_test(p_suite, "ptr_float_cast", test_ptr_float_cast) == NULL ||
-      CU_add_test(p_suite, "ptr_double_cast", test_ptr_double_cast) == NULL) {
+      CU_add_test(p_suite, "ptr_double_cast", test_ptr_double_cast) == NULL ||
+      CU_add_test(p_suite, "allocator", test_allocator) == NULL) {
     CU_cleanup_registry();
     return CU_get_error();
   }
@@ -103,7 +104,11 @@ int main(int argc, char** argv)
       CU_add_test(p_suite, "test_erase_if", test_list_erase_if) == NULL ||
       CU_add_test(p_suite, "test_reverse", test_list_reverse) == NULL ||
       CU_add_test(p_suite, "test_unique", test_list_unique) == NULL ||
-      CU_add_test(p_suite, "test_sort", test_list_sort) == NULL) {
+      CU_add_test(p_suite, "test_sort", test_list_sort) == NULL ||
+      CU_add_test(p_suite, "test_pool", test_list_pool) == NULL ||
+      CU_add_test(p_suite, "test_pool_free_nodes",
+                  test_list_pool_free_nodes) == NULL ||
+      CU_add_test(p_suite, "test_cmp3", test_list_cmp3) == NULL) {
     CU_cleanup_registry();
     return CU_get_error();
   }
@@ -209,7 +214,8 @@ int main(int argc, char** argv)
       CU_add_test(p_suite, "test_insert", test_heap_insert) == NULL ||
       CU_add_test(p_suite, "test_change_key", test_heap_change_key) == NULL ||
       CU_add_test(p_suite, "test_merge", test_heap_merge) == NULL ||
-      CU_add_test(p_suite, "test_swap", test_heap_swap) == NULL) {
+      CU_add_test(p_suite, "test_swap", test_heap_swap) == NULL ||
+      CU_add_test(p_suite, "test_cmp3", test_heap_cmp3) == NULL) {
     CU_cleanup_registry();
     return CU_get_error();
   }
@@ -290,7 +296,19 @@ int main(int argc, char** argv)
                   test_treap_insert_or_assign) == NULL ||
       CU_add_test(p_suite, "test_erase", test_treap_erase) == NULL ||
       CU_add_test(p_suite, "test_iterators", test_treap_iterators) == NULL ||
-      CU_add_test(p_suite, "test_height", test_treap_height) == NULL) {
+      CU_add_test(p_suite, "test_height", test_treap_height) == NULL ||
+      CU_add_test(p_suite, "test_pool", test_treap_pool) == NULL ||
+      CU_add_test(p_suite, "test_cmp3", test_treap_cmp3) == NULL ||
+      CU_add_test(p_suite, "test_rank_select", test_treap_rank_select) ==
+          NULL ||
+      CU_add_test(p_suite, "test_bounds", test_treap_bounds) == NULL ||
+      CU_add_test(p_suite, "test_split_join", test_treap_split_join) == NULL ||
+      CU_add_test(p_suite, "test_join_pool", test_treap_join_pool) == NULL ||
+      CU_add_test(p_suite, "test_set_operations", test_treap_set_operations) ==
+          NULL ||
+      CU_add_test(p_suite, "test_union_keeps_a", test_treap_union_keeps_a) ==
+          NULL ||
+      CU_add_test(p_suite, "test_priority", test_treap_priority) == NULL) {
     CU_cleanup_registry();
     return CU_get_error();
   }
@@ -313,7 +331,188 @@ int main(int argc, char** argv)
       CU_add_test(p_suite, "test_erase", test_hash_table_erase) == NULL ||
       CU_add_test(p_suite, "test_swap", test_hash_table_swap) == NULL ||
       CU_add_test(p_suite, "test_rehash", test_hash_table_rehash) == NULL ||
-      CU_add_test(p_suite, "test_reserve", test_hash_table_reserve) == NULL) {
+      CU_add_test(p_suite, "test_reserve", test_hash_table_reserve) == NULL ||
+      CU_add_test(p_suite, "test_incremental_rehash",
+                  test_hash_table_incremental_rehash) == NULL ||
+      CU_add_test(p_suite, "test_seed", test_hash_table_seed) == NULL ||
+      CU_add_test(p_suite, "test_hashed", test_hash_table_hashed) == NULL ||
+      CU_add_test(p_suite, "test_get_many", test_hash_table_get_many) ==
+          NULL ||
+      CU_add_test(p_suite, "test_stats", test_hash_table_stats) == NULL ||
+      CU_add_test(p_suite, "test_stats_threads",
+                  test_hash_table_stats_threads) == NULL ||
+      CU_add_test(p_suite, "test_ctor_from", test_hash_table_ctor_from) ==
+          NULL ||
+      CU_add_test(p_suite, "test_insert_range",
+                  test_hash_table_insert_range) == NULL ||
+      CU_add_test(p_suite, "test_bulk_threads",
+                  test_hash_table_bulk_threads) == NULL ||
+      CU_add_test(p_suite, "test_scan", test_hash_table_scan) == NULL ||
+      CU_add_test(p_suite, "test_scan_rehash", test_hash_table_scan_rehash) ==
+          NULL ||
+      CU_add_test(p_suite, "test_scan_erase", test_hash_table_scan_erase) ==
+          NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  p_suite = CU_add_suite("RH TABLE TESTS", NULL, NULL);
+  if (p_suite == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  if (CU_add_test(p_suite, "test_ctor", test_rh_table_ctor) == NULL ||
+      CU_add_test(p_suite, "test_ctorl", test_rh_table_ctorl) == NULL ||
+      CU_add_test(p_suite, "test_get", test_rh_table_get) == NULL ||
+      CU_add_test(p_suite, "test_count", test_rh_table_count) == NULL ||
+      CU_add_test(p_suite, "test_find", test_rh_table_find) == NULL ||
+      CU_add_test(p_suite, "test_clear", test_rh_table_clear) == NULL ||
+      CU_add_test(p_suite, "test_insert", test_rh_table_insert) == NULL ||
+      CU_add_test(p_suite, "test_insert_or_assign",
+                  test_rh_table_insert_or_assign) == NULL ||
+      CU_add_test(p_suite, "test_erase", test_rh_table_erase) == NULL ||
+      CU_add_test(p_suite, "test_swap", test_rh_table_swap) == NULL ||
+      CU_add_test(p_suite, "test_rehash", test_rh_table_rehash) == NULL ||
+      CU_add_test(p_suite, "test_reserve", test_rh_table_reserve) == NULL ||
+      CU_add_test(p_suite, "test_collisions", test_rh_table_collisions) ==
+          NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  p_suite = CU_add_suite("SWISS TABLE TESTS", NULL, NULL);
+  if (p_suite == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  if (CU_add_test(p_suite, "test_ctor", test_swiss_table_ctor) == NULL ||
+      CU_add_test(p_suite, "test_ctorl", test_swiss_table_ctorl) == NULL ||
+      CU_add_test(p_suite, "test_get", test_swiss_table_get) == NULL ||
+      CU_add_test(p_suite, "test_count", test_swiss_table_count) == NULL ||
+      CU_add_test(p_suite, "test_find", test_swiss_table_find) == NULL ||
+      CU_add_test(p_suite, "test_clear", test_swiss_table_clear) == NULL ||
+      CU_add_test(p_suite, "test_insert", test_swiss_table_insert) == NULL ||
+      CU_add_test(p_suite, "test_insert_or_assign",
+                  test_swiss_table_insert_or_assign) == NULL ||
+      CU_add_test(p_suite, "test_erase", test_swiss_table_erase) == NULL ||
+      CU_add_test(p_suite, "test_swap", test_swiss_table_swap) == NULL ||
+      CU_add_test(p_suite, "test_rehash", test_swiss_table_rehash) == NULL ||
+      CU_add_test(p_suite, "test_reserve", test_swiss_table_reserve) == NULL ||
+      CU_add_test(p_suite, "test_collisions",
+                  test_swiss_table_collisions) == NULL ||
+      CU_add_test(p_suite, "test_erase_reinsert",
+                  test_swiss_table_erase_reinsert) == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  p_suite = CU_add_suite("COMPACT TABLE TESTS", NULL, NULL);
+  if (p_suite == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  if (CU_add_test(p_suite, "test_ctor", test_compact_table_ctor) == NULL ||
+      CU_add_test(p_suite, "test_ctorl", test_compact_table_ctorl) == NULL ||
+      CU_add_test(p_suite, "test_get", test_compact_table_get) == NULL ||
+      CU_add_test(p_suite, "test_count", test_compact_table_count) == NULL ||
+      CU_add_test(p_suite, "test_find", test_compact_table_find) == NULL ||
+      CU_add_test(p_suite, "test_clear", test_compact_table_clear) == NULL ||
+      CU_add_test(p_suite, "test_insert", test_compact_table_insert) == NULL ||
+      CU_add_test(p_suite, "test_insert_or_assign",
+                  test_compact_table_insert_or_assign) == NULL ||
+      CU_add_test(p_suite, "test_erase", test_compact_table_erase) == NULL ||
+      CU_add_test(p_suite, "test_swap", test_compact_table_swap) == NULL ||
+      CU_add_test(p_suite, "test_rehash", test_compact_table_rehash) == NULL ||
+      CU_add_test(p_suite, "test_reserve",
+                  test_compact_table_reserve) == NULL ||
+      CU_add_test(p_suite, "test_collisions",
+                  test_compact_table_collisions) == NULL ||
+      CU_add_test(p_suite, "test_erase_last_moved",
+                  test_compact_table_erase_last_moved) == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  p_suite = CU_add_suite("HASH SET TESTS", NULL, NULL);
+  if (p_suite == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  if (CU_add_test(p_suite, "test_ctor", test_hash_set_ctor) == NULL ||
+      CU_add_test(p_suite, "test_ctorl", test_hash_set_ctorl) == NULL ||
+      CU_add_test(p_suite, "test_insert", test_hash_set_insert) == NULL ||
+      CU_add_test(p_suite, "test_find", test_hash_set_find) == NULL ||
+      CU_add_test(p_suite, "test_erase", test_hash_set_erase) == NULL ||
+      CU_add_test(p_suite, "test_clear", test_hash_set_clear) == NULL ||
+      CU_add_test(p_suite, "test_swap", test_hash_set_swap) == NULL ||
+      CU_add_test(p_suite, "test_reserve", test_hash_set_reserve) == NULL ||
+      CU_add_test(p_suite, "test_iterators", test_hash_set_iterators) == NULL ||
+      CU_add_test(p_suite, "test_union", test_hash_set_union) == NULL ||
+      CU_add_test(p_suite, "test_intersection",
+                  test_hash_set_intersection) == NULL ||
+      CU_add_test(p_suite, "test_difference",
+                  test_hash_set_difference) == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  p_suite = CU_add_suite("FROZEN MAP TESTS", NULL, NULL);
+  if (p_suite == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  if (CU_add_test(p_suite, "test_ctorl", test_frozen_map_ctorl) == NULL ||
+      CU_add_test(p_suite, "test_ctor", test_frozen_map_ctor) == NULL ||
+      CU_add_test(p_suite, "test_find", test_frozen_map_find) == NULL ||
+      CU_add_test(p_suite, "test_iterators",
+                  test_frozen_map_iterators) == NULL ||
+      CU_add_test(p_suite, "test_swap", test_frozen_map_swap) == NULL ||
+      CU_add_test(p_suite, "test_collisions",
+                  test_frozen_map_collisions) == NULL ||
+      CU_add_test(p_suite, "test_dtor", test_frozen_map_dtor) == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  p_suite = CU_add_suite("HASH SNAPSHOT TESTS", NULL, NULL);
+  if (p_suite == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  if (CU_add_test(p_suite, "test_get", test_hash_snapshot_get) == NULL ||
+      CU_add_test(p_suite, "test_count", test_hash_snapshot_count) == NULL ||
+      CU_add_test(p_suite, "test_find", test_hash_snapshot_find) == NULL ||
+      CU_add_test(p_suite, "test_iterators",
+                  test_hash_snapshot_iterators) == NULL ||
+      CU_add_test(p_suite, "test_string_keys",
+                  test_hash_snapshot_string_keys) == NULL ||
+      CU_add_test(p_suite, "test_empty", test_hash_snapshot_empty) == NULL ||
+      CU_add_test(p_suite, "test_many", test_hash_snapshot_many) == NULL ||
+      CU_add_test(p_suite, "test_bad_file",
+                  test_hash_snapshot_bad_file) == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  p_suite = CU_add_suite("CONCURRENT MAP TESTS", NULL, NULL);
+  if (p_suite == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  if (CU_add_test(p_suite, "test_ctor", test_concurrent_map_ctor) == NULL ||
+      CU_add_test(p_suite, "test_insert", test_concurrent_map_insert) == NULL ||
+      CU_add_test(p_suite, "test_erase", test_concurrent_map_erase) == NULL ||
+      CU_add_test(p_suite, "test_scoped_info",
+                  test_concurrent_map_scoped_info) == NULL ||
+      CU_add_test(p_suite, "test_threads", test_concurrent_map_threads) ==
+          NULL) {
     CU_cleanup_registry();
     return CU_get_error();
   }
@@ -337,7 +536,12 @@ int main(int argc, char** argv)
       CU_add_test(p_suite, "test_erase", test_splay_tree_erase) == NULL ||
       CU_add_test(p_suite, "test_iterators", test_splay_tree_iterators) ==
           NULL ||
-      CU_add_test(p_suite, "test_height", test_splay_tree_height) == NULL) {
+      CU_add_test(p_suite, "test_height", test_splay_tree_height) == NULL ||
+      CU_add_test(p_suite, "test_pool", test_splay_tree_pool) == NULL ||
+      CU_add_test(p_suite, "test_cmp3", test_splay_tree_cmp3) == NULL ||
+      CU_add_test(p_suite, "test_bounds", test_splay_tree_bounds) == NULL ||
+      CU_add_test(p_suite, "test_splay_period",
+                  test_splay_tree_splay_period) == NULL) {
     CU_cleanup_registry();
     return CU_get_error();
   }
@@ -360,7 +564,44 @@ int main(int argc, char** argv)
                   test_avl_tree_insert_or_assign) == NULL ||
       CU_add_test(p_suite, "test_erase", test_avl_tree_erase) == NULL ||
       CU_add_test(p_suite, "test_iterators", test_avl_tree_iterators) == NULL ||
-      CU_add_test(p_suite, "test_height", test_avl_tree_height) == NULL) {
+      CU_add_test(p_suite, "test_height", test_avl_tree_height) == NULL ||
+      CU_add_test(p_suite, "test_pool", test_avl_tree_pool) == NULL ||
+      CU_add_test(p_suite, "test_cmp3", test_avl_tree_cmp3) == NULL ||
+      CU_add_test(p_suite, "test_rank_select", test_avl_tree_rank_select) ==
+          NULL ||
+      CU_add_test(p_suite, "test_erase_two_children",
+                  test_avl_tree_erase_two_children) == NULL ||
+      CU_add_test(p_suite, "test_bounds", test_avl_tree_bounds) == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  p_suite = CU_add_suite("B+ TREE TESTS", NULL, NULL);
+  if (p_suite == NULL) {
+    CU_cleanup_registry();
+    return CU_get_error();
+  }
+
+  if (CU_add_test(p_suite, "test_ctor", test_bplus_tree_ctor) == NULL ||
+      CU_add_test(p_suite, "test_ctorl", test_bplus_tree_ctorl) == NULL ||
+      CU_add_test(p_suite, "test_get", test_bplus_tree_get) == NULL ||
+      CU_add_test(p_suite, "test_count", test_bplus_tree_count) == NULL ||
+      CU_add_test(p_suite, "test_find", test_bplus_tree_find) == NULL ||
+      CU_add_test(p_suite, "test_clear", test_bplus_tree_clear) == NULL ||
+      CU_add_test(p_suite, "test_insert", test_bplus_tree_insert) == NULL ||
+      CU_add_test(p_suite, "test_insert_or_assign",
+                  test_bplus_tree_insert_or_assign) == NULL ||
+      CU_add_test(p_suite, "test_erase", test_bplus_tree_erase) == NULL ||
+      CU_add_test(p_suite, "test_erase_many",
+                  test_bplus_tree_erase_many) == NULL ||
+      CU_add_test(p_suite, "test_iterators",
+                  test_bplus_tree_iterators) == NULL ||
+      CU_add_test(p_suite, "test_swap", test_bplus_tree_swap) == NULL ||
+      CU_add_test(p_suite, "test_pool", test_bplus_tree_pool) == NULL ||
+      CU_add_test(p_suite, "test_bad_alloc", test_bplus_tree_bad_alloc) ==
+          NULL ||
+      CU_add_test(p_suite, "test_cmp3", test_bplus_tree_cmp3) == NULL ||
+      CU_add_test(p_suite, "test_bounds", test_bplus_tree_bounds) == NULL) {
     CU_cleanup_registry();
     return CU_get_error();
   }
@@ -383,7 +624,9 @@ int main(int argc, char** argv)
                   test_map_insert_or_assign) == NULL ||
       CU_add_test(p_suite, "test_erase", test_map_erase) == NULL ||
       CU_add_test(p_suite, "test_iterators", test_map_iterators) == NULL ||
-      CU_add_test(p_suite, "test_iter_type", test_map_iter_type) == NULL) {
+      CU_add_test(p_suite, "test_iter_type", test_map_iter_type) == NULL ||
+      CU_add_test(p_suite, "test_bounds", test_map_bounds) == NULL ||
+      CU_add_test(p_suite, "test_range", test_map_range) == NULL) {
     CU_cleanup_registry();
     return CU_get_error();
   }
@@ -70,7 +70,9 @@ static bool map_key_int_eq(struct cdc_map *t, size_t count, ...)
 void test_map_ctor()
 {
   const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
-                                          cdc_map_treap, cdc_map_htable};
+                                          cdc_map_treap, cdc_map_bplus,
+                                          cdc_map_htable, cdc_map_rhtable,
+                                          cdc_map_swtable, cdc_map_cmtable};
   for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
     struct cdc_map *m = NULL;
     struct cdc_data_info info = CDC_INIT_STRUCT;
@@ -87,7 +89,9 @@ void test_map_ctor()
 void test_map_ctorl()
 {
   const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
-                                          cdc_map_treap, cdc_map_htable};
+                                          cdc_map_treap, cdc_map_bplus,
+                                          cdc_map_htable, cdc_map_rhtable,
+                                          cdc_map_swtable, cdc_map_cmtable};
   for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
     struct cdc_map *m = NULL;
     struct cdc_data_info info = CDC_INIT_STRUCT;
@@ -107,7 +111,9 @@ void test_map_ctorl()
 void test_map_get()
 {
   const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
-                                          cdc_map_treap, cdc_map_htable};
+                                          cdc_map_treap, cdc_map_bplus,
+                                          cdc_map_htable, cdc_map_rhtable,
+                                          cdc_map_swtable, cdc_map_cmtable};
   for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
     struct cdc_map *m = NULL;
     void *value = NULL;
@@ -130,7 +136,9 @@ void test_map_get()
 void test_map_count()
 {
   const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
-                                          cdc_map_treap, cdc_map_htable};
+                                          cdc_map_treap, cdc_map_bplus,
+                                          cdc_map_htable, cdc_map_rhtable,
+                                          cdc_map_swtable, cdc_map_cmtable};
   for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
     struct cdc_map *m = NULL;
     struct cdc_data_info info = CDC_INIT_STRUCT;
@@ -151,7 +159,9 @@ void test_map_count()
 void test_map_find()
 {
   const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
-                                          cdc_map_treap, cdc_map_htable};
+                                          cdc_map_treap, cdc_map_bplus,
+                                          cdc_map_htable, cdc_map_rhtable,
+                                          cdc_map_swtable, cdc_map_cmtable};
   for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
     struct cdc_map *m = NULL;
     struct cdc_map_iter it = CDC_INIT_STRUCT;
@@ -185,7 +195,9 @@ void test_map_find()
 void test_map_clear()
 {
   const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
-                                          cdc_map_treap, cdc_map_htable};
+                                          cdc_map_treap, cdc_map_bplus,
+                                          cdc_map_htable, cdc_map_rhtable,
+                                          cdc_map_swtable, cdc_map_cmtable};
   for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
     struct cdc_map *m = NULL;
     struct cdc_data_info info = CDC_INIT_STRUCT;
@@ -207,7 +219,9 @@ void test_map_clear()
 void test_map_insert()
 {
   const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
-                                          cdc_map_treap, cdc_map_htable};
+                                          cdc_map_treap, cdc_map_bplus,
+                                          cdc_map_htable, cdc_map_rhtable,
+                                          cdc_map_swtable, cdc_map_cmtable};
   for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
     struct cdc_map *m = NULL;
     const int count = 100;
@@ -236,7 +250,9 @@ void test_map_insert()
 void test_map_insert_or_assign()
 {
   const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
-                                          cdc_map_treap, cdc_map_htable};
+                                          cdc_map_treap, cdc_map_bplus,
+                                          cdc_map_htable, cdc_map_rhtable,
+                                          cdc_map_swtable, cdc_map_cmtable};
   for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
     struct cdc_map *m = NULL;
     struct cdc_map_iter it = CDC_INIT_STRUCT;
@@ -289,7 +305,9 @@ void test_map_insert_or_assign()
 void test_map_erase()
 {
   const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
-                                          cdc_map_treap, cdc_map_htable};
+                                          cdc_map_treap, cdc_map_bplus,
+                                          cdc_map_htable, cdc_map_rhtable,
+                                          cdc_map_swtable, cdc_map_cmtable};
   for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
     struct cdc_map *m = NULL;
     void *value = NULL;
@@ -354,7 +372,9 @@ void test_map_swap() {}
 void test_map_iterators()
 {
   const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
-                                          cdc_map_treap, cdc_map_htable};
+                                          cdc_map_treap, cdc_map_bplus,
+                                          cdc_map_htable, cdc_map_rhtable,
+                                          cdc_map_swtable, cdc_map_cmtable};
   for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
     struct cdc_map *m = NULL;
     struct cdc_data_info info = CDC_INIT_STRUCT;
@@ -379,7 +399,12 @@ void test_map_iterators()
     cdc_map_begin(m, &it1);
     cdc_map_end(m, &it2);
     for (; !cdc_map_iter_is_eq(&it1, &it2); cdc_map_iter_next(&it1)) {
-      CU_ASSERT_EQUAL(cdc_map_iter_key(&it1), arr[i]->first)
+      // Hash tables do not keep the order of keys.
+      if (cdc_map_iter_type(&it1) == CDC_BIDIR_ITERATOR) {
+        CU_ASSERT_EQUAL(cdc_map_iter_key(&it1), arr[i]->first)
+      } else {
+        CU_ASSERT_EQUAL(cdc_map_count(m, cdc_map_iter_key(&it1)), 1);
+      }
       ++i;
     }
     CU_ASSERT_EQUAL(cdc_map_size(m), i);
@@ -399,7 +424,11 @@ void test_map_iterators()
     i = 0;
     cdc_map_begin(m, &it1);
     while (cdc_map_iter_has_next(&it1)) {
-      CU_ASSERT_EQUAL(cdc_map_iter_key(&it1), arr[i]->first)
+      if (cdc_map_iter_type(&it1) == CDC_BIDIR_ITERATOR) {
+        CU_ASSERT_EQUAL(cdc_map_iter_key(&it1), arr[i]->first)
+      } else {
+        CU_ASSERT_EQUAL(cdc_map_count(m, cdc_map_iter_key(&it1)), 1);
+      }
       ++i;
       cdc_map_iter_next(&it1);
     }
@@ -427,10 +456,13 @@ void test_map_iterators()
 void test_map_iter_type()
 {
   const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
-                                          cdc_map_treap, cdc_map_htable};
+                                          cdc_map_treap, cdc_map_bplus,
+                                          cdc_map_htable, cdc_map_rhtable,
+                                          cdc_map_swtable, cdc_map_cmtable};
   const enum cdc_iterator_type answers[] = {
       CDC_BIDIR_ITERATOR, CDC_BIDIR_ITERATOR, CDC_BIDIR_ITERATOR,
-      CDC_FWD_ITERATOR};
+      CDC_BIDIR_ITERATOR, CDC_FWD_ITERATOR, CDC_FWD_ITERATOR,
+      CDC_FWD_ITERATOR, CDC_FWD_ITERATOR};
   CU_ASSERT_EQUAL(CDC_ARRAY_SIZE(tables), CDC_ARRAY_SIZE(answers));
   for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
     struct cdc_map *m = NULL;
@@ -447,3 +479,87 @@ void test_map_iter_type()
     cdc_map_dtor(m);
   }
 }
+
+void test_map_bounds()
+{
+  const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
+                                          cdc_map_treap, cdc_map_bplus};
+  for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
+    struct cdc_map *m = NULL;
+    struct cdc_map_iter it = CDC_INIT_STRUCT;
+    struct cdc_map_iter it_end = CDC_INIT_STRUCT;
+    struct cdc_data_info info = CDC_INIT_STRUCT;
+    info.cmp = lt;
+
+    CU_ASSERT_EQUAL(cdc_map_ctorl(tables[t], &m, &info, &a, &c, &e, CDC_END),
+                    CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(cdc_map_iter_ctor(m, &it), CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(cdc_map_iter_ctor(m, &it_end), CDC_STATUS_OK);
+
+    cdc_map_lower_bound(m, c.first, &it);
+    CU_ASSERT_EQUAL(cdc_map_iter_key(&it), c.first);
+    cdc_map_lower_bound(m, d.first, &it);
+    CU_ASSERT_EQUAL(cdc_map_iter_key(&it), e.first);
+    cdc_map_upper_bound(m, c.first, &it);
+    CU_ASSERT_EQUAL(cdc_map_iter_key(&it), e.first);
+    cdc_map_upper_bound(m, e.first, &it);
+    cdc_map_end(m, &it_end);
+    CU_ASSERT(cdc_map_iter_is_eq(&it, &it_end));
+    cdc_map_iter_dtor(&it);
+    cdc_map_iter_dtor(&it_end);
+    cdc_map_dtor(m);
+  }
+}
+
+struct range_ctx {
+  int keys[8];
+  size_t size;
+  size_t limit;
+};
+
+static bool collect_key(void *key, void *value, void *ctx)
+{
+  struct range_ctx *range = (struct range_ctx *)ctx;
+  CU_ASSERT_EQUAL(key, value);
+  range->keys[range->size++] = CDC_TO_INT(key);
+  return range->size < range->limit;
+}
+
+void test_map_range()
+{
+  const struct cdc_map_table *tables[] = {cdc_map_avl, cdc_map_splay,
+                                          cdc_map_treap, cdc_map_bplus};
+  for (size_t t = 0; t < CDC_ARRAY_SIZE(tables); ++t) {
+    struct cdc_map *m = NULL;
+    struct cdc_data_info info = CDC_INIT_STRUCT;
+    info.cmp = lt;
+
+    CU_ASSERT_EQUAL(cdc_map_ctorl(tables[t], &m, &info, &h, &a, &g, &c, &e,
+                                  &b, CDC_END),
+                    CDC_STATUS_OK);
+
+    struct range_ctx range = {{0}, 0, 8};
+    cdc_map_range(m, b.first, g.first, collect_key, &range);
+    CU_ASSERT_EQUAL(range.size, 3);
+    CU_ASSERT_EQUAL(range.keys[0], 1);
+    CU_ASSERT_EQUAL(range.keys[1], 2);
+    CU_ASSERT_EQUAL(range.keys[2], 4);
+
+    range.size = 0;
+    cdc_map_range(m, d.first, CDC_FROM_INT(100), collect_key, &range);
+    CU_ASSERT_EQUAL(range.size, 3);
+    CU_ASSERT_EQUAL(range.keys[0], 4);
+    CU_ASSERT_EQUAL(range.keys[2], 7);
+
+    range.size = 0;
+    range.limit = 2;
+    cdc_map_range(m, a.first, h.first, collect_key, &range);
+    CU_ASSERT_EQUAL(range.size, 2);
+    CU_ASSERT_EQUAL(range.keys[1], 1);
+
+    range.size = 0;
+    cdc_map_range(m, g.first, b.first, collect_key, &range);
+    CU_ASSERT_EQUAL(range.size, 0);
+    cdc_map_dtor(m);
+  }
+}
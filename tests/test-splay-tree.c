@@ -47,6 +47,11 @@ static int lt(const void *l, const void *r)
   return CDC_TO_INT(l) < CDC_TO_INT(r);
 }
 
+static int cmp_int(const void *l, const void *r)
+{
+  return (CDC_TO_INT(l) > CDC_TO_INT(r)) - (CDC_TO_INT(l) < CDC_TO_INT(r));
+}
+
 static bool splay_tree_key_int_eq(struct cdc_splay_tree *t, size_t count, ...)
 {
   va_list args;
@@ -376,3 +381,205 @@ void test_splay_tree_height()
          experimental_height, count);
   cdc_splay_tree_dtor(t);
 }
+
+void test_splay_tree_pool()
+{
+  struct cdc_splay_tree *t = NULL;
+  struct cdc_splay_tree *w = NULL;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.pool_chunk = 64;
+
+  CU_ASSERT_EQUAL(cdc_splay_tree_ctor(&t, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_splay_tree_ctor(&w, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_splay_tree_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(cdc_splay_tree_erase(t, CDC_FROM_INT(i)), 1);
+  }
+
+  CU_ASSERT_EQUAL(cdc_splay_tree_size(t), kCount / 2);
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(
+        cdc_splay_tree_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_splay_tree_size(t), kCount);
+  for (int i = 0; i < kCount; ++i) {
+    void *value = NULL;
+    CU_ASSERT_EQUAL(cdc_splay_tree_get(t, CDC_FROM_INT(i), &value),
+                    CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(CDC_TO_INT(value), i);
+  }
+
+  cdc_splay_tree_swap(t, w);
+  CU_ASSERT(cdc_splay_tree_empty(t));
+  CU_ASSERT_EQUAL(cdc_splay_tree_size(w), kCount);
+  cdc_splay_tree_clear(w);
+  CU_ASSERT(cdc_splay_tree_empty(w));
+  CU_ASSERT_EQUAL(
+      cdc_splay_tree_insert(w, CDC_FROM_INT(1), CDC_FROM_INT(1), NULL),
+      CDC_STATUS_OK);
+  cdc_splay_tree_dtor(t);
+  cdc_splay_tree_dtor(w);
+}
+
+void test_splay_tree_cmp3()
+{
+  struct cdc_splay_tree *t = NULL;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp3 = cmp_int;
+
+  CU_ASSERT_EQUAL(cdc_splay_tree_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount;
+    CU_ASSERT_EQUAL(
+        cdc_splay_tree_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(cdc_splay_tree_erase(t, CDC_FROM_INT(i)), 1);
+  }
+
+  CU_ASSERT_EQUAL(cdc_splay_tree_size(t), kCount / 2);
+  for (int i = 0; i < kCount; ++i) {
+    void *value = NULL;
+    enum cdc_stat stat = cdc_splay_tree_get(t, CDC_FROM_INT(i), &value);
+    CU_ASSERT_EQUAL(stat, i % 2 ? CDC_STATUS_OK : CDC_STATUS_NOT_FOUND);
+  }
+
+  struct cdc_splay_tree_iter it = CDC_INIT_STRUCT;
+  int expected = 1;
+  cdc_splay_tree_begin(t, &it);
+  while (cdc_splay_tree_iter_has_next(&it)) {
+    CU_ASSERT_EQUAL(CDC_TO_INT(cdc_splay_tree_iter_key(&it)), expected);
+    expected += 2;
+    cdc_splay_tree_iter_next(&it);
+  }
+
+  CU_ASSERT_EQUAL(expected, kCount + 1);
+  cdc_splay_tree_dtor(t);
+}
+
+static int splay_tree_bound_key(struct cdc_splay_tree *t,
+                                struct cdc_splay_tree_iter *it)
+{
+  struct cdc_splay_tree_iter it_end = CDC_INIT_STRUCT;
+  cdc_splay_tree_end(t, &it_end);
+  if (cdc_splay_tree_iter_is_eq(it, &it_end)) {
+    return -1;
+  }
+
+  return CDC_TO_INT(cdc_splay_tree_iter_key(it));
+}
+
+void test_splay_tree_bounds()
+{
+  struct cdc_splay_tree *t = NULL;
+  struct cdc_splay_tree_iter it = CDC_INIT_STRUCT;
+  struct cdc_pair_splay_tree_iter range = CDC_INIT_STRUCT;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_splay_tree_ctor(&t, &info), CDC_STATUS_OK);
+  cdc_splay_tree_lower_bound(t, CDC_FROM_INT(0), &it);
+  CU_ASSERT_EQUAL(splay_tree_bound_key(t, &it), -1);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount * 2;
+    CU_ASSERT_EQUAL(
+        cdc_splay_tree_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  // The keys are the even numbers in [0, 2 * kCount).
+  for (int i = -1; i <= 2 * kCount; ++i) {
+    int lower = (i + 1) / 2 * 2;
+    int upper = (i + 2) / 2 * 2;
+    lower = lower < 2 * kCount ? lower : -1;
+    upper = upper < 2 * kCount ? upper : -1;
+    cdc_splay_tree_lower_bound(t, CDC_FROM_INT(i), &it);
+    CU_ASSERT_EQUAL(splay_tree_bound_key(t, &it), lower);
+    cdc_splay_tree_upper_bound(t, CDC_FROM_INT(i), &it);
+    CU_ASSERT_EQUAL(splay_tree_bound_key(t, &it), upper);
+    cdc_splay_tree_equal_range(t, CDC_FROM_INT(i), &range);
+    CU_ASSERT_EQUAL(splay_tree_bound_key(t, &range.first), lower);
+    CU_ASSERT_EQUAL(splay_tree_bound_key(t, &range.second), upper);
+  }
+
+  cdc_splay_tree_lower_bound(t, CDC_FROM_INT(7), &it);
+  cdc_splay_tree_iter_prev(&it);
+  CU_ASSERT_EQUAL(CDC_TO_INT(cdc_splay_tree_iter_key(&it)), 6);
+  cdc_splay_tree_dtor(t);
+}
+
+void test_splay_tree_splay_period()
+{
+  struct cdc_splay_tree *t = NULL;
+  struct cdc_splay_tree_iter it = CDC_INIT_STRUCT;
+  const int kCount = 100;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  void *value = NULL;
+
+  CU_ASSERT_EQUAL(cdc_splay_tree_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_splay_tree_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  // The peek lookups never change the root.
+  struct cdc_splay_tree_node *root = t->root;
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_splay_tree_peek(t, CDC_FROM_INT(i), &value),
+                    CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(CDC_TO_INT(value), i);
+    cdc_splay_tree_peek_find(t, CDC_FROM_INT(i), &it);
+    CU_ASSERT_EQUAL(CDC_TO_INT(cdc_splay_tree_iter_value(&it)), i);
+  }
+
+  CU_ASSERT_EQUAL(cdc_splay_tree_peek(t, CDC_FROM_INT(kCount), &value),
+                  CDC_STATUS_NOT_FOUND);
+  CU_ASSERT(t->root == root);
+
+  // With period 0 the lookups keep the tree as it is.
+  cdc_splay_tree_set_splay_period(t, 0);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(cdc_splay_tree_get(t, CDC_FROM_INT(i), &value),
+                    CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(CDC_TO_INT(value), i);
+    CU_ASSERT_EQUAL(cdc_splay_tree_count(t, CDC_FROM_INT(i)), 1);
+    cdc_splay_tree_lower_bound(t, CDC_FROM_INT(i), &it);
+    CU_ASSERT_EQUAL(CDC_TO_INT(cdc_splay_tree_iter_key(&it)), i);
+  }
+
+  CU_ASSERT(t->root == root);
+
+  // With period 3 every third lookup splays the found element.
+  cdc_splay_tree_set_splay_period(t, 3);
+  int key = CDC_TO_INT(root->key) == 0 ? 1 : 0;
+  cdc_splay_tree_find(t, CDC_FROM_INT(key), &it);
+  cdc_splay_tree_find(t, CDC_FROM_INT(key), &it);
+  CU_ASSERT(t->root == root);
+  cdc_splay_tree_find(t, CDC_FROM_INT(key), &it);
+  CU_ASSERT_EQUAL(CDC_TO_INT(t->root->key), key);
+
+  // The inserts and the erases always splay.
+  cdc_splay_tree_set_splay_period(t, 0);
+  CU_ASSERT_EQUAL(cdc_splay_tree_insert(t, CDC_FROM_INT(kCount),
+                                        CDC_FROM_INT(kCount), NULL),
+                  CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(CDC_TO_INT(t->root->key), kCount);
+  CU_ASSERT_EQUAL(cdc_splay_tree_erase(t, CDC_FROM_INT(kCount)), 1);
+  CU_ASSERT_EQUAL(cdc_splay_tree_size(t), (size_t)kCount);
+  cdc_splay_tree_dtor(t);
+}
@@ -46,6 +46,23 @@ static int lt(const void *l, const void *r)
   return CDC_TO_INT(l) < CDC_TO_INT(r);
 }
 
+static int cmp_int(const void *l, const void *r)
+{
+  return (CDC_TO_INT(l) > CDC_TO_INT(r)) - (CDC_TO_INT(l) < CDC_TO_INT(r));
+}
+
+static size_t treap_check_sizes(struct cdc_treap_node *node)
+{
+  if (!node) {
+    return 0;
+  }
+
+  size_t size = treap_check_sizes(node->left) +
+                treap_check_sizes(node->right) + 1;
+  CU_ASSERT_EQUAL(node->size, size);
+  return size;
+}
+
 static bool treap_key_int_eq(struct cdc_treap *t, size_t count, ...)
 {
   va_list args;
@@ -367,3 +384,480 @@ void test_treap_height()
          experimental_height, count);
   cdc_treap_dtor(t);
 }
+
+void test_treap_pool()
+{
+  struct cdc_treap *t = NULL;
+  struct cdc_treap *w = NULL;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.pool_chunk = 64;
+
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&t, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&w, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(cdc_treap_erase(t, CDC_FROM_INT(i)), 1);
+  }
+
+  CU_ASSERT_EQUAL(cdc_treap_size(t), kCount / 2);
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_treap_size(t), kCount);
+  for (int i = 0; i < kCount; ++i) {
+    void *value = NULL;
+    CU_ASSERT_EQUAL(cdc_treap_get(t, CDC_FROM_INT(i), &value), CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(CDC_TO_INT(value), i);
+  }
+
+  cdc_treap_swap(t, w);
+  CU_ASSERT(cdc_treap_empty(t));
+  CU_ASSERT_EQUAL(cdc_treap_size(w), kCount);
+  cdc_treap_clear(w);
+  CU_ASSERT(cdc_treap_empty(w));
+  CU_ASSERT_EQUAL(
+      cdc_treap_insert(w, CDC_FROM_INT(1), CDC_FROM_INT(1), NULL),
+      CDC_STATUS_OK);
+  cdc_treap_dtor(t);
+  cdc_treap_dtor(w);
+}
+
+void test_treap_cmp3()
+{
+  struct cdc_treap *t = NULL;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp3 = cmp_int;
+
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount;
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; i += 2) {
+    CU_ASSERT_EQUAL(cdc_treap_erase(t, CDC_FROM_INT(i)), 1);
+  }
+
+  CU_ASSERT_EQUAL(cdc_treap_size(t), kCount / 2);
+  for (int i = 0; i < kCount; ++i) {
+    void *value = NULL;
+    enum cdc_stat stat = cdc_treap_get(t, CDC_FROM_INT(i), &value);
+    CU_ASSERT_EQUAL(stat, i % 2 ? CDC_STATUS_OK : CDC_STATUS_NOT_FOUND);
+  }
+
+  struct cdc_treap_iter it = CDC_INIT_STRUCT;
+  int expected = 1;
+  cdc_treap_begin(t, &it);
+  while (cdc_treap_iter_has_next(&it)) {
+    CU_ASSERT_EQUAL(CDC_TO_INT(cdc_treap_iter_key(&it)), expected);
+    expected += 2;
+    cdc_treap_iter_next(&it);
+  }
+
+  CU_ASSERT_EQUAL(expected, kCount + 1);
+  cdc_treap_dtor(t);
+}
+
+void test_treap_rank_select()
+{
+  struct cdc_treap *t = NULL;
+  struct cdc_treap_iter it = CDC_INIT_STRUCT;
+  struct cdc_treap_iter it_end = CDC_INIT_STRUCT;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&t, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_treap_rank(t, CDC_FROM_INT(0)), 0);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount;
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  for (int i = 0; i < kCount; i += 3) {
+    CU_ASSERT_EQUAL(cdc_treap_erase(t, CDC_FROM_INT(i)), 1);
+  }
+
+  CU_ASSERT_EQUAL(treap_check_sizes(t->root), cdc_treap_size(t));
+
+  // The keys left are the ones not divisible by 3.
+  size_t index = 0;
+  for (int i = 0; i < kCount; ++i) {
+    size_t rank = (size_t)(i - (i + 2) / 3);
+    CU_ASSERT_EQUAL(cdc_treap_rank(t, CDC_FROM_INT(i)), rank);
+    if (i % 3 != 0) {
+      cdc_treap_select(t, index, &it);
+      CU_ASSERT_EQUAL(CDC_TO_INT(cdc_treap_iter_key(&it)), i);
+      ++index;
+    }
+  }
+
+  CU_ASSERT_EQUAL(index, cdc_treap_size(t));
+  CU_ASSERT_EQUAL(cdc_treap_rank(t, CDC_FROM_INT(kCount)), index);
+  cdc_treap_select(t, index, &it);
+  cdc_treap_end(t, &it_end);
+  CU_ASSERT(cdc_treap_iter_is_eq(&it, &it_end));
+  cdc_treap_dtor(t);
+}
+
+static int treap_bound_key(struct cdc_treap *t, struct cdc_treap_iter *it)
+{
+  struct cdc_treap_iter it_end = CDC_INIT_STRUCT;
+  cdc_treap_end(t, &it_end);
+  if (cdc_treap_iter_is_eq(it, &it_end)) {
+    return -1;
+  }
+
+  return CDC_TO_INT(cdc_treap_iter_key(it));
+}
+
+void test_treap_bounds()
+{
+  struct cdc_treap *t = NULL;
+  struct cdc_treap_iter it = CDC_INIT_STRUCT;
+  struct cdc_pair_treap_iter range = CDC_INIT_STRUCT;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&t, &info), CDC_STATUS_OK);
+  cdc_treap_lower_bound(t, CDC_FROM_INT(0), &it);
+  CU_ASSERT_EQUAL(treap_bound_key(t, &it), -1);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount * 2;
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  // The keys are the even numbers in [0, 2 * kCount).
+  for (int i = -1; i <= 2 * kCount; ++i) {
+    int lower = (i + 1) / 2 * 2;
+    int upper = (i + 2) / 2 * 2;
+    lower = lower < 2 * kCount ? lower : -1;
+    upper = upper < 2 * kCount ? upper : -1;
+    cdc_treap_lower_bound(t, CDC_FROM_INT(i), &it);
+    CU_ASSERT_EQUAL(treap_bound_key(t, &it), lower);
+    cdc_treap_upper_bound(t, CDC_FROM_INT(i), &it);
+    CU_ASSERT_EQUAL(treap_bound_key(t, &it), upper);
+    cdc_treap_equal_range(t, CDC_FROM_INT(i), &range);
+    CU_ASSERT_EQUAL(treap_bound_key(t, &range.first), lower);
+    CU_ASSERT_EQUAL(treap_bound_key(t, &range.second), upper);
+  }
+
+  cdc_treap_lower_bound(t, CDC_FROM_INT(7), &it);
+  cdc_treap_iter_prev(&it);
+  CU_ASSERT_EQUAL(CDC_TO_INT(cdc_treap_iter_key(&it)), 6);
+  cdc_treap_dtor(t);
+}
+
+// Checks that the keys of the treap are the numbers from first to last.
+static bool treap_keys_are_seq(struct cdc_treap *t, int first, int last)
+{
+  struct cdc_treap_iter it = CDC_INIT_STRUCT;
+  int key = first;
+  for (cdc_treap_begin(t, &it); cdc_treap_iter_has_next(&it);
+       cdc_treap_iter_next(&it)) {
+    if (CDC_TO_INT(cdc_treap_iter_key(&it)) != key++) {
+      return false;
+    }
+  }
+
+  return key == last + 1 && cdc_treap_size(t) == (size_t)(last - first + 1);
+}
+
+void test_treap_split_join()
+{
+  struct cdc_treap *t = NULL;
+  struct cdc_treap *left = NULL;
+  struct cdc_treap *right = NULL;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount;
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(t, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_treap_split(t, CDC_FROM_INT(kCount / 2), &left, &right),
+                  CDC_STATUS_OK);
+  CU_ASSERT(cdc_treap_empty(t));
+  CU_ASSERT(treap_keys_are_seq(left, 0, kCount / 2 - 1));
+  CU_ASSERT(treap_keys_are_seq(right, kCount / 2, kCount - 1));
+  CU_ASSERT_EQUAL(treap_check_sizes(left->root), cdc_treap_size(left));
+  CU_ASSERT_EQUAL(treap_check_sizes(right->root), cdc_treap_size(right));
+  cdc_treap_dtor(t);
+
+  CU_ASSERT_EQUAL(cdc_treap_insert(right, CDC_FROM_INT(kCount),
+                                   CDC_FROM_INT(kCount), NULL),
+                  CDC_STATUS_OK);
+  cdc_treap_join(right, left);
+  CU_ASSERT(cdc_treap_empty(left));
+  CU_ASSERT(treap_keys_are_seq(right, 0, kCount));
+  CU_ASSERT_EQUAL(treap_check_sizes(right->root), cdc_treap_size(right));
+  CU_ASSERT_EQUAL(cdc_treap_erase(right, CDC_FROM_INT(0)), 1);
+  cdc_treap_dtor(left);
+
+  CU_ASSERT_EQUAL(cdc_treap_split(right, CDC_FROM_INT(0), &left, &t),
+                  CDC_STATUS_OK);
+  CU_ASSERT(cdc_treap_empty(left));
+  CU_ASSERT(treap_keys_are_seq(t, 1, kCount));
+  cdc_treap_dtor(left);
+  cdc_treap_dtor(right);
+  cdc_treap_dtor(t);
+}
+
+void test_treap_join_pool()
+{
+  struct cdc_treap *a = NULL;
+  struct cdc_treap *b = NULL;
+  struct cdc_treap *left = NULL;
+  struct cdc_treap *right = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.pool_chunk = 16;
+
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&a, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&b, &info), CDC_STATUS_OK);
+  for (int i = 0; i < 100; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(a, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(b, CDC_FROM_INT(i + 100), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  CU_ASSERT_EQUAL(cdc_treap_split(a, CDC_FROM_INT(50), &left, &right),
+                  CDC_STATUS_NOT_SUPPORTED);
+  CU_ASSERT(treap_keys_are_seq(a, 0, 99));
+  cdc_treap_join(a, b);
+  CU_ASSERT(cdc_treap_empty(b));
+  CU_ASSERT(treap_keys_are_seq(a, 0, 199));
+  cdc_treap_dtor(b);
+  CU_ASSERT_EQUAL(cdc_treap_erase(a, CDC_FROM_INT(150)), 1);
+  CU_ASSERT_EQUAL(cdc_treap_size(a), 199);
+  cdc_treap_dtor(a);
+}
+
+static struct cdc_treap *make_treap_range(int first, int last, int step,
+                                          size_t pool_chunk)
+{
+  struct cdc_treap *t = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.pool_chunk = pool_chunk;
+
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&t, &info), CDC_STATUS_OK);
+  for (int i = first; i <= last; i += step) {
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(t, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+  }
+
+  return t;
+}
+
+// Checks the keys of t against the keys of the numbers i from 0 to last for
+// which is_member(i) is true.
+static void treap_check_set(struct cdc_treap *t, int last,
+                            bool (*is_member)(int))
+{
+  struct cdc_treap_iter it = CDC_INIT_STRUCT;
+  size_t size = 0;
+  cdc_treap_begin(t, &it);
+  for (int i = 0; i <= last; ++i) {
+    if (!is_member(i)) {
+      continue;
+    }
+
+    CU_ASSERT(cdc_treap_iter_has_next(&it));
+    CU_ASSERT_EQUAL(CDC_TO_INT(cdc_treap_iter_key(&it)), i);
+    cdc_treap_iter_next(&it);
+    ++size;
+  }
+
+  CU_ASSERT(!cdc_treap_iter_has_next(&it));
+  CU_ASSERT_EQUAL(cdc_treap_size(t), size);
+  CU_ASSERT_EQUAL(treap_check_sizes(t->root), size);
+}
+
+static bool in_union(int i) { return i % 2 == 0 || i % 3 == 0; }
+
+static bool in_intersection(int i) { return i % 6 == 0; }
+
+static bool in_difference(int i) { return i % 2 == 0 && i % 3 != 0; }
+
+void test_treap_set_operations()
+{
+  // The treaps are large enough to be split between threads.
+  const int kLast = 100000;
+  size_t pool_chunks[] = {0, 32};
+  size_t threads[] = {1, 4};
+  for (size_t p = 0; p < CDC_ARRAY_SIZE(pool_chunks); ++p) {
+    for (size_t n = 0; n < CDC_ARRAY_SIZE(threads); ++n) {
+      struct cdc_treap *a = make_treap_range(0, kLast, 2, pool_chunks[p]);
+      struct cdc_treap *b = make_treap_range(0, kLast, 3, pool_chunks[p]);
+      cdc_treap_set_threads(a, threads[n]);
+      cdc_treap_union(a, b);
+      CU_ASSERT(cdc_treap_empty(b));
+      treap_check_set(a, kLast, in_union);
+      cdc_treap_dtor(a);
+      cdc_treap_dtor(b);
+
+      a = make_treap_range(0, kLast, 2, pool_chunks[p]);
+      b = make_treap_range(0, kLast, 3, pool_chunks[p]);
+      cdc_treap_set_threads(a, threads[n]);
+      cdc_treap_intersection(a, b);
+      CU_ASSERT(cdc_treap_empty(b));
+      treap_check_set(a, kLast, in_intersection);
+      cdc_treap_dtor(a);
+      cdc_treap_dtor(b);
+
+      a = make_treap_range(0, kLast, 2, pool_chunks[p]);
+      b = make_treap_range(0, kLast, 3, pool_chunks[p]);
+      cdc_treap_set_threads(a, threads[n]);
+      cdc_treap_difference(a, b);
+      CU_ASSERT(cdc_treap_empty(b));
+      treap_check_set(a, kLast, in_difference);
+      cdc_treap_dtor(a);
+      cdc_treap_dtor(b);
+    }
+  }
+}
+
+static size_t freed_a = 0;
+static size_t freed_b = 0;
+
+// The elements of a have the value 0, the elements of b have the value 1.
+static void count_set_free(void *pair)
+{
+  struct cdc_pair *p = (struct cdc_pair *)pair;
+  if (CDC_TO_INT(p->second) == 0) {
+    ++freed_a;
+  } else {
+    ++freed_b;
+  }
+}
+
+void test_treap_union_keeps_a()
+{
+  struct cdc_treap *a = NULL;
+  struct cdc_treap *b = NULL;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.dfree = count_set_free;
+
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&a, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&b, &info), CDC_STATUS_OK);
+  for (int i = 0; i < 100; ++i) {
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(a, CDC_FROM_INT(i), CDC_FROM_INT(0), NULL),
+        CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(b, CDC_FROM_INT(i * 2), CDC_FROM_INT(1), NULL),
+        CDC_STATUS_OK);
+  }
+
+  freed_a = 0;
+  freed_b = 0;
+  cdc_treap_union(a, b);
+  CU_ASSERT_EQUAL(freed_a, 0);
+  CU_ASSERT_EQUAL(freed_b, 50);
+  CU_ASSERT_EQUAL(cdc_treap_size(a), 150);
+  for (int i = 0; i < 100; ++i) {
+    void *value = NULL;
+    CU_ASSERT_EQUAL(cdc_treap_get(a, CDC_FROM_INT(i), &value), CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(CDC_TO_INT(value), 0);
+  }
+
+  cdc_treap_dtor(b);
+  cdc_treap_dtor(a);
+  CU_ASSERT_EQUAL(freed_a, 100);
+  CU_ASSERT_EQUAL(freed_b, 100);
+}
+
+static bool treap_same_shape(struct cdc_treap_node *a, struct cdc_treap_node *b)
+{
+  if (!a || !b) {
+    return a == b;
+  }
+
+  return a->key == b->key && a->priority == b->priority &&
+         treap_same_shape(a->left, b->left) &&
+         treap_same_shape(a->right, b->right);
+}
+
+static size_t hash(const void *val) { return cdc_hash_int(CDC_TO_INT(val)); }
+
+void test_treap_priority()
+{
+  struct cdc_treap *a = NULL;
+  struct cdc_treap *b = NULL;
+  const int kCount = 1000;
+  struct cdc_data_info info = CDC_INIT_STRUCT;
+  info.cmp = lt;
+  info.hash = hash;
+
+  // The same seed and the same insertions give the same tree.
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&a, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&b, &info), CDC_STATUS_OK);
+  cdc_treap_set_seed(a, 42);
+  cdc_treap_set_seed(b, 42);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount;
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(a, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(b, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  CU_ASSERT(treap_same_shape(a->root, b->root));
+  CU_ASSERT(cdc_tree_height(a->root) < 40);
+  cdc_treap_dtor(a);
+  cdc_treap_dtor(b);
+
+  // With the hash priorities and the same seed the order of insertions does
+  // not matter.
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&a, &info), CDC_STATUS_OK);
+  CU_ASSERT_EQUAL(cdc_treap_ctor(&b, &info), CDC_STATUS_OK);
+  cdc_treap_set_priority(a, CDC_TREAP_PRIORITY_HASH);
+  cdc_treap_set_priority(b, CDC_TREAP_PRIORITY_HASH);
+  cdc_treap_set_seed(a, 7);
+  cdc_treap_set_seed(b, 7);
+  for (int i = 0; i < kCount; ++i) {
+    int key = (i * 7919) % kCount;
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(a, CDC_FROM_INT(i), CDC_FROM_INT(i), NULL),
+        CDC_STATUS_OK);
+    CU_ASSERT_EQUAL(
+        cdc_treap_insert(b, CDC_FROM_INT(key), CDC_FROM_INT(key), NULL),
+        CDC_STATUS_OK);
+  }
+
+  CU_ASSERT(treap_same_shape(a->root, b->root));
+  CU_ASSERT(cdc_tree_height(a->root) < 40);
+  cdc_treap_dtor(a);
+  cdc_treap_dtor(b);
+}